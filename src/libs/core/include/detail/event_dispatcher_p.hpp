@@ -0,0 +1 @@
+#include "../../source/kernel/event_dispatcher_p.hpp"
@@ -0,0 +1 @@
+#include "../source/text/from_chars.hpp"
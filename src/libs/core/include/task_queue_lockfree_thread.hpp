@@ -0,0 +1 @@
+#include "../source/thread/task_queue_lockfree_thread.hpp"
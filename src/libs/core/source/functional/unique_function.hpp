@@ -50,6 +50,12 @@ namespace detail
 template <typename T>
 using UniqueFunction = fu2::unique_function<T>;
 
+/**
+ * UniqueFunction whose small buffer holds callables up to Capacity bytes without allocating.
+ */
+template <typename T, std::size_t Capacity>
+using InplaceUniqueFunction = fu2::function_base<true, false, fu2::capacity_fixed<Capacity>, true, false, T>;
+
 /**
  * @}
  * @}
@@ -35,6 +35,8 @@ class Object;
 
 class OCTK_CORE_API Event
 {
+    friend class EventLoop;
+
 public:
     enum class Type
     {
@@ -64,6 +66,8 @@ public:
 
     inline Type type() const { return static_cast<Type>(mType); }
 
+    inline bool isPosted() const { return mPosted; }
+
     inline bool isAccepted() const { return mAccept; }
     inline void setAccepted(bool accepted) { mAccept = accepted; }
 
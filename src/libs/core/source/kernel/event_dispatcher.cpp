@@ -0,0 +1,179 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/detail/event_dispatcher_p.hpp>
+#include <openctk/core/logging.hpp>
+
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <mutex>
+#include <map>
+
+#if OCTK_FEATURE_ENABLE_KERNEL
+
+OCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/**
+ * Portable fallback, timers are kept in a deadline ordered map and waits use a condition variable.
+ */
+class GenericEventDispatcher final : public EventDispatcher
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer
+    {
+        int id;
+        bool singleShot;
+        Clock::duration interval;
+        TimerCallback callback;
+    };
+
+public:
+    GenericEventDispatcher() = default;
+    ~GenericEventDispatcher() override = default;
+
+    bool registerFd(int fd, FdEvents events, FdCallback callback) override
+    {
+        OCTK_UNUSED(events);
+        OCTK_UNUSED(callback);
+        OCTK_WARNING("GenericEventDispatcher::registerFd: fd {} notifiers are not supported on this platform", fd);
+        return false;
+    }
+    bool unregisterFd(int fd) override
+    {
+        OCTK_UNUSED(fd);
+        return false;
+    }
+
+    int registerTimer(int intervalMSecs, bool singleShot, TimerCallback callback) override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const int id = mNextTimerId++;
+        const auto interval = std::chrono::milliseconds(intervalMSecs);
+        mTimers.emplace(Clock::now() + interval, Timer{id, singleShot, interval, std::move(callback)});
+        // the new timer may expire before the deadline a blocking processEvents() waits for
+        mWakeUp = true;
+        mCondition.notify_one();
+        return id;
+    }
+    bool unregisterTimer(int timerId) override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto iter = mTimers.begin(); iter != mTimers.end(); ++iter)
+        {
+            if (iter->second.id == timerId)
+            {
+                mTimers.erase(iter);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool processEvents(int timeoutMSecs) override
+    {
+        std::vector<Timer> expired;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            const auto ready = [this]() { return mWakeUp || (!mTimers.empty() && mTimers.begin()->first <= Clock::now()); };
+            if (timeoutMSecs != 0 && !ready())
+            {
+                auto deadline = timeoutMSecs < 0 ? Clock::time_point::max()
+                                                 : Clock::now() + std::chrono::milliseconds(timeoutMSecs);
+                if (!mTimers.empty() && mTimers.begin()->first < deadline)
+                {
+                    deadline = mTimers.begin()->first;
+                }
+                if (Clock::time_point::max() == deadline)
+                {
+                    mCondition.wait(lock, [this]() { return mWakeUp; });
+                }
+                else
+                {
+                    mCondition.wait_until(lock, deadline, [this]() { return mWakeUp; });
+                }
+            }
+            mWakeUp = false;
+            const auto now = Clock::now();
+            while (!mTimers.empty() && mTimers.begin()->first <= now)
+            {
+                expired.push_back(std::move(mTimers.begin()->second));
+                mTimers.erase(mTimers.begin());
+            }
+            // periodic timers are rescheduled before their callbacks run so that they can unregister themselves
+            for (const auto &timer : expired)
+            {
+                if (!timer.singleShot)
+                {
+                    mTimers.emplace(now + timer.interval, timer);
+                }
+            }
+        }
+        for (const auto &timer : expired)
+        {
+            timer.callback(timer.id);
+        }
+        return !expired.empty();
+    }
+
+    void wakeUp() override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWakeUp = true;
+        mCondition.notify_one();
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::multimap<Clock::time_point, Timer> mTimers;
+    int mNextTimerId{1};
+    bool mWakeUp{false};
+};
+
+EventDispatcher::UniquePtr createGenericEventDispatcher()
+{
+    return EventDispatcher::UniquePtr(new GenericEventDispatcher);
+}
+} // namespace detail
+
+EventDispatcher::UniquePtr EventDispatcher::create()
+{
+#if defined(OCTK_OS_LINUX)
+    auto dispatcher = detail::createEpollEventDispatcher();
+    if (dispatcher)
+    {
+        return dispatcher;
+    }
+    OCTK_WARNING("EventDispatcher::create: epoll dispatcher unavailable, fallback to generic dispatcher");
+#endif
+    return detail::createGenericEventDispatcher();
+}
+
+OCTK_END_NAMESPACE
+
+#endif // #if OCTK_FEATURE_ENABLE_KERNEL
@@ -0,0 +1,306 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/detail/event_dispatcher_p.hpp>
+#include <openctk/core/logging.hpp>
+
+#if OCTK_FEATURE_ENABLE_KERNEL && defined(OCTK_OS_LINUX)
+
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <unordered_map>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <cerrno>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+/**
+ * Linux dispatcher: fds and timerfd timers are registered level triggered in one epoll set, wakeUp() writes an
+ * eventfd. An idle loop therefore blocks in epoll_wait() and costs no CPU.
+ */
+class EpollEventDispatcher final : public EventDispatcher
+{
+    OCTK_STATIC_CONSTANT_NUMBER(kMaxEpollEvents, 64)
+
+    struct Watch
+    {
+        int fd;
+        int timerId;
+        FdCallback fdCallback;
+        TimerCallback timerCallback;
+        bool singleShot;
+    };
+    using WatchPtr = std::shared_ptr<Watch>;
+
+public:
+    EpollEventDispatcher(int epollFd, int wakeUpFd)
+        : mEpollFd(epollFd)
+        , mWakeUpFd(wakeUpFd)
+    {
+    }
+    ~EpollEventDispatcher() override
+    {
+        for (const auto &item : mTimerFds)
+        {
+            ::close(item.second);
+        }
+        ::close(mWakeUpFd);
+        ::close(mEpollFd);
+    }
+
+    static UniquePtr create()
+    {
+        const int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0)
+        {
+            OCTK_WARNING("EpollEventDispatcher::create: epoll_create1 failed, {}", std::strerror(errno));
+            return nullptr;
+        }
+        const int wakeUpFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeUpFd < 0)
+        {
+            OCTK_WARNING("EpollEventDispatcher::create: eventfd failed, {}", std::strerror(errno));
+            ::close(epollFd);
+            return nullptr;
+        }
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = wakeUpFd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeUpFd, &event) < 0)
+        {
+            OCTK_WARNING("EpollEventDispatcher::create: epoll_ctl failed, {}", std::strerror(errno));
+            ::close(wakeUpFd);
+            ::close(epollFd);
+            return nullptr;
+        }
+        return UniquePtr(new EpollEventDispatcher(epollFd, wakeUpFd));
+    }
+
+    bool registerFd(int fd, FdEvents events, FdCallback callback) override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mWatches.count(fd))
+        {
+            OCTK_WARNING("EpollEventDispatcher::registerFd: fd {} already registered", fd);
+            return false;
+        }
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = (events.testFlag(FdEvent::kRead) ? EPOLLIN : 0u) |
+                       (events.testFlag(FdEvent::kWrite) ? EPOLLOUT : 0u);
+        event.data.fd = fd;
+        if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            OCTK_WARNING("EpollEventDispatcher::registerFd: epoll_ctl fd {} failed, {}", fd, std::strerror(errno));
+            return false;
+        }
+        mWatches.emplace(fd, std::make_shared<Watch>(Watch{fd, 0, std::move(callback), nullptr, false}));
+        return true;
+    }
+    bool unregisterFd(int fd) override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto iter = mWatches.find(fd);
+        if (mWatches.end() == iter || iter->second->timerId > 0)
+        {
+            return false;
+        }
+        ::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, fd, nullptr);
+        mWatches.erase(iter);
+        return true;
+    }
+
+    int registerTimer(int intervalMSecs, bool singleShot, TimerCallback callback) override
+    {
+        const int timerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (timerFd < 0)
+        {
+            OCTK_WARNING("EpollEventDispatcher::registerTimer: timerfd_create failed, {}", std::strerror(errno));
+            return -1;
+        }
+        struct itimerspec spec;
+        std::memset(&spec, 0, sizeof(spec));
+        spec.it_value.tv_sec = intervalMSecs / 1000;
+        spec.it_value.tv_nsec = (intervalMSecs % 1000) * 1000000L;
+        if (0 == intervalMSecs)
+        {
+            // an all zero it_value disarms the timer, fire as soon as possible instead
+            spec.it_value.tv_nsec = 1;
+        }
+        if (!singleShot)
+        {
+            spec.it_interval = spec.it_value;
+        }
+        if (::timerfd_settime(timerFd, 0, &spec, nullptr) < 0)
+        {
+            OCTK_WARNING("EpollEventDispatcher::registerTimer: timerfd_settime failed, {}", std::strerror(errno));
+            ::close(timerFd);
+            return -1;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        const int timerId = mNextTimerId++;
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = timerFd;
+        if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, timerFd, &event) < 0)
+        {
+            OCTK_WARNING("EpollEventDispatcher::registerTimer: epoll_ctl failed, {}", std::strerror(errno));
+            ::close(timerFd);
+            return -1;
+        }
+        mWatches.emplace(timerFd,
+                         std::make_shared<Watch>(Watch{timerFd, timerId, nullptr, std::move(callback), singleShot}));
+        mTimerFds.emplace(timerId, timerFd);
+        return timerId;
+    }
+    bool unregisterTimer(int timerId) override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return this->removeTimer(timerId);
+    }
+
+    bool processEvents(int timeoutMSecs) override
+    {
+        struct epoll_event events[kMaxEpollEvents];
+        const int count = ::epoll_wait(mEpollFd, events, kMaxEpollEvents, timeoutMSecs);
+        if (count < 0)
+        {
+            if (EINTR != errno)
+            {
+                OCTK_WARNING("EpollEventDispatcher::processEvents: epoll_wait failed, {}", std::strerror(errno));
+            }
+            return false;
+        }
+
+        bool processed = false;
+        for (int i = 0; i < count; ++i)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == mWakeUpFd)
+            {
+                // clear the flag before draining, a concurrent wakeUp() then either hits this read or the next wait
+                mWakeUpPending.store(false, std::memory_order_release);
+                eventfd_t value;
+                ::eventfd_read(mWakeUpFd, &value);
+                continue;
+            }
+
+            WatchPtr watch;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                auto iter = mWatches.find(fd);
+                if (mWatches.end() == iter)
+                {
+                    // unregistered by a callback dispatched earlier in this batch
+                    continue;
+                }
+                watch = iter->second;
+            }
+
+            if (watch->timerId > 0)
+            {
+                uint64_t expirations = 0;
+                if (::read(fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+                {
+                    continue;
+                }
+                if (watch->singleShot)
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    this->removeTimer(watch->timerId);
+                }
+                // missed expirations are coalesced into one call
+                watch->timerCallback(watch->timerId);
+            }
+            else
+            {
+                FdEvents fdEvents;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP))
+                {
+                    fdEvents |= FdEvent::kRead;
+                }
+                if (events[i].events & EPOLLOUT)
+                {
+                    fdEvents |= FdEvent::kWrite;
+                }
+                if (events[i].events & EPOLLERR)
+                {
+                    fdEvents |= FdEvent::kError;
+                }
+                watch->fdCallback(fd, fdEvents);
+            }
+            processed = true;
+        }
+        return processed;
+    }
+
+    void wakeUp() override
+    {
+        if (!mWakeUpPending.exchange(true, std::memory_order_acq_rel))
+        {
+            ::eventfd_write(mWakeUpFd, 1);
+        }
+    }
+
+private:
+    bool removeTimer(int timerId)
+    {
+        auto iter = mTimerFds.find(timerId);
+        if (mTimerFds.end() == iter)
+        {
+            return false;
+        }
+        const int timerFd = iter->second;
+        ::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, timerFd, nullptr);
+        ::close(timerFd);
+        mWatches.erase(timerFd);
+        mTimerFds.erase(iter);
+        return true;
+    }
+
+    const int mEpollFd;
+    const int mWakeUpFd;
+    std::atomic<bool> mWakeUpPending{false};
+    std::mutex mMutex;
+    std::unordered_map<int, WatchPtr> mWatches;
+    std::unordered_map<int, int> mTimerFds;
+    int mNextTimerId{1};
+};
+
+EventDispatcher::UniquePtr createEpollEventDispatcher() { return EpollEventDispatcher::create(); }
+} // namespace detail
+
+OCTK_END_NAMESPACE
+
+#endif // #if OCTK_FEATURE_ENABLE_KERNEL && defined(OCTK_OS_LINUX)
@@ -0,0 +1,89 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#pragma once
+
+#include <openctk/core/event_loop.hpp>
+
+#include <memory>
+
+#if OCTK_FEATURE_ENABLE_KERNEL
+
+OCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief Platform backend of EventLoop.
+ *
+ * A dispatcher waits for fd readiness, timer expiry and wakeUp() requests and runs the registered callbacks on the
+ * thread calling processEvents(). Registration is thread-safe, callbacks are always invoked without internal locks held
+ * so they may register or unregister watches themselves.
+ */
+class EventDispatcher
+{
+public:
+    using UniquePtr = std::unique_ptr<EventDispatcher>;
+    using FdEvent = EventLoop::FdEvent;
+    using FdEvents = EventLoop::FdEvents;
+    using FdCallback = EventLoop::FdCallback;
+    using TimerCallback = EventLoop::TimerCallback;
+
+    /**
+     * Creates the best dispatcher of the current platform, epoll on linux and a condition variable based one
+     * (without fd support) elsewhere.
+     */
+    static UniquePtr create();
+
+    virtual ~EventDispatcher() = default;
+
+    virtual bool registerFd(int fd, FdEvents events, FdCallback callback) = 0;
+    virtual bool unregisterFd(int fd) = 0;
+
+    /**
+     * @return timer id greater than 0, or -1 on failure.
+     */
+    virtual int registerTimer(int intervalMSecs, bool singleShot, TimerCallback callback) = 0;
+    virtual bool unregisterTimer(int timerId) = 0;
+
+    /**
+     * Waits at most timeoutMSecs (negative waits forever) and dispatches every ready source.
+     * @return true if at least one fd or timer callback was invoked.
+     */
+    virtual bool processEvents(int timeoutMSecs) = 0;
+    /**
+     * Interrupts a blocking processEvents(), can be called from any thread.
+     */
+    virtual void wakeUp() = 0;
+};
+
+namespace detail
+{
+#if defined(OCTK_OS_LINUX)
+EventDispatcher::UniquePtr createEpollEventDispatcher();
+#endif
+EventDispatcher::UniquePtr createGenericEventDispatcher();
+} // namespace detail
+
+OCTK_END_NAMESPACE
+
+#endif // #if OCTK_FEATURE_ENABLE_KERNEL
@@ -24,23 +24,110 @@
 
 #include <openctk/core/detail/event_loop_p.hpp>
 #include <openctk/core/logging.hpp>
+#include <openctk/core/scope_guard.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
 
 #if OCTK_FEATURE_ENABLE_KERNEL
 
 OCTK_BEGIN_NAMESPACE
 
+namespace
+{
+// Live event loops, searched for the posted events and timers of destroyed receivers.
+std::mutex &eventLoopsMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<EventLoopPrivate *> &eventLoops()
+{
+    static std::vector<EventLoopPrivate *> loops;
+    return loops;
+}
+} // namespace
+
 EventLoopPrivate::EventLoopPrivate(EventLoop *p)
     : ObjectPrivate(p)
+    , mDispatcher(EventDispatcher::create())
 {
+    std::lock_guard<std::mutex> lock(eventLoopsMutex());
+    eventLoops().push_back(this);
 }
 
 EventLoopPrivate::~EventLoopPrivate()
 {
+    std::lock_guard<std::mutex> lock(eventLoopsMutex());
+    auto &loops = eventLoops();
+    loops.erase(std::remove(loops.begin(), loops.end(), this), loops.end());
+}
+
+bool EventLoopPrivate::sendPostedEvents()
+{
+    PostedEvents events;
+    {
+        std::lock_guard<std::mutex> lock(mPostedEventsMutex);
+        if (mPostedEvents.empty())
+        {
+            return false;
+        }
+        events.swap(mPostedEvents);
+        mSendingEvents.push_back(&events);
+    }
+    auto finished = utils::makeScopeGuard(
+        [this, &events]
+        {
+            std::lock_guard<std::mutex> lock(mPostedEventsMutex);
+            mSendingEvents.erase(std::find(mSendingEvents.begin(), mSendingEvents.end(), &events));
+        });
+    bool sent = false;
+    for (auto &posted : events)
+    {
+        if (auto receiver = posted.receiver.load(std::memory_order_acquire))
+        {
+            receiver->event(posted.event.get());
+            sent = true;
+        }
+    }
+    return sent;
+}
+
+void EventLoopPrivate::removeReceiver(Object *receiver)
+{
+    std::lock_guard<std::mutex> lock(eventLoopsMutex());
+    for (auto loop : eventLoops())
+    {
+        loop->pFunc()->removePostedEvents(receiver);
+        std::vector<int> timerIds;
+        {
+            std::lock_guard<std::mutex> timersLock(loop->mTimerReceiversMutex);
+            for (auto iter = loop->mTimerReceivers.begin(); iter != loop->mTimerReceivers.end();)
+            {
+                if (iter->second == receiver)
+                {
+                    timerIds.push_back(iter->first);
+                    iter = loop->mTimerReceivers.erase(iter);
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+        }
+        for (const auto timerId : timerIds)
+        {
+            loop->mDispatcher->unregisterTimer(timerId);
+        }
+    }
 }
 
 EventLoop::EventLoop(Object *parent)
-    : Object(parent)
+    : Object(new EventLoopPrivate(this))
 {
+    this->setParent(parent);
 }
 
 EventLoop::~EventLoop()
@@ -55,18 +142,22 @@ bool EventLoop::isRunning() const
 
 void EventLoop::processEvents(ProcessFlags flags, int maximumTime)
 {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(maximumTime);
+    flags.setFlag(ProcessFlag::kWaitForMoreEvents, false);
+    while (this->processEvents(flags) && std::chrono::steady_clock::now() < deadline)
+    {
+    }
 }
 
 bool EventLoop::processEvents(ProcessFlags flags)
 {
     OCTK_D(EventLoop);
-    // auto threadData = d->threadData.loadRelaxed();
-    // if (!threadData->hasEventDispatcher())
-    // {
-    //     return false;
-    // }
-    // return threadData->eventDispatcher.loadRelaxed()->processEvents(flags);
-    return false;
+    bool processed = d->sendPostedEvents();
+    // a post racing with this check writes the wakeup fd, so the dispatcher returns immediately
+    const bool wait = !processed && flags.testFlag(ProcessFlag::kWaitForMoreEvents) && !d->mExit.load();
+    processed |= d->mDispatcher->processEvents(wait ? -1 : 0);
+    processed |= d->sendPostedEvents();
+    return processed;
 }
 
 int EventLoop::exec(ProcessFlags flags)
@@ -78,20 +169,29 @@ int EventLoop::exec(ProcessFlags flags)
         return -1;
     }
 
+    d->mInExec = true;
+    d->mRetCode.store(0);
+    d->mExit.store(false);
     while (!d->mExit.load())
     {
         this->processEvents(flags | ProcessFlag::kWaitForMoreEvents | ProcessFlag::kEventLoopExec);
     }
-
+    d->mInExec = false;
     return d->mRetCode.load();
 }
 
 void EventLoop::wakeUp()
 {
+    OCTK_D(EventLoop);
+    d->mDispatcher->wakeUp();
 }
 
 void EventLoop::exit(int retCode)
 {
+    OCTK_D(EventLoop);
+    d->mRetCode.store(retCode);
+    d->mExit.store(true);
+    d->mDispatcher->wakeUp();
 }
 
 void EventLoop::quit()
@@ -99,6 +199,115 @@ void EventLoop::quit()
     this->exit(0);
 }
 
+void EventLoop::postEvent(Object *receiver, Event *event)
+{
+    OCTK_D(EventLoop);
+    if (nullptr == receiver || nullptr == event)
+    {
+        OCTK_WARNING("EventLoop::postEvent: can not post {} event to {} receiver",
+                     utils::fmt::ptr(event),
+                     utils::fmt::ptr(receiver));
+        delete event;
+        return;
+    }
+    event->mPosted = true;
+    ObjectPrivate::get(receiver)->mEventLoopReceiver.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(d->mPostedEventsMutex);
+        d->mPostedEvents.emplace_back(receiver, std::unique_ptr<Event>(event));
+    }
+    d->mDispatcher->wakeUp();
+}
+
+void EventLoop::removePostedEvents(Object *receiver)
+{
+    OCTK_D(EventLoop);
+    std::lock_guard<std::mutex> lock(d->mPostedEventsMutex);
+    for (auto events : d->mSendingEvents)
+    {
+        for (auto &posted : *events)
+        {
+            if (nullptr == receiver || posted.receiver.load(std::memory_order_relaxed) == receiver)
+            {
+                posted.receiver.store(nullptr, std::memory_order_release);
+            }
+        }
+    }
+    if (nullptr == receiver)
+    {
+        d->mPostedEvents.clear();
+        return;
+    }
+    auto iter = std::remove_if(d->mPostedEvents.begin(),
+                               d->mPostedEvents.end(),
+                               [receiver](const EventLoopPrivate::PostedEvent &posted)
+                               { return posted.receiver.load(std::memory_order_relaxed) == receiver; });
+    d->mPostedEvents.erase(iter, d->mPostedEvents.end());
+}
+
+bool EventLoop::registerFdNotifier(int fd, FdEvents events, FdCallback callback)
+{
+    OCTK_D(EventLoop);
+    if (fd < 0 || !callback)
+    {
+        OCTK_WARNING("EventLoop::registerFdNotifier: invalid fd {} or callback", fd);
+        return false;
+    }
+    return d->mDispatcher->registerFd(fd, events, std::move(callback));
+}
+
+bool EventLoop::unregisterFdNotifier(int fd)
+{
+    OCTK_D(EventLoop);
+    return d->mDispatcher->unregisterFd(fd);
+}
+
+int EventLoop::registerTimer(int intervalMSecs, Object *receiver)
+{
+    if (nullptr == receiver)
+    {
+        OCTK_WARNING("EventLoop::registerTimer: can not register timer for nullptr receiver");
+        return -1;
+    }
+    OCTK_D(EventLoop);
+    ObjectPrivate::get(receiver)->mEventLoopReceiver.store(true, std::memory_order_release);
+    // hold the lock across the registration, so that a receiver destroyed meanwhile can't miss the timer
+    std::lock_guard<std::mutex> lock(d->mTimerReceiversMutex);
+    const int timerId = this->registerTimer(
+        intervalMSecs,
+        [receiver](int timerId)
+        {
+            TimerEvent event(timerId);
+            receiver->event(&event);
+        });
+    if (timerId > 0)
+    {
+        d->mTimerReceivers.emplace(timerId, receiver);
+    }
+    return timerId;
+}
+
+int EventLoop::registerTimer(int intervalMSecs, TimerCallback callback, bool singleShot)
+{
+    OCTK_D(EventLoop);
+    if (intervalMSecs < 0 || !callback)
+    {
+        OCTK_WARNING("EventLoop::registerTimer: invalid interval {} or callback", intervalMSecs);
+        return -1;
+    }
+    return d->mDispatcher->registerTimer(intervalMSecs, singleShot, std::move(callback));
+}
+
+bool EventLoop::unregisterTimer(int timerId)
+{
+    OCTK_D(EventLoop);
+    {
+        std::lock_guard<std::mutex> lock(d->mTimerReceiversMutex);
+        d->mTimerReceivers.erase(timerId);
+    }
+    return d->mDispatcher->unregisterTimer(timerId);
+}
+
 bool EventLoop::event(Event *event)
 {
     if (event->type() == Event::Type::kQuit)
@@ -28,6 +28,8 @@
 #include <openctk/core/enum_flags.hpp>
 #include <openctk/core/core_config.hpp>
 
+#include <functional>
+
 #if OCTK_FEATURE_ENABLE_KERNEL
 
 OCTK_BEGIN_NAMESPACE
@@ -48,15 +50,66 @@ public:
     };
     OCTK_DECLARE_ENUM_FLAGS(ProcessFlags, ProcessFlag)
 
+    enum class FdEvent
+    {
+        kRead = 0x01,
+        kWrite = 0x02,
+        kError = 0x04
+    };
+    OCTK_DECLARE_ENUM_FLAGS(FdEvents, FdEvent)
+
+    using FdCallback = std::function<void(int fd, FdEvents events)>;
+    using TimerCallback = std::function<void(int timerId)>;
+
     explicit EventLoop(Object *parent = nullptr);
     ~EventLoop() override;
 
+    /**
+     * Sends all posted events and dispatches ready fds and expired timers.
+     * With ProcessFlag::kWaitForMoreEvents the calling thread sleeps until something becomes ready.
+     * @return true if any event was processed.
+     */
     bool processEvents(ProcessFlags flags = ProcessFlag::kAllEvents);
+    /**
+     * Processes pending events for at most maximumTime milliseconds, never waits for new events.
+     */
     void processEvents(ProcessFlags flags, int maximumTime);
 
     int exec(ProcessFlags flags = ProcessFlag::kAllEvents);
+    /**
+     * Interrupts a blocking processEvents() call, can be called from any thread.
+     */
     void wakeUp();
 
+    /**
+     * Queues the event for receiver and wakes the loop up, can be called from any thread.
+     * The loop takes ownership of the event and deletes it after receiver->event() returned.
+     */
+    void postEvent(Object *receiver, Event *event);
+    /**
+     * Drops the posted events of receiver that were not sent yet, all of them if receiver is nullptr.
+     */
+    void removePostedEvents(Object *receiver);
+
+    /**
+     * Invokes callback on the loop thread whenever fd becomes ready for one of events.
+     * An fd can only be registered once, the registration is level triggered. Not supported on all platforms.
+     */
+    bool registerFdNotifier(int fd, FdEvents events, FdCallback callback);
+    bool unregisterFdNotifier(int fd);
+
+    /**
+     * Sends a TimerEvent to receiver every intervalMSecs milliseconds.
+     * @return timer id, or -1 on failure.
+     */
+    int registerTimer(int intervalMSecs, Object *receiver);
+    /**
+     * Invokes callback every intervalMSecs milliseconds, or once if singleShot is set.
+     * @return timer id, or -1 on failure.
+     */
+    int registerTimer(int intervalMSecs, TimerCallback callback, bool singleShot = false);
+    bool unregisterTimer(int timerId);
+
     void exit(int retCode = 0);
     void quit();
 
@@ -68,6 +121,8 @@ private:
     OCTK_DECLARE_PRIVATE(EventLoop)
     OCTK_DISABLE_COPY_MOVE(EventLoop)
 };
+OCTK_DECLARE_ENUM_FLAGS_OPERATORS(EventLoop::ProcessFlags)
+OCTK_DECLARE_ENUM_FLAGS_OPERATORS(EventLoop::FdEvents)
 
 OCTK_END_NAMESPACE
 
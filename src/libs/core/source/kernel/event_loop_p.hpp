@@ -26,8 +26,14 @@
 
 #include <openctk/core/event_loop.hpp>
 #include <openctk/core/detail/object_p.hpp>
+#include <openctk/core/detail/event_dispatcher_p.hpp>
 #include <openctk/core/reference_counter.hpp>
 
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #if OCTK_FEATURE_ENABLE_KERNEL
 
 OCTK_BEGIN_NAMESPACE
@@ -46,10 +52,57 @@ public:
     {
         if (!mRefCounter.deref() && mInExec)
         {
-            // qApp->postEvent(mPPtr, new Event(Event::Type::kQuit));
+            OCTK_P(EventLoop);
+            p->postEvent(p, new Event(Event::Type::kQuit));
         }
     }
 
+    struct PostedEvent
+    {
+        PostedEvent(Object *r, std::unique_ptr<Event> e)
+            : receiver(r)
+            , event(std::move(e))
+        {
+        }
+        PostedEvent(PostedEvent &&other) noexcept
+            : receiver(other.receiver.load(std::memory_order_relaxed))
+            , event(std::move(other.event))
+        {
+        }
+        PostedEvent &operator=(PostedEvent &&other) noexcept
+        {
+            receiver.store(other.receiver.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            event = std::move(other.event);
+            return *this;
+        }
+
+        // reset to nullptr when the event is removed while its batch is being sent
+        std::atomic<Object *> receiver;
+        std::unique_ptr<Event> event;
+    };
+    using PostedEvents = std::deque<PostedEvent>;
+
+    /**
+     * Sends the events posted so far, events posted meanwhile are left for the next call. A handler that destroys an
+     * object or calls removePostedEvents() also drops the events of the current batch that were not sent yet.
+     * @return true if any event was sent.
+     */
+    bool sendPostedEvents();
+
+    /**
+     * Drops the posted events and timers of receiver in every event loop, called when the receiver is destroyed.
+     */
+    static void removeReceiver(Object *receiver);
+
+    EventDispatcher::UniquePtr mDispatcher;
+    std::mutex mPostedEventsMutex;
+    PostedEvents mPostedEvents;
+    // batches taken out of mPostedEvents by the sendPostedEvents() calls in progress, more than one when nested
+    std::vector<PostedEvents *> mSendingEvents;
+    std::mutex mTimerReceiversMutex;
+    // timer id to the receiver of its TimerEvents
+    std::unordered_map<int, Object *> mTimerReceivers;
+
     bool mInExec{false};
     std::atomic<bool> mExit{true};
     std::atomic<int> mRetCode{-1};
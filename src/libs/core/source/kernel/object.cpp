@@ -23,6 +23,7 @@
 ***********************************************************************************************************************/
 
 #include <openctk/core/detail/object_p.hpp>
+#include <openctk/core/detail/event_loop_p.hpp>
 
 #if OCTK_FEATURE_ENABLE_KERNEL
 
@@ -49,6 +50,11 @@ Object::Object(ObjectPrivate *d)
 
 Object::~Object()
 {
+    OCTK_D(Object);
+    if (d->mEventLoopReceiver.load(std::memory_order_acquire))
+    {
+        EventLoopPrivate::removeReceiver(this);
+    }
 }
 
 Object *Object::parent() const
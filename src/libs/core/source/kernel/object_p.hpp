@@ -26,6 +26,7 @@
 
 #include <openctk/core/object.hpp>
 
+#include <atomic>
 #include <list>
 
 #if OCTK_FEATURE_ENABLE_KERNEL
@@ -40,8 +41,12 @@ public:
     explicit ObjectPrivate(Object *p);
     virtual ~ObjectPrivate();
 
+    static ObjectPrivate *get(Object *object) { return object->dFunc(); }
+
     Object *mParent{nullptr};
     Children mChildren;
+    // Set once an event loop queued events or registered timers for the object, they are purged on destruction.
+    std::atomic<bool> mEventLoopReceiver{false};
 
 protected:
     OCTK_DEFINE_PPTR(Object)
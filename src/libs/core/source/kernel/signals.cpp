@@ -24,6 +24,151 @@
 
 #include "signals.hpp"
 
+#include <unordered_map>
+
 OCTK_BEGIN_NAMESPACE
 
+namespace signals
+{
+namespace detail
+{
+namespace
+{
+struct DispatcherRegistry
+{
+    std::mutex mutex;
+    std::unordered_map<TaskQueueBase *, std::weak_ptr<QueuedDispatcher>> dispatchers;
+};
+
+DispatcherRegistry &dispatcherRegistry()
+{
+    // intentionally leaked, dispatchers may be released by static objects at exit
+    static auto *registry = new DispatcherRegistry;
+    return *registry;
+}
+} // namespace
+
+/*
+ * Owned by the posted batch task: drains the dispatcher when run, and resets it when the task is destroyed without
+ * running, e.g. because the queue was shut down, so that later emissions post a new batch.
+ */
+class QueuedBatch final
+{
+public:
+    explicit QueuedBatch(QueuedDispatcher::SharedPtr dispatcher)
+        : mDispatcher(std::move(dispatcher))
+    {
+    }
+    QueuedBatch(QueuedBatch &&other) noexcept
+        : mDispatcher(std::move(other.mDispatcher))
+    {
+    }
+    ~QueuedBatch()
+    {
+        if (mDispatcher)
+        {
+            mDispatcher->abandon();
+        }
+    }
+
+    void run()
+    {
+        auto dispatcher = std::move(mDispatcher);
+        dispatcher->drain();
+    }
+
+private:
+    QueuedDispatcher::SharedPtr mDispatcher;
+};
+
+QueuedDispatcher::QueuedDispatcher(TaskQueueBase *queue)
+    : mQueue(queue)
+    , mPosted(false)
+{
+}
+
+QueuedDispatcher::~QueuedDispatcher()
+{
+    auto &registry = dispatcherRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto iter = registry.dispatchers.find(mQueue);
+    if (iter != registry.dispatchers.end() && iter->second.expired())
+    {
+        registry.dispatchers.erase(iter);
+    }
+}
+
+QueuedDispatcher::SharedPtr QueuedDispatcher::forQueue(Nonnull<TaskQueueBase *> queue)
+{
+    auto &registry = dispatcherRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto &weak = registry.dispatchers[queue];
+    auto dispatcher = weak.lock();
+    if (!dispatcher)
+    {
+        dispatcher = std::make_shared<QueuedDispatcher>(queue);
+        weak = dispatcher;
+    }
+    return dispatcher;
+}
+
+void QueuedDispatcher::schedule(const std::weak_ptr<QueuedSlotState> &slot)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending.push_back(slot);
+        if (mPosted)
+        {
+            return;
+        }
+        mPosted = true;
+    }
+    mQueue->postTask([batch = QueuedBatch(this->shared_from_this())]() mutable { batch.run(); });
+}
+
+void QueuedDispatcher::drain()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRunning.swap(mPending);
+    }
+    for (const auto &weak : mRunning)
+    {
+        if (auto slot = weak.lock())
+        {
+            slot->deliver();
+        }
+    }
+    mRunning.clear();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mPending.empty())
+        {
+            mPosted = false;
+            return;
+        }
+    }
+    // slots scheduled while delivering go into a new batch, keeping every batch bounded
+    mQueue->postTask([batch = QueuedBatch(this->shared_from_this())]() mutable { batch.run(); });
+}
+
+void QueuedDispatcher::abandon()
+{
+    std::vector<std::weak_ptr<QueuedSlotState>> pending;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        pending.swap(mPending);
+        mPosted = false;
+    }
+    for (const auto &weak : pending)
+    {
+        if (auto slot = weak.lock())
+        {
+            slot->discard();
+        }
+    }
+}
+} // namespace detail
+} // namespace signals
+
 OCTK_END_NAMESPACE
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <openctk/core/task_queue.hpp>
 #include <openctk/core/checks.hpp>
 #include <openctk/core/memory.hpp>
 #include <openctk/core/type_list.hpp>
@@ -31,6 +32,7 @@
 
 #include <mutex>
 #include <memory>
+#include <tuple>
 #include <thread>
 #include <atomic>
 #include <vector>
@@ -62,6 +64,16 @@ class SignalBase;
  */
 using GroupId = std::int32_t;
 
+/**
+ * Delivery policy of a slot connected through SignalBase::connect_queued().
+ * Slots connected with the other connect overloads are always called directly on the emitting thread.
+ */
+enum class ConnectionType
+{
+    kQueued,        // arguments are copied and the slot is called later on the target task queue
+    kBlockingQueued // the slot is called on the target task queue and the emitter waits for it to return
+};
+
 namespace detail
 {
 // Used to detect an object of observer type
@@ -1244,6 +1256,198 @@ private:
     std::decay_t<WeakPtr> ptr;
 };
 
+/*
+ * Type independent part of a queued slot, the only interface the dispatcher needs.
+ */
+class QueuedSlotState
+{
+public:
+    virtual ~QueuedSlotState() = default;
+
+    // run every call pending for this slot, always invoked on the target queue
+    virtual void deliver() = 0;
+
+    // drop every pending call, used when the batch task got destroyed without running
+    virtual void discard() = 0;
+};
+
+/*
+ * There is one dispatcher per target task queue, shared by all the queued slots of all the signals delivering to
+ * it. A slot registers itself once when its pending list goes from empty to non empty, and the dispatcher posts a
+ * single task draining every registered slot, so a burst of emissions towards the same queue costs one post.
+ */
+class OCTK_CORE_API QueuedDispatcher final : public std::enable_shared_from_this<QueuedDispatcher>
+{
+public:
+    using SharedPtr = std::shared_ptr<QueuedDispatcher>;
+
+    explicit QueuedDispatcher(TaskQueueBase *queue);
+    ~QueuedDispatcher();
+
+    static SharedPtr forQueue(Nonnull<TaskQueueBase *> queue);
+
+    TaskQueueBase *queue() const { return mQueue; }
+
+    void schedule(const std::weak_ptr<QueuedSlotState> &slot);
+
+private:
+    friend class QueuedBatch;
+
+    void drain();
+    void abandon();
+
+    TaskQueueBase *const mQueue;
+    std::mutex mMutex;
+    std::vector<std::weak_ptr<QueuedSlotState>> mPending;
+    std::vector<std::weak_ptr<QueuedSlotState>> mRunning;
+    bool mPosted;
+};
+
+/*
+ * A slot that copies the emitted arguments and calls its callable later on the target queue. Pending calls are
+ * kept in a per slot vector whose capacity is recycled between batches, so argument packs of value types with no
+ * heap storage of their own do not allocate once the slot has warmed up. Calls of a same slot are delivered in
+ * emission order; calls are dropped once the slot is disconnected or the optional safety flag is no longer alive.
+ */
+template <typename Func, typename... Args>
+class slot_queued final : public SlotBase<Args...>, public QueuedSlotState
+{
+    using SafetyFlag = TaskQueueBase::SafetyFlag;
+    using call_type = std::tuple<std::decay_t<Args>...>;
+
+public:
+    template <typename F>
+    slot_queued(Cleanable &c, F &&f, QueuedDispatcher::SharedPtr dispatcher, SafetyFlag::SharedPtr flag, GroupId gid)
+        : SlotBase<Args...>(c, gid)
+        , func{std::forward<F>(f)}
+        , mDispatcher(std::move(dispatcher))
+        , mFlag(std::move(flag))
+    {
+    }
+
+    std::weak_ptr<QueuedSlotState> self;
+
+    void deliver() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDelivering.swap(mPending);
+            mScheduled = false;
+        }
+        for (auto &call : mDelivering)
+        {
+            if (!SlotState::connected() || !alive())
+            {
+                break;
+            }
+            invoke(call, std::index_sequence_for<Args...>{});
+        }
+        mDelivering.clear();
+    }
+
+    void discard() override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending.clear();
+        mScheduled = false;
+    }
+
+protected:
+    void callSlot(Args... args) override
+    {
+        if (!alive())
+        {
+            SlotState::disconnect();
+            return;
+        }
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPending.emplace_back(std::forward<Args>(args)...);
+            schedule = !mScheduled;
+            mScheduled = true;
+        }
+        if (schedule)
+        {
+            mDispatcher->schedule(self);
+        }
+    }
+
+    func_ptr get_callable() const noexcept override { return get_function_ptr(func); }
+
+#    if OCTK_RTTI_ENABLED
+    const std::type_info &get_callable_type() const noexcept override { return typeid(func); }
+#    endif
+
+private:
+    bool alive() const { return !mFlag || mFlag->isAlive(); }
+
+    template <std::size_t... I>
+    void invoke(call_type &call, std::index_sequence<I...>)
+    {
+        func(std::forward<Args>(std::get<I>(call))...);
+    }
+
+    std::decay_t<Func> func;
+    const QueuedDispatcher::SharedPtr mDispatcher;
+    const SafetyFlag::SharedPtr mFlag;
+    std::mutex mMutex;
+    std::vector<call_type> mPending;
+    std::vector<call_type> mDelivering; // only touched on the target queue
+    bool mScheduled{false};
+};
+
+/*
+ * A slot that calls its callable on the target queue and blocks the emitter until it returns. Arguments are
+ * passed by reference since they outlive the call, the slot is called inline when emitting from the target queue.
+ */
+template <typename Func, typename... Args>
+class slot_blocking_queued final : public SlotBase<Args...>
+{
+    using SafetyFlag = TaskQueueBase::SafetyFlag;
+
+public:
+    template <typename F>
+    slot_blocking_queued(Cleanable &c, F &&f, TaskQueueBase *queue, SafetyFlag::SharedPtr flag, GroupId gid)
+        : SlotBase<Args...>(c, gid)
+        , func{std::forward<F>(f)}
+        , mQueue(queue)
+        , mFlag(std::move(flag))
+    {
+    }
+
+protected:
+    void callSlot(Args... args) override
+    {
+        if (!alive())
+        {
+            SlotState::disconnect();
+            return;
+        }
+        mQueue->sendTask(
+            [&]()
+            {
+                if (SlotState::connected() && alive())
+                {
+                    func(args...);
+                }
+            });
+    }
+
+    func_ptr get_callable() const noexcept override { return get_function_ptr(func); }
+
+#    if OCTK_RTTI_ENABLED
+    const std::type_info &get_callable_type() const noexcept override { return typeid(func); }
+#    endif
+
+private:
+    bool alive() const { return !mFlag || mFlag->isAlive(); }
+
+    std::decay_t<Func> func;
+    TaskQueueBase *const mQueue;
+    const SafetyFlag::SharedPtr mFlag;
+};
+
 } // namespace detail
 
 
@@ -1592,6 +1796,70 @@ public:
         return conn;
     }
 
+    /**
+     * Connect a callable that is invoked on a target task queue instead of the emitting thread.
+     *
+     * Effect: With ConnectionType::kQueued the arguments are copied and the emitter returns immediately, the
+     *         slot runs later on the target queue. Emissions towards the same queue are coalesced: whatever the
+     *         number of queued slots and emissions, at most one batch task is pending on a queue at a time.
+     *         With ConnectionType::kBlockingQueued the emitter waits until the slot returned on the target queue,
+     *         or calls it inline when already running on it.
+     * Safety: Thread-safety depends on locking policy. Slots must not be blocking-queued to a queue that may
+     *         itself be waiting on the emitting thread.
+     *
+     * @param queue the task queue the slot is called on, must outlive the connection
+     * @param c a callable
+     * @param type the delivery policy
+     * @param gid an identifier that can be used to order slot execution
+     * @return a connection object that can be used to interact with the slot
+     */
+    template <typename Callable>
+    std::enable_if_t<trait::is_callable_v<arg_list, Callable>, Connection> connect_queued(
+        Nonnull<TaskQueueBase *> queue,
+        Callable &&c,
+        ConnectionType type = ConnectionType::kQueued,
+        GroupId gid = 0)
+    {
+        return connect_queued(queue, nullptr, std::forward<Callable>(c), type, gid);
+    }
+
+    /**
+     * Overload of connect_queued guarded by a safety flag.
+     *
+     * Pending calls are dropped once the flag is no longer alive, typically because the receiver owning a
+     * SafetyFlag::Scoped was destroyed, and the next emission disconnects the slot.
+     *
+     * @param queue the task queue the slot is called on, must outlive the connection
+     * @param flag the receiver safety flag, may be null
+     * @param c a callable
+     * @param type the delivery policy
+     * @param gid an identifier that can be used to order slot execution
+     * @return a connection object that can be used to interact with the slot
+     */
+    template <typename Callable>
+    std::enable_if_t<trait::is_callable_v<arg_list, Callable>, Connection> connect_queued(
+        Nonnull<TaskQueueBase *> queue,
+        const TaskQueueBase::SafetyFlag::SharedPtr &flag,
+        Callable &&c,
+        ConnectionType type = ConnectionType::kQueued,
+        GroupId gid = 0)
+    {
+        if (ConnectionType::kBlockingQueued == type)
+        {
+            using slot_t = detail::slot_blocking_queued<Callable, T...>;
+            auto s = make_slot<slot_t>(std::forward<Callable>(c), queue, flag, gid);
+            Connection conn(s);
+            add_slot(std::move(s));
+            return conn;
+        }
+        using slot_t = detail::slot_queued<Callable, T...>;
+        auto s = make_slot<slot_t>(std::forward<Callable>(c), detail::QueuedDispatcher::forQueue(queue), flag, gid);
+        Connection conn(s);
+        std::static_pointer_cast<slot_t>(s)->self = std::static_pointer_cast<slot_t>(s);
+        add_slot(std::move(s));
+        return conn;
+    }
+
     /**
      * Creates a connection whose duration is tied to the return object.
      * Uses the same semantics as connect
@@ -26,9 +26,11 @@
 #include <openctk/core/assert.hpp>
 #include <openctk/core/limits.hpp>
 #include <openctk/core/string.hpp>
+#include <openctk/core/from_chars.hpp>
 
 #include <locale.h>
 #include <errno.h>
+#include <math.h>
 #include <stdlib.h>
 #include <ctype.h> /* For tolower() */
 
@@ -278,7 +280,8 @@ int ascii_xdigit_value(char c)
     return ascii_digit_value(c);
 }
 
-double_t ascii_strtod(const char *nptr, char **endptr)
+/* strtod() with the '.' translated to the decimal point of the current locale in a copy of the number. */
+static double_t _ascii_strtod_locale(const char *nptr, char **endptr)
 {
     char *fail_pos = NULL;
     double val;
@@ -458,6 +461,46 @@ double_t ascii_strtod(const char *nptr, char **endptr)
     return val;
 }
 
+double_t ascii_strtod(const char *nptr, char **endptr)
+{
+    /* Decimal numbers, infinities and NANs are parsed in place by fromChars(), which gives the same correctly rounded
+     * results as the C locale's strtod() without copying or consulting the locale. Hexadecimal floats and everything
+     * that sets errno, i.e. invalid input, overflow and underflow including subnormal results, keep the strtod() path
+     * so that errno and endptr are exactly what strtod() reports. */
+    const char *p = nptr;
+    while (ascii_isspace(*p))
+    {
+        p++;
+    }
+    if (*p == '+' && p[1] != '-')
+    {
+        p++;
+    }
+    const char *digits = *p == '-' ? p + 1 : p;
+    if (!(digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')))
+    {
+        /* Bound the number without strlen(), nptr may point into a long buffer. */
+        const char *last = p;
+        while (ascii_isalnum(*last) || *last == '.' || *last == '+' || *last == '-' || *last == '_' || *last == '(' ||
+               *last == ')')
+        {
+            last++;
+        }
+        double value = 0;
+        const utils::FromCharsResult result = utils::fromChars(p, last, value);
+        if (result.ec == std::errc() && fpclassify(value) != FP_SUBNORMAL)
+        {
+            if (endptr)
+            {
+                *endptr = const_cast<char *>(result.ptr);
+            }
+            errno = 0;
+            return value;
+        }
+    }
+    return _ascii_strtod_locale(nptr, endptr);
+}
+
 uint64_t ascii_strtoull(const char *nptr, char **endptr, uint_t base)
 {
     bool negative;
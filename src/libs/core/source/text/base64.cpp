@@ -24,8 +24,26 @@
 ***********************************************************************************************************************/
 
 #include "base64.hpp"
+#include <openctk/core/processor.hpp>
 #include <openctk/core/checks.hpp>
 
+#include <cstring>
+
+#if (defined(OCTK_PROCESSOR_X86_64) || defined(OCTK_PROCESSOR_X86_32)) &&                                            \
+    (defined(OCTK_CC_GNU) || defined(OCTK_CC_MSVC))
+#    define OCTK_BASE64_X86 1
+#    include <immintrin.h>
+#    if defined(OCTK_CC_MSVC) && !defined(OCTK_CC_CLANG)
+#        include <intrin.h>
+#        define OCTK_BASE64_TARGET(features)
+#    else
+#        define OCTK_BASE64_TARGET(features) __attribute__((target(features)))
+#    endif
+#elif defined(OCTK_PROCESSOR_ARM_64) && defined(__ARM_NEON)
+#    define OCTK_BASE64_NEON 1
+#    include <arm_neon.h>
+#endif
+
 OCTK_BEGIN_NAMESPACE
 
 static const char kPad = '=';
@@ -33,6 +51,274 @@ static const unsigned char pd = 0xFD;  // Padding
 static const unsigned char sp = 0xFE;  // Whitespace
 static const unsigned char il = 0xFF;  // Illegal base64 character
 
+namespace
+{
+// A kernel consumes whole 3 byte groups resp. quanta of 4 plain base64 characters from the front of its input and
+// returns how much it consumed, the scalar loops finish the rest. Decode kernels stop at the first block holding
+// anything else, i.e. whitespace, padding or illegal characters, and may store up to 8 bytes past the decoded data
+// of a block, which the callers size their output for.
+using EncodeKernel = size_t (*)(const unsigned char *data, size_t len, char *result);
+using DecodeKernel = size_t (*)(const char *data, size_t len, uint8_t *result);
+
+size_t encodeNone(const unsigned char *, size_t, char *) { return 0; }
+size_t decodeNone(const char *, size_t, uint8_t *) { return 0; }
+
+#if OCTK_BASE64_X86
+// Encoding after Wojciech Mula's pshufb/multiply-shift method: spread 3 bytes over the 4 bytes of each 32 bit lane,
+// move the 6 bit fields in place with two multiplies and turn the indices into characters with an offset table.
+OCTK_BASE64_TARGET("ssse3") size_t encodeSsse3(const unsigned char *data, size_t len, char *result)
+{
+    const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 16 <= len; i += 12, o += 16)
+    {
+        __m128i in = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), spread);
+        const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(t0, t1);
+        __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        reduced = _mm_or_si128(reduced, _mm_and_si128(upper, _mm_set1_epi8(13)));
+        const __m128i chars = _mm_add_epi8(_mm_shuffle_epi8(offsets, reduced), indices);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(result + o), chars);
+    }
+    return i;
+}
+
+OCTK_BASE64_TARGET("avx2") size_t encodeAvx2(const unsigned char *data, size_t len, char *result)
+{
+    const __m256i spread = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                           10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                             'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 28 <= len; i += 24, o += 32)
+    {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 12));
+        __m256i in = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), spread);
+        const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                                              _mm256_set1_epi32(0x04000040));
+        const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                                              _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t0, t1);
+        __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        reduced = _mm256_or_si256(reduced, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+        const __m256i chars = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, reduced), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(result + o), chars);
+    }
+    return i;
+}
+
+// Decoding classifies every character by range, which also rejects bytes >= 0x80 as they compare negative, adds the
+// offset of its range and packs the 6 bit values with two multiply-adds.
+#    define OCTK_BASE64_DECODE_BLOCK(bits, prefix)                                                                     \
+        const __m##bits##i upper = _mm##prefix##_and_si##bits(                                                         \
+            _mm##prefix##_cmpgt_epi8(in, _mm##prefix##_set1_epi8('A' - 1)),                                            \
+            _mm##prefix##_cmpgt_epi8(_mm##prefix##_set1_epi8('Z' + 1), in));                                          \
+        const __m##bits##i lower = _mm##prefix##_and_si##bits(                                                         \
+            _mm##prefix##_cmpgt_epi8(in, _mm##prefix##_set1_epi8('a' - 1)),                                            \
+            _mm##prefix##_cmpgt_epi8(_mm##prefix##_set1_epi8('z' + 1), in));                                           \
+        const __m##bits##i digit = _mm##prefix##_and_si##bits(                                                         \
+            _mm##prefix##_cmpgt_epi8(in, _mm##prefix##_set1_epi8('0' - 1)),                                            \
+            _mm##prefix##_cmpgt_epi8(_mm##prefix##_set1_epi8('9' + 1), in));                                           \
+        const __m##bits##i plus = _mm##prefix##_cmpeq_epi8(in, _mm##prefix##_set1_epi8('+'));                         \
+        const __m##bits##i slash = _mm##prefix##_cmpeq_epi8(in, _mm##prefix##_set1_epi8('/'));                        \
+        const __m##bits##i valid = _mm##prefix##_or_si##bits(                                                          \
+            _mm##prefix##_or_si##bits(_mm##prefix##_or_si##bits(upper, lower), digit),                                 \
+            _mm##prefix##_or_si##bits(plus, slash));                                                                   \
+        const __m##bits##i shift = _mm##prefix##_or_si##bits(                                                          \
+            _mm##prefix##_or_si##bits(                                                                                 \
+                _mm##prefix##_and_si##bits(upper, _mm##prefix##_set1_epi8(-65)),                                       \
+                _mm##prefix##_and_si##bits(lower, _mm##prefix##_set1_epi8(-71))),                                      \
+            _mm##prefix##_or_si##bits(                                                                                 \
+                _mm##prefix##_and_si##bits(digit, _mm##prefix##_set1_epi8(4)),                                         \
+                _mm##prefix##_or_si##bits(_mm##prefix##_and_si##bits(plus, _mm##prefix##_set1_epi8(19)),              \
+                                          _mm##prefix##_and_si##bits(slash, _mm##prefix##_set1_epi8(16)))));           \
+        const __m##bits##i values = _mm##prefix##_add_epi8(in, shift);                                                 \
+        const __m##bits##i pairs = _mm##prefix##_maddubs_epi16(values, _mm##prefix##_set1_epi32(0x01400140));          \
+        const __m##bits##i words = _mm##prefix##_madd_epi16(pairs, _mm##prefix##_set1_epi32(0x00011000))
+
+OCTK_BASE64_TARGET("ssse3") size_t decodeSsse3(const char *data, size_t len, uint8_t *result)
+{
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 24 <= len; i += 16, o += 12)
+    {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        OCTK_BASE64_DECODE_BLOCK(128, );
+        if (0xffff != _mm_movemask_epi8(valid))
+        {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(result + o), _mm_shuffle_epi8(words, pack));
+    }
+    return i;
+}
+
+OCTK_BASE64_TARGET("avx2") size_t decodeAvx2(const char *data, size_t len, uint8_t *result)
+{
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 44 <= len; i += 32, o += 24)
+    {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        OCTK_BASE64_DECODE_BLOCK(256, 256);
+        if (-1 != _mm256_movemask_epi8(valid))
+        {
+            break;
+        }
+        const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(words, pack), lanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(result + o), packed);
+    }
+    return i;
+}
+#    undef OCTK_BASE64_DECODE_BLOCK
+
+struct CpuFeatures
+{
+    bool ssse3{false};
+    bool avx2{false};
+};
+
+CpuFeatures detectCpuFeatures()
+{
+    CpuFeatures features;
+#    if defined(OCTK_CC_MSVC) && !defined(OCTK_CC_CLANG)
+    int info[4] = {0};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    features.ssse3 = 0 != (info[2] & (1 << 9));
+    const bool osSavesYmm = (0 != (info[2] & (1 << 27))) && (6 == (_xgetbv(0) & 6));
+    if (maxLeaf >= 7 && osSavesYmm)
+    {
+        __cpuidex(info, 7, 0);
+        features.avx2 = 0 != (info[1] & (1 << 5));
+    }
+#    else
+    __builtin_cpu_init();
+    features.ssse3 = __builtin_cpu_supports("ssse3");
+    features.avx2 = __builtin_cpu_supports("avx2");
+#    endif
+    return features;
+}
+#elif OCTK_BASE64_NEON
+// Encoding spreads 48 bytes over four index registers and looks all 64 characters up at once, decoding classifies
+// by range like the x86 kernels. The interleaving loads and stores keep both exact, there is no over-store.
+size_t encodeNeon(const unsigned char *data, size_t len, char *result)
+{
+    static const unsigned char kTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint8x16x4_t table;
+    table.val[0] = vld1q_u8(kTable);
+    table.val[1] = vld1q_u8(kTable + 16);
+    table.val[2] = vld1q_u8(kTable + 32);
+    table.val[3] = vld1q_u8(kTable + 48);
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 48 <= len; i += 48, o += 64)
+    {
+        const uint8x16x3_t in = vld3q_u8(data + i);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+        out.val[0] = vqtbl4q_u8(table, out.val[0]);
+        out.val[1] = vqtbl4q_u8(table, out.val[1]);
+        out.val[2] = vqtbl4q_u8(table, out.val[2]);
+        out.val[3] = vqtbl4q_u8(table, out.val[3]);
+        vst4q_u8(reinterpret_cast<uint8_t *>(result + o), out);
+    }
+    return i;
+}
+
+inline uint8x16_t decodeNeonLane(uint8x16_t in, uint8x16_t *invalid)
+{
+    const uint8x16_t upper = vandq_u8(vcgeq_u8(in, vdupq_n_u8('A')), vcleq_u8(in, vdupq_n_u8('Z')));
+    const uint8x16_t lower = vandq_u8(vcgeq_u8(in, vdupq_n_u8('a')), vcleq_u8(in, vdupq_n_u8('z')));
+    const uint8x16_t digit = vandq_u8(vcgeq_u8(in, vdupq_n_u8('0')), vcleq_u8(in, vdupq_n_u8('9')));
+    const uint8x16_t plus = vceqq_u8(in, vdupq_n_u8('+'));
+    const uint8x16_t slash = vceqq_u8(in, vdupq_n_u8('/'));
+    const uint8x16_t valid = vorrq_u8(vorrq_u8(vorrq_u8(upper, lower), digit), vorrq_u8(plus, slash));
+    *invalid = vorrq_u8(*invalid, vmvnq_u8(valid));
+    const uint8x16_t shift = vorrq_u8(vorrq_u8(vandq_u8(upper, vdupq_n_u8(static_cast<uint8_t>(-65))),
+                                               vandq_u8(lower, vdupq_n_u8(static_cast<uint8_t>(-71)))),
+                                      vorrq_u8(vandq_u8(digit, vdupq_n_u8(4)),
+                                               vorrq_u8(vandq_u8(plus, vdupq_n_u8(19)),
+                                                        vandq_u8(slash, vdupq_n_u8(16)))));
+    return vaddq_u8(in, shift);
+}
+
+size_t decodeNeon(const char *data, size_t len, uint8_t *result)
+{
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 64 <= len; i += 64, o += 48)
+    {
+        const uint8x16x4_t in = vld4q_u8(reinterpret_cast<const uint8_t *>(data + i));
+        uint8x16_t invalid = vdupq_n_u8(0);
+        const uint8x16_t a = decodeNeonLane(in.val[0], &invalid);
+        const uint8x16_t b = decodeNeonLane(in.val[1], &invalid);
+        const uint8x16_t c = decodeNeonLane(in.val[2], &invalid);
+        const uint8x16_t d = decodeNeonLane(in.val[3], &invalid);
+        if (0 != vmaxvq_u8(invalid))
+        {
+            break;
+        }
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+        vst3q_u8(result + o, out);
+    }
+    return i;
+}
+#endif
+
+struct Kernels
+{
+    EncodeKernel encode;
+    DecodeKernel decode;
+};
+
+Kernels selectKernels()
+{
+#if OCTK_BASE64_X86
+    const CpuFeatures features = detectCpuFeatures();
+    if (features.avx2)
+    {
+        return {encodeAvx2, decodeAvx2};
+    }
+    if (features.ssse3)
+    {
+        return {encodeSsse3, decodeSsse3};
+    }
+#elif OCTK_BASE64_NEON
+    return {encodeNeon, decodeNeon};
+#endif
+    return {encodeNone, decodeNone};
+}
+
+const Kernels &kernels()
+{
+    static const Kernels selected = selectKernels();
+    return selected;
+}
+} // namespace
+
 const char Base64::Base64Table[] =
     // 0000000000111111111122222222223333333333444444444455555555556666
     // 0123456789012345678901234567890123456789012345678901234567890123
@@ -106,55 +392,79 @@ bool Base64::IsBase64Encoded(StringView str)
     return true;
 }
 
-void Base64::EncodeFromArray(const void *data,
-                             size_t len,
-                             std::string *result)
+size_t Base64::EncodeGroups(const unsigned char *data, size_t len, char *result)
 {
-    OCTK_DCHECK(result);
-    result->clear();
-    result->resize(((len + 2) / 3) * 4);
-    const unsigned char *byte_data = static_cast<const unsigned char *>(data);
-
-    unsigned char c;
-    size_t i = 0;
-    size_t dest_ix = 0;
-    while (i < len)
+    size_t i = kernels().encode(data, len, result);
+    size_t o = (i / 3) * 4;
+    for (; i + 3 <= len; i += 3)
     {
-        c = (byte_data[i] >> 2) & 0x3f;
-        (*result)[dest_ix++] = Base64Table[c];
-
-        c = (byte_data[i] << 4) & 0x3f;
-        if (++i < len)
-        {
-            c |= (byte_data[i] >> 4) & 0x0f;
-        }
-        (*result)[dest_ix++] = Base64Table[c];
+        const uint32_t group = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+        result[o++] = Base64Table[group >> 18];
+        result[o++] = Base64Table[(group >> 12) & 0x3f];
+        result[o++] = Base64Table[(group >> 6) & 0x3f];
+        result[o++] = Base64Table[group & 0x3f];
+    }
+    return i;
+}
 
-        if (i < len)
+size_t Base64::EncodeToArray(const void *data, size_t len, char *result)
+{
+    OCTK_DCHECK(result || 0 == len);
+    const unsigned char *byte_data = static_cast<const unsigned char *>(data);
+    const size_t i = EncodeGroups(byte_data, len, result);
+    size_t dest_ix = (i / 3) * 4;
+    if (i < len)
+    {
+        result[dest_ix++] = Base64Table[(byte_data[i] >> 2) & 0x3f];
+        unsigned char c = (byte_data[i] << 4) & 0x3f;
+        if (i + 1 < len)
         {
-            c = (byte_data[i] << 2) & 0x3f;
-            if (++i < len)
-            {
-                c |= (byte_data[i] >> 6) & 0x03;
-            }
-            (*result)[dest_ix++] = Base64Table[c];
+            c |= (byte_data[i + 1] >> 4) & 0x0f;
+            result[dest_ix++] = Base64Table[c];
+            result[dest_ix++] = Base64Table[(byte_data[i + 1] << 2) & 0x3f];
         }
         else
         {
-            (*result)[dest_ix++] = kPad;
+            result[dest_ix++] = Base64Table[c];
+            result[dest_ix++] = kPad;
         }
+        result[dest_ix++] = kPad;
+    }
+    return dest_ix;
+}
 
-        if (i < len)
-        {
-            c = byte_data[i] & 0x3f;
-            (*result)[dest_ix++] = Base64Table[c];
-            ++i;
-        }
-        else
+void Base64::EncodeFromArray(const void *data,
+                             size_t len,
+                             std::string *result)
+{
+    OCTK_DCHECK(result);
+    result->clear();
+    result->resize(GetEncodedSize(len));
+    if (len > 0)
+    {
+        EncodeToArray(data, len, &(*result)[0]);
+    }
+}
+
+size_t Base64::DecodeQuanta(const char *data, size_t len, uint8_t *result)
+{
+    size_t i = kernels().decode(data, len, result);
+    size_t o = (i / 4) * 3;
+    for (; i + 4 <= len; i += 4)
+    {
+        const unsigned char a = DecodeTable[static_cast<unsigned char>(data[i])];
+        const unsigned char b = DecodeTable[static_cast<unsigned char>(data[i + 1])];
+        const unsigned char c = DecodeTable[static_cast<unsigned char>(data[i + 2])];
+        const unsigned char d = DecodeTable[static_cast<unsigned char>(data[i + 3])];
+        if ((a | b | c | d) & 0xc0)
         {
-            (*result)[dest_ix++] = kPad;
+            break;  // whitespace, padding or illegal characters are left to GetNextQuantum()
         }
+        result[o++] = static_cast<uint8_t>((a << 2) | (b >> 4));
+        result[o++] = static_cast<uint8_t>((b << 4) | (c >> 2));
+        result[o++] = static_cast<uint8_t>((c << 6) | d);
     }
+    return i;
 }
 
 size_t Base64::GetNextQuantum(DecodeFlags parse_flags,
@@ -275,14 +585,15 @@ bool Base64::DecodeFromArray(const char *data,
                                                           data_used);
 }
 
-template <typename T>
-bool Base64::DecodeFromArrayTemplate(const char *data,
-                                     size_t len,
-                                     DecodeFlags flags,
-                                     T *result,
-                                     size_t *data_used)
+bool Base64::DecodeToArray(const char *data,
+                           size_t len,
+                           DecodeFlags flags,
+                           uint8_t *result,
+                           size_t *result_len,
+                           size_t *data_used)
 {
-    OCTK_DCHECK(result);
+    OCTK_DCHECK(result || 0 == len);
+    OCTK_DCHECK(result_len);
     OCTK_DCHECK_LE(flags, (DO_PARSE_MASK | DO_PAD_MASK | DO_TERM_MASK));
 
     const DecodeFlags parse_flags = flags & DO_PARSE_MASK;
@@ -292,28 +603,35 @@ bool Base64::DecodeFromArrayTemplate(const char *data,
     OCTK_DCHECK_NE(0, pad_flags);
     OCTK_DCHECK_NE(0, term_flags);
 
-    result->clear();
-    result->reserve(len);
-
     size_t dpos = 0;
+    size_t rpos = 0;
     bool success = true, padded;
     unsigned char c, qbuf[4];
     while (dpos < len)
     {
+        // Runs of plain quanta, e.g. the lines of wrapped input, take the bulk path.
+        const size_t bulk = DecodeQuanta(data + dpos, len - dpos, result + rpos);
+        dpos += bulk;
+        rpos += (bulk / 4) * 3;
+        if (dpos == len)
+        {
+            break;
+        }
+
         size_t qlen = GetNextQuantum(parse_flags, (DO_PAD_NO == pad_flags), data,
                                      len, &dpos, qbuf, &padded);
         c = (qbuf[0] << 2) | ((qbuf[1] >> 4) & 0x3);
         if (qlen >= 2)
         {
-            result->push_back(c);
+            result[rpos++] = c;
             c = ((qbuf[1] << 4) & 0xf0) | ((qbuf[2] >> 2) & 0xf);
             if (qlen >= 3)
             {
-                result->push_back(c);
+                result[rpos++] = c;
                 c = ((qbuf[2] << 6) & 0xc0) | qbuf[3];
                 if (qlen >= 4)
                 {
-                    result->push_back(c);
+                    result[rpos++] = c;
                     c = 0;
                 }
             }
@@ -339,6 +657,243 @@ bool Base64::DecodeFromArrayTemplate(const char *data,
     {
         *data_used = dpos;
     }
+    *result_len = rpos;
+    return success;
+}
+
+template <typename T>
+bool Base64::DecodeFromArrayTemplate(const char *data,
+                                     size_t len,
+                                     DecodeFlags flags,
+                                     T *result,
+                                     size_t *data_used)
+{
+    OCTK_DCHECK(result);
+    result->clear();
+    result->resize(GetMaxDecodedSize(len));
+
+    size_t result_len = 0;
+    uint8_t *buffer = result->empty() ? nullptr : reinterpret_cast<uint8_t *>(&(*result)[0]);
+    const bool success = DecodeToArray(data, len, flags, buffer, &result_len, data_used);
+    result->resize(result_len);
+    return success;
+}
+
+size_t Base64::Encoder::Update(const void *data, size_t len, char *result)
+{
+    const unsigned char *byte_data = static_cast<const unsigned char *>(data);
+    size_t written = 0;
+    if (mPendingLength > 0)
+    {
+        while (mPendingLength < 3 && len > 0)
+        {
+            mPending[mPendingLength++] = *byte_data++;
+            --len;
+        }
+        if (mPendingLength < 3)
+        {
+            return 0;
+        }
+        written = EncodeToArray(mPending, 3, result);
+        mPendingLength = 0;
+    }
+    const size_t groups = len - len % 3;
+    written += EncodeToArray(byte_data, groups, result + written);
+    for (size_t i = groups; i < len; ++i)
+    {
+        mPending[mPendingLength++] = byte_data[i];
+    }
+    return written;
+}
+
+void Base64::Encoder::Update(const void *data, size_t len, std::string *result)
+{
+    OCTK_DCHECK(result);
+    const size_t offset = result->size();
+    result->resize(offset + GetMaxUpdateSize(len));
+    result->resize(offset + this->Update(data, len, &(*result)[offset]));
+}
+
+size_t Base64::Encoder::Finish(char *result)
+{
+    const size_t written = EncodeToArray(mPending, mPendingLength, result);
+    mPendingLength = 0;
+    return written;
+}
+
+void Base64::Encoder::Finish(std::string *result)
+{
+    OCTK_DCHECK(result);
+    char tail[4];
+    result->append(tail, this->Finish(tail));
+}
+
+Base64::Decoder::Decoder(DecodeFlags flags)
+    : mFlags(flags)
+{
+    OCTK_DCHECK_LE(flags, (DO_PARSE_MASK | DO_PAD_MASK | DO_TERM_MASK));
+    OCTK_DCHECK_NE(0, flags & DO_PARSE_MASK);
+    OCTK_DCHECK_NE(0, flags & DO_PAD_MASK);
+    OCTK_DCHECK_NE(0, flags & DO_TERM_MASK);
+}
+
+bool Base64::Decoder::Update(const char *data, size_t len, uint8_t *result, size_t *result_len)
+{
+    OCTK_DCHECK(result_len);
+    size_t written = 0;
+    size_t pos = 0;
+    while (!mFailed && pos < len)
+    {
+        if (0 == mQuantumLength && 0 == mPadLength && !mFinished)
+        {
+            const size_t bulk = DecodeQuanta(data + pos, len - pos, result + written);
+            pos += bulk;
+            written += (bulk / 4) * 3;
+            if (pos == len)
+            {
+                break;
+            }
+        }
+        this->Accept(data[pos++], result, &written);
+    }
+    *result_len = written;
+    return !mFailed;
+}
+
+bool Base64::Decoder::Update(const char *data, size_t len, std::string *result)
+{
+    OCTK_DCHECK(result);
+    const size_t offset = result->size();
+    result->resize(offset + GetMaxUpdateSize(len));
+    size_t written = 0;
+    const bool success = this->Update(data, len, reinterpret_cast<uint8_t *>(&(*result)[offset]), &written);
+    result->resize(offset + written);
+    return success;
+}
+
+bool Base64::Decoder::Finish(uint8_t *result, size_t *result_len)
+{
+    OCTK_DCHECK(result_len);
+    size_t written = 0;
+    if (!mFailed && !mFinished)
+    {
+        if (mPadLength > 0)
+        {
+            // Incomplete padding, which DecodeFromArray() leaves unparsed.
+            const DecodeFlags term_flags = mFlags & DO_TERM_MASK;
+            if ((DO_PAD_YES == (mFlags & DO_PAD_MASK)) || (DO_TERM_BUFFER == term_flags))
+            {
+                mFailed = true;
+            }
+        }
+        if (mQuantumLength > 0)
+        {
+            this->FlushQuantum(result, &written);
+            if (DO_PAD_YES == (mFlags & DO_PAD_MASK))
+            {
+                mFailed = true;  // expected padding
+            }
+        }
+    }
+    const bool success = !mFailed;
+    *result_len = written;
+    this->Reset();
+    return success;
+}
+
+bool Base64::Decoder::Finish(std::string *result)
+{
+    OCTK_DCHECK(result);
+    uint8_t tail[3];
+    size_t written = 0;
+    const bool success = this->Finish(tail, &written);
+    result->append(reinterpret_cast<const char *>(tail), written);
     return success;
 }
+
+void Base64::Decoder::Accept(char ch, uint8_t *result, size_t *result_len)
+{
+    const DecodeFlags parse_flags = mFlags & DO_PARSE_MASK;
+    const unsigned char value = DecodeTable[static_cast<unsigned char>(ch)];
+    if (mFinished)
+    {
+        // Only what DecodeFromArray() would skip may follow the padding.
+        if (!((sp == value && DO_PARSE_STRICT != parse_flags) || DO_PARSE_ANY == parse_flags))
+        {
+            mFailed = true;
+        }
+    }
+    else if ((il == value) || (pd == value && DO_PAD_NO == (mFlags & DO_PAD_MASK)))
+    {
+        mFailed = DO_PARSE_ANY != parse_flags;
+    }
+    else if (sp == value)
+    {
+        mFailed = DO_PARSE_STRICT == parse_flags;
+    }
+    else if (pd == value)
+    {
+        if (mQuantumLength < 2 || mQuantumLength + mPadLength >= 4)
+        {
+            mFailed = DO_PARSE_ANY != parse_flags;  // unexpected or extra pads
+        }
+        else if (4 == mQuantumLength + ++mPadLength)
+        {
+            this->FlushQuantum(result, result_len);
+            mFinished = true;
+        }
+    }
+    else
+    {
+        if (mPadLength > 0)
+        {
+            if (DO_PARSE_ANY != parse_flags)
+            {
+                mFailed = true;  // pads followed by data
+                return;
+            }
+            mPadLength = 0;
+        }
+        mQuantum[mQuantumLength++] = value;
+        if (4 == mQuantumLength)
+        {
+            result[(*result_len)++] = static_cast<uint8_t>((mQuantum[0] << 2) | (mQuantum[1] >> 4));
+            result[(*result_len)++] = static_cast<uint8_t>((mQuantum[1] << 4) | (mQuantum[2] >> 2));
+            result[(*result_len)++] = static_cast<uint8_t>((mQuantum[2] << 6) | mQuantum[3]);
+            mQuantumLength = 0;
+        }
+    }
+}
+
+void Base64::Decoder::FlushQuantum(uint8_t *result, size_t *result_len)
+{
+    for (size_t i = mQuantumLength; i < 4; ++i)
+    {
+        mQuantum[i] = 0;
+    }
+    unsigned char c = (mQuantum[0] << 2) | ((mQuantum[1] >> 4) & 0x3);
+    if (mQuantumLength >= 2)
+    {
+        result[(*result_len)++] = c;
+        c = ((mQuantum[1] << 4) & 0xf0) | ((mQuantum[2] >> 2) & 0xf);
+        if (mQuantumLength >= 3)
+        {
+            result[(*result_len)++] = c;
+            c = (mQuantum[2] << 6) & 0xc0;
+        }
+    }
+    if ((DO_TERM_ANY != (mFlags & DO_TERM_MASK)) && (0 != c))
+    {
+        mFailed = true;  // unused bits
+    }
+    mQuantumLength = 0;
+}
+
+void Base64::Decoder::Reset()
+{
+    mQuantumLength = 0;
+    mPadLength = 0;
+    mFinished = false;
+    mFailed = false;
+}
 OCTK_END_NAMESPACE
@@ -76,6 +76,23 @@ public:
     // encoded characters.
     static bool IsBase64Encoded(StringView str);
 
+    // Number of characters EncodeToArray() writes for `len` bytes, padding included.
+    static inline size_t GetEncodedSize(size_t len) { return ((len + 2) / 3) * 4; }
+    // Upper bound of the bytes DecodeToArray() writes for `len` characters.
+    static inline size_t GetMaxDecodedSize(size_t len) { return ((len + 3) / 4) * 3; }
+
+    // Encodes into `result`, which must have room for GetEncodedSize(len)
+    // characters. Returns the number of characters written.
+    static size_t EncodeToArray(const void *data, size_t len, char *result);
+    // Decodes into `result`, which must have room for GetMaxDecodedSize(len)
+    // bytes, without allocating. The decoded length goes to `result_len`.
+    static bool DecodeToArray(const char *data,
+                              size_t len,
+                              DecodeFlags flags,
+                              uint8_t *result,
+                              size_t *result_len,
+                              size_t *data_used);
+
     static void EncodeFromArray(const void *data,
                                 size_t len,
                                 std::string *result);
@@ -123,6 +140,61 @@ public:
         return DecodeFromArray(data.data(), data.size(), flags, result, data_used);
     }
 
+    // Incremental encoder for payloads that arrive in pieces. The concatenated
+    // output of Update() and Finish() equals Encode() of the concatenated input.
+    class OCTK_CORE_API Encoder
+    {
+    public:
+        // Upper bound of the characters Update() writes for `len` bytes.
+        static inline size_t GetMaxUpdateSize(size_t len) { return GetEncodedSize(len + 2); }
+
+        // Encodes every complete 3 byte group and keeps the remainder for the
+        // next call. Returns the number of characters written.
+        size_t Update(const void *data, size_t len, char *result);
+        void Update(const void *data, size_t len, std::string *result);
+        // Writes the padded remainder, at most 4 characters, and resets the encoder.
+        size_t Finish(char *result);
+        void Finish(std::string *result);
+
+    private:
+        unsigned char mPending[3];
+        size_t mPendingLength{0};
+    };
+
+    // Incremental decoder for encodings that arrive in pieces, applying the
+    // same flags as DecodeFromArray(). Unlike DecodeFromArray() it has no
+    // notion of unparsed trailing data: a character the flags reject fails the
+    // decoder, DO_TERM_* only governs the unused bits of the last quantum.
+    class OCTK_CORE_API Decoder
+    {
+    public:
+        explicit Decoder(DecodeFlags flags);
+
+        // Upper bound of the bytes Update() writes for `len` characters.
+        static inline size_t GetMaxUpdateSize(size_t len) { return GetMaxDecodedSize(len + 3); }
+
+        // Decodes every complete quantum and keeps the remainder for the next
+        // call. The Update() and Finish() overloads taking a std::string append.
+        bool Update(const char *data, size_t len, uint8_t *result, size_t *result_len);
+        bool Update(const char *data, size_t len, std::string *result);
+        // Writes the last partial quantum, at most 2 bytes, checks the padding
+        // and termination rules and resets the decoder.
+        bool Finish(uint8_t *result, size_t *result_len);
+        bool Finish(std::string *result);
+
+    private:
+        void Accept(char ch, uint8_t *result, size_t *result_len);
+        void FlushQuantum(uint8_t *result, size_t *result_len);
+        void Reset();
+
+        const DecodeFlags mFlags;
+        unsigned char mQuantum[4];
+        size_t mQuantumLength{0};
+        size_t mPadLength{0};
+        bool mFinished{false};
+        bool mFailed{false};
+    };
+
 private:
     static const char Base64Table[];
     static const unsigned char DecodeTable[];
@@ -134,6 +206,10 @@ private:
                                  size_t *dpos,
                                  unsigned char qbuf[4],
                                  bool *padded);
+    // Bulk paths, consuming whole 3 byte groups resp. quanta of 4 plain base64
+    // characters with the best kernel the CPU supports.
+    static size_t EncodeGroups(const unsigned char *data, size_t len, char *result);
+    static size_t DecodeQuanta(const char *data, size_t len, uint8_t *result);
     template <typename T>
     static bool DecodeFromArrayTemplate(const char *data,
                                         size_t len,
@@ -0,0 +1,129 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#ifndef _OCTK_FROM_CHARS_HPP
+#define _OCTK_FROM_CHARS_HPP
+
+#include <openctk/core/string_view.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+OCTK_BEGIN_NAMESPACE
+
+// Locale independent number parsing with the contract of C++17's std::from_chars(), for C++14. Nothing is copied
+// or allocated, the input does not need to be nul terminated and the parsed range is [first, last).
+//
+// On success `ptr` points past the last character of the number and `ec` is empty. When no number starts at
+// `first`, `ptr` is `first` and `ec` is std::errc::invalid_argument. When the number does not fit, `ptr` still
+// points past it but `ec` is std::errc::result_out_of_range. `value` is only written on success.
+//
+// Integers take an optional '-' (signed types only) followed by digits of `base`, 2 to 36, without prefix.
+// Floating point numbers take an optional '-', decimal digits with an optional '.' and an optional exponent, or
+// "inf", "infinity", "nan" and "nan(...)" in any case. They are correctly rounded (round to nearest even) through
+// the Eisel-Lemire algorithm, so that printing a value with enough digits and parsing it back gives the same bits.
+// Results that underflow to zero or overflow to infinity are out of range, subnormals are returned.
+
+namespace utils
+{
+struct FromCharsResult
+{
+    const char *ptr;
+    std::errc ec;
+};
+
+namespace detail
+{
+inline unsigned digitValue(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return static_cast<unsigned>(c - '0');
+    }
+    const char lower = static_cast<char>(c | 0x20);
+    if (lower >= 'a' && lower <= 'z')
+    {
+        return static_cast<unsigned>(lower - 'a' + 10);
+    }
+    return 255;
+}
+} // namespace detail
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, FromCharsResult>::type
+fromChars(const char *first, const char *last, T &value, int base = 10)
+{
+    using U = typename std::make_unsigned<T>::type;
+    const char *p = first;
+    const bool negative = std::is_signed<T>::value && p != last && '-' == *p;
+    if (negative)
+    {
+        ++p;
+    }
+    const U limit = negative ? static_cast<U>(static_cast<U>(std::numeric_limits<T>::max()) + 1U)
+                             : static_cast<U>(std::numeric_limits<T>::max());
+    const char *digits = p;
+    bool overflow = false;
+    U result = 0;
+    for (; p != last; ++p)
+    {
+        const unsigned digit = detail::digitValue(*p);
+        if (digit >= static_cast<unsigned>(base))
+        {
+            break;
+        }
+        if (overflow || result > (limit - digit) / static_cast<unsigned>(base))
+        {
+            overflow = true;
+            continue;
+        }
+        result = static_cast<U>(result * static_cast<unsigned>(base) + digit);
+    }
+    if (p == digits)
+    {
+        return {first, std::errc::invalid_argument};
+    }
+    if (overflow)
+    {
+        return {p, std::errc::result_out_of_range};
+    }
+    value = negative ? static_cast<T>(static_cast<U>(0U - result)) : static_cast<T>(result);
+    return {p, std::errc()};
+}
+
+OCTK_CORE_API FromCharsResult fromChars(const char *first, const char *last, float &value);
+OCTK_CORE_API FromCharsResult fromChars(const char *first, const char *last, double &value);
+
+template <typename T>
+FromCharsResult fromChars(StringView str, T &value)
+{
+    return fromChars(str.data(), str.data() + str.size(), value);
+}
+} // namespace utils
+
+OCTK_END_NAMESPACE
+
+#endif // _OCTK_FROM_CHARS_HPP
@@ -44,57 +44,65 @@ SimpleStringBuilder &SimpleStringBuilder::operator<<(StringView str)
 
 // Numeric conversion routines.
 //
-// We use std::[v]snprintf instead of std::to_string because:
-// * std::to_string relies on the current locale for formatting purposes,
-//   and therefore concurrent calls to std::to_string from multiple threads
-//   may result in partial serialization of calls
-// * snprintf allows us to print the number directly into our buffer.
-// * avoid allocating a std::string (potential heap alloc).
-// TODO(tommi): Switch to std::to_chars in C++17.
+// Integers go through fmt::format_int and floats through fmt's "{:g}", which
+// prints exactly what "%g" does, because:
+// * both are locale independent, unlike std::to_string.
+// * both print the number into a stack buffer resp. directly into our buffer.
+// * neither parses a printf format string at runtime.
+
+namespace
+{
+template <typename T>
+SimpleStringBuilder &AppendInteger(SimpleStringBuilder &builder, T i)
+{
+    const fmt::format_int formatted(i);
+    return builder << StringView(formatted.data(), formatted.size());
+}
+} // namespace
 
 SimpleStringBuilder &SimpleStringBuilder::operator<<(int i)
 {
-    return AppendFormat("%d", i);
+    return AppendInteger(*this, i);
 }
 
 SimpleStringBuilder &SimpleStringBuilder::operator<<(unsigned i)
 {
-    return AppendFormat("%u", i);
+    return AppendInteger(*this, i);
 }
 
 SimpleStringBuilder &SimpleStringBuilder::operator<<(long i)
 { // NOLINT
-    return AppendFormat("%ld", i);
+    return AppendInteger(*this, i);
 }
 
 SimpleStringBuilder &SimpleStringBuilder::operator<<(long long i)
 { // NOLINT
-    return AppendFormat("%lld", i);
+    return AppendInteger(*this, i);
 }
 
 SimpleStringBuilder &SimpleStringBuilder::operator<<(unsigned long i)
 { // NOLINT
-    return AppendFormat("%lu", i);
+    return AppendInteger(*this, i);
 }
 
 SimpleStringBuilder &SimpleStringBuilder::operator<<(unsigned long long i)
 { // NOLINT
-    return AppendFormat("%llu", i);
+    return AppendInteger(*this, i);
 }
 
 SimpleStringBuilder &SimpleStringBuilder::operator<<(float f)
 {
-    return AppendFormat("%g", f);
+    return Format(FMT_STRING("{:g}"), f);
 }
 
 SimpleStringBuilder &SimpleStringBuilder::operator<<(double f)
 {
-    return AppendFormat("%g", f);
+    return Format(FMT_STRING("{:g}"), f);
 }
 
 SimpleStringBuilder &SimpleStringBuilder::operator<<(long double f)
 {
-    return AppendFormat("%Lg", f);
+    return Format(FMT_STRING("{:g}"), f);
 }
 
 SimpleStringBuilder &SimpleStringBuilder::AppendFormat(const char *fmt, ...)
@@ -120,6 +128,16 @@ SimpleStringBuilder &SimpleStringBuilder::AppendFormat(const char *fmt, ...)
     return *this;
 }
 
+SimpleStringBuilder &SimpleStringBuilder::Advance(size_t length)
+{
+    const size_t chars_added = SafeMin(length, mBuffer.size() - 1 - mSize);
+    OCTK_DCHECK_EQ(length, chars_added) << "Buffer size was insufficient";
+    mSize += chars_added;
+    mBuffer[mSize] = '\0';
+    OCTK_DCHECK(IsConsistent());
+    return *this;
+}
+
 StringBuilder &StringBuilder::AppendFormat(const char *fmt, ...)
 {
     va_list args, copy;
@@ -14,7 +14,10 @@
 #include <openctk/core/string_view.hpp>
 #include <openctk/core/string_encode.hpp>
 
+#include <openctk/3rdparty/fmt/format.h>
+
 #include <cstdio>
+#include <iterator>
 #include <string>
 #include <utility>
 
@@ -60,9 +63,24 @@ public:
     OCTK_ATTRIBUTE_FORMAT_PRINTF(2, 3)
     SimpleStringBuilder &AppendFormat(const char *fmt, ...);
 
+    // Allows appending an fmt style formatted string, written straight into
+    // the buffer. Wrapping the literal in FMT_STRING() checks it at compile
+    // time, under C++20 that happens without it.
+    template <typename... Args>
+    SimpleStringBuilder &Format(fmt::format_string<Args...> format, Args &&...args)
+    {
+        const size_t capacity = mBuffer.size() - 1 - mSize;
+        const auto result = fmt::format_to_n(&mBuffer[mSize], capacity, format, std::forward<Args>(args)...);
+        return Advance(result.size);
+    }
+
 private:
     bool IsConsistent() const { return mSize <= mBuffer.size() - 1 && mBuffer[mSize] == '\0'; }
 
+    // Accounts for `length` characters formatted into the buffer, of which
+    // those beyond its end were dropped.
+    SimpleStringBuilder &Advance(size_t length);
+
     // An always-zero-terminated fixed-size buffer that we write to. The fixed
     // size allows the buffer to be stack allocated, which helps performance.
     // Having a fixed size is furthermore useful to avoid unnecessary resizing
@@ -102,56 +120,47 @@ public:
 
     StringBuilder &operator<<(int i)
     {
-        mString += utils::toString(i);
-        return *this;
+        return AppendInteger(i);
     }
 
     StringBuilder &operator<<(unsigned i)
     {
-        mString += utils::toString(i);
-        return *this;
+        return AppendInteger(i);
     }
 
     StringBuilder &operator<<(long i)
     { // NOLINT
-        mString += utils::toString(i);
-        return *this;
+        return AppendInteger(i);
     }
 
     StringBuilder &operator<<(long long i)
     { // NOLINT
-        mString += utils::toString(i);
-        return *this;
+        return AppendInteger(i);
     }
 
     StringBuilder &operator<<(unsigned long i)
     { // NOLINT
-        mString += utils::toString(i);
-        return *this;
+        return AppendInteger(i);
     }
 
     StringBuilder &operator<<(unsigned long long i)
     { // NOLINT
-        mString += utils::toString(i);
-        return *this;
+        return AppendInteger(i);
     }
 
     StringBuilder &operator<<(float f)
     {
-        mString += utils::toString(f);
-        return *this;
+        return Format(FMT_STRING("{:g}"), f);
     }
 
     StringBuilder &operator<<(double f)
     {
-        mString += utils::toString(f);
-        return *this;
+        return Format(FMT_STRING("{:g}"), f);
     }
 
     StringBuilder &operator<<(long double f)
     {
-        mString += utils::toString(f);
-        return *this;
+        return Format(FMT_STRING("{:g}"), f);
     }
 
     const std::string &str() const { return mString; }
@@ -170,7 +179,25 @@ public:
     // Allows appending a printf style formatted string.
     StringBuilder &AppendFormat(const char *fmt, ...) OCTK_ATTRIBUTE_FORMAT_PRINTF(2, 3);
 
+    // Allows appending an fmt style formatted string, written straight into
+    // the string. Wrapping the literal in FMT_STRING() checks it at compile
+    // time, under C++20 that happens without it.
+    template <typename... Args>
+    StringBuilder &Format(fmt::format_string<Args...> format, Args &&...args)
+    {
+        fmt::format_to(std::back_inserter(mString), format, std::forward<Args>(args)...);
+        return *this;
+    }
+
 private:
+    template <typename T>
+    StringBuilder &AppendInteger(T i)
+    {
+        const fmt::format_int formatted(i);
+        mString.append(formatted.data(), formatted.size());
+        return *this;
+    }
+
     std::string mString;
 };
 
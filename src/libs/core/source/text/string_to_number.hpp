@@ -27,7 +27,9 @@
 
 #include <openctk/core/optional.hpp>
 #include <openctk/core/string_view.hpp>
+#include <openctk/core/from_chars.hpp>
 
+#include <cctype>
 #include <limits>
 
 OCTK_BEGIN_NAMESPACE
@@ -56,68 +58,98 @@ namespace utils
 {
 namespace detail
 {
-// These must be (unsigned) long long, to match the signature of strto(u)ll.
 using unsigned_type = unsigned long long; // NOLINT(runtime/int)
 using signed_type = long long;            // NOLINT(runtime/int)
 
-static Optional<signed_type> ParseSigned(StringView str, int base)
+// Parses the magnitude of an integer through fromChars(), without copying the string. Mirrors what strto(u)ll()
+// accepts after the checks below: an optional minus sign, the "0x" prefix for base 16 and 0, and the leading "0" of
+// octal numbers for base 0.
+static Optional<unsigned_type> ParseMagnitude(StringView str, int base, bool *is_negative)
 {
-    if (str.empty())
+    if (str.empty() || !(isdigit(static_cast<unsigned char>(str[0])) || str[0] == '-') ||
+        (base != 0 && (base < 2 || base > 36)))
+    {
+        return utils::nullopt;
+    }
+    const char *first = str.data();
+    const char *last = str.data() + str.size();
+    *is_negative = *first == '-';
+    if (*is_negative)
+    {
+        ++first;
+    }
+    if ((base == 0 || base == 16) && last - first > 2 && first[0] == '0' && (first[1] | 0x20) == 'x' &&
+        isxdigit(static_cast<unsigned char>(first[2])))
+    {
+        first += 2;
+        base = 16;
+    }
+    else if (base == 0)
+    {
+        base = first != last && *first == '0' ? 8 : 10;
+    }
+    unsigned_type value = 0;
+    const FromCharsResult result = fromChars(first, last, value, base);
+    // Trailing contents, including embedded nuls, and out of range values are errors.
+    if (result.ec != std::errc() || result.ptr != last)
     {
         return utils::nullopt;
     }
+    return value;
+}
 
-    if (isdigit(static_cast<unsigned char>(str[0])) || str[0] == '-')
+static Optional<signed_type> ParseSigned(StringView str, int base)
+{
+    bool is_negative = false;
+    const Optional<unsigned_type> magnitude = ParseMagnitude(str, base, &is_negative);
+    if (!magnitude)
     {
-        std::string str_str(str);
-        char *end = nullptr;
-        errno = 0;
-        const signed_type value = std::strtoll(str_str.c_str(), &end, base);
-        // Check for errors and also make sure that there were no embedded nuls in
-        // the input string.
-        if (end == str_str.c_str() + str_str.size() && errno == 0)
+        return utils::nullopt;
+    }
+    const unsigned_type limit = static_cast<unsigned_type>(std::numeric_limits<signed_type>::max());
+    if (is_negative)
+    {
+        if (*magnitude > limit + 1)
         {
-            return value;
+            return utils::nullopt;
         }
+        return static_cast<signed_type>(0U - *magnitude);
     }
-    return utils::nullopt;
+    if (*magnitude > limit)
+    {
+        return utils::nullopt;
+    }
+    return static_cast<signed_type>(*magnitude);
 }
 static Optional<unsigned_type> ParseUnsigned(StringView str, int base)
 {
-    if (str.empty())
+    // Explicitly discard negative values. We cannot just reject values that start with -, though, since -0 is
+    // perfectly fine, as is -0000000000000000000000000000000.
+    bool is_negative = false;
+    const Optional<unsigned_type> value = ParseMagnitude(str, base, &is_negative);
+    if (value && (*value == 0 || !is_negative))
     {
-        return utils::nullopt;
+        return value;
     }
+    return utils::nullopt;
+}
 
-    if (isdigit(static_cast<unsigned char>(str[0])) || str[0] == '-')
+// float and double are parsed by fromChars(): locale independent, correctly rounded and without copying the
+// string. Like for integers, leading space, a plus sign and trailing contents are rejected, and so are hexadecimal
+// floats. Values that overflow to infinity or underflow to zero are out of range.
+template <typename T> Optional<T> ParseFloatingPoint(StringView str)
+{
+    T value;
+    const FromCharsResult result = fromChars(str, value);
+    if (result.ec == std::errc() && result.ptr == str.data() + str.size())
     {
-        std::string str_str(str);
-        // Explicitly discard negative values. std::strtoull parsing causes unsigned
-        // wraparound. We cannot just reject values that start with -, though, since
-        // -0 is perfectly fine, as is -0000000000000000000000000000000.
-        const bool is_negative = str[0] == '-';
-        char *end = nullptr;
-        errno = 0;
-        const unsigned_type value = std::strtoull(str_str.c_str(), &end, base);
-        // Check for errors and also make sure that there were no embedded nuls in
-        // the input string.
-        if (end == str_str.c_str() + str_str.size() && errno == 0 && (value == 0 || !is_negative))
-        {
-            return value;
-        }
+        return value;
     }
     return utils::nullopt;
 }
 
-template <typename T> T StrToT(const char *str, char **str_end);
-
-template <> inline float StrToT(const char *str, char **str_end) { return std::strtof(str, str_end); }
-
-template <> inline double StrToT(const char *str, char **str_end) { return std::strtod(str, str_end); }
-
-template <> inline long double StrToT(const char *str, char **str_end) { return std::strtold(str, str_end); }
-
-template <typename T> Optional<T> ParseFloatingPoint(StringView str)
+// long double has no fromChars() overload and keeps using strtold().
+template <> inline Optional<long double> ParseFloatingPoint(StringView str)
 {
     if (str.empty())
     {
@@ -131,16 +163,13 @@ template <typename T> Optional<T> ParseFloatingPoint(StringView str)
     std::string str_str(str);
     char *end = nullptr;
     errno = 0;
-    const T value = StrToT<T>(str_str.c_str(), &end);
+    const long double value = std::strtold(str_str.c_str(), &end);
     if (end == str_str.c_str() + str_str.size() && errno == 0)
     {
         return value;
     }
     return utils::nullopt;
 }
-template Optional<float> ParseFloatingPoint(StringView str);
-template Optional<double> ParseFloatingPoint(StringView str);
-template Optional<long double> ParseFloatingPoint(StringView str);
 } // namespace detail
 
 template <typename T>
@@ -22,7 +22,8 @@
 **
 ***********************************************************************************************************************/
 
-#include "concurrent.hpp"
+#include <openctk/core/concurrent.hpp>
+#include <openctk/core/exception.hpp>
 
 OCTK_BEGIN_NAMESPACE
 
@@ -30,7 +31,125 @@ namespace concurrent
 {
 namespace detail
 {
+namespace
+{
+// a block should run long enough to hide the cost of claiming it
+OCTK_STATIC_CONSTANT_NUMBER(kTargetBlockNSecs, 100000)
+// every thread should get several blocks so that uneven item costs still balance out
+OCTK_STATIC_CONSTANT_NUMBER(kMinBlocksPerThread, 4)
+} // namespace
+
+BlockSizeManager::BlockSizeManager(int64_t iterationCount, int threadCount)
+    : mMaxBlockSize(std::max(int64_t(1), iterationCount / (std::max(1, threadCount) * int64_t(kMinBlocksPerThread))))
+{
+}
+
+void BlockSizeManager::timeBeforeUser() { mStartTime = std::chrono::steady_clock::now(); }
+
+void BlockSizeManager::timeAfterUser(int64_t iterations)
+{
+    const auto elapsed = std::chrono::steady_clock::now() - mStartTime;
+    const double iterationNSecs =
+        double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / double(iterations);
+    mAverageIterationNSecs = mAverageIterationNSecs <= 0 ? iterationNSecs
+                                                         : 0.75 * mAverageIterationNSecs + 0.25 * iterationNSecs;
+    const double blockSize = double(kTargetBlockNSecs) / std::max(1.0, mAverageIterationNSecs);
+    mBlockSize = std::max(int64_t(1), std::min(mMaxBlockSize, int64_t(blockSize)));
+}
+
+IterateEngine::IterateEngine(int64_t count, ThreadPool *pool, StatePtr state)
+    : mCount(count)
+    , mPool(pool)
+    , mState(std::move(state))
+    , mRemaining(count)
+{
+}
 
+void IterateEngine::start(bool blocking)
+{
+    mState->setProgressRange(0, mCount);
+    if (0 == mCount)
+    {
+        this->finish();
+        mState->reportFinished();
+        return;
+    }
+
+    int64_t workers = std::min(int64_t(std::max(1, mPool->maxThreadCount())), mCount);
+    if (blocking)
+    {
+        --workers;
+    }
+    const auto self = this->shared_from_this();
+    for (int64_t i = 0; i < workers; ++i)
+    {
+        mPool->start([self]() { self->run(); });
+    }
+    if (blocking)
+    {
+        this->run();
+        mState->wait();
+    }
+}
+
+void IterateEngine::run()
+{
+    BlockSizeManager blockSizeManager(mCount, mPool->maxThreadCount());
+    while (true)
+    {
+        if (mState->isCanceled())
+        {
+            // claim everything left, the worker accounting for the last iteration finishes the state
+            const int64_t begin = mNext.exchange(mCount);
+            if (begin < mCount)
+            {
+                this->account(mCount - begin);
+            }
+            return;
+        }
+
+        const int64_t blockSize = blockSizeManager.blockSize();
+        const int64_t begin = mNext.fetch_add(blockSize);
+        if (begin >= mCount)
+        {
+            return;
+        }
+        const int64_t end = std::min(begin + blockSize, mCount);
+        blockSizeManager.timeBeforeUser();
+        OCTK_TRY
+        {
+            this->runRange(begin, end);
+        }
+        OCTK_CATCH(...)
+        {
+            mState->reportException(std::current_exception());
+            mState->cancel();
+        }
+        blockSizeManager.timeAfterUser(end - begin);
+        mState->addProgressValue(end - begin);
+        this->account(end - begin);
+    }
+}
+
+void IterateEngine::account(int64_t iterations)
+{
+    if (mRemaining.fetch_sub(iterations, std::memory_order_acq_rel) != iterations)
+    {
+        return;
+    }
+    if (!mState->isCanceled())
+    {
+        OCTK_TRY
+        {
+            this->finish();
+        }
+        OCTK_CATCH(...)
+        {
+            mState->reportException(std::current_exception());
+        }
+    }
+    mState->reportFinished();
+}
 } // namespace detail
 } // namespace concurrent
 
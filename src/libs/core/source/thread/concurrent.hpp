@@ -26,15 +26,449 @@
 
 #include <openctk/core/thread_pool.hpp>
 #include <openctk/core/type_traits.hpp>
+#include <openctk/core/future.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <chrono>
 
 OCTK_BEGIN_NAMESPACE
 
+/**
+ * @addtogroup core
+ * @{
+ * @addtogroup Concurrent
+ * @brief Parallel algorithms running on a ThreadPool.
+ * @{
+ * @details
+ * Every algorithm splits its input into blocks that idle pool threads claim one after another.
+ * The block size adapts to the measured cost of the functor, cheap functors get large blocks to amortize the
+ * scheduling overhead while expensive ones stay fine grained for load balancing.
+ *
+ * The non blocking algorithms return a Future that reports progress in iterations, can be canceled and delivers the
+ * result. Canceled computations stop at the next block boundary and have no result.
+ * The blocking variants let the calling thread work on the blocks too, so they can be used from pool threads.
+ *
+ * Functors are invoked concurrently from several threads and must be thread-safe. Input sequences have to be random
+ * access and must stay alive until the computation finished.
+ */
 namespace concurrent
 {
 namespace detail
 {
+template <typename Functor, typename Arg>
+using InvokeResult = typename std::decay<decltype(std::declval<Functor &>()(std::declval<Arg>()))>::type;
+
+template <typename Iterator>
+using IteratorValue = typename std::iterator_traits<Iterator>::value_type;
+
+/**
+ * Tracks the cost of the user functor of one worker and derives how many iterations it claims at once.
+ */
+class OCTK_CORE_API BlockSizeManager
+{
+public:
+    BlockSizeManager(int64_t iterationCount, int threadCount);
+
+    int64_t blockSize() const { return mBlockSize; }
+
+    void timeBeforeUser();
+    void timeAfterUser(int64_t iterations);
+
+private:
+    const int64_t mMaxBlockSize;
+    int64_t mBlockSize{1};
+    double mAverageIterationNSecs{0};
+    std::chrono::steady_clock::time_point mStartTime;
+};
+
+/**
+ * Drives the iterations [0, count) of one algorithm on a pool and finishes its future state.
+ */
+class OCTK_CORE_API IterateEngine : public std::enable_shared_from_this<IterateEngine>
+{
+public:
+    using StatePtr = std::shared_ptr<octk::detail::FutureStateBase>;
+
+    IterateEngine(int64_t count, ThreadPool *pool, StatePtr state);
+    virtual ~IterateEngine() = default;
+
+    /**
+     * Starts the workers, with blocking the calling thread works as well and returns once the state finished.
+     */
+    void start(bool blocking);
+
+protected:
+    virtual void runRange(int64_t begin, int64_t end) = 0;
+    /**
+     * Called once after all iterations ran, not called for canceled or failed computations.
+     */
+    virtual void finish() { }
+
+private:
+    void run();
+    void account(int64_t iterations);
+
+    const int64_t mCount;
+    ThreadPool *const mPool;
+    const StatePtr mState;
+    std::atomic<int64_t> mNext{0};
+    std::atomic<int64_t> mRemaining;
+};
+
+template <typename Iterator, typename Functor>
+class MapEngine final : public IterateEngine
+{
+public:
+    MapEngine(Iterator begin, int64_t count, Functor functor, ThreadPool *pool, Future<void>::StatePtr state)
+        : IterateEngine(count, pool, std::move(state))
+        , mBegin(begin)
+        , mFunctor(std::move(functor))
+    {
+    }
+
+protected:
+    void runRange(int64_t begin, int64_t end) override
+    {
+        auto iter = mBegin + begin;
+        for (int64_t i = begin; i < end; ++i, ++iter)
+        {
+            mFunctor(*iter);
+        }
+    }
+
+private:
+    const Iterator mBegin;
+    Functor mFunctor;
+};
+
+template <typename Iterator, typename Functor, typename Result>
+class MappedEngine final : public IterateEngine
+{
+public:
+    using ResultVector = std::vector<Result>;
+
+    MappedEngine(Iterator begin, int64_t count, Functor functor, ThreadPool *pool, typename Future<ResultVector>::StatePtr state)
+        : IterateEngine(count, pool, state)
+        , mBegin(begin)
+        , mFunctor(std::move(functor))
+        , mState(std::move(state))
+        , mResults(static_cast<size_t>(count))
+    {
+    }
+
+protected:
+    void runRange(int64_t begin, int64_t end) override
+    {
+        auto iter = mBegin + begin;
+        for (int64_t i = begin; i < end; ++i, ++iter)
+        {
+            mResults[static_cast<size_t>(i)] = mFunctor(*iter);
+        }
+    }
+    void finish() override { mState->reportResult(std::move(mResults)); }
+
+private:
+    const Iterator mBegin;
+    Functor mFunctor;
+    const typename Future<ResultVector>::StatePtr mState;
+    ResultVector mResults;
+};
+
+template <typename Iterator, typename Predicate>
+class FilterEngine final : public IterateEngine
+{
+public:
+    using ResultVector = std::vector<IteratorValue<Iterator>>;
+
+    FilterEngine(Iterator begin, int64_t count, Predicate predicate, ThreadPool *pool, typename Future<ResultVector>::StatePtr state)
+        : IterateEngine(count, pool, state)
+        , mBegin(begin)
+        , mPredicate(std::move(predicate))
+        , mState(std::move(state))
+        , mKeep(static_cast<size_t>(count), 0)
+    {
+    }
+
+protected:
+    void runRange(int64_t begin, int64_t end) override
+    {
+        auto iter = mBegin + begin;
+        for (int64_t i = begin; i < end; ++i, ++iter)
+        {
+            mKeep[static_cast<size_t>(i)] = mPredicate(*iter) ? 1 : 0;
+        }
+    }
+    void finish() override
+    {
+        ResultVector results;
+        auto iter = mBegin;
+        for (size_t i = 0; i < mKeep.size(); ++i, ++iter)
+        {
+            if (mKeep[i])
+            {
+                results.push_back(*iter);
+            }
+        }
+        mState->reportResult(std::move(results));
+    }
+
+private:
+    const Iterator mBegin;
+    Predicate mPredicate;
+    const typename Future<ResultVector>::StatePtr mState;
+    std::vector<char> mKeep; // not std::vector<bool>, its elements can not be written concurrently
+};
+
+template <typename Iterator, typename MapFunctor, typename ReduceFunctor, typename Result>
+class ReduceEngine final : public IterateEngine
+{
+public:
+    using Mapped = InvokeResult<MapFunctor, decltype(*std::declval<Iterator>())>;
+
+    ReduceEngine(Iterator begin,
+                 int64_t count,
+                 MapFunctor mapFunctor,
+                 ReduceFunctor reduceFunctor,
+                 Result initial,
+                 ThreadPool *pool,
+                 typename Future<Result>::StatePtr state)
+        : IterateEngine(count, pool, state)
+        , mBegin(begin)
+        , mMapFunctor(std::move(mapFunctor))
+        , mReduceFunctor(std::move(reduceFunctor))
+        , mInitial(std::move(initial))
+        , mState(std::move(state))
+        , mMapped(static_cast<size_t>(count))
+    {
+    }
+
+protected:
+    void runRange(int64_t begin, int64_t end) override
+    {
+        auto iter = mBegin + begin;
+        for (int64_t i = begin; i < end; ++i, ++iter)
+        {
+            mMapped[static_cast<size_t>(i)] = mMapFunctor(*iter);
+        }
+    }
+    void finish() override
+    {
+        Result result = std::move(mInitial);
+        for (const auto &mapped : mMapped)
+        {
+            mReduceFunctor(result, mapped);
+        }
+        mState->reportResult(std::move(result));
+    }
+
+private:
+    const Iterator mBegin;
+    MapFunctor mMapFunctor;
+    ReduceFunctor mReduceFunctor;
+    Result mInitial;
+    const typename Future<Result>::StatePtr mState;
+    std::vector<Mapped> mMapped;
+};
+
+template <typename Functor>
+class ForEngine final : public IterateEngine
+{
+public:
+    ForEngine(int64_t first, int64_t count, Functor functor, ThreadPool *pool, Future<void>::StatePtr state)
+        : IterateEngine(count, pool, std::move(state))
+        , mFirst(first)
+        , mFunctor(std::move(functor))
+    {
+    }
+
+protected:
+    void runRange(int64_t begin, int64_t end) override
+    {
+        for (int64_t i = begin; i < end; ++i)
+        {
+            mFunctor(mFirst + i);
+        }
+    }
+
+private:
+    const int64_t mFirst;
+    Functor mFunctor;
+};
+
+template <typename Engine, typename T, typename... Args>
+Future<T> startEngine(bool blocking, Args &&...args)
+{
+    auto state = std::make_shared<typename Future<T>::State>();
+    auto engine = std::make_shared<Engine>(std::forward<Args>(args)..., state);
+    engine->start(blocking);
+    return Future<T>(state);
+}
 } // namespace detail
 
+/**
+ * Runs functor() on pool, a functor returning a Future is unwrapped like with Future::then().
+ * @return a future of the functor's return value.
+ */
+template <typename Functor>
+auto run(Functor functor, ThreadPool *pool = ThreadPool::defaultInstance())
+    -> decltype(makeReadyFuture().then(Executor(pool), std::move(functor)))
+{
+    return makeReadyFuture().then(Executor(pool), std::move(functor));
+}
+
+/**
+ * Calls functor(item) for every item in [begin, end), the functor usually modifies the item in place.
+ */
+template <typename Iterator, typename Functor>
+Future<void> map(Iterator begin, Iterator end, Functor functor, ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    return detail::startEngine<detail::MapEngine<Iterator, Functor>, void>(false,
+                                                                           begin,
+                                                                           int64_t(std::distance(begin, end)),
+                                                                           std::move(functor),
+                                                                           pool);
+}
+template <typename Container, typename Functor>
+Future<void> map(Container &container, Functor functor, ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    return concurrent::map(std::begin(container), std::end(container), std::move(functor), pool);
+}
+
+/**
+ * Like map(), but returns once every item was processed and rethrows the first exception of the functor.
+ */
+template <typename Iterator, typename Functor>
+void blockingMap(Iterator begin, Iterator end, Functor functor, ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    detail::startEngine<detail::MapEngine<Iterator, Functor>, void>(true,
+                                                                    begin,
+                                                                    int64_t(std::distance(begin, end)),
+                                                                    std::move(functor),
+                                                                    pool)
+        .result();
+}
+template <typename Container, typename Functor>
+void blockingMap(Container &container, Functor functor, ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    concurrent::blockingMap(std::begin(container), std::end(container), std::move(functor), pool);
+}
+
+/**
+ * @return the results of functor(item) for every item, in sequence order.
+ */
+template <typename Iterator,
+          typename Functor,
+          typename Result = detail::InvokeResult<Functor, decltype(*std::declval<Iterator>())>>
+Future<std::vector<Result>> mapped(Iterator begin,
+                                   Iterator end,
+                                   Functor functor,
+                                   ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    return detail::startEngine<detail::MappedEngine<Iterator, Functor, Result>, std::vector<Result>>(
+        false,
+        begin,
+        int64_t(std::distance(begin, end)),
+        std::move(functor),
+        pool);
+}
+template <typename Container, typename Functor>
+auto mapped(const Container &container, Functor functor, ThreadPool *pool = ThreadPool::defaultInstance())
+    -> decltype(concurrent::mapped(std::begin(container), std::end(container), std::move(functor), pool))
+{
+    return concurrent::mapped(std::begin(container), std::end(container), std::move(functor), pool);
+}
+
+/**
+ * @return copies of the items for which predicate(item) returned true, in sequence order.
+ */
+template <typename Iterator, typename Predicate>
+Future<std::vector<detail::IteratorValue<Iterator>>> filter(Iterator begin,
+                                                            Iterator end,
+                                                            Predicate predicate,
+                                                            ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    using Engine = detail::FilterEngine<Iterator, Predicate>;
+    return detail::startEngine<Engine, typename Engine::ResultVector>(false,
+                                                                      begin,
+                                                                      int64_t(std::distance(begin, end)),
+                                                                      std::move(predicate),
+                                                                      pool);
+}
+template <typename Container, typename Predicate>
+auto filter(const Container &container, Predicate predicate, ThreadPool *pool = ThreadPool::defaultInstance())
+    -> decltype(concurrent::filter(std::begin(container), std::end(container), std::move(predicate), pool))
+{
+    return concurrent::filter(std::begin(container), std::end(container), std::move(predicate), pool);
+}
+
+/**
+ * Maps every item in parallel and folds the mapped values into initial with reduceFunctor(result, mapped).
+ * The fold runs on a single thread in sequence order, so reduceFunctor needs neither locking nor associativity.
+ */
+template <typename Iterator, typename MapFunctor, typename ReduceFunctor, typename Result>
+Future<Result> reduce(Iterator begin,
+                      Iterator end,
+                      MapFunctor mapFunctor,
+                      ReduceFunctor reduceFunctor,
+                      Result initial,
+                      ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    return detail::startEngine<detail::ReduceEngine<Iterator, MapFunctor, ReduceFunctor, Result>, Result>(
+        false,
+        begin,
+        int64_t(std::distance(begin, end)),
+        std::move(mapFunctor),
+        std::move(reduceFunctor),
+        std::move(initial),
+        pool);
+}
+template <typename Container, typename MapFunctor, typename ReduceFunctor, typename Result>
+Future<Result> reduce(const Container &container,
+                      MapFunctor mapFunctor,
+                      ReduceFunctor reduceFunctor,
+                      Result initial,
+                      ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    return concurrent::reduce(std::begin(container),
+                              std::end(container),
+                              std::move(mapFunctor),
+                              std::move(reduceFunctor),
+                              std::move(initial),
+                              pool);
+}
+
+/**
+ * Calls functor(index) for every index in [first, last).
+ */
+template <typename Functor>
+Future<void> parallelFor(int64_t first, int64_t last, Functor functor, ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    return detail::startEngine<detail::ForEngine<Functor>, void>(false,
+                                                                 first,
+                                                                 std::max(int64_t(0), last - first),
+                                                                 std::move(functor),
+                                                                 pool);
+}
+template <typename Functor>
+void blockingParallelFor(int64_t first,
+                         int64_t last,
+                         Functor functor,
+                         ThreadPool *pool = ThreadPool::defaultInstance())
+{
+    detail::startEngine<detail::ForEngine<Functor>, void>(true,
+                                                          first,
+                                                          std::max(int64_t(0), last - first),
+                                                          std::move(functor),
+                                                          pool)
+        .result();
+}
 } // namespace concurrent
 
-OCTK_END_NAMESPACE
\ No newline at end of file
+/**
+ * @}
+ * @}
+ */
+
+OCTK_END_NAMESPACE
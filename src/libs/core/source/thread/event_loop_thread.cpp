@@ -1,5 +1,123 @@
-//
-// Created by cxw on 2026/1/12.
-//
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
 
-#include "event_loop_thread.hpp"
+#include <openctk/core/detail/platform_thread_p.hpp>
+#include <openctk/core/event_loop_thread.hpp>
+
+#if OCTK_FEATURE_ENABLE_KERNEL
+
+OCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+class ExitEvent : public Event
+{
+public:
+    explicit ExitEvent(int retCode)
+        : Event(Type::kQuit)
+        , mRetCode(retCode)
+    {
+    }
+
+    int retCode() const { return mRetCode; }
+
+private:
+    const int mRetCode;
+};
+
+class ExitEventReceiver : public Object
+{
+public:
+    explicit ExitEventReceiver(EventLoop *eventLoop)
+        : mEventLoop(eventLoop)
+    {
+    }
+
+    bool event(Event *event) override
+    {
+        if (Event::Type::kQuit == event->type())
+        {
+            mEventLoop->exit(static_cast<ExitEvent *>(event)->retCode());
+            return true;
+        }
+        return Object::event(event);
+    }
+
+private:
+    EventLoop *const mEventLoop;
+};
+} // namespace detail
+
+class EventLoopThreadPrivate : public PlatformThreadPrivate
+{
+public:
+    explicit EventLoopThreadPrivate(EventLoopThread *p)
+        : PlatformThreadPrivate(p)
+        , mExitEventReceiver(&mEventLoop)
+    {
+    }
+    ~EventLoopThreadPrivate() override { }
+
+    EventLoop mEventLoop;
+    detail::ExitEventReceiver mExitEventReceiver;
+};
+
+EventLoopThread::EventLoopThread()
+    : PlatformThread(new EventLoopThreadPrivate(this))
+{
+    this->setName("EventLoopThread", this);
+}
+
+EventLoopThread::~EventLoopThread()
+{
+    if (this->isRunning())
+    {
+        this->quit();
+        this->wait();
+    }
+}
+
+EventLoop *EventLoopThread::eventLoop() const
+{
+    OCTK_D(const EventLoopThread);
+    return const_cast<EventLoop *>(&d->mEventLoop);
+}
+
+void EventLoopThread::exit(int retCode)
+{
+    OCTK_D(EventLoopThread);
+    d->mEventLoop.postEvent(&d->mExitEventReceiver, new detail::ExitEvent(retCode));
+}
+
+void EventLoopThread::quit() { this->exit(0); }
+
+void EventLoopThread::run()
+{
+    OCTK_D(EventLoopThread);
+    d->mEventLoop.exec();
+}
+
+OCTK_END_NAMESPACE
+
+#endif // #if OCTK_FEATURE_ENABLE_KERNEL
@@ -24,24 +24,39 @@
 
 #pragma once
 
-#include <openctk/core/object.hpp>
+#include <openctk/core/event_loop.hpp>
 #include <openctk/core/platform_thread.hpp>
-#include <openctk/core/task_queue_thread.hpp>
+
+#if OCTK_FEATURE_ENABLE_KERNEL
 
 OCTK_BEGIN_NAMESPACE
 
-#if 0
-class EventLoopPrivate;
-class OCTK_CORE_API EventLoopThread : public Qbject, public PlatformThread
+/**
+ * @brief PlatformThread running an EventLoop.
+ *
+ * The loop exists as soon as the thread object is constructed, so events and timers can be registered before start().
+ * quit() posts a quit event, it is honoured even if the thread has not entered exec() yet.
+ */
+class EventLoopThreadPrivate;
+class OCTK_CORE_API EventLoopThread : public PlatformThread
 {
 public:
-    explicit EventLoopThread(Object *parent = nullptr);
+    EventLoopThread();
     ~EventLoopThread() override;
 
+    EventLoop *eventLoop() const;
+
+    void exit(int retCode = 0);
+    void quit();
+
+protected:
+    void run() override;
+
 private:
     OCTK_DECLARE_PRIVATE(EventLoopThread)
     OCTK_DISABLE_COPY_MOVE(EventLoopThread)
 };
-#endif
 
-OCTK_END_NAMESPACE
\ No newline at end of file
+OCTK_END_NAMESPACE
+
+#endif // #if OCTK_FEATURE_ENABLE_KERNEL
\ No newline at end of file
@@ -22,9 +22,194 @@
 **
 ***********************************************************************************************************************/
 
-#include "future.hpp"
+#include <openctk/core/task_queue.hpp>
+#include <openctk/core/thread_pool.hpp>
+#include <openctk/core/future.hpp>
+#include <openctk/core/logging.hpp>
+
+#include <algorithm>
+#include <future>
 
 OCTK_BEGIN_NAMESPACE
 
+void Executor::execute(Function function) const
+{
+    switch (mType)
+    {
+        case Type::kThreadPool:
+        {
+            static_cast<ThreadPool *>(mTarget)->start(Task::create(Task::UniqueFunc(std::move(function))));
+            break;
+        }
+        case Type::kTaskQueue:
+        {
+            static_cast<TaskQueueBase *>(mTarget)->postTask(std::move(function));
+            break;
+        }
+        default:
+        {
+            std::move(function)();
+            break;
+        }
+    }
+}
+
+namespace detail
+{
+std::exception_ptr makeBrokenPromiseException()
+{
+#if OCTK_HAS_EXCEPTIONS
+    return std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+#else
+    return nullptr;
+#endif
+}
+
+void FutureStateBase::cancel()
+{
+    mCanceled.store(true, std::memory_order_release);
+    std::shared_ptr<FutureStateBase> upstream;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        upstream = mUpstream.lock();
+    }
+    if (upstream && !upstream->isFinished())
+    {
+        upstream->cancel();
+    }
+}
+
+void FutureStateBase::setUpstream(const std::shared_ptr<FutureStateBase> &upstream)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mUpstream = upstream;
+}
+
+void FutureStateBase::setProgressRange(int64_t minimum, int64_t maximum)
+{
+    mProgressMinimum.store(minimum, std::memory_order_relaxed);
+    mProgressMaximum.store(std::max(minimum, maximum), std::memory_order_relaxed);
+    mProgressValue.store(minimum, std::memory_order_relaxed);
+}
+
+void FutureStateBase::wait() const
+{
+    if (this->isFinished())
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait(lock, [this]() { return this->isFinished(); });
+}
+
+bool FutureStateBase::waitFor(int64_t msecs) const
+{
+    if (this->isFinished())
+    {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mCondition.wait_for(lock, std::chrono::milliseconds(msecs), [this]() { return this->isFinished(); });
+}
+
+bool FutureStateBase::hasException() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return nullptr != mException;
+}
+
+std::exception_ptr FutureStateBase::exception() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mException;
+}
+
+void FutureStateBase::reportException(std::exception_ptr exception)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mException)
+    {
+        mException = std::move(exception);
+    }
+}
+
+void FutureStateBase::rethrowIfException() const
+{
+    std::exception_ptr exception = this->exception();
+    if (exception)
+    {
+#if OCTK_HAS_EXCEPTIONS
+        std::rethrow_exception(exception);
+#else
+        OCTK_FATAL("Future: rethrow exception while exceptions are disabled");
+#endif
+    }
+}
+
+bool FutureStateBase::reportFinished()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (this->isFinished())
+    {
+        return false;
+    }
+    return this->finishLocked(lock);
+}
+
+bool FutureStateBase::reportFinishedWithException(std::exception_ptr exception)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (this->isFinished())
+    {
+        return false;
+    }
+    if (!mException)
+    {
+        mException = std::move(exception);
+    }
+    return this->finishLocked(lock);
+}
+
+void FutureStateBase::addContinuation(Continuation continuation)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (this->isFinished())
+    {
+        lock.unlock();
+        continuation(*this);
+        return;
+    }
+    if (!mContinuation)
+    {
+        mContinuation = std::move(continuation);
+    }
+    else
+    {
+        mMoreContinuations.push_back(std::move(continuation));
+    }
+}
+
+bool FutureStateBase::finishLocked(std::unique_lock<std::mutex> &lock)
+{
+    mFinished.store(true, std::memory_order_release);
+    Continuation continuation = std::move(mContinuation);
+    std::vector<Continuation> moreContinuations;
+    moreContinuations.swap(mMoreContinuations);
+    lock.unlock();
+    mCondition.notify_all();
+
+    // continuations may drop the last external reference of this state
+    const auto self = this->shared_from_this();
+    if (continuation)
+    {
+        continuation(*this);
+    }
+    for (auto &item : moreContinuations)
+    {
+        item(*this);
+    }
+    return true;
+}
+} // namespace detail
 
 OCTK_END_NAMESPACE
@@ -24,8 +24,731 @@
 
 #pragma once
 
-#include <openctk/core/global.hpp>
+#include <openctk/core/unique_function.hpp>
+#include <openctk/core/optional.hpp>
+#include <openctk/core/assert.hpp>
+
+#include <condition_variable>
+#include <type_traits>
+#include <exception>
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <mutex>
 
 OCTK_BEGIN_NAMESPACE
 
-OCTK_END_NAMESPACE
\ No newline at end of file
+class ThreadPool;
+class TaskQueueBase;
+
+/**
+ * @brief Selects where a Future continuation runs.
+ *
+ * Executor is a small value type referring to a ThreadPool or a TaskQueueBase, the referenced object has to outlive
+ * every continuation scheduled on it. The default executor runs continuations inline, on the thread finishing the
+ * previous stage or calling then() if that stage already finished.
+ */
+class OCTK_CORE_API Executor final
+{
+public:
+    using Function = UniqueFunction<void() &&>;
+
+    enum class Type
+    {
+        kInline,
+        kThreadPool,
+        kTaskQueue
+    };
+
+    Executor() = default;
+    Executor(ThreadPool *threadPool)
+        : mType(nullptr != threadPool ? Type::kThreadPool : Type::kInline)
+        , mTarget(threadPool)
+    {
+    }
+    Executor(TaskQueueBase *taskQueue)
+        : mType(nullptr != taskQueue ? Type::kTaskQueue : Type::kInline)
+        , mTarget(taskQueue)
+    {
+    }
+
+    static Executor inlineExecutor() { return Executor(); }
+
+    Type type() const { return mType; }
+    bool isInline() const { return Type::kInline == mType; }
+
+    void execute(Function function) const;
+
+private:
+    Type mType{Type::kInline};
+    void *mTarget{nullptr};
+};
+
+template <typename T>
+class Future;
+template <typename T>
+class Promise;
+
+namespace detail
+{
+/**
+ * @brief Type independent part of the state shared between a Future and the code producing its result.
+ *
+ * Progress values and the canceled flag are lock free so producers can update them per work item,
+ * the mutex only guards the finished transition, the exception, the result and the continuations.
+ */
+class OCTK_CORE_API FutureStateBase : public std::enable_shared_from_this<FutureStateBase>
+{
+public:
+    OCTK_STATIC_CONSTANT_NUMBER(kContinuationCapacity, 64)
+    /**
+     * Invoked once with the finished state, small continuations are stored without allocation.
+     */
+    using Continuation = InplaceUniqueFunction<void(FutureStateBase &state), kContinuationCapacity>;
+
+    FutureStateBase() = default;
+    virtual ~FutureStateBase() = default;
+
+    bool isFinished() const { return mFinished.load(std::memory_order_acquire); }
+    bool isCanceled() const { return mCanceled.load(std::memory_order_acquire); }
+    /**
+     * Requests cancellation of this and the upstream stages, producers stop at their next check and still finish.
+     */
+    void cancel();
+    /**
+     * Links the stage this state continues, cancel() is forwarded to it.
+     */
+    void setUpstream(const std::shared_ptr<FutureStateBase> &upstream);
+
+    int64_t progressMinimum() const { return mProgressMinimum.load(std::memory_order_relaxed); }
+    int64_t progressMaximum() const { return mProgressMaximum.load(std::memory_order_relaxed); }
+    int64_t progressValue() const { return mProgressValue.load(std::memory_order_relaxed); }
+    void setProgressRange(int64_t minimum, int64_t maximum);
+    void addProgressValue(int64_t delta) { mProgressValue.fetch_add(delta, std::memory_order_relaxed); }
+
+    void wait() const;
+    /**
+     * @return false if the state did not finish within msecs milliseconds.
+     */
+    bool waitFor(int64_t msecs) const;
+
+    bool hasException() const;
+    std::exception_ptr exception() const;
+    /**
+     * Stores the exception, the first reported exception wins. Does not finish the state.
+     */
+    void reportException(std::exception_ptr exception);
+    /**
+     * Rethrows the exception reported by the producer, aborts instead when exceptions are disabled.
+     */
+    void rethrowIfException() const;
+
+    /**
+     * Marks the state finished, wakes all waiters and runs the continuations. Only the first call has an effect.
+     * @return true if this call finished the state.
+     */
+    bool reportFinished();
+    bool reportFinishedWithException(std::exception_ptr exception);
+
+    /**
+     * Runs continuation once the state finished, immediately on the calling thread if it already is.
+     */
+    void addContinuation(Continuation continuation);
+
+protected:
+    /**
+     * Finishes the state, lock must hold mMutex and is released.
+     */
+    bool finishLocked(std::unique_lock<std::mutex> &lock);
+
+    mutable std::mutex mMutex;
+    mutable std::condition_variable mCondition;
+    std::exception_ptr mException;
+    std::weak_ptr<FutureStateBase> mUpstream;
+    Continuation mContinuation;
+    std::vector<Continuation> mMoreContinuations;
+    std::atomic<bool> mFinished{false};
+    std::atomic<bool> mCanceled{false};
+    std::atomic<int64_t> mProgressMinimum{0};
+    std::atomic<int64_t> mProgressMaximum{0};
+    std::atomic<int64_t> mProgressValue{0};
+};
+
+template <typename T>
+class FutureState : public FutureStateBase
+{
+public:
+    /**
+     * Stores the result and finishes the state, ignored if the state already finished.
+     */
+    bool reportResult(T value)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (this->isFinished())
+        {
+            return false;
+        }
+        mResult = std::move(value);
+        return this->finishLocked(lock);
+    }
+    /**
+     * Only valid once the state finished with a result.
+     */
+    const T &result() const { return *mResult; }
+    bool hasResult() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mResult.has_value();
+    }
+    /**
+     * @return true if the state finished with a result, as opposed to an exception or a cancellation.
+     */
+    bool isSucceeded() const { return this->isFinished() && this->hasResult(); }
+
+private:
+    Optional<T> mResult;
+};
+
+template <>
+class FutureState<void> : public FutureStateBase
+{
+public:
+    bool reportResult()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (this->isFinished())
+        {
+            return false;
+        }
+        mHasResult = true;
+        return this->finishLocked(lock);
+    }
+    bool hasResult() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mHasResult;
+    }
+    /**
+     * @return true if the state finished with a result, as opposed to an exception or a cancellation.
+     */
+    bool isSucceeded() const { return this->isFinished() && this->hasResult(); }
+
+private:
+    bool mHasResult{false};
+};
+
+template <typename T>
+struct IsFuture : std::false_type
+{
+};
+template <typename T>
+struct IsFuture<Future<T>> : std::true_type
+{
+};
+
+template <typename T>
+struct UnwrapFuture
+{
+    using Type = T;
+};
+template <typename T>
+struct UnwrapFuture<Future<T>>
+{
+    using Type = T;
+};
+
+template <typename T>
+struct FutureInvoker
+{
+    template <typename Functor>
+    static auto invoke(Functor &functor, const FutureState<T> &state) -> decltype(functor(state.result()))
+    {
+        return functor(state.result());
+    }
+};
+template <>
+struct FutureInvoker<void>
+{
+    template <typename Functor>
+    static auto invoke(Functor &functor, const FutureState<void> &) -> decltype(functor())
+    {
+        return functor();
+    }
+};
+
+/**
+ * Finishes target like source finished: with the result, the exception or canceled.
+ */
+template <typename T>
+void forwardFutureState(FutureState<T> &source, FutureState<T> &target);
+
+template <typename T>
+struct FutureForwarder
+{
+    static void forward(FutureState<T> &source, FutureState<T> &target) { target.reportResult(source.result()); }
+};
+template <>
+struct FutureForwarder<void>
+{
+    static void forward(FutureState<void> &, FutureState<void> &target) { target.reportResult(); }
+};
+
+template <typename T>
+void forwardFutureState(FutureState<T> &source, FutureState<T> &target)
+{
+    if (source.hasException())
+    {
+        target.reportFinishedWithException(source.exception());
+    }
+    else if (source.isSucceeded())
+    {
+        FutureForwarder<T>::forward(source, target);
+    }
+    else
+    {
+        target.cancel();
+        target.reportFinished();
+    }
+}
+
+/**
+ * Completes a continuation state with the value returned by the continuation functor.
+ */
+template <typename R>
+struct FutureResolver
+{
+    template <typename Call>
+    static void resolve(const std::shared_ptr<FutureState<R>> &state, Call &&call)
+    {
+        state->reportResult(call());
+    }
+};
+template <>
+struct FutureResolver<void>
+{
+    template <typename Call>
+    static void resolve(const std::shared_ptr<FutureState<void>> &state, Call &&call)
+    {
+        call();
+        state->reportResult();
+    }
+};
+template <typename U>
+struct FutureResolver<Future<U>>
+{
+    template <typename Call>
+    static void resolve(const std::shared_ptr<FutureState<U>> &state, Call &&call)
+    {
+        const Future<U> inner = call();
+        if (!inner.isValid())
+        {
+            state->cancel();
+            state->reportFinished();
+            return;
+        }
+        state->setUpstream(inner.state());
+        inner.state()->addContinuation(
+            [state](FutureStateBase &source)
+            { forwardFutureState(static_cast<FutureState<U> &>(source), *state); });
+    }
+};
+
+template <typename R, typename Call>
+void resolveFutureState(const std::shared_ptr<FutureState<typename UnwrapFuture<R>::Type>> &state, Call &&call)
+{
+#if OCTK_HAS_EXCEPTIONS
+    try
+    {
+        FutureResolver<R>::resolve(state, std::forward<Call>(call));
+    }
+    catch (...)
+    {
+        state->reportFinishedWithException(std::current_exception());
+    }
+#else
+    FutureResolver<R>::resolve(state, std::forward<Call>(call));
+#endif
+}
+} // namespace detail
+
+/**
+ * @brief Handle to the result of an asynchronous computation.
+ *
+ * Futures are cheap to copy, all copies observe the same state. Besides the result a Future exposes the progress
+ * of the computation, allows requesting its cancellation and chains further work with then().
+ * Results are produced by a Promise or by the algorithms in the concurrent namespace.
+ *
+ * valid(), wait_for(), wait_until() and get() mirror std::future, so code written against std::future keeps
+ * compiling. Unlike std::future::get(), get() can be called more than once and returns a reference.
+ */
+template <typename T>
+class FutureBase
+{
+public:
+    using State = detail::FutureState<T>;
+    using StatePtr = std::shared_ptr<State>;
+
+    FutureBase() = default;
+    explicit FutureBase(StatePtr state)
+        : mState(std::move(state))
+    {
+    }
+
+    bool isValid() const { return nullptr != mState; }
+    bool isFinished() const { return mState && mState->isFinished(); }
+    bool isCanceled() const { return mState && mState->isCanceled(); }
+    bool hasException() const { return mState && mState->hasException(); }
+    /**
+     * @return true if the computation finished with a result, as opposed to an exception or a cancellation.
+     */
+    bool isSucceeded() const { return mState && mState->isSucceeded(); }
+    /**
+     * Requests cancellation of this computation and of the stages it continues.
+     */
+    void cancel()
+    {
+        if (mState)
+        {
+            mState->cancel();
+        }
+    }
+
+    int64_t progressMinimum() const { return mState ? mState->progressMinimum() : 0; }
+    int64_t progressMaximum() const { return mState ? mState->progressMaximum() : 0; }
+    int64_t progressValue() const { return mState ? mState->progressValue() : 0; }
+
+    void wait() const
+    {
+        if (mState)
+        {
+            mState->wait();
+        }
+    }
+    bool waitFor(int64_t msecs) const { return !mState || mState->waitFor(msecs); }
+
+    bool valid() const { return this->isValid(); }
+    template <typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period> &timeout) const
+    {
+        auto msecs = std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
+        if (msecs < timeout)
+        {
+            ++msecs;
+        }
+        const int64_t count = std::max<int64_t>(msecs.count(), 0);
+        return this->waitFor(count) ? std::future_status::ready : std::future_status::timeout;
+    }
+    template <typename Clock, typename Duration>
+    std::future_status wait_until(const std::chrono::time_point<Clock, Duration> &deadline) const
+    {
+        return this->wait_for(deadline - Clock::now());
+    }
+
+    /**
+     * Runs functor with the result once this future succeeded and returns a future of the functor's return value.
+     * A functor returning a Future is unwrapped, the returned future finishes with the inner one.
+     * Exceptions and cancellation skip the functor and propagate to the returned future.
+     *
+     * @param executor selects where functor runs, inline by default.
+     */
+    template <typename Functor,
+              typename R = decltype(detail::FutureInvoker<T>::invoke(std::declval<Functor &>(), std::declval<const State &>()))>
+    Future<typename detail::UnwrapFuture<R>::Type> then(Executor executor, Functor functor) const
+    {
+        using Result = typename detail::UnwrapFuture<R>::Type;
+        OCTK_ASSERT(mState);
+        auto next = std::make_shared<detail::FutureState<Result>>();
+        next->setUpstream(mState);
+        mState->addContinuation(
+            [executor, next, functor = std::move(functor)](detail::FutureStateBase &base) mutable
+            {
+                auto &state = static_cast<State &>(base);
+                if (state.hasException())
+                {
+                    next->reportFinishedWithException(state.exception());
+                    return;
+                }
+                if (!state.isSucceeded() || next->isCanceled())
+                {
+                    next->cancel();
+                    next->reportFinished();
+                    return;
+                }
+                if (executor.isInline())
+                {
+                    detail::resolveFutureState<R>(next,
+                                                  [&]() -> R { return detail::FutureInvoker<T>::invoke(functor, state); });
+                    return;
+                }
+                // the upstream state is kept alive by the executed function through its own reference
+                auto upstream = std::static_pointer_cast<State>(state.shared_from_this());
+                executor.execute(
+                    [next, upstream, functor = std::move(functor)]() mutable
+                    {
+                        if (next->isCanceled())
+                        {
+                            next->reportFinished();
+                            return;
+                        }
+                        detail::resolveFutureState<R>(
+                            next,
+                            [&]() -> R { return detail::FutureInvoker<T>::invoke(functor, *upstream); });
+                    });
+            });
+        return Future<Result>(next);
+    }
+    template <typename Functor,
+              typename R = decltype(detail::FutureInvoker<T>::invoke(std::declval<Functor &>(), std::declval<const State &>()))>
+    Future<typename detail::UnwrapFuture<R>::Type> then(Functor functor) const
+    {
+        return this->then(Executor::inlineExecutor(), std::move(functor));
+    }
+
+    const StatePtr &state() const { return mState; }
+
+protected:
+    StatePtr mState;
+};
+
+template <typename T>
+class Future : public FutureBase<T>
+{
+public:
+    using FutureBase<T>::FutureBase;
+
+    /**
+     * Waits for the computation and returns its result, rethrows the exception reported by the producer.
+     * A canceled computation has no result, check isCanceled() first.
+     */
+    const T &result() const
+    {
+        OCTK_ASSERT(this->mState);
+        this->mState->wait();
+        this->mState->rethrowIfException();
+        OCTK_ASSERT(this->mState->hasResult());
+        return this->mState->result();
+    }
+    const T &get() const { return this->result(); }
+};
+
+template <>
+class Future<void> : public FutureBase<void>
+{
+public:
+    using FutureBase<void>::FutureBase;
+
+    void result() const
+    {
+        OCTK_ASSERT(mState);
+        mState->wait();
+        mState->rethrowIfException();
+    }
+    void get() const { this->result(); }
+};
+
+/**
+ * @brief Producer side of a Future.
+ *
+ * A Promise is move only. Destroying a Promise whose future has not finished yet finishes it with a
+ * std::future_error(broken_promise) exception, or canceled when exceptions are disabled.
+ */
+template <typename T>
+class PromiseBase
+{
+public:
+    using State = detail::FutureState<T>;
+
+    PromiseBase()
+        : mState(std::make_shared<State>())
+    {
+    }
+    PromiseBase(const PromiseBase &) = delete;
+    PromiseBase &operator=(const PromiseBase &) = delete;
+    PromiseBase(PromiseBase &&other) = default;
+    PromiseBase &operator=(PromiseBase &&other)
+    {
+        if (this != &other)
+        {
+            this->breakPromise();
+            mState = std::move(other.mState);
+        }
+        return *this;
+    }
+    ~PromiseBase() { this->breakPromise(); }
+
+    Future<T> future() const { return Future<T>(mState); }
+
+    /**
+     * Producers should poll this and stop early, the future still has to be finished.
+     */
+    bool isCanceled() const { return mState && mState->isCanceled(); }
+    bool isFinished() const { return mState && mState->isFinished(); }
+
+    void setProgressRange(int64_t minimum, int64_t maximum) { mState->setProgressRange(minimum, maximum); }
+    void addProgressValue(int64_t delta) { mState->addProgressValue(delta); }
+
+    bool setException(std::exception_ptr exception) { return mState->reportFinishedWithException(std::move(exception)); }
+    /**
+     * Finishes the future without result, e.g. after the producer noticed isCanceled().
+     */
+    bool setCanceled()
+    {
+        mState->cancel();
+        return mState->reportFinished();
+    }
+
+protected:
+    void breakPromise();
+
+    std::shared_ptr<State> mState;
+};
+
+template <typename T>
+class Promise : public PromiseBase<T>
+{
+public:
+    Promise() = default;
+    Promise(Promise &&other) = default;
+    Promise &operator=(Promise &&other) = default;
+
+    bool setValue(T value) { return this->mState->reportResult(std::move(value)); }
+};
+
+template <>
+class Promise<void> : public PromiseBase<void>
+{
+public:
+    Promise() = default;
+    Promise(Promise &&other) = default;
+    Promise &operator=(Promise &&other) = default;
+
+    bool setValue() { return mState->reportResult(); }
+};
+
+namespace detail
+{
+OCTK_CORE_API std::exception_ptr makeBrokenPromiseException();
+} // namespace detail
+
+template <typename T>
+void PromiseBase<T>::breakPromise()
+{
+    if (mState && !mState->isFinished())
+    {
+        std::exception_ptr exception = detail::makeBrokenPromiseException();
+        if (exception)
+        {
+            mState->reportFinishedWithException(exception);
+        }
+        else
+        {
+            this->setCanceled();
+        }
+    }
+}
+
+/**
+ * @return an already finished future holding value.
+ */
+template <typename T>
+Future<typename std::decay<T>::type> makeReadyFuture(T &&value)
+{
+    Promise<typename std::decay<T>::type> promise;
+    promise.setValue(std::forward<T>(value));
+    return promise.future();
+}
+inline Future<void> makeReadyFuture()
+{
+    Promise<void> promise;
+    promise.setValue();
+    return promise.future();
+}
+template <typename T>
+Future<T> makeExceptionalFuture(std::exception_ptr exception)
+{
+    Promise<T> promise;
+    promise.setException(std::move(exception));
+    return promise.future();
+}
+
+/**
+ * @return a future finishing once every future in futures finished, holding the input futures.
+ */
+template <typename T>
+Future<std::vector<Future<T>>> whenAll(std::vector<Future<T>> futures)
+{
+    struct Context
+    {
+        std::vector<Future<T>> futures;
+        std::atomic<size_t> remaining;
+        Promise<std::vector<Future<T>>> promise;
+    };
+    auto context = std::make_shared<Context>();
+    context->remaining.store(futures.size());
+    context->futures = std::move(futures);
+    auto future = context->promise.future();
+    if (context->futures.empty())
+    {
+        context->promise.setValue({});
+        return future;
+    }
+    for (const auto &item : context->futures)
+    {
+        OCTK_ASSERT(item.isValid());
+        item.state()->addContinuation(
+            [context](detail::FutureStateBase &)
+            {
+                if (1 == context->remaining.fetch_sub(1, std::memory_order_acq_rel))
+                {
+                    context->promise.setValue(std::move(context->futures));
+                }
+            });
+    }
+    return future;
+}
+
+template <typename T>
+struct WhenAnyResult
+{
+    size_t index;
+    Future<T> future;
+};
+
+/**
+ * @return a future finishing with the first finished future of futures and its index, canceled if futures is empty.
+ */
+template <typename T>
+Future<WhenAnyResult<T>> whenAny(const std::vector<Future<T>> &futures)
+{
+    struct Context
+    {
+        std::atomic<bool> done{false};
+        Promise<WhenAnyResult<T>> promise;
+    };
+    auto context = std::make_shared<Context>();
+    auto future = context->promise.future();
+    if (futures.empty())
+    {
+        context->promise.setCanceled();
+        return future;
+    }
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        OCTK_ASSERT(futures[i].isValid());
+        const Future<T> item = futures[i];
+        item.state()->addContinuation(
+            [context, i, item](detail::FutureStateBase &)
+            {
+                if (!context->done.exchange(true, std::memory_order_acq_rel))
+                {
+                    context->promise.setValue(WhenAnyResult<T>{i, item});
+                }
+            });
+    }
+    return future;
+}
+
+OCTK_END_NAMESPACE
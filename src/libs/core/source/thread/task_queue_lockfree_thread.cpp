@@ -0,0 +1,612 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include "task_queue_lockfree_thread.hpp"
+#include <openctk/core/date_time.hpp>
+#include <openctk/core/semaphore.hpp>
+
+#include <mutex>
+#include <array>
+#include <limits>
+#include <thread>
+#include <algorithm>
+#include <condition_variable>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+enum TaskHandleState : int
+{
+    kTaskPending = 0,
+    kTaskRunning,
+    kTaskCanceled
+};
+
+struct LockFreeTaskNode
+{
+    std::atomic<LockFreeTaskNode *> next{nullptr};
+    LockFreeTaskNode *listNext{nullptr};
+    Task::SharedPtr task;
+    int64_t deadline{0}; // usecs, 0 for immediate tasks
+    TaskQueueLockFreeThread::TaskHandle::State state;
+
+    bool isCanceled() const { return state && kTaskCanceled == state->load(std::memory_order_acquire); }
+};
+
+/**
+ * Intrusive multi-producer single-consumer queue (Dmitry Vyukov), push() is wait-free and pop() is lock-free.
+ */
+class LockFreeTaskQueue
+{
+public:
+    LockFreeTaskQueue()
+        : mHead(&mStub)
+        , mTail(&mStub)
+    {
+    }
+
+    void push(LockFreeTaskNode *node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        auto prev = mHead.exchange(node);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * Consumer only, returns nullptr when empty or when a producer is in the middle of a push.
+     */
+    LockFreeTaskNode *pop()
+    {
+        auto tail = mTail;
+        auto next = tail->next.load(std::memory_order_acquire);
+        if (&mStub == tail)
+        {
+            if (!next)
+            {
+                return nullptr;
+            }
+            mTail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next)
+        {
+            mTail = next;
+            return tail;
+        }
+        if (tail != mHead.load())
+        {
+            return nullptr;
+        }
+        this->push(&mStub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next)
+        {
+            mTail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Consumer only and valid after pop() returned nullptr, false if a push was started since then.
+     */
+    bool isEmpty() const { return mHead.load() == mTail; }
+
+private:
+    std::atomic<LockFreeTaskNode *> mHead;
+    LockFreeTaskNode *mTail;
+    LockFreeTaskNode mStub;
+};
+
+/**
+ * Intrusive FIFO list of nodes owned by the queue thread.
+ */
+struct LockFreeTaskList
+{
+    LockFreeTaskNode *head{nullptr};
+    LockFreeTaskNode *tail{nullptr};
+
+    bool isEmpty() const { return nullptr == head; }
+    void append(LockFreeTaskNode *node)
+    {
+        node->listNext = nullptr;
+        if (tail)
+        {
+            tail->listNext = node;
+        }
+        else
+        {
+            head = node;
+        }
+        tail = node;
+    }
+    void append(LockFreeTaskList &other)
+    {
+        if (other.head)
+        {
+            if (tail)
+            {
+                tail->listNext = other.head;
+            }
+            else
+            {
+                head = other.head;
+            }
+            tail = other.tail;
+            other.head = other.tail = nullptr;
+        }
+    }
+    LockFreeTaskNode *takeFirst()
+    {
+        auto node = head;
+        if (node)
+        {
+            head = node->listNext;
+            if (!head)
+            {
+                tail = nullptr;
+            }
+            node->listNext = nullptr;
+        }
+        return node;
+    }
+};
+
+/**
+ * Hierarchical timer wheel with kLevels levels of kSlots slots, one tick is one millisecond.
+ * Level n holds the tasks that expire within kSlots^(n+1) ticks, they cascade down one level when the lower level
+ * wraps around. Tasks further away than the last level are parked in its farthest slot and re-inserted on cascade.
+ */
+class TimerWheel
+{
+public:
+    OCTK_STATIC_CONSTANT_NUMBER(kTickUSecs, 1000)
+    OCTK_STATIC_CONSTANT_NUMBER(kLevels, 4)
+    OCTK_STATIC_CONSTANT_NUMBER(kSlotBits, 8)
+    OCTK_STATIC_CONSTANT_NUMBER(kSlots, 1 << 8)
+    OCTK_STATIC_CONSTANT_NUMBER(kSlotMask, (1 << 8) - 1)
+
+    explicit TimerWheel(int64_t nowUSecs)
+        : mCurrentTick(nowUSecs / kTickUSecs)
+    {
+    }
+
+    static int64_t toTick(int64_t usecs) { return (usecs + kTickUSecs - 1) / kTickUSecs; }
+
+    size_t size() const { return mSize; }
+
+    /**
+     * Inserts @a node by its deadline, nodes that are already due go to @a expired.
+     */
+    void insert(LockFreeTaskNode *node, LockFreeTaskList &expired)
+    {
+        const int64_t tick = toTick(node->deadline);
+        if (tick <= mCurrentTick)
+        {
+            expired.append(node);
+            return;
+        }
+        const int64_t delta = tick - mCurrentTick;
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (int64_t(1) << (kSlotBits * (level + 1))))
+        {
+            ++level;
+        }
+        int64_t slotTick = tick;
+        const int64_t maxDelta = (int64_t(1) << (kSlotBits * kLevels)) - 1;
+        if (delta > maxDelta)
+        {
+            slotTick = mCurrentTick + maxDelta;
+        }
+        mSlots[level][(slotTick >> (kSlotBits * level)) & kSlotMask].append(node);
+        ++mSize;
+    }
+
+    /**
+     * Advances the wheel to @a nowUSecs and moves all expired nodes to @a expired, in deadline order.
+     */
+    void advance(int64_t nowUSecs, LockFreeTaskList &expired)
+    {
+        const int64_t nowTick = nowUSecs / kTickUSecs;
+        if (0 == mSize)
+        {
+            mCurrentTick = std::max(mCurrentTick, nowTick);
+            return;
+        }
+        while (mCurrentTick < nowTick && mSize > 0)
+        {
+            ++mCurrentTick;
+            for (int level = 1; level < kLevels; ++level)
+            {
+                // cascade the next slot of the upper level when the lower level wraps around
+                if (0 != ((mCurrentTick >> (kSlotBits * (level - 1))) & kSlotMask))
+                {
+                    break;
+                }
+                this->cascade(level, expired);
+            }
+            auto &slot = mSlots[0][mCurrentTick & kSlotMask];
+            while (auto node = slot.takeFirst())
+            {
+                --mSize;
+                expired.append(node);
+            }
+        }
+        mCurrentTick = std::max(mCurrentTick, nowTick);
+    }
+
+    /**
+     * Returns the earliest time in usecs at which advance() may expire a node, the result is never later than the
+     * actual deadline so the caller can sleep until then.
+     */
+    int64_t nextWakeUSecs() const
+    {
+        int64_t wakeTick = std::numeric_limits<int64_t>::max();
+        for (int level = 0; level < kLevels && mSize > 0; ++level)
+        {
+            const int shift = kSlotBits * level;
+            const int64_t index = mCurrentTick >> shift;
+            for (int64_t offset = 1; offset <= kSlots; ++offset)
+            {
+                if (!mSlots[level][(index + offset) & kSlotMask].isEmpty())
+                {
+                    // upper level slots cascade at their start tick, which is a lower bound of their deadlines
+                    wakeTick = std::min(wakeTick, (index + offset) << shift);
+                    break;
+                }
+            }
+        }
+        return std::numeric_limits<int64_t>::max() == wakeTick ? wakeTick : wakeTick * kTickUSecs;
+    }
+
+    /**
+     * Removes all nodes, used on shutdown.
+     */
+    void clear(LockFreeTaskList &removed)
+    {
+        for (auto &level : mSlots)
+        {
+            for (auto &slot : level)
+            {
+                removed.append(slot);
+            }
+        }
+        mSize = 0;
+    }
+
+    template <typename Func> void forEach(Func func)
+    {
+        for (auto &level : mSlots)
+        {
+            for (auto &slot : level)
+            {
+                for (auto node = slot.head; node; node = node->listNext)
+                {
+                    func(node);
+                }
+            }
+        }
+    }
+
+private:
+    void cascade(int level, LockFreeTaskList &expired)
+    {
+        auto &slot = mSlots[level][(mCurrentTick >> (kSlotBits * level)) & kSlotMask];
+        LockFreeTaskList nodes;
+        nodes.append(slot);
+        while (auto node = nodes.takeFirst())
+        {
+            --mSize;
+            this->insert(node, expired);
+        }
+    }
+
+    size_t mSize{0};
+    int64_t mCurrentTick{0};
+    std::array<std::array<LockFreeTaskList, kSlots>, kLevels> mSlots;
+};
+} // namespace detail
+
+class TaskQueueLockFreeThreadPrivate
+{
+    OCTK_DEFINE_PPTR(TaskQueueLockFreeThread)
+    OCTK_DECLARE_PUBLIC(TaskQueueLockFreeThread)
+    OCTK_DISABLE_COPY_MOVE(TaskQueueLockFreeThreadPrivate)
+public:
+    using Node = detail::LockFreeTaskNode;
+
+    explicit TaskQueueLockFreeThreadPrivate(TaskQueueLockFreeThread *p);
+    ~TaskQueueLockFreeThreadPrivate() = default;
+
+    void init();
+    void post(const Task::SharedPtr &task, int64_t deadline, const TaskQueueLockFreeThread::TaskHandle::State &state);
+    void wakeUp();
+    void sleep(int64_t deadline);
+    void receiveTasks();
+    bool cancel(const Task *task);
+    void clear();
+
+    std::thread mThread;
+    std::atomic<bool> mQuit{false};
+    std::atomic<bool> mSleeping{false};
+    detail::LockFreeTaskQueue mIncomingTasks;
+
+    // wake up state, only used when the queue thread sleeps
+    std::mutex mWakeUpMutex;
+    std::condition_variable mWakeUpCondition;
+    bool mWakeUp{false};
+
+    // owned by the queue thread
+    detail::LockFreeTaskList mReadyTasks;
+    detail::TimerWheel mDelayedTasks{DateTime::steadyTimeUSecs()};
+};
+
+TaskQueueLockFreeThreadPrivate::TaskQueueLockFreeThreadPrivate(TaskQueueLockFreeThread *p)
+    : mPPtr(p)
+{
+}
+
+void TaskQueueLockFreeThreadPrivate::init()
+{
+    Semaphore started;
+    mThread = std::thread(
+        [this, &started]()
+        {
+            OCTK_LOGGING_TRACE(OCTK_TASK_QUEUE_LOGGER(), "TaskQueueLockFreeThreadPrivate: thread started");
+            TaskQueueLockFreeThread::CurrentSetter currentSetter(mPPtr);
+            started.release();
+            mPPtr->processTasks();
+            OCTK_LOGGING_TRACE(OCTK_TASK_QUEUE_LOGGER(), "TaskQueueLockFreeThreadPrivate: thread finished");
+        });
+    started.acquire();
+}
+
+void TaskQueueLockFreeThreadPrivate::post(const Task::SharedPtr &task,
+                                          int64_t deadline,
+                                          const TaskQueueLockFreeThread::TaskHandle::State &state)
+{
+    auto node = new Node;
+    node->task = task;
+    node->deadline = deadline;
+    node->state = state;
+    mIncomingTasks.push(node);
+    // pairs with sleep(), either the queue thread sees the node or this thread sees it sleeping
+    if (mSleeping.load())
+    {
+        this->wakeUp();
+    }
+}
+
+void TaskQueueLockFreeThreadPrivate::wakeUp()
+{
+    std::lock_guard<std::mutex> lock(mWakeUpMutex);
+    mWakeUp = true;
+    mWakeUpCondition.notify_one();
+}
+
+void TaskQueueLockFreeThreadPrivate::sleep(int64_t deadline)
+{
+    mSleeping.store(true);
+    if (mIncomingTasks.isEmpty() && !mQuit.load())
+    {
+        std::unique_lock<std::mutex> lock(mWakeUpMutex);
+        if (std::numeric_limits<int64_t>::max() == deadline)
+        {
+            mWakeUpCondition.wait(lock, [this]() { return mWakeUp; });
+        }
+        else
+        {
+            const auto timeout = std::chrono::microseconds(std::max<int64_t>(deadline - DateTime::steadyTimeUSecs(), 0));
+            mWakeUpCondition.wait_for(lock, timeout, [this]() { return mWakeUp; });
+        }
+        mWakeUp = false;
+    }
+    mSleeping.store(false);
+}
+
+void TaskQueueLockFreeThreadPrivate::receiveTasks()
+{
+    while (auto node = mIncomingTasks.pop())
+    {
+        if (0 == node->deadline)
+        {
+            mReadyTasks.append(node);
+        }
+        else
+        {
+            mDelayedTasks.insert(node, mReadyTasks);
+        }
+    }
+    mDelayedTasks.advance(DateTime::steadyTimeUSecs(), mReadyTasks);
+}
+
+bool TaskQueueLockFreeThreadPrivate::cancel(const Task *task)
+{
+    this->receiveTasks();
+    bool canceled = false;
+    const auto cancelNode = [&](Node *node)
+    {
+        if (node->task.get() == task && !node->isCanceled())
+        {
+            if (!node->state)
+            {
+                node->state = std::make_shared<std::atomic<int>>(detail::kTaskPending);
+            }
+            int expected = detail::kTaskPending;
+            canceled = node->state->compare_exchange_strong(expected, detail::kTaskCanceled) || canceled;
+        }
+    };
+    for (auto node = mReadyTasks.head; node; node = node->listNext)
+    {
+        cancelNode(node);
+    }
+    mDelayedTasks.forEach(cancelNode);
+    return canceled;
+}
+
+void TaskQueueLockFreeThreadPrivate::clear()
+{
+    detail::LockFreeTaskList nodes;
+    nodes.append(mReadyTasks);
+    mDelayedTasks.clear(nodes);
+    do
+    {
+        while (auto node = mIncomingTasks.pop())
+        {
+            nodes.append(node);
+        }
+        while (auto node = nodes.takeFirst())
+        {
+            delete node;
+        }
+        // a producer may be in the middle of a push
+    } while (!mIncomingTasks.isEmpty());
+}
+
+bool TaskQueueLockFreeThread::TaskHandle::isPending() const
+{
+    return mState && detail::kTaskPending == mState->load(std::memory_order_acquire);
+}
+
+bool TaskQueueLockFreeThread::TaskHandle::cancel()
+{
+    if (!mState)
+    {
+        return false;
+    }
+    int expected = detail::kTaskPending;
+    return mState->compare_exchange_strong(expected, detail::kTaskCanceled) || detail::kTaskCanceled == expected;
+}
+
+TaskQueueLockFreeThread::TaskQueueLockFreeThread()
+    : mDPtr(new TaskQueueLockFreeThreadPrivate(this))
+{
+    mDPtr->init();
+}
+
+TaskQueueLockFreeThread::SharedPtr TaskQueueLockFreeThread::makeShared()
+{
+    return SharedPtr(new TaskQueueLockFreeThread, [](TaskQueueLockFreeThread *thread) { thread->destroy(); });
+}
+
+TaskQueueLockFreeThread::UniquePtr TaskQueueLockFreeThread::makeUnique()
+{
+    return UniquePtr(new TaskQueueLockFreeThread);
+}
+
+TaskQueueLockFreeThread::~TaskQueueLockFreeThread()
+{
+}
+
+void TaskQueueLockFreeThread::destroy()
+{
+    OCTK_D(TaskQueueLockFreeThread);
+    OCTK_LOGGING_TRACE(OCTK_TASK_QUEUE_LOGGER(), "TaskQueueLockFreeThread::destroy()");
+    OCTK_ASSERT(!this->isCurrent());
+    d->mQuit.store(true);
+    d->wakeUp();
+    if (d->mThread.joinable())
+    {
+        d->mThread.join();
+    }
+    delete this;
+}
+
+bool TaskQueueLockFreeThread::cancelTask(const Task *task)
+{
+    OCTK_D(TaskQueueLockFreeThread);
+    if (this->isCurrent())
+    {
+        return d->cancel(task);
+    }
+    bool canceled = false;
+    this->sendTask([d, task, &canceled]() { canceled = d->cancel(task); });
+    return canceled;
+}
+
+void TaskQueueLockFreeThread::postTask(const Task::SharedPtr &task, const SourceLocation &location)
+{
+    OCTK_D(TaskQueueLockFreeThread);
+    OCTK_UNUSED(location);
+    d->post(task, 0, nullptr);
+}
+
+void TaskQueueLockFreeThread::postDelayedTask(const Task::SharedPtr &task,
+                                              const TimeDelta &delay,
+                                              const SourceLocation &location)
+{
+    OCTK_D(TaskQueueLockFreeThread);
+    OCTK_UNUSED(location);
+    d->post(task, DateTime::steadyTimeUSecs() + std::max<int64_t>(delay.us(), 1), nullptr);
+}
+
+TaskQueueLockFreeThread::TaskHandle TaskQueueLockFreeThread::postCancelableTask(const Task::SharedPtr &task,
+                                                                                const SourceLocation &location)
+{
+    OCTK_D(TaskQueueLockFreeThread);
+    OCTK_UNUSED(location);
+    auto state = std::make_shared<std::atomic<int>>(detail::kTaskPending);
+    d->post(task, 0, state);
+    return TaskHandle(state);
+}
+
+TaskQueueLockFreeThread::TaskHandle TaskQueueLockFreeThread::postCancelableDelayedTask(
+    const Task::SharedPtr &task,
+    const TimeDelta &delay,
+    const SourceLocation &location)
+{
+    OCTK_D(TaskQueueLockFreeThread);
+    OCTK_UNUSED(location);
+    auto state = std::make_shared<std::atomic<int>>(detail::kTaskPending);
+    d->post(task, DateTime::steadyTimeUSecs() + std::max<int64_t>(delay.us(), 1), state);
+    return TaskHandle(state);
+}
+
+void TaskQueueLockFreeThread::processTasks()
+{
+    OCTK_D(TaskQueueLockFreeThread);
+    while (!d->mQuit.load())
+    {
+        d->receiveTasks();
+        if (auto node = d->mReadyTasks.takeFirst())
+        {
+            int expected = detail::kTaskPending;
+            if (!node->state || node->state->compare_exchange_strong(expected, detail::kTaskRunning))
+            {
+                node->task->run();
+            }
+            delete node;
+            // Attempt to run more tasks before going to sleep.
+            continue;
+        }
+        d->sleep(d->mDelayedTasks.nextWakeUSecs());
+    }
+    OCTK_LOGGING_TRACE(OCTK_TASK_QUEUE_LOGGER(), "TaskQueueLockFreeThread::processTasks() break loop");
+    // Ensure remaining deleted tasks are destroyed with Current() set up to this task queue.
+    d->clear();
+}
+
+OCTK_END_NAMESPACE
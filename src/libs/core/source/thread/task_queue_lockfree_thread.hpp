@@ -0,0 +1,123 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#pragma once
+
+#include <openctk/core/task_queue.hpp>
+#include <openctk/core/logging.hpp>
+
+#include <atomic>
+
+OCTK_BEGIN_NAMESPACE
+
+/**
+ * TaskQueueLockFreeThread is a TaskQueueThread variant for queues that receive a lot of small tasks.
+ * Posting a task is a wait-free push onto a multi-producer single-consumer queue, the queue thread is only woken
+ * when it sleeps. Delayed tasks are kept in a hierarchical timer wheel with a resolution of one millisecond,
+ * so inserting and expiring them costs O(1) instead of O(log n).
+ *
+ * Tasks posted with postCancelableTask() or postCancelableDelayedTask() return a TaskHandle that cancels the task
+ * in O(1). cancelTask() is still supported but scans the queue on the queue thread.
+ */
+class TaskQueueLockFreeThreadPrivate;
+class OCTK_CORE_API TaskQueueLockFreeThread : public TaskQueueBase
+{
+protected:
+    TaskQueueLockFreeThread();
+
+public:
+    using SharedPtr = std::shared_ptr<TaskQueueLockFreeThread>;
+    using UniquePtr = std::unique_ptr<TaskQueueLockFreeThread, TaskQueueBase::Deleter>;
+
+    class OCTK_CORE_API TaskHandle final
+    {
+        friend class TaskQueueLockFreeThread;
+
+    public:
+        using State = std::shared_ptr<std::atomic<int>>;
+
+        TaskHandle() = default;
+
+        bool isValid() const { return nullptr != mState; }
+        /**
+         * Returns true if the task has neither started nor been canceled yet.
+         */
+        bool isPending() const;
+        /**
+         * Cancels the task if it has not started yet, can be called from any thread.
+         * @return true if the task will not run.
+         */
+        bool cancel();
+
+    private:
+        explicit TaskHandle(const State &state)
+            : mState(state)
+        {
+        }
+
+        State mState;
+    };
+
+    static SharedPtr makeShared();
+    static UniquePtr makeUnique();
+    static SharedPtr create() { return makeShared(); }
+
+    ~TaskQueueLockFreeThread() override;
+
+    void destroy() override;
+    bool cancelTask(const Task *task) override;
+
+    using TaskQueueBase::postTask;
+    void postTask(const Task::SharedPtr &task, const SourceLocation &location = SourceLocation::current()) override;
+    using TaskQueueBase::postDelayedTask;
+    void postDelayedTask(const Task::SharedPtr &task,
+                         const TimeDelta &delay,
+                         const SourceLocation &location = SourceLocation::current()) override;
+
+    TaskHandle postCancelableTask(const Task::SharedPtr &task,
+                                  const SourceLocation &location = SourceLocation::current());
+    TaskHandle postCancelableTask(UniqueFunction<void() &&> function,
+                                  const SourceLocation &location = SourceLocation::current())
+    {
+        return this->postCancelableTask(Task::create(std::move(function)), location);
+    }
+    TaskHandle postCancelableDelayedTask(const Task::SharedPtr &task,
+                                         const TimeDelta &delay,
+                                         const SourceLocation &location = SourceLocation::current());
+    TaskHandle postCancelableDelayedTask(UniqueFunction<void() &&> function,
+                                         const TimeDelta &delay,
+                                         const SourceLocation &location = SourceLocation::current())
+    {
+        return this->postCancelableDelayedTask(Task::create(std::move(function)), delay, location);
+    }
+
+protected:
+    void processTasks();
+
+    OCTK_DEFINE_DPTR(TaskQueueLockFreeThread)
+    OCTK_DECLARE_PRIVATE(TaskQueueLockFreeThread)
+    OCTK_DISABLE_COPY_MOVE(TaskQueueLockFreeThread)
+};
+
+OCTK_END_NAMESPACE
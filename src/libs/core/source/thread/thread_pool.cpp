@@ -38,7 +38,11 @@ namespace detail
 namespace tls
 {
 static thread_local ThreadPoolLocalData currentThreadData;
+static thread_local ThreadPoolTaskThread *currentTaskThread{nullptr};
 } // namespace tls
+
+// Number of work stealing tasks a pool thread runs before it rechecks the thread limits under the pool mutex.
+static constexpr int kMaxWorkTasksPerTurn = 64;
 } // namespace detail
 
 ThreadPoolLocalData::ThreadPoolLocalData()
@@ -77,6 +81,8 @@ void ThreadPoolLocalData::init(const ThreadPool::Thread::SharedPtr &thread)
     thread->dFunc()->mThreadId = std::this_thread::get_id();
 }
 
+ThreadPoolTaskThread *ThreadPoolTaskThread::current() { return detail::tls::currentTaskThread; }
+
 void ThreadPoolTaskThread::start()
 {
     OCTK_ASSERT_X(!this->isRunning(), "ThreadPoolThread::start", "still in running");
@@ -127,35 +133,24 @@ void ThreadPoolTaskThread::run()
     dFunc()->mRunning.store(true);
     dFunc()->mInFinish.store(false);
     ThreadPoolLocalData::init(mWeakThis.lock());
+    detail::tls::currentTaskThread = this;
     std::unique_lock<std::mutex> lock(mManager->mMutex);
+    mManager->mRunningWorkerCount.fetch_add(1);
     while (!mExit.load())
     {
         auto task = std::move(mTask);
         do
         {
             OCTK_LOGGING_TRACE(OCTK_THREAD_POOL_LOGGER(), "thread {} do", utils::fmt::ptr(this));
-            if (task)
+            if (task || mManager->hasPendingWorkTasks())
             {
                 lock.unlock();
-                OCTK_TRY
+                if (task)
                 {
-                    OCTK_LOGGING_TRACE(OCTK_THREAD_POOL_LOGGER(),
-                                       "thread {} do run task:{}",
-                                       utils::fmt::ptr(this),
-                                       utils::fmt::ptr(task.get()));
-                    mManager->mTasksDispatchedCount.fetch_add(1);
-                    task->run();
-                    mManager->mTasksCompletedCount.fetch_add(1);
-                }
-                OCTK_CATCH(...)
-                {
-                    OCTK_LOGGING_WARNING(OCTK_THREAD_POOL_LOGGER(),
-                                         "\nOCTK Concurrent has caught an exception thrown from a worker thread.\n"
-                                         "This is not supported, exceptions thrown in worker threads must be\n"
-                                         "caught before control returns to OCTK Concurrent.");
-                    this->registerThreadInactive();
-                    OCTK_RETHROW;
+                    this->runTask(task);
+                    task.reset();
                 }
+                this->runWorkTasks();
                 lock.lock();
             }
 
@@ -167,9 +162,9 @@ void ThreadPoolTaskThread::run()
                                    utils::fmt::ptr(this));
                 break;
             }
-            // if task queue is empty, exit do task loop
+            // if task queue and work queues are empty, exit do task loop
             task = mManager->mTaskQueue.pop();
-            if (!task)
+            if (!task && !mManager->hasPendingWorkTasks())
             {
                 OCTK_LOGGING_TRACE(OCTK_THREAD_POOL_LOGGER(), "thread {} do task queue empty", utils::fmt::ptr(this));
                 break;
@@ -183,6 +178,14 @@ void ThreadPoolTaskThread::run()
             // OCTK_LOGGING_TRACE(OCTK_THREAD_POOL_LOGGER(), "thread %p isTooManyThreadsActive false", this);
             // start enter waiting state
             OCTK_ASSERT(nullptr == mTask.get());
+            // pairs with ThreadPool::start(), either this thread sees the new work task or the starter sees this
+            // thread is no longer running and wakes a waiting one
+            mManager->mRunningWorkerCount.fetch_sub(1);
+            if (mManager->hasPendingWorkTasks())
+            {
+                mManager->mRunningWorkerCount.fetch_add(1);
+                continue;
+            }
             mManager->mWaitingThreads.push_back(this);
             this->registerThreadInactive();
             if (mExit.load())
@@ -206,6 +209,7 @@ void ThreadPoolTaskThread::run()
                 // start exit waiting state
                 ++mManager->mActiveThreadCount;
             }
+            mManager->mRunningWorkerCount.fetch_add(1);
             // erase if this thread is still in the waiting list
             {
                 const auto iter = std::find(mManager->mWaitingThreads.begin(), mManager->mWaitingThreads.end(), this);
@@ -240,11 +244,50 @@ void ThreadPoolTaskThread::run()
             break;
         }
     }
+    mManager->mRunningWorkerCount.fetch_sub(1);
+    detail::tls::currentTaskThread = nullptr;
     OCTK_LOGGING_TRACE(OCTK_THREAD_POOL_LOGGER(), "thread {} run exit", utils::fmt::ptr(this));
     dFunc()->mInFinish.store(true);
     dFunc()->mRunning.store(false);
 }
 
+void ThreadPoolTaskThread::runTask(const Task::SharedPtr &task)
+{
+    OCTK_TRY
+    {
+        OCTK_LOGGING_TRACE(OCTK_THREAD_POOL_LOGGER(),
+                           "thread {} do run task:{}",
+                           utils::fmt::ptr(this),
+                           utils::fmt::ptr(task.get()));
+        mManager->mTasksDispatchedCount.fetch_add(1);
+        task->run();
+        mManager->mTasksCompletedCount.fetch_add(1);
+    }
+    OCTK_CATCH(...)
+    {
+        OCTK_LOGGING_WARNING(OCTK_THREAD_POOL_LOGGER(),
+                             "\nOCTK Concurrent has caught an exception thrown from a worker thread.\n"
+                             "This is not supported, exceptions thrown in worker threads must be\n"
+                             "caught before control returns to OCTK Concurrent.");
+        this->registerThreadInactive();
+        OCTK_RETHROW;
+    }
+}
+
+void ThreadPoolTaskThread::runWorkTasks()
+{
+    // run without the pool mutex, return after a bounded number of tasks so the caller can recheck the thread limits
+    for (int count = 0; count < detail::kMaxWorkTasksPerTurn && !mExit.load(); ++count)
+    {
+        const auto task = mManager->takeWorkTask(mWorkQueueIndex);
+        if (!task)
+        {
+            break;
+        }
+        this->runTask(task);
+    }
+}
+
 void ThreadPoolTaskThread::registerThreadInactive()
 {
     OCTK_ASSERT_X(mManager->mActiveThreadCount > 0,
@@ -360,8 +403,9 @@ void ThreadPoolPrivate::enqueueTask(const Task::SharedPtr &task, Priority priori
 
 void ThreadPoolPrivate::startThread(const Task::SharedPtr &task)
 {
-    OCTK_ASSERT(nullptr != task.get());
-    ThreadPoolTaskThread::SharedPtr thread(new ThreadPoolTaskThread(this));
+    // work stealing threads may start without a task, they take one from the work queues
+    OCTK_ASSERT(nullptr != task.get() || this->hasPendingWorkTasks());
+    ThreadPoolTaskThread::SharedPtr thread(new ThreadPoolTaskThread(this, mWorkerCounter++));
     // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
     OCTK_ASSERT(mAllThreads.find(thread.get()) == mAllThreads.end());
     mAllThreads.insert(std::make_pair(thread.get(), thread));
@@ -431,6 +475,105 @@ void ThreadPoolPrivate::tryToStartMoreThreads()
             mTaskQueue.pop();
         }
     }
+    // try to get threads running for the tasks in the work queues, one thread per pending task at most
+    for (auto pending = mPendingWorkTasks.load(); pending > 0 && this->isWorkerNeeded(); --pending)
+    {
+        if (!this->tryStartWorker())
+        {
+            break;
+        }
+    }
+}
+
+void ThreadPoolPrivate::initWorkQueues()
+{
+    if (mWorkQueues.empty())
+    {
+        const auto count = std::max(std::max(ThreadPool::idealThreadCount(), mMaxThreadCount), 1);
+        mWorkQueues.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            mWorkQueues.emplace_back(new ThreadPoolWorkQueue);
+        }
+    }
+}
+
+void ThreadPoolPrivate::drainWorkQueues()
+{
+    for (auto &queue : mWorkQueues)
+    {
+        mPendingWorkTasks.fetch_sub(queue->moveTo(mTaskQueue));
+    }
+}
+
+void ThreadPoolPrivate::pushWorkTask(const Task::SharedPtr &task, Priority priority)
+{
+    OCTK_ASSERT(nullptr != task);
+    OCTK_ASSERT(!mWorkQueues.empty());
+    // keep tasks started from a pool thread on its own queue, spread the others
+    const auto thread = ThreadPoolTaskThread::current();
+    const auto index = (thread && this == thread->manager()) ? thread->workQueueIndex()
+                                                             : mNextWorkQueueIndex.fetch_add(1, std::memory_order_relaxed);
+    mWorkQueues[index % mWorkQueues.size()]->push(task, priority);
+    mPendingWorkTasks.fetch_add(1);
+}
+
+Task::SharedPtr ThreadPoolPrivate::takeWorkTask(size_t index)
+{
+    const auto count = mWorkQueues.size();
+    if (0 == count)
+    {
+        return nullptr;
+    }
+    index %= count;
+    auto task = mWorkQueues[index]->pop();
+    // steal from the other queues, skip the busy ones at first and only wait for them if nothing was found
+    for (size_t i = 1; !task && i < count; ++i)
+    {
+        task = mWorkQueues[(index + i) % count]->tryPop();
+    }
+    for (size_t i = 1; !task && i < count && this->hasPendingWorkTasks(); ++i)
+    {
+        task = mWorkQueues[(index + i) % count]->pop();
+    }
+    if (task)
+    {
+        mPendingWorkTasks.fetch_sub(1);
+    }
+    return task;
+}
+
+bool ThreadPoolPrivate::tryStartWorker()
+{
+    if (!mAllThreads.empty() && this->activeThreadCount() >= mMaxThreadCount)
+    {
+        return false;
+    }
+
+    if (!mWaitingThreads.empty())
+    {
+        // recycle an available thread
+        auto thread = mWaitingThreads.front();
+        OCTK_ASSERT(!thread->task().get());
+        mWaitingThreads.pop_front();
+        thread->wake();
+        return true;
+    }
+
+    if (!mExpiredThreads.empty())
+    {
+        // restart an expired thread
+        auto thread = mExpiredThreads.front();
+        OCTK_ASSERT(!thread->task().get());
+        mExpiredThreads.pop_front();
+        ++mActiveThreadCount;
+        thread->start();
+        return true;
+    }
+
+    // start a new thread
+    this->startThread(nullptr);
+    return true;
 }
 
 bool ThreadPoolPrivate::isTooManyThreadsActive() const
@@ -446,7 +589,7 @@ int ThreadPoolPrivate::activeThreadCount() const
 
 bool ThreadPoolPrivate::isDone() const
 {
-    return mTaskQueue.empty() && 0 == mActiveThreadCount;
+    return mTaskQueue.empty() && 0 == mActiveThreadCount && !this->hasPendingWorkTasks();
 }
 
 void ThreadPoolPrivate::reset()
@@ -531,6 +674,17 @@ void ThreadPool::start(const Task::SharedPtr &task, Priority priority)
     if (task)
     {
         OCTK_D(ThreadPool);
+        if (d->isWorkStealing())
+        {
+            // only take the pool mutex when a thread has to be woken or started
+            d->pushWorkTask(task, priority);
+            if (d->isWorkerNeeded())
+            {
+                std::unique_lock<std::mutex> lock(d->mMutex);
+                d->tryToStartMoreThreads();
+            }
+            return;
+        }
         std::unique_lock<std::mutex> lock(d->mMutex);
         if (!d->tryStart(task))
         {
@@ -586,6 +740,7 @@ void ThreadPool::setMaxThreadCount(int count)
     if (count != d->mMaxThreadCount)
     {
         d->mMaxThreadCount = count;
+        d->updateWorkerCapacity();
         d->tryToStartMoreThreads();
     }
 }
@@ -607,6 +762,29 @@ void ThreadPool::setExpiryTimeout(int msecs)
     }
 }
 
+ThreadPool::SchedulerMode ThreadPool::schedulerMode() const
+{
+    OCTK_D(const ThreadPool);
+    return d->isWorkStealing() ? SchedulerMode::kWorkStealing : SchedulerMode::kSharedQueue;
+}
+
+void ThreadPool::setSchedulerMode(SchedulerMode mode)
+{
+    OCTK_D(ThreadPool);
+    std::lock_guard<std::mutex> lock(d->mMutex);
+    if (SchedulerMode::kWorkStealing == mode)
+    {
+        d->initWorkQueues();
+        d->mWorkStealing.store(true, std::memory_order_release);
+    }
+    else if (d->isWorkStealing())
+    {
+        d->mWorkStealing.store(false, std::memory_order_release);
+        d->drainWorkQueues();
+        d->tryToStartMoreThreads();
+    }
+}
+
 bool ThreadPool::waitForDone(unsigned int msecs)
 {
     OCTK_D(ThreadPool);
@@ -645,7 +823,17 @@ bool ThreadPool::cancel(Task *task)
         return false;
     }
     std::unique_lock<std::mutex> lock(d->mMutex);
-    return d->mTaskQueue.cancel(task);
+    bool canceled = d->mTaskQueue.cancel(task);
+    for (auto &queue : d->mWorkQueues)
+    {
+        const auto count = queue->cancel(task);
+        if (count > 0)
+        {
+            d->mPendingWorkTasks.fetch_sub(count);
+            canceled = true;
+        }
+    }
+    return canceled;
 }
 
 void ThreadPool::clear()
@@ -653,6 +841,10 @@ void ThreadPool::clear()
     OCTK_D(ThreadPool);
     std::unique_lock<std::mutex> lock(d->mMutex);
     d->mTaskQueue.clear();
+    for (auto &queue : d->mWorkQueues)
+    {
+        d->mPendingWorkTasks.fetch_sub(queue->clear());
+    }
 }
 
 void ThreadPool::reserveThread()
@@ -660,6 +852,7 @@ void ThreadPool::reserveThread()
     OCTK_D(ThreadPool);
     std::lock_guard<std::mutex> lock(d->mMutex);
     ++d->mReservedThreadCount;
+    d->updateWorkerCapacity();
 }
 
 void ThreadPool::releaseThread()
@@ -667,6 +860,7 @@ void ThreadPool::releaseThread()
     OCTK_D(ThreadPool);
     std::lock_guard<std::mutex> lock(d->mMutex);
     --d->mReservedThreadCount;
+    d->updateWorkerCapacity();
     d->tryToStartMoreThreads();
 }
 
@@ -681,7 +875,7 @@ uint64_t ThreadPool::taskCount() const
 {
     OCTK_D(const ThreadPool);
     std::lock_guard<std::mutex> lock(d->mMutex);
-    return d->mTaskQueue.size();
+    return d->mTaskQueue.size() + static_cast<uint64_t>(std::max<int64_t>(d->mPendingWorkTasks.load(), 0));
 }
 uint64_t ThreadPool::tasksCompletedCount() const
 {
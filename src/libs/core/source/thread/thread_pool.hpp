@@ -91,6 +91,24 @@ public:
         kHighest = +127
     };
 
+    /**
+     * The strategy used to hand queued tasks over to the pool threads.
+     */
+    enum class SchedulerMode
+    {
+        /**
+         * All tasks go through one priority queue guarded by the pool mutex (default).
+         */
+        kSharedQueue,
+        /**
+         * Every pool thread owns a local task queue, idle threads steal tasks from the other queues.
+         * Tasks started from a pool thread are pushed onto the local queue of that thread, tasks started from other
+         * threads are spread over the local queues in round-robin order.
+         * Priority order is kept inside each local queue.
+         */
+        kWorkStealing
+    };
+
     class ThreadPrivate;
     class OCTK_CORE_API Thread
     {
@@ -227,6 +245,17 @@ public:
     int expiryTimeout() const;
     void setExpiryTimeout(int msecs);
 
+    /**
+     * This property represents the scheduler mode used to dispatch tasks, the default is SchedulerMode::kSharedQueue.
+     *
+     * SchedulerMode::kWorkStealing avoids the pool mutex on the start() path while all pool threads are busy,
+     * which helps when many producers submit a lot of small tasks.
+     * Switching back to SchedulerMode::kSharedQueue moves the tasks that are not yet started to the shared queue.
+     * @return
+     */
+    SchedulerMode schedulerMode() const;
+    void setSchedulerMode(SchedulerMode mode);
+
     OCTK_STATIC_CONSTANT_NUMBER(kWaitForeverMSecs, std::numeric_limits<unsigned int>::max())
     /**
      * Waits up to @a msecs milliseconds for all threads to exit and removes all threads from the thread pool.
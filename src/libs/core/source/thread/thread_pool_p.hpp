@@ -32,9 +32,11 @@
 #include <set>
 #include <map>
 #include <list>
+#include <deque>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 #include <condition_variable>
 
 OCTK_DECLARE_LOGGER(OCTK_CORE_API, OCTK_THREAD_POOL_LOGGER)
@@ -159,14 +161,135 @@ private:
     std::set<Item, Item::Compare> mTasks;
 };
 
+/**
+ * Local task queue of one pool thread in SchedulerMode::kWorkStealing, tasks are kept in FIFO order per priority.
+ * The owner thread uses pop(), other threads use tryPop() so that a busy queue is skipped instead of waited on.
+ */
+class ThreadPoolWorkQueue
+{
+public:
+    using Priority = ThreadPool::Priority;
+
+    ThreadPoolWorkQueue() = default;
+    ~ThreadPoolWorkQueue() = default;
+
+    void push(const Task::SharedPtr &task, Priority priority)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto iter = mLevels.begin();
+        while (iter != mLevels.end() && iter->priority > priority)
+        {
+            ++iter;
+        }
+        if (mLevels.end() == iter || iter->priority != priority)
+        {
+            iter = mLevels.insert(iter, Level{priority, {}});
+        }
+        iter->tasks.push_back(task);
+        ++mSize;
+    }
+
+    Task::SharedPtr pop()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return this->takeFirst();
+    }
+    Task::SharedPtr tryPop()
+    {
+        std::unique_lock<std::mutex> lock(mMutex, std::try_to_lock);
+        return lock.owns_lock() ? this->takeFirst() : nullptr;
+    }
+
+    size_t moveTo(ThreadPoolTaskQueue &queue)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto moved = mSize;
+        for (auto &level : mLevels)
+        {
+            for (auto &task : level.tasks)
+            {
+                queue.push(task, level.priority);
+            }
+            level.tasks.clear();
+        }
+        mSize = 0;
+        return moved;
+    }
+
+    size_t cancel(Task *task)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        size_t canceled = 0;
+        for (auto &level : mLevels)
+        {
+            for (auto iter = level.tasks.begin(); iter != level.tasks.end();)
+            {
+                if (iter->get() == task)
+                {
+                    iter = level.tasks.erase(iter);
+                    ++canceled;
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+        }
+        mSize -= canceled;
+        return canceled;
+    }
+    size_t clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto cleared = mSize;
+        for (auto &level : mLevels)
+        {
+            level.tasks.clear();
+        }
+        mSize = 0;
+        return cleared;
+    }
+
+private:
+    struct Level
+    {
+        Priority priority;
+        std::deque<Task::SharedPtr> tasks;
+    };
+
+    Task::SharedPtr takeFirst()
+    {
+        if (0 == mSize)
+        {
+            return nullptr;
+        }
+        for (auto &level : mLevels)
+        {
+            if (!level.tasks.empty())
+            {
+                auto task = std::move(level.tasks.front());
+                level.tasks.pop_front();
+                --mSize;
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    std::mutex mMutex;
+    size_t mSize{0};
+    std::vector<Level> mLevels; // sorted by priority, highest first
+};
+
 class ThreadPoolTaskThread : public ThreadPool::Thread
 {
 public:
     using SharedPtr = std::shared_ptr<ThreadPoolTaskThread>;
     using WeakPtr = std::weak_ptr<ThreadPoolTaskThread>;
 
-    ThreadPoolTaskThread(ThreadPoolPrivate *manager)
+    ThreadPoolTaskThread(ThreadPoolPrivate *manager, size_t workQueueIndex)
         : ThreadPool::Thread(false)
+        , mWorkQueueIndex(workQueueIndex)
         , mManager(manager)
     {
     }
@@ -180,6 +303,11 @@ public:
     void start();
     void exitWait();
 
+    static ThreadPoolTaskThread *current();
+
+    ThreadPoolPrivate *manager() const { return mManager; }
+    size_t workQueueIndex() const { return mWorkQueueIndex; }
+
     Task::SharedPtr task() { return mTask; }
     void setTask(const Task::SharedPtr &task)
     {
@@ -189,6 +317,8 @@ public:
 
 protected:
     void run();
+    void runTask(const Task::SharedPtr &task);
+    void runWorkTasks();
     void registerThreadInactive();
 
 private:
@@ -198,6 +328,7 @@ private:
     Task::SharedPtr mTask;
     std::once_flag mInitFlag;
     std::atomic<bool> mExit{true};
+    const size_t mWorkQueueIndex;
     ThreadPoolPrivate *const mManager;
     std::condition_variable mTaskReadyCondition;
 };
@@ -247,6 +378,20 @@ public:
     bool isDone() const;
     void reset();
 
+    bool isWorkStealing() const { return mWorkStealing.load(std::memory_order_acquire); }
+    bool hasPendingWorkTasks() const { return mPendingWorkTasks.load() > 0; }
+    bool isWorkerNeeded() const
+    {
+        const int runningWorkers = mRunningWorkerCount.load();
+        return runningWorkers <= 0 || runningWorkers < mWorkerCapacity.load();
+    }
+    void initWorkQueues();
+    void drainWorkQueues();
+    void pushWorkTask(const Task::SharedPtr &task, Priority priority);
+    Task::SharedPtr takeWorkTask(size_t index);
+    bool tryStartWorker();
+    void updateWorkerCapacity() { mWorkerCapacity.store(mMaxThreadCount - mReservedThreadCount); }
+
     mutable std::mutex mMutex;
     std::condition_variable mCondition;
 
@@ -263,6 +408,15 @@ public:
     int mActiveThreadCount = 0;
     int mReservedThreadCount = 0;
     int mMaxThreadCount = ThreadPool::idealThreadCount();
+
+    // work stealing scheduler state, mWorkQueues is created once and never resized afterwards
+    std::atomic<bool> mWorkStealing{false};
+    std::vector<std::unique_ptr<ThreadPoolWorkQueue>> mWorkQueues;
+    std::atomic<size_t> mNextWorkQueueIndex{0};
+    std::atomic<int64_t> mPendingWorkTasks{0};
+    std::atomic<int> mRunningWorkerCount{0};
+    std::atomic<int> mWorkerCapacity{ThreadPool::idealThreadCount()};
+    size_t mWorkerCounter = 0;
 };
 
 OCTK_END_NAMESPACE
@@ -315,9 +315,9 @@ public:
                 (static_cast<Value>(flag) != 0 || mValue == static_cast<Value>(flag)));
     }
 
-    OCTK_CONSTEXPR inline EnumFlags &setFlag(Enum flag, bool on = true) OCTK_NOEXCEPT
+    OCTK_CXX14_CONSTEXPR inline EnumFlags &setFlag(Enum flag, bool on = true) OCTK_NOEXCEPT
     {
-        return on ? (*this |= flag) : (*this &= ~Int(flag));
+        return on ? (*this |= flag) : (*this &= ~static_cast<Value>(flag));
     }
 
 private:
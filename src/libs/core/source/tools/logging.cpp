@@ -26,7 +26,11 @@
 #include <openctk/core/memory.hpp>
 #include <openctk/core/assert.hpp>
 
+#include <condition_variable>
 #include <unordered_map>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
 #ifndef OCTK_OS_WIN32
 #    include <stdlib.h> // abort
 #else
@@ -63,12 +67,412 @@ static inline std::atomic<int> &loggerIdNumberCounter()
     return counter;
 }
 
-static inline std::string currentThreadIdString()
+static constexpr size_t kAsyncLogInlineTextSize = 256;
+static constexpr auto kAsyncLogIdleWait = std::chrono::milliseconds(50);
+
+struct AsyncLogRecord final
 {
-    std::stringstream ss;
-    ss << std::this_thread::get_id();
-    return ss.str();
-}
+    const char *text() const { return textSize < sizeof(inlineText) ? inlineText : longText.c_str(); }
+    void setText(const char *str)
+    {
+        textSize = std::strlen(str);
+        if (textSize < sizeof(inlineText))
+        {
+            std::memcpy(inlineText, str, textSize + 1);
+        }
+        else
+        {
+            longText.assign(str, textSize);
+        }
+    }
+
+    LoggerPrivate *logger{nullptr};
+    Logger::Context context;
+    spdlog::log_clock::time_point time;
+    size_t threadId{0};
+    // Set for deferred records, the text is the format string then.
+    Logger::DeferredFormatter formatter{nullptr};
+    alignas(8) unsigned char args[OCTK_LOGGING_DEFERRED_ARGS_MAX];
+    size_t textSize{0};
+    char inlineText[kAsyncLogInlineTextSize];
+    std::string longText;
+};
+
+/**
+ * Single producer single consumer ring of preallocated records, one per logging thread.
+ */
+class AsyncLogRing final
+{
+public:
+    explicit AsyncLogRing(size_t capacity)
+        : mRecords(capacity)
+        , mMask(capacity - 1)
+    {
+    }
+
+    AsyncLogRecord *beginWrite()
+    {
+        const auto head = mHead.load(std::memory_order_relaxed);
+        return head - mTail.load(std::memory_order_acquire) > mMask ? nullptr : &mRecords[head & mMask];
+    }
+    // seq_cst pairs with the sleeping flag of the writer.
+    void endWrite() { mHead.store(mHead.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst); }
+
+    AsyncLogRecord *beginRead()
+    {
+        const auto tail = mTail.load(std::memory_order_relaxed);
+        return tail == mHead.load(std::memory_order_acquire) ? nullptr : &mRecords[tail & mMask];
+    }
+    void endRead() { mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool isEmpty() const { return mTail.load(std::memory_order_acquire) == mHead.load(std::memory_order_seq_cst); }
+
+    std::atomic<bool> closed{false};
+
+private:
+    std::vector<AsyncLogRecord> mRecords;
+    const size_t mMask;
+    char mPadding0[64];
+    std::atomic<size_t> mHead{0};
+    char mPadding1[64];
+    std::atomic<size_t> mTail{0};
+};
+
+struct AsyncLogRingHolder final
+{
+    ~AsyncLogRingHolder()
+    {
+        if (ring)
+        {
+            ring->closed.store(true);
+        }
+    }
+
+    std::shared_ptr<AsyncLogRing> ring;
+    uint64_t generation{0};
+};
+
+class AsyncLogBackend final
+{
+public:
+    // Never destroyed, loggers may still flush from their destructors at exit.
+    static AsyncLogBackend &instance()
+    {
+        static AsyncLogBackend *backend = new AsyncLogBackend;
+        return *backend;
+    }
+
+    bool isEnabled() const { return mEnabled.load(std::memory_order_acquire); }
+    uint64_t droppedCount() const { return mDropped.load(); }
+
+    void enable(const Logger::AsyncOptions &options)
+    {
+        std::lock_guard<std::mutex> control(mControlMutex);
+        this->stop();
+        size_t capacity = 2;
+        while (capacity < options.ringCapacity)
+        {
+            capacity <<= 1;
+        }
+        mRingCapacity.store(capacity);
+        mOverflowPolicy.store(options.overflowPolicy);
+        mGeneration.fetch_add(1);
+        mQuit.store(false);
+        mDroppedReported = mDropped.load();
+        mThread = std::thread(&AsyncLogBackend::run, this);
+        mEnabled.store(true, std::memory_order_release);
+        static std::once_flag exitHandlerFlag;
+        std::call_once(exitHandlerFlag, [] { std::atexit([] { AsyncLogBackend::instance().disable(); }); });
+    }
+
+    void disable()
+    {
+        std::lock_guard<std::mutex> control(mControlMutex);
+        this->stop();
+    }
+
+    void flush()
+    {
+        if (!this->isEnabled() || std::this_thread::get_id() == mThread.get_id())
+        {
+            return;
+        }
+        const auto target = mPushed.load();
+        std::unique_lock<std::mutex> locker(mMutex);
+        ++mFlushWaiters;
+        mWakeup.notify_one();
+        while (mWritten.load() < target)
+        {
+            mFlushed.wait_for(locker, kAsyncLogIdleWait);
+        }
+        --mFlushWaiters;
+    }
+
+    // Returns false when the record has to be written synchronously.
+    bool push(LoggerPrivate *logger,
+              const Logger::Context &context,
+              const char *text,
+              Logger::DeferredFormatter formatter,
+              const unsigned char *args)
+    {
+        if (!mEnabled.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        mProducers.fetch_add(1);
+        if (!mEnabled.load())
+        {
+            mProducers.fetch_sub(1);
+            return false;
+        }
+        auto ring = this->localRing();
+        auto record = ring->beginWrite();
+        while (!record)
+        {
+            if (Logger::OverflowPolicy::Block != mOverflowPolicy)
+            {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                mProducers.fetch_sub(1);
+                return true;
+            }
+            this->wakeup();
+            std::this_thread::yield();
+            record = ring->beginWrite();
+        }
+        record->logger = logger;
+        record->context = context;
+        record->time = spdlog::log_clock::now();
+        record->threadId = spdlog::details::os::thread_id();
+        record->formatter = formatter;
+        if (formatter)
+        {
+            std::memcpy(record->args, args, OCTK_LOGGING_DEFERRED_ARGS_MAX);
+        }
+        record->setText(text);
+        ring->endWrite();
+        mPushed.fetch_add(1);
+        mProducers.fetch_sub(1);
+        if (mSleeping.load())
+        {
+            this->wakeup();
+        }
+        return true;
+    }
+
+private:
+    AsyncLogBackend() = default;
+
+    AsyncLogRing *localRing()
+    {
+        static thread_local AsyncLogRingHolder holder;
+        const auto generation = mGeneration.load();
+        if (holder.generation != generation)
+        {
+            if (holder.ring)
+            {
+                holder.ring->closed.store(true);
+            }
+            holder.ring = std::make_shared<AsyncLogRing>(mRingCapacity);
+            holder.generation = generation;
+            std::lock_guard<std::mutex> locker(mMutex);
+            mRings.push_back(holder.ring);
+            ++mRingsVersion;
+        }
+        return holder.ring.get();
+    }
+
+    void wakeup()
+    {
+        std::lock_guard<std::mutex> locker(mMutex);
+        mWakeup.notify_one();
+    }
+
+    void stop()
+    {
+        if (!mThread.joinable())
+        {
+            return;
+        }
+        // Records already being pushed must reach a ring the writer still drains.
+        mEnabled.store(false);
+        while (mProducers.load())
+        {
+            std::this_thread::yield();
+        }
+        {
+            std::lock_guard<std::mutex> locker(mMutex);
+            mQuit.store(true);
+            mWakeup.notify_one();
+        }
+        mThread.join();
+        std::lock_guard<std::mutex> locker(mMutex);
+        mRings.clear();
+        ++mRingsVersion;
+        mFlushed.notify_all();
+    }
+
+    void run()
+    {
+        std::vector<std::shared_ptr<AsyncLogRing>> rings;
+        std::vector<LoggerPrivate *> touched;
+        LoggerPrivate *lastLogger = nullptr;
+        uint64_t ringsVersion = 0;
+        std::string buffer;
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> locker(mMutex);
+                if (ringsVersion != mRingsVersion)
+                {
+                    mRings.erase(std::remove_if(mRings.begin(),
+                                                mRings.end(),
+                                                [](const std::shared_ptr<AsyncLogRing> &ring)
+                                                { return ring->closed.load() && ring->isEmpty(); }),
+                                 mRings.end());
+                    rings = mRings;
+                    ringsVersion = mRingsVersion;
+                }
+            }
+            size_t written = 0;
+            for (const auto &ring : rings)
+            {
+                // Bounded batches per ring keep one chatty thread from starving the others.
+                for (size_t batch = 0; batch < 64; ++batch)
+                {
+                    auto record = ring->beginRead();
+                    if (!record)
+                    {
+                        break;
+                    }
+                    this->write(*record, buffer);
+                    if (touched.end() == std::find(touched.begin(), touched.end(), record->logger))
+                    {
+                        touched.push_back(record->logger);
+                    }
+                    lastLogger = record->logger;
+                    ring->endRead();
+                    mWritten.fetch_add(1);
+                    ++written;
+                }
+            }
+            if (written)
+            {
+                continue;
+            }
+
+            const auto dropped = mDropped.load();
+            if (dropped != mDroppedReported && lastLogger)
+            {
+                if (Logger::OverflowPolicy::Count == mOverflowPolicy)
+                {
+                    buffer = utils::fmt::format("{} log messages dropped, ring buffer full", dropped - mDroppedReported);
+                    this->writeText(lastLogger, Logger::Context{LogLevel::Warning, "", "", "", 0}, buffer);
+                    lastLogger->mLogger->flush();
+                }
+                mDroppedReported = dropped;
+            }
+            for (auto logger : touched)
+            {
+                logger->mLogger->flush();
+            }
+            touched.clear();
+
+            std::unique_lock<std::mutex> locker(mMutex);
+            if (mFlushWaiters)
+            {
+                mFlushed.notify_all();
+            }
+            if (mQuit.load())
+            {
+                if (std::all_of(rings.begin(),
+                                rings.end(),
+                                [](const std::shared_ptr<AsyncLogRing> &ring) { return ring->isEmpty(); }) &&
+                    ringsVersion == mRingsVersion)
+                {
+                    break;
+                }
+                continue;
+            }
+            mSleeping.store(true);
+            const bool pending = ringsVersion != mRingsVersion ||
+                                 !std::all_of(rings.begin(),
+                                              rings.end(),
+                                              [](const std::shared_ptr<AsyncLogRing> &ring) { return ring->isEmpty(); });
+            if (!pending)
+            {
+                mWakeup.wait_for(locker, kAsyncLogIdleWait);
+            }
+            mSleeping.store(false);
+        }
+    }
+
+    void write(const AsyncLogRecord &record, std::string &buffer)
+    {
+        if (record.formatter)
+        {
+            buffer.clear();
+            record.formatter(buffer, record.text(), record.args);
+            this->writeText(record.logger, record.context, buffer, record.time, record.threadId);
+        }
+        else
+        {
+            this->writeText(record.logger,
+                            record.context,
+                            spdlog::string_view_t(record.text(), record.textSize),
+                            record.time,
+                            record.threadId);
+        }
+    }
+
+    void writeText(LoggerPrivate *logger,
+                   const Logger::Context &context,
+                   spdlog::string_view_t text,
+                   spdlog::log_clock::time_point time = spdlog::log_clock::now(),
+                   size_t threadId = spdlog::details::os::thread_id())
+    {
+        const auto &spdLogger = logger->mLogger;
+        const auto level = static_cast<spdlog::level::level_enum>(context.level);
+        spdlog::details::log_msg message(time,
+                                         logger->mNoSource || !context.line
+                                             ? spdlog::source_loc{}
+                                             : spdlog::source_loc{context.filePath, context.line, context.funcName},
+                                         spdLogger->name(),
+                                         level,
+                                         text);
+        message.thread_id = threadId;
+        for (const auto &sink : spdLogger->sinks())
+        {
+            if (sink->should_log(level))
+            {
+                sink->log(message);
+                if (level >= spdlog::level::err)
+                {
+                    sink->flush();
+                }
+            }
+        }
+    }
+
+    std::mutex mControlMutex;
+    std::mutex mMutex;
+    std::condition_variable mWakeup;
+    std::condition_variable mFlushed;
+    std::vector<std::shared_ptr<AsyncLogRing>> mRings;
+    uint64_t mRingsVersion{0};
+    int mFlushWaiters{0};
+    std::thread mThread;
+    std::atomic<size_t> mRingCapacity{0};
+    std::atomic<Logger::OverflowPolicy> mOverflowPolicy{Logger::OverflowPolicy::Count};
+    std::atomic<uint64_t> mGeneration{0};
+    std::atomic<bool> mEnabled{false};
+    std::atomic<bool> mQuit{false};
+    std::atomic<bool> mSleeping{false};
+    std::atomic<int> mProducers{0};
+    std::atomic<uint64_t> mPushed{0};
+    std::atomic<uint64_t> mWritten{0};
+    std::atomic<uint64_t> mDropped{0};
+    uint64_t mDroppedReported{0}; // writer thread only
+};
 }; // namespace detail
 
 LoggerPrivate::LoggerPrivate(Logger *p, const char *name)
@@ -97,6 +501,20 @@ bool LoggerPrivate::messageHandlerOutput(const Context &context, const char *mes
     return false;
 }
 
+void LoggerPrivate::sinkOutput(const Context &context, const char *message)
+{
+    if (mNoSource)
+    {
+        mLogger->log(static_cast<spdlog::level::level_enum>(context.level), message);
+    }
+    else
+    {
+        mLogger->log(spdlog::source_loc{context.filePath, context.line, context.funcName},
+                     static_cast<spdlog::level::level_enum>(context.level),
+                     message);
+    }
+}
+
 Logger::Logger(const char *name, LogLevel defaultLevel)
     : mDPtr(new LoggerPrivate(this, name))
 {
@@ -118,6 +536,8 @@ Logger::Logger(LoggerPrivate *d)
 
 Logger::~Logger()
 {
+    // The async writer may still hold records of this logger.
+    Logger::flushAsync();
 }
 
 Logger::Pointer Logger::logger(int idNumber)
@@ -207,15 +627,14 @@ void Logger::output(const Context &context, const char *message)
     OCTK_D(Logger);
     if (!d->messageHandlerOutput(context, message))
     {
-        if (d->mNoSource)
+        if (LogLevel::Fatal == context.level)
         {
-            d->mLogger->log(static_cast<spdlog::level::level_enum>(context.level), message);
+            Logger::flushAsync();
+            d->sinkOutput(context, message);
         }
-        else
+        else if (!detail::AsyncLogBackend::instance().push(d, context, message, nullptr, nullptr))
         {
-            d->mLogger->log(spdlog::source_loc{context.filePath, context.line, context.funcName},
-                            static_cast<spdlog::level::level_enum>(context.level),
-                            message);
+            d->sinkOutput(context, message);
         }
     }
     if (LogLevel::Fatal == context.level)
@@ -224,28 +643,27 @@ void Logger::output(const Context &context, const char *message)
     }
 }
 
-void Logger::vlogging(const Context &context, const char *format, va_list args)
+void Logger::outputDeferred(const Context &context,
+                            const char *format,
+                            DeferredFormatter formatter,
+                            const unsigned char *args)
 {
     OCTK_D(Logger);
-    char message[OCTK_LOGGING_BUFFER_SIZE_MAX] = {0};
-    std::vsnprintf(message, OCTK_LOGGING_BUFFER_SIZE_MAX, format, args);
-    if (!d->messageHandlerOutput(context, message))
+    if (LogLevel::Fatal != context.level && !d->mMessageHandlerWraper.load() &&
+        detail::AsyncLogBackend::instance().push(d, context, format, formatter, args))
     {
-        if (d->mNoSource)
-        {
-            d->mLogger->log(static_cast<spdlog::level::level_enum>(context.level), message);
-        }
-        else
-        {
-            d->mLogger->log(spdlog::source_loc{context.filePath, context.line, context.funcName},
-                            static_cast<spdlog::level::level_enum>(context.level),
-                            message);
-        }
-    }
-    if (LogLevel::Fatal == context.level)
-    {
-        this->fatalAbort();
+        return;
     }
+    std::string message;
+    formatter(message, format, args);
+    this->output(context, message.c_str());
+}
+
+void Logger::vlogging(const Context &context, const char *format, va_list args)
+{
+    char message[OCTK_LOGGING_BUFFER_SIZE_MAX] = {0};
+    std::vsnprintf(message, OCTK_LOGGING_BUFFER_SIZE_MAX, format, args);
+    this->output(context, message);
 }
 
 void Logger::installMessageHandler(const MessageHandler &handler, bool uniqueOwnership)
@@ -260,6 +678,18 @@ void Logger::installMessageHandler(const MessageHandler &handler, bool uniqueOwn
     }
 }
 
+void Logger::enableAsync(const AsyncOptions &options) { detail::AsyncLogBackend::instance().enable(options); }
+
+void Logger::enableAsync() { Logger::enableAsync(AsyncOptions()); }
+
+void Logger::disableAsync() { detail::AsyncLogBackend::instance().disable(); }
+
+bool Logger::isAsyncEnabled() { return detail::AsyncLogBackend::instance().isEnabled(); }
+
+void Logger::flushAsync() { detail::AsyncLogBackend::instance().flush(); }
+
+uint64_t Logger::asyncDroppedCount() { return detail::AsyncLogBackend::instance().droppedCount(); }
+
 void Logger::fatalAbort()
 {
 #ifdef OCTK_OS_WIN32
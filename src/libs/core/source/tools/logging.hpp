@@ -27,13 +27,18 @@
 #include <openctk/core/format.hpp>
 #include <openctk/core/string_utils.hpp>
 
+#include <type_traits>
 #include <functional>
 #include <ostream>
 #include <sstream>
+#include <cstring>
+#include <memory>
 #include <vector>
 #include <string>
+#include <tuple>
 
 #define OCTK_LOGGING_BUFFER_SIZE_MAX 102400 // 100kb
+#define OCTK_LOGGING_DEFERRED_ARGS_MAX 64 // bytes of arguments a deferred log record captures
 
 OCTK_BEGIN_NAMESPACE
 
@@ -50,6 +55,71 @@ enum class LogLevel : int
 
 static constexpr int LogLevelNum = 7;
 
+namespace detail
+{
+template <typename... Ts>
+struct LogArgsDeferrable : std::true_type
+{
+};
+template <typename T, typename... Ts>
+struct LogArgsDeferrable<T, Ts...>
+    : std::integral_constant<bool, std::is_arithmetic<T>::value && LogArgsDeferrable<Ts...>::value>
+{
+};
+
+constexpr size_t logArgsSize() { return 0; }
+template <typename... Ts>
+constexpr size_t logArgsSize(size_t size, Ts... sizes)
+{
+    return size + logArgsSize(sizes...);
+}
+
+/**
+ * Captures arithmetic log arguments by value into a flat buffer and formats them later, possibly on another thread.
+ */
+template <typename... Args>
+struct DeferredLogArgs final
+{
+    static constexpr size_t size = logArgsSize(sizeof(Args)...);
+    static constexpr bool deferrable = LogArgsDeferrable<Args...>::value && size <= OCTK_LOGGING_DEFERRED_ARGS_MAX;
+
+    static void store(unsigned char *buffer, const Args &...args)
+    {
+        size_t offset = 0;
+        const int expand[] = {0, (std::memcpy(buffer + offset, &args, sizeof(Args)), offset += sizeof(Args), 0)...};
+        OCTK_UNUSED(expand);
+        OCTK_UNUSED(offset);
+    }
+
+    static void render(std::string &out, const char *format, const unsigned char *buffer)
+    {
+        std::tuple<Args...> values;
+        load(values, buffer, std::index_sequence_for<Args...>());
+        formatTo(out, format, values, std::index_sequence_for<Args...>());
+    }
+
+private:
+    template <size_t... I>
+    static void load(std::tuple<Args...> &values, const unsigned char *buffer, std::index_sequence<I...>)
+    {
+        size_t offset = 0;
+        const int expand[] = {
+            0,
+            (std::memcpy(&std::get<I>(values), buffer + offset, sizeof(Args)), offset += sizeof(Args), 0)...};
+        OCTK_UNUSED(expand);
+        OCTK_UNUSED(offset);
+    }
+    template <size_t... I>
+    static void formatTo(std::string &out,
+                         const char *format,
+                         const std::tuple<Args...> &values,
+                         std::index_sequence<I...>)
+    {
+        out += utils::fmt::vformat(utils::fmt::string_view(format), utils::fmt::make_format_args(std::get<I>(values)...));
+    }
+};
+} // namespace detail
+
 class LoggerPrivate;
 
 class OCTK_CORE_API Logger
@@ -66,6 +136,28 @@ public:
         int line;
     };
 
+    // Formats the captured arguments of a deferred record into out.
+    using DeferredFormatter = void (*)(std::string &out, const char *format, const unsigned char *args);
+
+    /**
+     * @brief What a thread logging in async mode does when its ring buffer is full.
+     * Block waits for the writer, Drop discards the record and Count discards it too but has the writer log how many
+     * records were lost.
+     */
+    enum class OverflowPolicy : int
+    {
+        Block = 0,
+        Drop = 1,
+        Count = 2,
+    };
+
+    struct AsyncOptions final
+    {
+        // Records preallocated per logging thread, rounded up to a power of two.
+        size_t ringCapacity{512};
+        OverflowPolicy overflowPolicy{OverflowPolicy::Count};
+    };
+
     class Stream final
     {
         struct StreamData
@@ -78,11 +170,31 @@ public:
             {
             }
 
+            // Formats a deferred call before anything else is streamed behind it.
+            std::stringstream &stream()
+            {
+                if (!ss)
+                {
+                    ss.reset(new std::stringstream);
+                    if (deferredFormatter)
+                    {
+                        std::string text;
+                        deferredFormatter(text, deferredFormat, deferredArgs);
+                        deferredFormatter = nullptr;
+                        *ss << text;
+                    }
+                }
+                return *ss;
+            }
+
             int ref;
             bool space;
             Logger &logger;
-            std::stringstream ss;
+            std::unique_ptr<std::stringstream> ss;
             const Context &context;
+            const char *deferredFormat{nullptr};
+            DeferredFormatter deferredFormatter{nullptr};
+            alignas(8) unsigned char deferredArgs[OCTK_LOGGING_DEFERRED_ARGS_MAX];
         } *mStream;
 
     public:
@@ -101,8 +213,17 @@ public:
         {
             if (!--mStream->ref)
             {
-                std::string buffer(mStream->ss.str());
-                if (mStream->space && buffer.back() == ' ')
+                if (mStream->deferredFormatter)
+                {
+                    mStream->logger.outputDeferred(mStream->context,
+                                                   mStream->deferredFormat,
+                                                   mStream->deferredFormatter,
+                                                   mStream->deferredArgs);
+                    delete mStream;
+                    return;
+                }
+                std::string buffer(mStream->ss ? mStream->ss->str() : std::string());
+                if (mStream->space && !buffer.empty() && buffer.back() == ' ')
                 {
                     buffer.pop_back();
                 }
@@ -129,15 +250,15 @@ public:
 
         OCTK_FORCE_INLINE void prepend(const char *message)
         {
-            std::stringstream ss;
-            ss << message << mStream->ss.get();
+            std::unique_ptr<std::stringstream> ss(new std::stringstream);
+            *ss << message << mStream->stream().str();
             std::swap(mStream->ss, ss);
         }
 
         inline Stream &space()
         {
             mStream->space = true;
-            mStream->ss << ' ';
+            mStream->stream() << ' ';
             return *this;
         }
 
@@ -151,32 +272,32 @@ public:
         {
             if (mStream->space)
             {
-                mStream->ss << ' ';
+                mStream->stream() << ' ';
             }
             return *this;
         }
 
         inline Stream &operator<<(bool t)
         {
-            mStream->ss << (t ? "true" : "false");
+            mStream->stream() << (t ? "true" : "false");
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(char t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(signed short t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(unsigned short t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
@@ -194,49 +315,49 @@ public:
 
         inline Stream &operator<<(signed int t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(unsigned int t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(signed long t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(signed long long t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(unsigned long t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(unsigned long long t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(float t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(double t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
@@ -244,7 +365,7 @@ public:
         {
             if (t)
             {
-                mStream->ss << t;
+                mStream->stream() << t;
                 return this->maybeSpace();
             }
             return *this;
@@ -252,45 +373,68 @@ public:
 
         inline Stream &operator<<(const std::string &t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(const void *t)
         {
-            mStream->ss << t;
+            mStream->stream() << t;
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(std::nullptr_t)
         {
-            mStream->ss << "(nullptr)";
+            mStream->stream() << "(nullptr)";
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(const std::stringstream &ss)
         {
-            mStream->ss << ss.str();
+            mStream->stream() << ss.str();
             return this->maybeSpace();
         }
 
         inline Stream &operator<<(const StringView &t)
         {
-            mStream->ss << t.data();
+            mStream->stream() << t.data();
             return this->maybeSpace();
         }
 
         template <typename... Args>
         inline Stream &format(const char *format, const Args &...args)
         {
-            mStream->ss << utils::fmt::vformat(utils::fmt::string_view(format), utils::fmt::make_format_args(args...));
-            return this->maybeSpace();
+            return this->format(std::integral_constant<bool, detail::DeferredLogArgs<Args...>::deferrable>(),
+                                format,
+                                args...);
         }
 
         template <typename... Args>
         inline Stream &printf(const char *format, const Args &...args)
         {
-            mStream->ss << utils::fmt::vsprintf(utils::fmt::string_view(format), utils::fmt::make_printf_args(args...));
+            mStream->stream() << utils::fmt::vsprintf(utils::fmt::string_view(format), utils::fmt::make_printf_args(args...));
+            return this->maybeSpace();
+        }
+
+    private:
+        // Arithmetic arguments of a fresh stream are captured by value, formatting happens in the log writer.
+        template <typename... Args>
+        inline Stream &format(std::true_type, const char *format, const Args &...args)
+        {
+            if (mStream->ss || mStream->deferredFormatter || mStream->space)
+            {
+                return this->format(std::false_type(), format, args...);
+            }
+            detail::DeferredLogArgs<Args...>::store(mStream->deferredArgs, args...);
+            mStream->deferredFormat = format;
+            mStream->deferredFormatter = &detail::DeferredLogArgs<Args...>::render;
+            return *this;
+        }
+
+        template <typename... Args>
+        inline Stream &format(std::false_type, const char *format, const Args &...args)
+        {
+            mStream->stream() << utils::fmt::vformat(utils::fmt::string_view(format), utils::fmt::make_format_args(args...));
             return this->maybeSpace();
         }
     };
@@ -370,11 +514,39 @@ public:
     void setLevelEnable(LogLevel level, bool enable);
 
     void output(const Context &context, const char *message);
+    void outputDeferred(const Context &context,
+                        const char *format,
+                        DeferredFormatter formatter,
+                        const unsigned char *args);
     void vlogging(const Context &context, const char *format, va_list args);
 
     using MessageHandler = std::function<void(const char *name, const Context &context, const char *message)>;
     void installMessageHandler(const MessageHandler &handler, bool uniqueOwnership = false);
 
+    /**
+     * @brief Switches every logger to asynchronous output.
+     * Log calls copy the record into a preallocated ring buffer of the calling thread and a background writer
+     * formats deferred arguments and feeds the sinks. Message handlers still run on the calling thread and fatal
+     * records flush the writer before they are written synchronously. Records of different threads are written in
+     * the order the writer drains their rings.
+     * @param options
+     */
+    static void enableAsync(const AsyncOptions &options);
+    static void enableAsync();
+    /**
+     * @brief Writes every pending record, stops the writer and goes back to synchronous output.
+     */
+    static void disableAsync();
+    static bool isAsyncEnabled();
+    /**
+     * @brief Waits until the writer wrote every record logged before this call.
+     */
+    static void flushAsync();
+    /**
+     * @brief Returns how many records were discarded because a ring buffer was full.
+     */
+    static uint64_t asyncDroppedCount();
+
 protected:
     void fatalAbort();
 
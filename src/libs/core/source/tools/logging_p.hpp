@@ -50,6 +50,7 @@ public:
     virtual ~LoggerPrivate();
 
     bool messageHandlerOutput(const Context &context, const char *message);
+    void sinkOutput(const Context &context, const char *message);
 
     bool mNoSource;
     const int mIdNumber;
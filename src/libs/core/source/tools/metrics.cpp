@@ -23,30 +23,157 @@
 ***********************************************************************************************************************/
 
 #include "metrics.hpp"
+#include <openctk/core/file_wrapper.hpp>
 #include <openctk/core/mutex.hpp>
+#include <openctk/core/bits.hpp>
 
 #include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <cmath>
 
 OCTK_BEGIN_NAMESPACE
 
 namespace metrics
 {
 class Histogram;
+class LatencyHistogram;
 
 namespace
 {
-// Limit for the maximum number of sample values that can be stored.
-// TODO(asapersson): Consider using bucket count (and set up
-// linearly/exponentially spaced buckets) if samples are logged more frequently.
-const int kMaxSampleMapSize = 300;
+// Samples are counted in per thread shards so that concurrent adds neither take a lock nor bounce the same cache
+// lines between cores. Threads are mapped to a shard round robin on first use and shards are summed when read.
+const size_t kShardCount = 8;
+
+// Histograms whose value range (underflow bucket included) is at most this wide keep one counter per value, wider
+// ones use log-linear buckets reported by their lower bound.
+const int64_t kMaxDenseRange = 1024;
+
+// Log-linear buckets: values below kSubBucketCount get their own bucket, then every power of two range is split
+// in kSubBucketCount buckets, so a bucket never spans more than 1 / 32 of its values.
+const int kSubBucketBits = 5;
+const uint64_t kSubBucketCount = uint64_t(1) << kSubBucketBits;
+
+size_t LogLinearBucket(uint64_t value)
+{
+    if (value < kSubBucketCount)
+    {
+        return static_cast<size_t>(value);
+    }
+    const int shift = 63 - utils::countl_zero(value) - kSubBucketBits;
+    return (static_cast<size_t>(shift + 1) << kSubBucketBits) + ((value >> shift) & (kSubBucketCount - 1));
+}
+
+uint64_t LogLinearLowerBound(size_t bucket)
+{
+    if (bucket < kSubBucketCount)
+    {
+        return bucket;
+    }
+    const int shift = static_cast<int>(bucket >> kSubBucketBits) - 1;
+    return (kSubBucketCount + (bucket & (kSubBucketCount - 1))) << shift;
+}
+
+uint64_t LogLinearUpperBound(size_t bucket) { return LogLinearLowerBound(bucket + 1) - 1; }
+
+size_t CurrentShard()
+{
+    static std::atomic<size_t> next_shard(0);
+    thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+    return shard;
+}
+
+// Fixed size array of atomic counters, sharded per thread. Shards are allocated by the first thread adding to them.
+template <typename T>
+class ShardedCounters
+{
+public:
+    explicit ShardedCounters(size_t size)
+        : size_(size)
+    {
+        for (auto &shard : shards_)
+        {
+            shard.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    ~ShardedCounters()
+    {
+        for (auto &shard : shards_)
+        {
+            delete[] shard.load(std::memory_order_relaxed);
+        }
+    }
+
+    ShardedCounters(const ShardedCounters &) = delete;
+    ShardedCounters &operator=(const ShardedCounters &) = delete;
+
+    size_t size() const { return size_; }
+
+    void Add(size_t index, T value) { LocalShard()[index].fetch_add(value, std::memory_order_relaxed); }
+
+    // Sums the shards. With `reset` the counters are exchanged with zero, so that no concurrent add gets lost: it is
+    // either part of this sum or of the next one.
+    std::vector<T> Sum(bool reset) const
+    {
+        std::vector<T> totals(size_, 0);
+        for (const auto &slot : shards_)
+        {
+            std::atomic<T> *shard = slot.load(std::memory_order_acquire);
+            if (!shard)
+            {
+                continue;
+            }
+            for (size_t i = 0; i < size_; ++i)
+            {
+                totals[i] += reset ? shard[i].exchange(0, std::memory_order_relaxed)
+                                   : shard[i].load(std::memory_order_relaxed);
+            }
+        }
+        return totals;
+    }
+
+private:
+    std::atomic<T> *LocalShard()
+    {
+        std::atomic<std::atomic<T> *> &slot = shards_[CurrentShard()];
+        std::atomic<T> *shard = slot.load(std::memory_order_acquire);
+        if (!shard)
+        {
+            std::atomic<T> *created = new std::atomic<T>[size_]();
+            if (slot.compare_exchange_strong(shard, created, std::memory_order_acq_rel))
+            {
+                shard = created;
+            }
+            else
+            {
+                delete[] created;
+            }
+        }
+        return shard;
+    }
+
+    const size_t size_;
+    std::atomic<std::atomic<T> *> shards_[kShardCount];
+};
 
 class RtcHistogram
 {
 public:
+    struct Bucket
+    {
+        int lower;
+        int upper;
+        int count;
+    };
+
     RtcHistogram(StringView name, int min, int max, int bucket_count)
         : min_(min)
         , max_(max)
-        , info_(name, min, max, bucket_count)
+        , bucket_count_(bucket_count)
+        , name_(name)
+        , dense_(static_cast<int64_t>(max) - min + 2 <= kMaxDenseRange)
+        , counts_(dense_ ? static_cast<size_t>(static_cast<int64_t>(max) - min + 2)
+                         : LogLinearBucket(static_cast<uint64_t>(static_cast<int64_t>(max) - min + 1)) + 1)
     {
         OCTK_DCHECK_GT(bucket_count, 0);
     }
@@ -59,76 +186,194 @@ public:
         sample = std::min(sample, max_);
         sample = std::max(sample, min_ - 1); // Underflow bucket.
 
-        Mutex::Lock lock(mutex_);
-        if (info_.samples.size() == kMaxSampleMapSize && info_.samples.find(sample) == info_.samples.end())
-        {
-            return;
-        }
-        ++info_.samples[sample];
+        const uint64_t offset = static_cast<uint64_t>(static_cast<int64_t>(sample) - (min_ - 1));
+        counts_.Add(dense_ ? static_cast<size_t>(offset) : LogLinearBucket(offset), 1);
     }
 
     // Returns a copy (or nullptr if there are no samples) and clears samples.
     std::unique_ptr<SampleInfo> GetAndReset()
     {
-        Mutex::Lock lock(mutex_);
-        if (info_.samples.empty())
+        std::map<int, int> samples = ToSamples(Buckets(true));
+        if (samples.empty())
         {
             return nullptr;
         }
 
-        SampleInfo *copy = new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count);
+        SampleInfo *copy = new SampleInfo(name_, min_, max_, bucket_count_);
 
-        std::swap(info_.samples, copy->samples);
+        std::swap(samples, copy->samples);
 
         return std::unique_ptr<SampleInfo>(copy);
     }
 
-    const std::string &name() const { return info_.name; }
+    const std::string &name() const { return name_; }
+    int min() const { return min_; }
+    int max() const { return max_; }
 
-    // Functions only for testing.
-    void Reset()
+    // Non empty buckets in ascending order, dense histograms have lower == upper.
+    std::vector<Bucket> Buckets(bool reset) const
     {
-        Mutex::Lock lock(mutex_);
-        info_.samples.clear();
+        const std::vector<int> counts = counts_.Sum(reset);
+        std::vector<Bucket> buckets;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i] <= 0)
+            {
+                continue;
+            }
+            const int64_t base = static_cast<int64_t>(min_) - 1;
+            const int64_t lower = base + static_cast<int64_t>(dense_ ? i : LogLinearLowerBound(i));
+            const int64_t upper = dense_ ? lower : base + static_cast<int64_t>(LogLinearUpperBound(i));
+            buckets.push_back({static_cast<int>(lower), static_cast<int>(std::min<int64_t>(upper, max_)), counts[i]});
+        }
+        return buckets;
     }
 
+    // Functions only for testing.
+    void Reset() { counts_.Sum(true); }
+
     int NumEvents(int sample) const
     {
-        Mutex::Lock lock(mutex_);
-        const auto it = info_.samples.find(sample);
-        return (it == info_.samples.end()) ? 0 : it->second;
+        const std::map<int, int> samples = Samples();
+        const auto it = samples.find(sample);
+        return (it == samples.end()) ? 0 : it->second;
     }
 
     int NumSamples() const
     {
         int num_samples = 0;
-        Mutex::Lock lock(mutex_);
-        for (const auto &sample : info_.samples)
+        for (const auto &bucket : Buckets(false))
         {
-            num_samples += sample.second;
+            num_samples += bucket.count;
         }
         return num_samples;
     }
 
     int MinSample() const
     {
-        Mutex::Lock lock(mutex_);
-        return (info_.samples.empty()) ? -1 : info_.samples.begin()->first;
+        const std::vector<Bucket> buckets = Buckets(false);
+        return buckets.empty() ? -1 : buckets.front().lower;
     }
 
-    std::map<int, int> Samples() const
+    std::map<int, int> Samples() const { return ToSamples(Buckets(false)); }
+
+private:
+    static std::map<int, int> ToSamples(const std::vector<Bucket> &buckets)
     {
-        Mutex::Lock lock(mutex_);
-        return info_.samples;
+        std::map<int, int> samples;
+        for (const auto &bucket : buckets)
+        {
+            samples.emplace_hint(samples.end(), bucket.lower, bucket.count);
+        }
+        return samples;
     }
 
-private:
     const int min_;
     const int max_;
-    mutable Mutex mutex_;
-    SampleInfo info_ OCTK_ATTRIBUTE_GUARDED_BY(mutex_);
+    const int bucket_count_;
+    const std::string name_;
+    const bool dense_;
+    ShardedCounters<int> counts_;
 };
 
+class RtcLatencyHistogram
+{
+public:
+    RtcLatencyHistogram(StringView name, int64_t highest_trackable_value)
+        : name_(name)
+        , highest_(std::max<int64_t>(highest_trackable_value, 1))
+        , counts_(LogLinearBucket(static_cast<uint64_t>(highest_)) + 1)
+        , sum_(1)
+        , min_(std::numeric_limits<int64_t>::max())
+        , max_(std::numeric_limits<int64_t>::min())
+    {
+    }
+
+    RtcLatencyHistogram(const RtcLatencyHistogram &) = delete;
+    RtcLatencyHistogram &operator=(const RtcLatencyHistogram &) = delete;
+
+    void Add(int64_t sample)
+    {
+        sample = std::min(std::max<int64_t>(sample, 0), highest_);
+        counts_.Add(LogLinearBucket(static_cast<uint64_t>(sample)), 1);
+        sum_.Add(0, sample);
+
+        // Extremes only move while warming up, after that these are plain loads.
+        int64_t min = min_.load(std::memory_order_relaxed);
+        while (sample < min && !min_.compare_exchange_weak(min, sample, std::memory_order_relaxed))
+        {
+        }
+        int64_t max = max_.load(std::memory_order_relaxed);
+        while (sample > max && !max_.compare_exchange_weak(max, sample, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Returns a copy (or nullptr if `reset` and there are no samples).
+    std::unique_ptr<LatencySnapshot> Snapshot(bool reset)
+    {
+        std::unique_ptr<LatencySnapshot> snapshot(new LatencySnapshot(name_));
+        const std::vector<uint64_t> counts = counts_.Sum(reset);
+        snapshot->sum = sum_.Sum(reset)[0];
+        const int64_t min = reset ? min_.exchange(std::numeric_limits<int64_t>::max()) : min_.load();
+        const int64_t max = reset ? max_.exchange(std::numeric_limits<int64_t>::min()) : max_.load();
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i] > 0)
+            {
+                const int64_t upper = std::min(static_cast<int64_t>(LogLinearUpperBound(i)), highest_);
+                snapshot->buckets.emplace_back(upper, counts[i]);
+                snapshot->count += counts[i];
+            }
+        }
+        if (0 == snapshot->count)
+        {
+            return reset ? nullptr : std::move(snapshot);
+        }
+        snapshot->min = min <= max ? min : 0;
+        snapshot->max = min <= max ? max : 0;
+        return snapshot;
+    }
+
+    const std::string &name() const { return name_; }
+
+private:
+    const std::string name_;
+    const int64_t highest_;
+    ShardedCounters<uint64_t> counts_;
+    ShardedCounters<int64_t> sum_;
+    std::atomic<int64_t> min_;
+    std::atomic<int64_t> max_;
+};
+
+// Metric names are [a-zA-Z_:][a-zA-Z0-9_:]*, anything else becomes an underscore.
+std::string OpenMetricsName(const std::string &name)
+{
+    std::string result = name.empty() ? std::string("_") : name;
+    for (auto &c : result)
+    {
+        const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == ':';
+        if (!valid)
+        {
+            c = '_';
+        }
+    }
+    if (result[0] >= '0' && result[0] <= '9')
+    {
+        result.insert(result.begin(), '_');
+    }
+    return result;
+}
+
+std::string FormatDouble(double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+    return buffer;
+}
+
+const double kExportedPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+
 class RtcHistogramMap
 {
 public:
@@ -166,6 +411,20 @@ public:
         return reinterpret_cast<Histogram *>(hist);
     }
 
+    LatencyHistogram *GetLatencyHistogram(StringView name, int64_t highest_trackable_value)
+    {
+        Mutex::Lock lock(mutex_);
+        const auto &it = latency_map_.find(name.data());
+        if (it != latency_map_.end())
+        {
+            return reinterpret_cast<LatencyHistogram *>(it->second.get());
+        }
+
+        RtcLatencyHistogram *hist = new RtcLatencyHistogram(name, highest_trackable_value);
+        latency_map_.emplace(name, hist);
+        return reinterpret_cast<LatencyHistogram *>(hist);
+    }
+
     void GetAndReset(std::map<std::string, std::unique_ptr<SampleInfo>, StringViewCmp> *histograms)
     {
         Mutex::Lock lock(mutex_);
@@ -179,6 +438,54 @@ public:
         }
     }
 
+    void GetAndResetLatencies(std::map<std::string, std::unique_ptr<LatencySnapshot>, StringViewCmp> *histograms)
+    {
+        Mutex::Lock lock(mutex_);
+        for (const auto &kv : latency_map_)
+        {
+            std::unique_ptr<LatencySnapshot> snapshot = kv.second->Snapshot(true);
+            if (snapshot)
+            {
+                histograms->insert(std::make_pair(kv.first, std::move(snapshot)));
+            }
+        }
+    }
+
+    std::unique_ptr<LatencySnapshot> GetLatencySnapshot(StringView name) const
+    {
+        Mutex::Lock lock(mutex_);
+        const auto &it = latency_map_.find(name.data());
+        return (it == latency_map_.end()) ? nullptr : it->second->Snapshot(false);
+    }
+
+    std::string Export(ExportFormat format) const
+    {
+        Mutex::Lock lock(mutex_);
+        std::string out;
+        for (const auto &kv : map_)
+        {
+            const std::vector<RtcHistogram::Bucket> buckets = kv.second->Buckets(false);
+            if (!buckets.empty())
+            {
+                ExportFormat::kText == format ? AppendText(kv.first, *kv.second, buckets, &out)
+                                              : AppendOpenMetrics(kv.first, buckets, &out);
+            }
+        }
+        for (const auto &kv : latency_map_)
+        {
+            std::unique_ptr<LatencySnapshot> snapshot = kv.second->Snapshot(false);
+            if (snapshot->count > 0)
+            {
+                ExportFormat::kText == format ? AppendText(*snapshot, &out) : AppendOpenMetrics(*snapshot, &out);
+            }
+        }
+        if (ExportFormat::kOpenMetrics == format)
+        {
+            out += "# EOF\n";
+        }
+        return out;
+    }
+
     // Functions only for testing.
     void Reset()
     {
@@ -187,6 +494,10 @@ public:
         {
             kv.second->Reset();
         }
+        for (const auto &kv : latency_map_)
+        {
+            kv.second->Snapshot(true);
+        }
     }
 
     int NumEvents(StringView name, int sample) const
@@ -218,10 +529,70 @@ public:
     }
 
 private:
+    static void AppendText(const std::string &name,
+                           const RtcHistogram &histogram,
+                           const std::vector<RtcHistogram::Bucket> &buckets,
+                           std::string *out)
+    {
+        int count = 0;
+        std::string values;
+        for (const auto &bucket : buckets)
+        {
+            count += bucket.count;
+            values += (values.empty() ? "" : ", ") + std::to_string(bucket.lower) + ": " + std::to_string(bucket.count);
+        }
+        *out += name + " [" + std::to_string(histogram.min()) + ", " + std::to_string(histogram.max()) +
+                "] samples=" + std::to_string(count) + " {" + values + "}\n";
+    }
+
+    static void AppendText(const LatencySnapshot &snapshot, std::string *out)
+    {
+        *out += snapshot.name + " count=" + std::to_string(snapshot.count) + " min=" + std::to_string(snapshot.min) +
+                " mean=" + FormatDouble(snapshot.Mean());
+        for (double percentile : kExportedPercentiles)
+        {
+            *out += " p" + FormatDouble(percentile) + "=" + std::to_string(snapshot.Percentile(percentile));
+        }
+        *out += " max=" + std::to_string(snapshot.max) + "\n";
+    }
+
+    static void AppendOpenMetrics(const std::string &name,
+                                  const std::vector<RtcHistogram::Bucket> &buckets,
+                                  std::string *out)
+    {
+        const std::string metric = OpenMetricsName(name);
+        int64_t count = 0;
+        int64_t sum = 0;
+        *out += "# TYPE " + metric + " histogram\n";
+        for (const auto &bucket : buckets)
+        {
+            count += bucket.count;
+            sum += static_cast<int64_t>(bucket.lower) * bucket.count;
+            *out += metric + "_bucket{le=\"" + std::to_string(bucket.upper) + "\"} " + std::to_string(count) + "\n";
+        }
+        *out += metric + "_bucket{le=\"+Inf\"} " + std::to_string(count) + "\n";
+        *out += metric + "_count " + std::to_string(count) + "\n";
+        *out += metric + "_sum " + std::to_string(sum) + "\n";
+    }
+
+    static void AppendOpenMetrics(const LatencySnapshot &snapshot, std::string *out)
+    {
+        const std::string metric = OpenMetricsName(snapshot.name);
+        *out += "# TYPE " + metric + " summary\n";
+        for (double percentile : kExportedPercentiles)
+        {
+            *out += metric + "{quantile=\"" + FormatDouble(percentile / 100.0) + "\"} " +
+                    std::to_string(snapshot.Percentile(percentile)) + "\n";
+        }
+        *out += metric + "_count " + std::to_string(snapshot.count) + "\n";
+        *out += metric + "_sum " + std::to_string(snapshot.sum) + "\n";
+    }
+
     mutable Mutex mutex_;
     std::map<std::string, std::unique_ptr<RtcHistogram>, StringViewCmp> map_ OCTK_ATTRIBUTE_GUARDED_BY(mutex_);
+    std::map<std::string, std::unique_ptr<RtcLatencyHistogram>, StringViewCmp> latency_map_
+        OCTK_ATTRIBUTE_GUARDED_BY(mutex_);
 };
-
 // RtcHistogramMap is allocated upon call to Enable().
 // The histogram getter functions, which return pointer values to the histograms
 // in the map, are cached in WebRTC. Therefore, this memory is not freed by the
@@ -315,6 +686,28 @@ void HistogramAdd(Histogram *histogram_pointer, int sample)
     ptr->Add(sample);
 }
 
+// Latency histogram with log-linear buckets.
+// Creates (or finds) histogram.
+// The returned histogram pointer is cached (and used for adding samples in
+// subsequent calls).
+LatencyHistogram *LatencyHistogramFactoryGet(StringView name, int64_t highest_trackable_value)
+{
+    RtcHistogramMap *map = GetMap();
+    if (!map)
+    {
+        return nullptr;
+    }
+
+    return map->GetLatencyHistogram(name, highest_trackable_value);
+}
+
+// Fast path. Adds `sample` to cached `histogram_pointer`.
+void LatencyHistogramAdd(LatencyHistogram *histogram_pointer, int64_t sample)
+{
+    RtcLatencyHistogram *ptr = reinterpret_cast<RtcLatencyHistogram *>(histogram_pointer);
+    ptr->Add(sample);
+}
+
 #endif // OCTK_EXCLUDE_METRICS_DEFAULT
 
 SampleInfo::SampleInfo(StringView name, int min, int max, size_t bucket_count)
@@ -329,6 +722,37 @@ SampleInfo::~SampleInfo()
 {
 }
 
+LatencySnapshot::LatencySnapshot(StringView name)
+    : name(name)
+{
+}
+
+LatencySnapshot::~LatencySnapshot()
+{
+}
+
+int64_t LatencySnapshot::Percentile(double percentile) const
+{
+    if (0 == count)
+    {
+        return 0;
+    }
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count)));
+    uint64_t seen = 0;
+    for (const auto &bucket : buckets)
+    {
+        seen += bucket.second;
+        if (seen >= rank)
+        {
+            return std::min(std::max(bucket.first, min), max);
+        }
+    }
+    return max;
+}
+
+double LatencySnapshot::Mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
 // Implementation of global functions in metrics.h.
 void Enable()
 {
@@ -349,6 +773,61 @@ void GetAndReset(std::map<std::string, std::unique_ptr<SampleInfo>, StringViewCm
     }
 }
 
+void GetAndResetLatencies(std::map<std::string, std::unique_ptr<LatencySnapshot>, StringViewCmp> *histograms)
+{
+    histograms->clear();
+    RtcHistogramMap *map = GetMap();
+    if (map)
+    {
+        map->GetAndResetLatencies(histograms);
+    }
+}
+
+std::unique_ptr<LatencySnapshot> GetLatencySnapshot(StringView name)
+{
+    RtcHistogramMap *map = GetMap();
+    return map ? map->GetLatencySnapshot(name) : nullptr;
+}
+
+std::string Export(ExportFormat format)
+{
+    RtcHistogramMap *map = GetMap();
+    if (map)
+    {
+        return map->Export(format);
+    }
+    return ExportFormat::kOpenMetrics == format ? "# EOF\n" : "";
+}
+
+bool ExportToFile(StringView path, ExportFormat format)
+{
+    const std::string content = Export(format);
+    const std::string target(path);
+    const std::string temporary = target + ".tmp";
+    {
+        FileWrapper file = FileWrapper::OpenWriteOnly(temporary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        if (!file.Write(content.data(), content.size()) || !file.Close())
+        {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+#if defined(OCTK_OS_WIN)
+    // rename() does not replace an existing file on windows
+    std::remove(target.c_str());
+#endif
+    if (0 != std::rename(temporary.c_str(), target.c_str()))
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
 void Reset()
 {
     RtcHistogramMap *map = GetMap();
@@ -33,6 +33,7 @@
 #include <atomic>
 #include <string>
 #include <memory>
+#include <vector>
 #include <map>
 
 #if defined(OCTK_DISABLE_METRICS)
@@ -78,6 +79,16 @@ Histogram *SparseHistogramFactoryGetEnumeration(StringView name, int boundary);
 // Function for adding a `sample` to a histogram.
 void HistogramAdd(Histogram *histogram_pointer, int sample);
 
+class LatencyHistogram;
+
+// Get HDR style histogram for latencies (constructs or finds the named histogram).
+// Samples are clamped to [0, highest_trackable_value] and counted in log-linear buckets precise to about 3% of
+// their value, so percentiles stay accurate over the whole range at a fixed memory cost.
+LatencyHistogram *LatencyHistogramFactoryGet(StringView name, int64_t highest_trackable_value);
+
+// Function for adding a `sample` to a latency histogram.
+void LatencyHistogramAdd(LatencyHistogram *histogram_pointer, int64_t sample);
+
 struct SampleInfo
 {
     SampleInfo(StringView name, int min, int max, size_t bucket_count);
@@ -90,6 +101,23 @@ struct SampleInfo
     std::map<int, int> samples; // <value, # of events>
 };
 
+struct LatencySnapshot
+{
+    explicit LatencySnapshot(StringView name);
+    ~LatencySnapshot();
+
+    // Returns the upper bound of the bucket holding `percentile` (0 - 100), clamped to [min, max], or 0 when empty.
+    int64_t Percentile(double percentile) const;
+    double Mean() const;
+
+    const std::string name;
+    uint64_t count = 0;
+    int64_t sum = 0;
+    int64_t min = 0;
+    int64_t max = 0;
+    std::vector<std::pair<int64_t, uint64_t>> buckets; // <bucket upper bound, # of events>, ascending
+};
+
 // Enables collection of samples.
 // This method should be called before any other call into webrtc.
 void Enable();
@@ -97,6 +125,25 @@ void Enable();
 // Gets histograms and clears all samples.
 void GetAndReset(std::map<std::string, std::unique_ptr<SampleInfo>, StringViewCmp> *histograms);
 
+// Gets latency histograms and clears all samples.
+void GetAndResetLatencies(std::map<std::string, std::unique_ptr<LatencySnapshot>, StringViewCmp> *histograms);
+
+// Returns a copy of the named latency histogram without clearing it (or nullptr if it does not exist).
+std::unique_ptr<LatencySnapshot> GetLatencySnapshot(StringView name);
+
+enum class ExportFormat
+{
+    kText,       // one human readable line per histogram
+    kOpenMetrics // OpenMetrics text exposition, served as "application/openmetrics-text; version=1.0.0"
+};
+
+// Renders every histogram holding samples, without clearing them. Names are sanitized to valid metric names
+// for OpenMetrics: counts histograms are exposed as histograms and latency histograms as summaries.
+std::string Export(ExportFormat format = ExportFormat::kOpenMetrics);
+
+// Writes Export() to `path` through a temporary file renamed over it, so readers never see a partial dump.
+bool ExportToFile(StringView path, ExportFormat format = ExportFormat::kOpenMetrics);
+
 // Functions below are mainly for testing.
 
 // Clears all samples.
@@ -265,6 +312,27 @@ std::map<int, int> Samples(StringView name);
             }                                                                                                          \
         } while (0)
 
+// Histogram for latencies (log-linear buckets, see LatencyHistogramFactoryGet). The name should not vary.
+#    define OCTK_LATENCY_HISTOGRAM_US(name, sample) OCTK_LATENCY_HISTOGRAM(name, sample, 60000000)
+#    define OCTK_LATENCY_HISTOGRAM_MS(name, sample) OCTK_LATENCY_HISTOGRAM(name, sample, 3600000)
+#    define OCTK_LATENCY_HISTOGRAM(constant_name, sample, highest_trackable_value)                                     \
+        do                                                                                                             \
+        {                                                                                                              \
+            static std::atomic<octk::metrics::LatencyHistogram *> atomic_histogram_pointer(nullptr);                   \
+            octk::metrics::LatencyHistogram *histogram_pointer =                                                       \
+                atomic_histogram_pointer.load(std::memory_order_acquire);                                              \
+            if (!histogram_pointer)                                                                                    \
+            {                                                                                                          \
+                histogram_pointer = octk::metrics::LatencyHistogramFactoryGet(constant_name, highest_trackable_value); \
+                octk::metrics::LatencyHistogram *null_histogram = nullptr;                                             \
+                atomic_histogram_pointer.compare_exchange_strong(null_histogram, histogram_pointer);                   \
+            }                                                                                                          \
+            if (histogram_pointer)                                                                                     \
+            {                                                                                                          \
+                octk::metrics::LatencyHistogramAdd(histogram_pointer, sample);                                         \
+            }                                                                                                          \
+        } while (0)
+
 // Helper macros.
 // Macros for calling a histogram with varying name (e.g. when using a metric
 // in different modes such as real-time vs screenshare). Fast, because pointer
@@ -336,6 +404,10 @@ std::map<int, int> Samples(StringView name);
 #    define OCTK_HISTOGRAM_PERCENTAGE(name, sample)            octk::metrics::detail::NoOp(name, sample)
 #    define OCTK_HISTOGRAM_BOOLEAN(name, sample)               octk::metrics::detail::NoOp(name, sample)
 #    define OCTK_HISTOGRAM_ENUMERATION(name, sample, boundary) octk::metrics::detail::NoOp(name, sample, boundary)
+#    define OCTK_LATENCY_HISTOGRAM_US(name, sample) octk::metrics::detail::NoOp(name, sample)
+#    define OCTK_LATENCY_HISTOGRAM_MS(name, sample) octk::metrics::detail::NoOp(name, sample)
+#    define OCTK_LATENCY_HISTOGRAM(constant_name, sample, highest_trackable_value)                                     \
+        octk::metrics::detail::NoOp(constant_name, sample, highest_trackable_value)
 #    define OCTK_HISTOGRAM_COMMON_BLOCK(constant_name, sample, factory_get_invocation)                                 \
         octk::metrics::detail::NoOp(constant_name, sample, factory_get_invocation)
 #    define OCTK_HISTOGRAM_COMMON_BLOCK_SLOW(name, sample, factory_get_invocation)                                     \
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <cstring>
 #include <cstdio>
+#include <random>
 
 using namespace octk;
 
@@ -1454,4 +1455,162 @@ TEST(Base64, GetNextBase64Char)
     EXPECT_FALSE(Base64::GetNextBase64Char('&', &next_char));
     EXPECT_FALSE(Base64::GetNextBase64Char('Z', nullptr));
 }
+std::string RandomBytes(std::mt19937 &random, size_t size)
+{
+    std::string bytes(size, '\0');
+    for (auto &byte : bytes)
+    {
+        byte = static_cast<char>(random() & 0xff);
+    }
+    return bytes;
+}
+
+// Byte at a time encoder the bulk kernels are checked against.
+std::string ReferenceEncode(const std::string &data)
+{
+    static const char kTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string result;
+    for (size_t i = 0; i < data.size(); i += 3)
+    {
+        uint32_t group = static_cast<uint8_t>(data[i]) << 16;
+        if (i + 1 < data.size())
+        {
+            group |= static_cast<uint8_t>(data[i + 1]) << 8;
+        }
+        if (i + 2 < data.size())
+        {
+            group |= static_cast<uint8_t>(data[i + 2]);
+        }
+        result += kTable[group >> 18];
+        result += kTable[(group >> 12) & 0x3f];
+        result += i + 1 < data.size() ? kTable[(group >> 6) & 0x3f] : '=';
+        result += i + 2 < data.size() ? kTable[group & 0x3f] : '=';
+    }
+    return result;
+}
+
+TEST(Base64, BulkEncodeDecodeMatchReference)
+{
+    std::mt19937 random(20260317);
+    for (size_t size = 0; size < 600; ++size)
+    {
+        const std::string data = RandomBytes(random, size);
+        const std::string encoded = Base64::Encode(data);
+        ASSERT_EQ(ReferenceEncode(data), encoded) << "size " << size;
+
+        std::string decoded;
+        size_t used = 0;
+        EXPECT_TRUE(Base64::DecodeFromArray(encoded.data(), encoded.size(), Base64::DO_STRICT, &decoded, &used));
+        EXPECT_EQ(encoded.size(), used);
+        ASSERT_EQ(data, decoded) << "size " << size;
+    }
+}
+
+TEST(Base64, BulkDecodeStopsAtIllegalCharacter)
+{
+    std::mt19937 random(7);
+    const std::string data = RandomBytes(random, 300);
+    const std::string encoded = Base64::Encode(data);
+    for (size_t position = 0; position + 4 < encoded.size(); ++position)
+    {
+        std::string corrupted = encoded;
+        corrupted[position] = '*';
+        std::string decoded;
+        size_t used = 0;
+        Base64::DecodeFromArray(corrupted.data(), corrupted.size(), Base64::DO_STRICT, &decoded, &used);
+        EXPECT_EQ(position, used);
+        ASSERT_GE(decoded.size(), (position / 4) * 3);
+        EXPECT_EQ(data.substr(0, (position / 4) * 3), decoded.substr(0, (position / 4) * 3));
+    }
+}
+
+TEST(Base64, BulkDecodeWrappedLines)
+{
+    std::mt19937 random(11);
+    const std::string data = RandomBytes(random, 4096);
+    const std::string encoded = Base64::Encode(data);
+    std::string wrapped;
+    for (size_t i = 0; i < encoded.size(); i += 76)
+    {
+        wrapped += encoded.substr(i, 76) + "\r\n";
+    }
+    EXPECT_EQ(data, Base64::Decode(wrapped, Base64::DO_PARSE_WHITE | Base64::DO_PAD_YES | Base64::DO_TERM_BUFFER));
+}
+
+TEST(Base64, DecodeToArrayWritesCallerBuffer)
+{
+    const char encoded[] = "SGVsbG8sIFdvcmxkIQ==";
+    uint8_t buffer[32];
+    ASSERT_LE(Base64::GetMaxDecodedSize(sizeof(encoded) - 1), sizeof(buffer));
+    size_t length = 0;
+    size_t used = 0;
+    EXPECT_TRUE(Base64::DecodeToArray(encoded, sizeof(encoded) - 1, Base64::DO_STRICT, buffer, &length, &used));
+    EXPECT_EQ(sizeof(encoded) - 1, used);
+    EXPECT_EQ("Hello, World!", std::string(reinterpret_cast<const char *>(buffer), length));
+
+    char text[32];
+    ASSERT_LE(Base64::GetEncodedSize(13), sizeof(text));
+    length = Base64::EncodeToArray("Hello, World!", 13, text);
+    EXPECT_EQ(Base64::GetEncodedSize(13), length);
+    EXPECT_EQ(std::string(encoded), std::string(text, length));
+}
+
+TEST(Base64, StreamingMatchesOneShot)
+{
+    std::mt19937 random(3);
+    for (int round = 0; round < 50; ++round)
+    {
+        const std::string data = RandomBytes(random, random() % 2000);
+        const std::string encoded = Base64::Encode(data);
+
+        Base64::Encoder encoder;
+        std::string streamed;
+        for (size_t i = 0; i < data.size();)
+        {
+            const size_t piece = std::min<size_t>(random() % 70, data.size() - i);
+            encoder.Update(data.data() + i, piece, &streamed);
+            i += piece;
+        }
+        encoder.Finish(&streamed);
+        ASSERT_EQ(encoded, streamed);
+
+        Base64::Decoder decoder(Base64::DO_STRICT);
+        std::string decoded;
+        for (size_t i = 0; i < encoded.size();)
+        {
+            const size_t piece = std::min<size_t>(random() % 90, encoded.size() - i);
+            ASSERT_TRUE(decoder.Update(encoded.data() + i, piece, &decoded));
+            i += piece;
+        }
+        EXPECT_TRUE(decoder.Finish(&decoded));
+        ASSERT_EQ(data, decoded);
+    }
+}
+
+TEST(Base64, StreamingDecoderAppliesFlags)
+{
+    std::string decoded;
+    Base64::Decoder white(Base64::DO_PARSE_WHITE | Base64::DO_PAD_YES | Base64::DO_TERM_BUFFER);
+    EXPECT_TRUE(white.Update("YWJj\nZA", 7, &decoded));
+    EXPECT_TRUE(white.Update("=\n=", 3, &decoded));
+    EXPECT_TRUE(white.Finish(&decoded));
+    EXPECT_EQ("abcd", decoded);
+
+    decoded.clear();
+    Base64::Decoder strict(Base64::DO_STRICT);
+    EXPECT_FALSE(strict.Update("YWJj\nZA==", 9, &decoded));
+    EXPECT_FALSE(strict.Finish(&decoded));
+    EXPECT_EQ("abc", decoded);
+
+    decoded.clear();
+    Base64::Decoder unpadded(Base64::DO_STRICT);
+    EXPECT_TRUE(unpadded.Update("YWJjZA", 6, &decoded));
+    EXPECT_FALSE(unpadded.Finish(&decoded));
+
+    decoded.clear();
+    Base64::Decoder lax(Base64::DO_LAX);
+    EXPECT_TRUE(lax.Update("YWJjZA", 6, &decoded));
+    EXPECT_TRUE(lax.Finish(&decoded));
+    EXPECT_EQ("abcd", decoded);
+}
 }  // namespace
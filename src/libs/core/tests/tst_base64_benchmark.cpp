@@ -0,0 +1,131 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+#include <openctk/core/base64.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+std::string randomBytes(size_t size)
+{
+    std::mt19937 random(static_cast<uint32_t>(size));
+    std::string bytes(size, '\0');
+    for (auto &byte : bytes)
+    {
+        byte = static_cast<char>(random() & 0xff);
+    }
+    return bytes;
+}
+} // namespace
+
+void BM_Base64Encode(benchmark::State &state)
+{
+    const std::string data = randomBytes(state.range(0));
+    std::string result;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        Base64::EncodeFromArray(data.data(), data.size(), &result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Base64Decode(benchmark::State &state)
+{
+    const std::string encoded = Base64::Encode(randomBytes(state.range(0)));
+    std::string result;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        Base64::DecodeFromArray(encoded.data(), encoded.size(), Base64::DO_STRICT, &result, nullptr);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+
+void BM_Base64DecodeToArray(benchmark::State &state)
+{
+    const std::string encoded = Base64::Encode(randomBytes(state.range(0)));
+    std::vector<uint8_t> buffer(Base64::GetMaxDecodedSize(encoded.size()));
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        size_t length = 0;
+        Base64::DecodeToArray(encoded.data(), encoded.size(), Base64::DO_STRICT, buffer.data(), &length, nullptr);
+        benchmark::DoNotOptimize(length);
+    }
+    state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+
+void BM_Base64DecodeWrapped(benchmark::State &state)
+{
+    const std::string encoded = Base64::Encode(randomBytes(state.range(0)));
+    std::string wrapped;
+    for (size_t i = 0; i < encoded.size(); i += 76)
+    {
+        wrapped += encoded.substr(i, 76) + "\r\n";
+    }
+    const Base64::DecodeFlags flags = Base64::DO_PARSE_WHITE | Base64::DO_PAD_YES | Base64::DO_TERM_BUFFER;
+    std::string result;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        Base64::DecodeFromArray(wrapped.data(), wrapped.size(), flags, &result, nullptr);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(state.iterations() * wrapped.size());
+}
+
+void BM_Base64StreamingDecode(benchmark::State &state)
+{
+    const std::string encoded = Base64::Encode(randomBytes(1 << 20));
+    const size_t piece = state.range(0);
+    std::vector<uint8_t> buffer(Base64::Decoder::GetMaxUpdateSize(piece));
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        Base64::Decoder decoder(Base64::DO_STRICT);
+        size_t length = 0;
+        for (size_t i = 0; i < encoded.size(); i += piece)
+        {
+            decoder.Update(encoded.data() + i, std::min(piece, encoded.size() - i), buffer.data(), &length);
+        }
+        decoder.Finish(buffer.data(), &length);
+        benchmark::DoNotOptimize(length);
+    }
+    state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+
+BENCHMARK(BM_Base64Encode)->Arg(32)->Arg(1024)->Arg(64 * 1024)->Arg(1 << 20);
+BENCHMARK(BM_Base64Decode)->Arg(32)->Arg(1024)->Arg(64 * 1024)->Arg(1 << 20);
+BENCHMARK(BM_Base64DecodeToArray)->Arg(32)->Arg(1024)->Arg(64 * 1024)->Arg(1 << 20);
+BENCHMARK(BM_Base64DecodeWrapped)->Arg(64 * 1024);
+BENCHMARK(BM_Base64StreamingDecode)->Arg(1000)->Arg(64 * 1024);
+
+OCTK_END_NAMESPACE
@@ -27,7 +27,11 @@
 #include <openctk/core/logging.hpp>
 
 #include <list>
+#include <cmath>
 #include <atomic>
+#include <vector>
+#include <numeric>
+#include <stdexcept>
 #include <thread>
 #include <memory>
 #include <random>
@@ -46,6 +50,176 @@ void light()
 }
 } // namespace
 
-TEST(ConcurrentRunTest, RunLightFunction) { }
+TEST(ConcurrentRunTest, RunLightFunction)
+{
+    concurrent::run(light).result();
+
+    const auto callerId = std::this_thread::get_id();
+    std::thread::id runId;
+    auto future = concurrent::run(
+        [&]()
+        {
+            runId = std::this_thread::get_id();
+            return 42;
+        });
+    EXPECT_EQ(future.result(), 42);
+    EXPECT_NE(runId, callerId);
+}
+
+TEST(ConcurrentRunTest, RunNested)
+{
+    auto future = concurrent::run([]() { return concurrent::run([]() { return std::string("inner"); }); });
+    EXPECT_EQ(future.result(), "inner");
+}
+
+TEST(ConcurrentMapTest, MapInPlace)
+{
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 0);
+    auto future = concurrent::map(values, [](int &value) { value *= 2; });
+    future.wait();
+    EXPECT_TRUE(future.isFinished());
+    EXPECT_FALSE(future.isCanceled());
+    EXPECT_EQ(future.progressMinimum(), 0);
+    EXPECT_EQ(future.progressMaximum(), 10000);
+    EXPECT_EQ(future.progressValue(), 10000);
+    for (int i = 0; i < int(values.size()); ++i)
+    {
+        ASSERT_EQ(values[i], i * 2);
+    }
+}
+
+TEST(ConcurrentMapTest, BlockingMap)
+{
+    std::vector<int> values(1000, 1);
+    concurrent::blockingMap(values.begin(), values.end(), [](int &value) { value += 1; });
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0), 2000);
+
+    std::vector<int> empty;
+    concurrent::blockingMap(empty, [](int &) { FAIL(); });
+}
+
+TEST(ConcurrentMapTest, BlockingMapNested)
+{
+    // blocking algorithms let the calling pool thread work, nesting must not dead lock a saturated pool
+    ThreadPool pool;
+    pool.setMaxThreadCount(2);
+    std::vector<std::vector<int>> rows(8, std::vector<int>(100, 1));
+    concurrent::blockingMap(
+        rows,
+        [&pool](std::vector<int> &row) { concurrent::blockingMap(row, [](int &value) { value = 3; }, &pool); },
+        &pool);
+    for (const auto &row : rows)
+    {
+        EXPECT_EQ(std::accumulate(row.begin(), row.end(), 0), 300);
+    }
+}
+
+TEST(ConcurrentMapTest, Mapped)
+{
+    std::vector<int> values(5000);
+    std::iota(values.begin(), values.end(), 0);
+    auto future = concurrent::mapped(values, [](int value) { return std::to_string(value); });
+    const auto &results = future.result();
+    ASSERT_EQ(results.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        ASSERT_EQ(results[i], std::to_string(values[i]));
+    }
+}
+
+TEST(ConcurrentFilterTest, Filter)
+{
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 0);
+    auto future = concurrent::filter(values, [](int value) { return 0 == value % 3; });
+    const auto &results = future.result();
+    ASSERT_EQ(results.size(), size_t(3334));
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        ASSERT_EQ(results[i], int(i) * 3);
+    }
+}
+
+TEST(ConcurrentReduceTest, Reduce)
+{
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 1);
+    auto sum = concurrent::reduce(
+        values,
+        [](int value) { return int64_t(value) * value; },
+        [](int64_t &result, int64_t value) { result += value; },
+        int64_t(0));
+    EXPECT_EQ(sum.result(), int64_t(10000) * 10001 * 20001 / 6);
+
+    // the fold runs in sequence order
+    std::vector<std::string> words = {"a", "b", "c", "d", "e"};
+    auto joined = concurrent::reduce(
+        words,
+        [](const std::string &word) { return word; },
+        [](std::string &result, const std::string &word) { result += word; },
+        std::string(">"));
+    EXPECT_EQ(joined.result(), ">abcde");
+}
+
+TEST(ConcurrentParallelForTest, ParallelFor)
+{
+    std::vector<std::atomic<int>> hits(20000);
+    for (auto &hit : hits)
+    {
+        hit.store(0);
+    }
+    auto future = concurrent::parallelFor(100, 20100, [&](int64_t index) { hits[index - 100].fetch_add(1); });
+    future.result();
+    for (const auto &hit : hits)
+    {
+        ASSERT_EQ(hit.load(), 1);
+    }
+
+    std::atomic<int64_t> sum{0};
+    concurrent::blockingParallelFor(0, 1000, [&](int64_t index) { sum.fetch_add(index); });
+    EXPECT_EQ(sum.load(), 999 * 1000 / 2);
+    concurrent::blockingParallelFor(10, 0, [&](int64_t) { FAIL(); });
+}
+
+TEST(ConcurrentParallelForTest, Cancel)
+{
+    std::atomic<int> count{0};
+    auto future = concurrent::parallelFor(0,
+                                          100000,
+                                          [&](int64_t)
+                                          {
+                                              count.fetch_add(1);
+                                              std::this_thread::sleep_for(std::chrono::microseconds(50));
+                                          });
+    while (count.load() < 10)
+    {
+        std::this_thread::yield();
+    }
+    future.cancel();
+    EXPECT_TRUE(future.waitFor(5000));
+    EXPECT_TRUE(future.isCanceled());
+    EXPECT_LT(count.load(), 100000);
+    EXPECT_LT(future.progressValue(), 100000);
+}
+
+#if OCTK_HAS_EXCEPTIONS
+TEST(ConcurrentMapTest, Exception)
+{
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+    auto future = concurrent::mapped(values,
+                                     [](int value)
+                                     {
+                                         if (500 == value)
+                                         {
+                                             throw std::runtime_error("bad value");
+                                         }
+                                         return value;
+                                     });
+    EXPECT_THROW(future.result(), std::runtime_error);
+    EXPECT_THROW(concurrent::blockingMap(values, [](int &) { throw std::logic_error("bad"); }), std::logic_error);
+}
+#endif
 
 OCTK_END_NAMESPACE
\ No newline at end of file
@@ -311,6 +311,18 @@ TEST(EnumFlagsTest, TestFlag)
     EXPECT_FALSE(f.testFlag(enum_testFlag::value_2));
 }
 
+TEST(EnumFlagsTest, SetFlag)
+{
+    enum_testFlags f = enum_testFlag::value_1 | enum_testFlag::value_2;
+
+    f.setFlag(enum_testFlag::value_3);
+    EXPECT_TRUE(f.testFlag(enum_testFlag::value_3));
+    f.setFlag(enum_testFlag::value_1, false);
+    EXPECT_FALSE(f.testFlag(enum_testFlag::value_1));
+    EXPECT_TRUE(f.testFlag(enum_testFlag::value_2));
+    EXPECT_EQ(f, enum_testFlag::value_2 | enum_testFlag::value_3);
+}
+
 TEST(EnumFlagsTest, ConstExpr)
 {
     MockMouseButtons btn = MockMouseButton::LeftButton | MockMouseButton::RightButton;
@@ -0,0 +1,355 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/event_loop_thread.hpp>
+#include <openctk/core/event_loop.hpp>
+#include <openctk/core/semaphore.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <ctime>
+
+#if defined(OCTK_OS_LINUX)
+#    include <unistd.h>
+#endif
+
+#if OCTK_FEATURE_ENABLE_KERNEL
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+constexpr int kTimeoutMSecs = 1000;
+
+class EventReceiver : public Object
+{
+public:
+    bool event(Event *event) override
+    {
+        if (event->type() >= Event::Type::kUser)
+        {
+            EXPECT_TRUE(event->isPosted());
+            mCustomEvents.fetch_add(1);
+            mSemaphore.release();
+            return true;
+        }
+        return Object::event(event);
+    }
+
+    std::atomic<int> mCustomEvents{0};
+    std::atomic<int> mTimerEvents{0};
+    Semaphore mSemaphore;
+
+protected:
+    void timerEvent(TimerEvent *event) override
+    {
+        EXPECT_GT(event->timerId(), 0);
+        mTimerEvents.fetch_add(1);
+        mSemaphore.release();
+    }
+};
+
+bool acquire(Semaphore &semaphore, int count = 1)
+{
+    return semaphore.tryAcquireFor(count, std::chrono::milliseconds(kTimeoutMSecs));
+}
+} // namespace
+
+TEST(EventLoopTest, PostEvent)
+{
+    EventLoop eventLoop;
+    EventReceiver receiver;
+    eventLoop.postEvent(&receiver, new Event(Event::Type::kUser));
+    eventLoop.postEvent(&receiver, new Event(Event::Type::kUser));
+    EXPECT_EQ(receiver.mCustomEvents.load(), 0);
+    EXPECT_TRUE(eventLoop.processEvents());
+    EXPECT_EQ(receiver.mCustomEvents.load(), 2);
+    EXPECT_FALSE(eventLoop.processEvents());
+}
+
+TEST(EventLoopTest, RemovePostedEvents)
+{
+    EventLoop eventLoop;
+    EventReceiver receiver1;
+    EventReceiver receiver2;
+    eventLoop.postEvent(&receiver1, new Event(Event::Type::kUser));
+    eventLoop.postEvent(&receiver2, new Event(Event::Type::kUser));
+    eventLoop.removePostedEvents(&receiver1);
+    eventLoop.processEvents();
+    EXPECT_EQ(receiver1.mCustomEvents.load(), 0);
+    EXPECT_EQ(receiver2.mCustomEvents.load(), 1);
+}
+
+TEST(EventLoopTest, ReceiverDeletedByEarlierHandler)
+{
+    class Deleter : public Object
+    {
+    public:
+        bool event(Event *event) override
+        {
+            if (event->type() >= Event::Type::kUser)
+            {
+                delete mVictim;
+                mVictim = nullptr;
+                return true;
+            }
+            return Object::event(event);
+        }
+        Object *mVictim{nullptr};
+    };
+
+    EventLoop eventLoop;
+    Deleter deleter;
+    EventReceiver survivor;
+    auto victim = new EventReceiver;
+    deleter.mVictim = victim;
+    eventLoop.postEvent(&deleter, new Event(Event::Type::kUser));
+    // queued in the same batch as the deleting event, must be dropped with the receiver
+    eventLoop.postEvent(victim, new Event(Event::Type::kUser));
+    eventLoop.postEvent(&survivor, new Event(Event::Type::kUser));
+    eventLoop.postEvent(victim, new Event(Event::Type::kUser));
+    EXPECT_TRUE(eventLoop.processEvents());
+    EXPECT_EQ(deleter.mVictim, nullptr);
+    EXPECT_EQ(survivor.mCustomEvents.load(), 1);
+    EXPECT_FALSE(eventLoop.processEvents());
+}
+
+TEST(EventLoopTest, RemovePostedEventsFromHandler)
+{
+    class Remover : public Object
+    {
+    public:
+        Remover(EventLoop *eventLoop, Object *target)
+            : mEventLoop(eventLoop)
+            , mTarget(target)
+        {
+        }
+        bool event(Event *event) override
+        {
+            if (event->type() >= Event::Type::kUser)
+            {
+                mEventLoop->removePostedEvents(mTarget);
+                return true;
+            }
+            return Object::event(event);
+        }
+        EventLoop *const mEventLoop;
+        Object *const mTarget;
+    };
+
+    EventLoop eventLoop;
+    EventReceiver receiver;
+    Remover remover(&eventLoop, &receiver);
+    eventLoop.postEvent(&remover, new Event(Event::Type::kUser));
+    eventLoop.postEvent(&receiver, new Event(Event::Type::kUser));
+    eventLoop.processEvents();
+    EXPECT_EQ(receiver.mCustomEvents.load(), 0);
+}
+
+TEST(EventLoopTest, DestroyedReceiverDropsTimers)
+{
+    EventLoop eventLoop;
+    auto receiver = new EventReceiver;
+    const int timerId = eventLoop.registerTimer(1, receiver);
+    EXPECT_GT(timerId, 0);
+    delete receiver;
+    // the timer was unregistered with its receiver, its expiry must not reach the deleted object
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    eventLoop.processEvents();
+    EXPECT_FALSE(eventLoop.unregisterTimer(timerId));
+}
+
+TEST(EventLoopTest, ExecAndExit)
+{
+    EventLoop eventLoop;
+    EXPECT_FALSE(eventLoop.isRunning());
+    std::thread thread(
+        [&]()
+        {
+            while (!eventLoop.isRunning())
+            {
+                std::this_thread::yield();
+            }
+            eventLoop.exit(3);
+        });
+    EXPECT_EQ(eventLoop.exec(), 3);
+    EXPECT_FALSE(eventLoop.isRunning());
+    thread.join();
+}
+
+TEST(EventLoopTest, QuitEvent)
+{
+    EventLoop eventLoop;
+    eventLoop.postEvent(&eventLoop, new Event(Event::Type::kQuit));
+    EXPECT_EQ(eventLoop.exec(), 0);
+}
+
+TEST(EventLoopTest, Timer)
+{
+    EventLoopThread thread;
+    EventReceiver receiver;
+    const int timerId = thread.eventLoop()->registerTimer(2, &receiver);
+    EXPECT_GT(timerId, 0);
+    thread.start();
+    EXPECT_TRUE(acquire(receiver.mSemaphore, 3));
+    EXPECT_TRUE(thread.eventLoop()->unregisterTimer(timerId));
+    EXPECT_FALSE(thread.eventLoop()->unregisterTimer(timerId));
+    thread.quit();
+    EXPECT_TRUE(thread.wait(kTimeoutMSecs));
+    EXPECT_GE(receiver.mTimerEvents.load(), 3);
+}
+
+TEST(EventLoopTest, SingleShotTimer)
+{
+    EventLoop eventLoop;
+    std::atomic<int> count{0};
+    const auto start = std::chrono::steady_clock::now();
+    const int timerId = eventLoop.registerTimer(
+        5,
+        [&](int) { count.fetch_add(1); },
+        true);
+    EXPECT_GT(timerId, 0);
+    while (0 == count.load() && std::chrono::steady_clock::now() - start < std::chrono::milliseconds(kTimeoutMSecs))
+    {
+        eventLoop.processEvents(EventLoop::ProcessFlag::kWaitForMoreEvents);
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(5));
+    eventLoop.processEvents(EventLoop::ProcessFlags(), 20);
+    EXPECT_EQ(count.load(), 1);
+    EXPECT_FALSE(eventLoop.unregisterTimer(timerId));
+}
+
+TEST(EventLoopTest, TimerUnregisterItself)
+{
+    EventLoop eventLoop;
+    int count = 0;
+    eventLoop.registerTimer(1,
+                            [&](int timerId)
+                            {
+                                if (3 == ++count)
+                                {
+                                    eventLoop.unregisterTimer(timerId);
+                                    eventLoop.quit();
+                                }
+                            });
+    eventLoop.exec();
+    EXPECT_EQ(count, 3);
+}
+
+#if defined(OCTK_OS_LINUX)
+TEST(EventLoopTest, FdNotifier)
+{
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    EventLoopThread thread;
+    Semaphore semaphore;
+    std::atomic<char> received{0};
+    EXPECT_TRUE(thread.eventLoop()->registerFdNotifier(fds[0],
+                                                       EventLoop::FdEvent::kRead,
+                                                       [&](int fd, EventLoop::FdEvents events)
+                                                       {
+                                                           EXPECT_TRUE(events.testFlag(EventLoop::FdEvent::kRead));
+                                                           char value = 0;
+                                                           EXPECT_EQ(::read(fd, &value, 1), 1);
+                                                           received.store(value);
+                                                           semaphore.release();
+                                                       }));
+    EXPECT_FALSE(thread.eventLoop()->registerFdNotifier(fds[0], EventLoop::FdEvent::kRead, [](int, EventLoop::FdEvents) { }));
+    thread.start();
+    const char value = 'x';
+    EXPECT_EQ(::write(fds[1], &value, 1), 1);
+    EXPECT_TRUE(acquire(semaphore));
+    EXPECT_EQ(received.load(), 'x');
+    EXPECT_TRUE(thread.eventLoop()->unregisterFdNotifier(fds[0]));
+    EXPECT_FALSE(thread.eventLoop()->unregisterFdNotifier(fds[0]));
+    thread.quit();
+    EXPECT_TRUE(thread.wait(kTimeoutMSecs));
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+#endif
+
+TEST(EventLoopTest, IdleLoopSleeps)
+{
+    EventLoopThread thread;
+    EventReceiver receiver;
+    thread.start();
+    thread.eventLoop()->postEvent(&receiver, new Event(Event::Type::kUser));
+    EXPECT_TRUE(acquire(receiver.mSemaphore));
+
+    // a busy spinning loop would burn the whole interval
+    const std::clock_t cpuStart = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const double cpuMSecs = 1000.0 * double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    EXPECT_LT(cpuMSecs, 20.0);
+
+    thread.eventLoop()->postEvent(&receiver, new Event(Event::Type::kUser));
+    EXPECT_TRUE(acquire(receiver.mSemaphore));
+    thread.exit(5);
+    EXPECT_TRUE(thread.wait(kTimeoutMSecs));
+}
+
+TEST(EventLoopTest, QuitBeforeStart)
+{
+    EventLoopThread thread;
+    thread.quit();
+    thread.start();
+    EXPECT_TRUE(thread.wait(kTimeoutMSecs));
+}
+
+TEST(EventLoopTest, ManyProducers)
+{
+    const int producers = 4;
+    const int runs = 10000;
+    EventLoopThread thread;
+    EventReceiver receiver;
+    thread.start();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; ++i)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for (int j = 0; j < runs; ++j)
+                {
+                    thread.eventLoop()->postEvent(&receiver, new Event(Event::Type::kUser));
+                }
+            });
+    }
+    for (auto &producer : threads)
+    {
+        producer.join();
+    }
+    EXPECT_TRUE(acquire(receiver.mSemaphore, producers * runs));
+    EXPECT_EQ(receiver.mCustomEvents.load(), producers * runs);
+    thread.quit();
+    EXPECT_TRUE(thread.wait(kTimeoutMSecs));
+}
+
+OCTK_END_NAMESPACE
+
+#endif // #if OCTK_FEATURE_ENABLE_KERNEL
@@ -0,0 +1,125 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/event_loop_thread.hpp>
+#include <openctk/core/event_loop.hpp>
+#include <openctk/core/semaphore.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+
+#if OCTK_FEATURE_ENABLE_KERNEL
+
+using namespace octk;
+
+namespace
+{
+class PingReceiver : public Object
+{
+public:
+    bool event(Event *event) override
+    {
+        if (event->type() >= Event::Type::kUser)
+        {
+            mCount.fetch_add(1, std::memory_order_relaxed);
+            mSemaphore.release();
+            return true;
+        }
+        return Object::event(event);
+    }
+
+    std::atomic<int64_t> mCount{0};
+    Semaphore mSemaphore;
+};
+} // namespace
+
+/**
+ * Round trip of one posted event to an idle loop thread, i.e. the latency of waking a loop blocked in the dispatcher.
+ */
+void BM_EventLoopWakeUpLatency(benchmark::State &state)
+{
+    EventLoopThread thread;
+    PingReceiver receiver;
+    thread.start();
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        thread.eventLoop()->postEvent(&receiver, new Event(Event::Type::kUser));
+        receiver.mSemaphore.acquire();
+    }
+    thread.quit();
+    thread.wait();
+}
+
+/**
+ * Throughput of posting a batch of events that the loop drains with one wakeup.
+ */
+void BM_EventLoopPostEvents(benchmark::State &state)
+{
+    const int64_t batch = state.range(0);
+    EventLoopThread thread;
+    PingReceiver receiver;
+    thread.start();
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        for (int64_t i = 0; i < batch; ++i)
+        {
+            thread.eventLoop()->postEvent(&receiver, new Event(Event::Type::kUser));
+        }
+        receiver.mSemaphore.acquire(static_cast<int>(batch));
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+    thread.quit();
+    thread.wait();
+}
+
+/**
+ * Lateness of a 1ms single shot timer armed on an idle loop.
+ */
+void BM_EventLoopTimerLatency(benchmark::State &state)
+{
+    EventLoopThread thread;
+    Semaphore semaphore;
+    thread.start();
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        const auto start = std::chrono::steady_clock::now();
+        thread.eventLoop()->registerTimer(1, [&](int) { semaphore.release(); }, true);
+        semaphore.acquire();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        state.SetIterationTime(std::chrono::duration<double>(elapsed - std::chrono::milliseconds(1)).count());
+    }
+    thread.quit();
+    thread.wait();
+}
+
+BENCHMARK(BM_EventLoopWakeUpLatency)->UseRealTime();
+BENCHMARK(BM_EventLoopPostEvents)->Arg(1000)->UseRealTime();
+BENCHMARK(BM_EventLoopTimerLatency)->UseManualTime()->Iterations(200);
+
+#endif // #if OCTK_FEATURE_ENABLE_KERNEL
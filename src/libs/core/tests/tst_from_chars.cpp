@@ -0,0 +1,213 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/from_chars.hpp>
+#include <openctk/core/ascii.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+using namespace octk;
+
+namespace
+{
+template <typename T> T parseOk(const std::string &str)
+{
+    T value = T(42);
+    const utils::FromCharsResult result = utils::fromChars(str, value);
+    EXPECT_EQ(std::errc(), result.ec) << str;
+    EXPECT_EQ(str.data() + str.size(), result.ptr) << str;
+    return value;
+}
+
+template <typename T> void expectError(const std::string &str, std::errc ec, size_t consumed)
+{
+    T value = T(42);
+    const utils::FromCharsResult result = utils::fromChars(str, value);
+    EXPECT_EQ(ec, result.ec) << str;
+    EXPECT_EQ(str.data() + consumed, result.ptr) << str;
+    EXPECT_EQ(T(42), value) << str;
+}
+
+template <typename T> void expectSameBits(T expected, T actual, const std::string &str)
+{
+    EXPECT_EQ(0, std::memcmp(&expected, &actual, sizeof(T))) << str;
+}
+} // namespace
+
+TEST(FromCharsTest, Integers)
+{
+    EXPECT_EQ(0, parseOk<int>("0"));
+    EXPECT_EQ(-128, parseOk<int8_t>("-128"));
+    EXPECT_EQ(255u, parseOk<uint8_t>("255"));
+    EXPECT_EQ(std::numeric_limits<int64_t>::min(), parseOk<int64_t>("-9223372036854775808"));
+    EXPECT_EQ(std::numeric_limits<uint64_t>::max(), parseOk<uint64_t>("18446744073709551615"));
+
+    int value = 0;
+    const char kHex[] = "7fFfzz";
+    const utils::FromCharsResult result = utils::fromChars(kHex, kHex + 6, value, 16);
+    EXPECT_EQ(std::errc(), result.ec);
+    EXPECT_EQ(kHex + 4, result.ptr);
+    EXPECT_EQ(0x7fff, value);
+
+    expectError<int8_t>("128", std::errc::result_out_of_range, 3);
+    expectError<int8_t>("-129", std::errc::result_out_of_range, 4);
+    expectError<uint64_t>("18446744073709551616", std::errc::result_out_of_range, 20);
+    expectError<unsigned>("-1", std::errc::invalid_argument, 0);
+    expectError<int>("+1", std::errc::invalid_argument, 0);
+    expectError<int>(" 1", std::errc::invalid_argument, 0);
+    expectError<int>("-", std::errc::invalid_argument, 0);
+    expectError<int>("", std::errc::invalid_argument, 0);
+}
+
+TEST(FromCharsTest, FloatingPoint)
+{
+    EXPECT_EQ(0.1, parseOk<double>("0.1"));
+    EXPECT_EQ(0.1f, parseOk<float>("0.1"));
+    EXPECT_EQ(0.5, parseOk<double>(".5"));
+    EXPECT_EQ(5.0, parseOk<double>("5."));
+    EXPECT_EQ(1e23, parseOk<double>("1e23"));
+    EXPECT_EQ(-2.5e-3, parseOk<double>("-2.5E-3"));
+    EXPECT_EQ(1e300, parseOk<double>("1e+300"));
+    EXPECT_TRUE(std::signbit(parseOk<double>("-0")));
+    EXPECT_EQ(0.0, parseOk<double>("0e999999999999999999"));
+    EXPECT_EQ(std::numeric_limits<double>::max(), parseOk<double>("1.7976931348623157e308"));
+    EXPECT_EQ(std::numeric_limits<double>::min(), parseOk<double>("2.2250738585072014e-308"));
+    EXPECT_EQ(std::numeric_limits<double>::denorm_min(), parseOk<double>("4.9406564584124654e-324"));
+    EXPECT_EQ(std::numeric_limits<float>::max(), parseOk<float>("3.4028235e38"));
+    EXPECT_EQ(std::numeric_limits<float>::denorm_min(), parseOk<float>("1.4e-45"));
+    // Exactly halfway between 2^53 and 2^53 + 2, rounds to even, and just above halfway.
+    EXPECT_EQ(9007199254740992.0, parseOk<double>("9007199254740993"));
+    EXPECT_EQ(9007199254740994.0, parseOk<double>("9007199254740993.000000000000000000001"));
+    EXPECT_EQ(1.0, parseOk<double>("1.00000000000000000000000000000000000000000000000000000000000001"));
+    EXPECT_EQ(123456789012345678901234567890.0, parseOk<double>("123456789012345678901234567890"));
+
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), parseOk<double>("inf"));
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), parseOk<double>("-Infinity"));
+    EXPECT_TRUE(std::isnan(parseOk<double>("nan")));
+    EXPECT_TRUE(std::isnan(parseOk<float>("NaN(1234_abc)")));
+
+    double value = 0;
+    const std::string kPartial = "1.5e+x";
+    const utils::FromCharsResult result = utils::fromChars(kPartial, value);
+    EXPECT_EQ(std::errc(), result.ec);
+    EXPECT_EQ(kPartial.data() + 3, result.ptr);
+    EXPECT_EQ(1.5, value);
+
+    expectError<double>("1e400", std::errc::result_out_of_range, 5);
+    expectError<double>("-1e-400", std::errc::result_out_of_range, 7);
+    expectError<double>("2e-324", std::errc::result_out_of_range, 6);
+    expectError<float>("3.5e38", std::errc::result_out_of_range, 6);
+    expectError<double>(".", std::errc::invalid_argument, 0);
+    expectError<double>("-.e1", std::errc::invalid_argument, 0);
+    expectError<double>("+1", std::errc::invalid_argument, 0);
+    expectError<double>(" 1", std::errc::invalid_argument, 0);
+    expectError<double>("in", std::errc::invalid_argument, 0);
+    expectError<double>("", std::errc::invalid_argument, 0);
+}
+
+TEST(FromCharsTest, MatchesStrtod)
+{
+    std::mt19937_64 random(1234);
+    char buffer[64];
+    for (int i = 0; i < 200000; ++i)
+    {
+        const uint64_t bits = random();
+        double number;
+        std::memcpy(&number, &bits, sizeof(number));
+        if (!std::isfinite(number))
+        {
+            continue;
+        }
+        std::snprintf(buffer, sizeof(buffer), "%.*g", static_cast<int>(random() % 17) + 1, number);
+        // Rounding to fewer digits may leave the range, like 2e308, and floats mostly do.
+        errno = 0;
+        const double expected = std::strtod(buffer, nullptr);
+        if (0 == errno)
+        {
+            expectSameBits(expected, parseOk<double>(buffer), buffer);
+        }
+        errno = 0;
+        const float single = std::strtof(buffer, nullptr);
+        if (0 == errno)
+        {
+            expectSameBits(single, parseOk<float>(buffer), buffer);
+        }
+        std::snprintf(buffer, sizeof(buffer), "%.17g", number);
+        expectSameBits(number, parseOk<double>(buffer), buffer);
+    }
+
+    // Long significands, where digits beyond the 19th decide the rounding.
+    std::string digits;
+    for (int i = 0; i < 100000; ++i)
+    {
+        digits.assign(1, static_cast<char>('1' + random() % 9));
+        const size_t length = random() % 40;
+        const size_t point = random() % (length + 1);
+        for (size_t k = 0; k < length; ++k)
+        {
+            digits += k == point ? '.' : static_cast<char>('0' + random() % 10);
+        }
+        digits += 'e' + std::to_string(static_cast<int>(random() % 600) - 300);
+        double value = 0;
+        if (utils::fromChars(digits, value).ec == std::errc())
+        {
+            expectSameBits(std::strtod(digits.c_str(), nullptr), value, digits);
+        }
+    }
+}
+
+TEST(AsciiStrtodTest, MatchesStrtod)
+{
+    const char *const kInputs[] = {"1.5",     "  -2.25e3 tail", "+7",      "+-7",     "0x1p3", "-0X1.8p1",
+                                   "1e-310",  "1e400",          "1e-400",  "-inf",    "nan(x)", ".5e",
+                                   "1.5e+",   "x",              "",        "1,5",     "\t42",   "4.9e-324"};
+    for (const char *input : kInputs)
+    {
+        char *expectedEnd = nullptr;
+        errno = 0;
+        const double expected = std::strtod(input, &expectedEnd);
+        const int expectedErrno = errno;
+        char *end = nullptr;
+        errno = EINVAL;
+        const double value = ascii_strtod(input, &end);
+        EXPECT_EQ(expectedErrno, errno) << input;
+        EXPECT_EQ(expectedEnd, end) << input;
+        if (std::isnan(expected))
+        {
+            EXPECT_TRUE(std::isnan(value)) << input;
+        }
+        else
+        {
+            expectSameBits(expected, value, input);
+        }
+    }
+    EXPECT_EQ(0.25, ascii_strtod("0.25", nullptr));
+}
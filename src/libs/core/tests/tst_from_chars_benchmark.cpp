@@ -0,0 +1,156 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/from_chars.hpp>
+#include <openctk/core/ascii.hpp>
+#include <openctk/core/string_to_number.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+// Random doubles printed with 17 significant digits, one nul terminated string each.
+std::vector<std::string> randomNumbers(size_t count)
+{
+    std::mt19937_64 random(count);
+    std::uniform_real_distribution<double> exponent(-300, 300);
+    std::vector<std::string> numbers;
+    char buffer[32];
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::snprintf(buffer, sizeof(buffer), "%.17g", (random() % 2 ? -1 : 1) * std::pow(10.0, exponent(random)));
+        numbers.emplace_back(buffer);
+    }
+    return numbers;
+}
+
+size_t totalSize(const std::vector<std::string> &numbers)
+{
+    size_t size = 0;
+    for (const auto &number : numbers)
+    {
+        size += number.size();
+    }
+    return size;
+}
+} // namespace
+
+void BM_FromCharsDouble(benchmark::State &state)
+{
+    const std::vector<std::string> numbers = randomNumbers(1000);
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        for (const auto &number : numbers)
+        {
+            double value;
+            utils::fromChars(number.data(), number.data() + number.size(), value);
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+    state.SetBytesProcessed(state.iterations() * totalSize(numbers));
+}
+
+void BM_StrtodDouble(benchmark::State &state)
+{
+    const std::vector<std::string> numbers = randomNumbers(1000);
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        for (const auto &number : numbers)
+        {
+            benchmark::DoNotOptimize(std::strtod(number.c_str(), nullptr));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+    state.SetBytesProcessed(state.iterations() * totalSize(numbers));
+}
+
+void BM_AsciiStrtod(benchmark::State &state)
+{
+    const std::vector<std::string> numbers = randomNumbers(1000);
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        for (const auto &number : numbers)
+        {
+            benchmark::DoNotOptimize(ascii_strtod(number.c_str(), nullptr));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+    state.SetBytesProcessed(state.iterations() * totalSize(numbers));
+}
+
+void BM_StringToNumberDouble(benchmark::State &state)
+{
+    const std::vector<std::string> numbers = randomNumbers(1000);
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        for (const auto &number : numbers)
+        {
+            benchmark::DoNotOptimize(utils::stringToNumber<double>(number));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+    state.SetBytesProcessed(state.iterations() * totalSize(numbers));
+}
+
+void BM_StringToNumberInt(benchmark::State &state)
+{
+    std::mt19937_64 random(1);
+    std::vector<std::string> numbers;
+    for (int i = 0; i < 1000; ++i)
+    {
+        numbers.push_back(std::to_string(static_cast<int64_t>(random())));
+    }
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        for (const auto &number : numbers)
+        {
+            benchmark::DoNotOptimize(utils::stringToNumber<int64_t>(number));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+    state.SetBytesProcessed(state.iterations() * totalSize(numbers));
+}
+
+BENCHMARK(BM_FromCharsDouble);
+BENCHMARK(BM_StrtodDouble);
+BENCHMARK(BM_AsciiStrtod);
+BENCHMARK(BM_StringToNumberDouble);
+BENCHMARK(BM_StringToNumberInt);
+
+OCTK_END_NAMESPACE
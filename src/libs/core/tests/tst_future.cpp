@@ -23,7 +23,9 @@
 **
 ***********************************************************************************************************************/
 
+#include <openctk/core/task_queue_thread.hpp>
 #include <openctk/core/elapsed_timer.hpp>
+#include <openctk/core/thread_pool.hpp>
 #include <openctk/core/logging.hpp>
 #include <openctk/core/future.hpp>
 
@@ -31,8 +33,10 @@
 #include <atomic>
 #include <thread>
 #include <memory>
+#include <future>
 #include <random>
 #include <utility>
+#include <stdexcept>
 
 #include <gtest/gtest.h>
 
@@ -40,7 +44,288 @@ OCTK_BEGIN_NAMESPACE
 
 namespace
 {
-
+struct MoveOnly
+{
+    explicit MoveOnly(int v = 0)
+        : value(new int(v))
+    {
+    }
+    std::unique_ptr<int> value;
+};
 } // namespace
 
-OCTK_END_NAMESPACE
\ No newline at end of file
+TEST(FutureTest, Invalid)
+{
+    Future<int> future;
+    EXPECT_FALSE(future.isValid());
+    EXPECT_FALSE(future.isFinished());
+    EXPECT_TRUE(future.waitFor(0));
+}
+
+TEST(FutureTest, PromiseSetValue)
+{
+    Promise<int> promise;
+    auto future = promise.future();
+    EXPECT_FALSE(future.isFinished());
+    EXPECT_FALSE(future.waitFor(1));
+    std::thread thread([&]() { EXPECT_TRUE(promise.setValue(7)); });
+    EXPECT_EQ(future.result(), 7);
+    EXPECT_TRUE(future.isSucceeded());
+    EXPECT_FALSE(promise.setValue(8));
+    EXPECT_EQ(future.result(), 7);
+    thread.join();
+
+    Promise<void> voidPromise;
+    auto voidFuture = voidPromise.future();
+    voidPromise.setValue();
+    voidFuture.result();
+    EXPECT_TRUE(voidFuture.isSucceeded());
+}
+
+TEST(FutureTest, SucceededWithResultDespiteCancel)
+{
+    // a producer may still deliver after a cancellation request, void and non-void states agree on the outcome
+    Promise<int> promise;
+    auto future = promise.future();
+    future.cancel();
+    promise.setValue(1);
+    EXPECT_TRUE(future.isCanceled());
+    EXPECT_TRUE(future.isSucceeded());
+
+    Promise<void> voidPromise;
+    auto voidFuture = voidPromise.future();
+    voidFuture.cancel();
+    voidPromise.setValue();
+    EXPECT_TRUE(voidFuture.isCanceled());
+    EXPECT_TRUE(voidFuture.isSucceeded());
+
+    Promise<void> canceledPromise;
+    auto canceledFuture = canceledPromise.future();
+    canceledPromise.setCanceled();
+    EXPECT_FALSE(canceledFuture.isSucceeded());
+}
+
+TEST(FutureTest, StdFutureSpelling)
+{
+    Promise<int> promise;
+    auto future = promise.future();
+    EXPECT_TRUE(future.valid());
+    EXPECT_EQ(std::future_status::timeout, future.wait_for(std::chrono::milliseconds(1)));
+    promise.setValue(3);
+    EXPECT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(0)));
+    EXPECT_EQ(std::future_status::ready, future.wait_until(std::chrono::steady_clock::now()));
+    EXPECT_EQ(3, future.get());
+
+    auto voidFuture = makeReadyFuture();
+    voidFuture.get();
+    EXPECT_FALSE(Future<int>().valid());
+}
+
+TEST(FutureTest, ThenInline)
+{
+    Promise<int> promise;
+    std::thread::id thenId;
+    auto future = promise.future()
+                      .then(
+                          [&](int value)
+                          {
+                              thenId = std::this_thread::get_id();
+                              return value * 2;
+                          })
+                      .then([](int value) { return std::to_string(value); })
+                      .then([](const std::string &value) { return value + "!"; });
+    std::thread thread([&]() { promise.setValue(21); });
+    EXPECT_EQ(future.result(), "42!");
+    EXPECT_NE(thenId, std::this_thread::get_id());
+    thread.join();
+
+    // an already finished future runs the continuation on the calling thread
+    auto ready = makeReadyFuture(1).then(
+        [&](int value)
+        {
+            thenId = std::this_thread::get_id();
+            return value;
+        });
+    EXPECT_TRUE(ready.isFinished());
+    EXPECT_EQ(thenId, std::this_thread::get_id());
+}
+
+TEST(FutureTest, ThenVoid)
+{
+    std::atomic<int> count{0};
+    auto future = makeReadyFuture()
+                      .then([&]() { count.fetch_add(1); })
+                      .then([&]() { return count.fetch_add(1) + 1; })
+                      .then([&](int value) { count.fetch_add(value); });
+    future.result();
+    EXPECT_EQ(count.load(), 4);
+}
+
+TEST(FutureTest, ThenExecutors)
+{
+    ThreadPool pool;
+    auto taskQueue = TaskQueueThread::makeShared();
+    Promise<int> promise;
+    auto future = promise.future()
+                      .then(&pool,
+                            [](int value)
+                            {
+                                EXPECT_NE(ThreadPool::defaultInstance(), nullptr);
+                                return value + 1;
+                            })
+                      .then(taskQueue.get(),
+                            [&](int value)
+                            {
+                                EXPECT_TRUE(taskQueue->isCurrent());
+                                return value + 1;
+                            });
+    promise.setValue(1);
+    EXPECT_EQ(future.result(), 3);
+}
+
+TEST(FutureTest, ThenUnwrap)
+{
+    ThreadPool pool;
+    Promise<int> inner;
+    auto future = makeReadyFuture(1).then([&](int) { return inner.future(); }).then([](int value) { return value * 10; });
+    EXPECT_FALSE(future.isFinished());
+    inner.setValue(5);
+    EXPECT_EQ(future.result(), 50);
+}
+
+TEST(FutureTest, MoveOnlyResult)
+{
+    Promise<MoveOnly> promise;
+    auto future = promise.future().then([](const MoveOnly &value) { return *value.value; });
+    promise.setValue(MoveOnly(3));
+    EXPECT_EQ(future.result(), 3);
+}
+
+#if OCTK_HAS_EXCEPTIONS
+TEST(FutureTest, ExceptionPropagation)
+{
+    std::atomic<bool> skipped{true};
+    auto future = makeReadyFuture(1)
+                      .then([](int) -> int { throw std::runtime_error("failed"); })
+                      .then(
+                          [&](int value)
+                          {
+                              skipped.store(false);
+                              return value;
+                          });
+    EXPECT_TRUE(future.isFinished());
+    EXPECT_TRUE(future.hasException());
+    EXPECT_THROW(future.result(), std::runtime_error);
+    EXPECT_TRUE(skipped.load());
+
+    auto exceptional = makeExceptionalFuture<int>(std::make_exception_ptr(std::logic_error("bad")));
+    EXPECT_THROW(exceptional.result(), std::logic_error);
+}
+
+TEST(FutureTest, BrokenPromise)
+{
+    Future<int> future;
+    {
+        Promise<int> promise;
+        future = promise.future();
+    }
+    EXPECT_TRUE(future.isFinished());
+    EXPECT_THROW(future.result(), std::future_error);
+}
+#endif
+
+TEST(FutureTest, Cancel)
+{
+    Promise<int> promise;
+    std::atomic<bool> ran{false};
+    auto future = promise.future().then(
+        [&](int value)
+        {
+            ran.store(true);
+            return value;
+        });
+    future.cancel();
+    // cancellation is forwarded upstream so the producer can stop early
+    EXPECT_TRUE(promise.isCanceled());
+    EXPECT_TRUE(promise.setCanceled());
+    EXPECT_TRUE(future.isFinished());
+    EXPECT_TRUE(future.isCanceled());
+    EXPECT_FALSE(future.isSucceeded());
+    EXPECT_FALSE(ran.load());
+}
+
+TEST(FutureTest, CancelBeforeExecutor)
+{
+    ThreadPool pool;
+    pool.setMaxThreadCount(1);
+    Promise<void> blocker;
+    pool.start([&]() { blocker.future().wait(); });
+    std::atomic<bool> ran{false};
+    auto future = makeReadyFuture().then(&pool, [&]() { ran.store(true); });
+    future.cancel();
+    blocker.setValue();
+    EXPECT_TRUE(future.waitFor(1000));
+    EXPECT_TRUE(future.isCanceled());
+    EXPECT_FALSE(ran.load());
+}
+
+TEST(FutureTest, WhenAll)
+{
+    std::vector<Promise<int>> promises(3);
+    std::vector<Future<int>> futures;
+    for (auto &promise : promises)
+    {
+        futures.push_back(promise.future());
+    }
+    auto all = whenAll(futures);
+    promises[2].setValue(2);
+    promises[0].setValue(0);
+    EXPECT_FALSE(all.isFinished());
+    promises[1].setValue(1);
+    ASSERT_TRUE(all.isFinished());
+    const auto &results = all.result();
+    ASSERT_EQ(results.size(), size_t(3));
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(results[i].result(), i);
+    }
+
+    EXPECT_TRUE(whenAll(std::vector<Future<int>>()).isFinished());
+}
+
+TEST(FutureTest, WhenAny)
+{
+    std::vector<Promise<int>> promises(3);
+    std::vector<Future<int>> futures;
+    for (auto &promise : promises)
+    {
+        futures.push_back(promise.future());
+    }
+    auto any = whenAny(futures);
+    EXPECT_FALSE(any.isFinished());
+    promises[1].setValue(11);
+    promises[0].setValue(10);
+    ASSERT_TRUE(any.isFinished());
+    EXPECT_EQ(any.result().index, size_t(1));
+    EXPECT_EQ(any.result().future.result(), 11);
+    promises[2].setValue(12);
+
+    EXPECT_TRUE(whenAny(std::vector<Future<int>>()).isCanceled());
+}
+
+TEST(FutureTest, ManyContinuations)
+{
+    Promise<int> promise;
+    auto future = promise.future();
+    std::atomic<int> sum{0};
+    std::vector<Future<void>> continuations;
+    for (int i = 0; i < 10; ++i)
+    {
+        continuations.push_back(future.then([&](int value) { sum.fetch_add(value); }));
+    }
+    promise.setValue(3);
+    whenAll(continuations).wait();
+    EXPECT_EQ(sum.load(), 30);
+}
+
+OCTK_END_NAMESPACE
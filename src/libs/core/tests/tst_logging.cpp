@@ -0,0 +1,157 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/logging.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+OCTK_BEGIN_NAMESPACE
+
+OCTK_DEFINE_LOGGER("octk-logging-test", TEST_LOGGER)
+
+namespace
+{
+size_t countOf(const std::string &text, const std::string &pattern)
+{
+    size_t count = 0;
+    for (auto pos = text.find(pattern); std::string::npos != pos; pos = text.find(pattern, pos + pattern.size()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+Logger::AsyncOptions asyncOptions(size_t ringCapacity, Logger::OverflowPolicy policy)
+{
+    Logger::AsyncOptions options;
+    options.ringCapacity = ringCapacity;
+    options.overflowPolicy = policy;
+    return options;
+}
+} // namespace
+
+TEST(LoggingTest, DeferredFormat)
+{
+    testing::internal::CaptureStdout();
+    OCTK_LOGGING(TEST_LOGGER(), LogLevel::Info, "deferred {} {:.2f} {}", 42, 1.5, true);
+    OCTK_LOGGING(TEST_LOGGER(), LogLevel::Info, "mixed {}", 7) << "tail";
+    OCTK_LOGGING(TEST_LOGGER(), LogLevel::Info, "eager {}", std::string("text"));
+    const auto output = testing::internal::GetCapturedStdout();
+    EXPECT_NE(std::string::npos, output.find("deferred 42 1.50 true"));
+    EXPECT_NE(std::string::npos, output.find("mixed 7tail"));
+    EXPECT_NE(std::string::npos, output.find("eager text"));
+}
+
+TEST(LoggingTest, AsyncKeepsThreadOrder)
+{
+    testing::internal::CaptureStdout();
+    Logger::enableAsync();
+    EXPECT_TRUE(Logger::isAsyncEnabled());
+    for (int i = 0; i < 100; ++i)
+    {
+        OCTK_LOGGING(TEST_LOGGER(), LogLevel::Info, "ordered {}#", i);
+    }
+    OCTK_LOGGING(TEST_LOGGER(), LogLevel::Info, std::string(1000, 'x') + "long");
+    Logger::flushAsync();
+    Logger::disableAsync();
+    EXPECT_FALSE(Logger::isAsyncEnabled());
+    const auto output = testing::internal::GetCapturedStdout();
+    size_t last = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        const auto pos = output.find("ordered " + std::to_string(i) + "#");
+        ASSERT_NE(std::string::npos, pos);
+        EXPECT_GE(pos, last);
+        last = pos;
+    }
+    EXPECT_NE(std::string::npos, output.find(std::string(1000, 'x') + "long"));
+}
+
+TEST(LoggingTest, AsyncBlockLosesNothing)
+{
+    const auto dropped = Logger::asyncDroppedCount();
+    testing::internal::CaptureStdout();
+    Logger::enableAsync(asyncOptions(2, Logger::OverflowPolicy::Block));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            []
+            {
+                for (int i = 0; i < 500; ++i)
+                {
+                    OCTK_LOGGING(TEST_LOGGER(), LogLevel::Debug, "blocking {}", i);
+                }
+            });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    Logger::disableAsync();
+    const auto output = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(2000u, countOf(output, "blocking "));
+    EXPECT_EQ(dropped, Logger::asyncDroppedCount());
+}
+
+TEST(LoggingTest, AsyncDropCountsLostRecords)
+{
+    const auto dropped = Logger::asyncDroppedCount();
+    testing::internal::CaptureStdout();
+    Logger::enableAsync(asyncOptions(2, Logger::OverflowPolicy::Count));
+    for (int i = 0; i < 5000; ++i)
+    {
+        OCTK_LOGGING(TEST_LOGGER(), LogLevel::Debug, "dropping {}", i);
+    }
+    Logger::disableAsync();
+    const auto output = testing::internal::GetCapturedStdout();
+    const auto lost = Logger::asyncDroppedCount() - dropped;
+    EXPECT_EQ(5000u, countOf(output, "dropping ") + lost);
+    if (lost)
+    {
+        EXPECT_NE(std::string::npos, output.find("log messages dropped"));
+    }
+}
+
+TEST(LoggingTest, MessageHandlerStaysSynchronous)
+{
+    std::vector<std::string> messages;
+    TEST_LOGGER().installMessageHandler([&](const char *, const Logger::Context &, const char *message)
+                                        { messages.emplace_back(message); },
+                                        true);
+    Logger::enableAsync();
+    OCTK_LOGGING(TEST_LOGGER(), LogLevel::Warning, "handled {}", 1);
+    OCTK_LOGGING(TEST_LOGGER(), LogLevel::Warning, "handled text");
+    ASSERT_EQ(2u, messages.size());
+    EXPECT_EQ("handled 1", messages[0]);
+    EXPECT_EQ("handled text", messages[1]);
+    Logger::disableAsync();
+    TEST_LOGGER().installMessageHandler(nullptr);
+}
+
+OCTK_END_NAMESPACE
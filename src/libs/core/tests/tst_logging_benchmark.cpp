@@ -0,0 +1,100 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/logging.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#ifdef OCTK_OS_WIN32
+#    include <io.h>
+#    define dup _dup
+#    define dup2 _dup2
+#    define close _close
+#    define OCTK_NULL_DEVICE "NUL"
+#else
+#    include <unistd.h>
+#    define OCTK_NULL_DEVICE "/dev/null"
+#endif
+
+OCTK_BEGIN_NAMESPACE
+
+OCTK_DEFINE_LOGGER("octk-logging-benchmark", BENCHMARK_LOGGER)
+
+namespace
+{
+int stdoutFd = -1;
+
+// Keeps the console out of the numbers while a benchmark runs, the reporter prints to stdout afterwards.
+void loggingSetup(const benchmark::State &state)
+{
+    std::fflush(stdout);
+    stdoutFd = dup(1);
+    OCTK_UNUSED(std::freopen(OCTK_NULL_DEVICE, "w", stdout));
+    if (state.range(0))
+    {
+        Logger::AsyncOptions options;
+        options.ringCapacity = 4096;
+        options.overflowPolicy = Logger::OverflowPolicy::Drop;
+        Logger::enableAsync(options);
+    }
+}
+
+void loggingTeardown(const benchmark::State &)
+{
+    Logger::disableAsync();
+    std::fflush(stdout);
+    dup2(stdoutFd, 1);
+    close(stdoutFd);
+}
+} // namespace
+
+// range(0): 0 synchronous, 1 asynchronous
+void BM_LogDeferredArgs(benchmark::State &state)
+{
+    const auto dropped = Logger::asyncDroppedCount();
+    int64_t i = 0;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        OCTK_LOGGING(BENCHMARK_LOGGER(), LogLevel::Info, "frame {} took {:.3f} ms, keyframe {}", ++i, 1.25, true);
+    }
+    state.counters["dropped"] = static_cast<double>(Logger::asyncDroppedCount() - dropped);
+}
+
+void BM_LogString(benchmark::State &state)
+{
+    const std::string message("frame delivered to sink");
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        OCTK_LOGGING(BENCHMARK_LOGGER(), LogLevel::Info, message);
+    }
+}
+
+BENCHMARK(BM_LogDeferredArgs)->Arg(0)->Arg(1)->Setup(loggingSetup)->Teardown(loggingTeardown);
+BENCHMARK(BM_LogDeferredArgs)->Arg(1)->Threads(4)->Setup(loggingSetup)->Teardown(loggingTeardown);
+BENCHMARK(BM_LogString)->Arg(0)->Arg(1)->Setup(loggingSetup)->Teardown(loggingTeardown);
+
+OCTK_END_NAMESPACE
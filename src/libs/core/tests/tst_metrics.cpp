@@ -28,6 +28,12 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
 OCTK_BEGIN_NAMESPACE
 
 using ::testing::ElementsAre;
@@ -40,6 +46,14 @@ namespace
 {
 const int kSample = 22;
 
+// Metrics have to be enabled once, before any histogram is used.
+class MetricsEnvironment : public ::testing::Environment
+{
+public:
+    void SetUp() override { metrics::Enable(); }
+};
+const auto *const kMetricsEnvironment = ::testing::AddGlobalTestEnvironment(new MetricsEnvironment);
+
 void AddSparseSample(StringView name, int sample)
 {
     OCTK_HISTOGRAM_COUNTS_SPARSE_100(name, sample);
@@ -162,6 +176,133 @@ TEST_F(MetricsTest, RtcHistogramSparse_NonConstantNameWorks)
     EXPECT_THAT(metrics::Samples("Sparse1"), ElementsAre(Pair(kSample, 1)));
     EXPECT_THAT(metrics::Samples("Sparse2"), ElementsAre(Pair(kSample, 1)));
 }
+
+TEST_F(MetricsTest, RtcHistogramCounts_WideRangeUsesLogLinearBuckets)
+{
+    const std::string kName = "Counts1G";
+    const int kLargeSample = 1000003;
+    OCTK_HISTOGRAM_COUNTS_1G(kName, kLargeSample);
+    OCTK_HISTOGRAM_COUNTS_1G(kName, kSample);
+    EXPECT_EQ(2, metrics::NumSamples(kName));
+    const std::map<int, int> samples = metrics::Samples(kName);
+    ASSERT_EQ(2u, samples.size());
+    // small values keep their own bucket, large ones are reported by a lower bound within 1/32 of the value
+    EXPECT_EQ(1, samples.begin()->second);
+    EXPECT_EQ(kSample, samples.begin()->first);
+    EXPECT_LE(samples.rbegin()->first, kLargeSample);
+    EXPECT_GE(samples.rbegin()->first, kLargeSample - kLargeSample / 32);
+}
+
+TEST_F(MetricsTest, RtcHistogramCounts_ConcurrentAdds)
+{
+    const std::string kName = "Counts1000";
+    const int kThreads = 4;
+    const int kSamplesPerThread = 100000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for (int i = 0; i < kSamplesPerThread; ++i)
+                {
+                    OCTK_HISTOGRAM_COUNTS_1000(kName, i % 10 + 1);
+                }
+            });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(kThreads * kSamplesPerThread, metrics::NumSamples(kName));
+    EXPECT_EQ(kThreads * kSamplesPerThread / 10, metrics::NumEvents(kName, 1));
+    EXPECT_EQ(1, metrics::MinSample(kName));
+}
+
+TEST_F(MetricsTest, RtcHistogram_GetAndResetMergesAndClears)
+{
+    const std::string kName = "Counts10000";
+    std::thread other([&]() { OCTK_HISTOGRAM_COUNTS_10000(kName, kSample); });
+    other.join();
+    OCTK_HISTOGRAM_COUNTS_10000(kName, kSample);
+    OCTK_HISTOGRAM_COUNTS_10000(kName, 0);
+
+    std::map<std::string, std::unique_ptr<metrics::SampleInfo>, StringViewCmp> histograms;
+    metrics::GetAndReset(&histograms);
+    ASSERT_EQ(1u, histograms.count(kName));
+    EXPECT_THAT(histograms[kName]->samples, ElementsAre(Pair(0, 1), Pair(kSample, 2)));
+    EXPECT_EQ(0, metrics::NumSamples(kName));
+}
+
+TEST_F(MetricsTest, LatencyHistogram_Percentiles)
+{
+    const std::string kName = "Latency.Percentiles";
+    for (int i = 1; i <= 10000; ++i)
+    {
+        OCTK_LATENCY_HISTOGRAM_US(kName, i);
+    }
+    std::unique_ptr<metrics::LatencySnapshot> snapshot = metrics::GetLatencySnapshot(kName);
+    ASSERT_TRUE(snapshot);
+    EXPECT_EQ(10000u, snapshot->count);
+    EXPECT_EQ(1, snapshot->min);
+    EXPECT_EQ(10000, snapshot->max);
+    EXPECT_DOUBLE_EQ(5000.5, snapshot->Mean());
+    EXPECT_NEAR(5000, snapshot->Percentile(50), 5000 / 32);
+    EXPECT_NEAR(9900, snapshot->Percentile(99), 9900 / 32);
+    EXPECT_EQ(1, snapshot->Percentile(0));
+    EXPECT_EQ(10000, snapshot->Percentile(100));
+}
+
+TEST_F(MetricsTest, LatencyHistogram_ClampsAndResets)
+{
+    const std::string kName = "Latency.Clamped";
+    OCTK_LATENCY_HISTOGRAM(kName, -5, 1000);
+    OCTK_LATENCY_HISTOGRAM(kName, 5000, 1000);
+
+    std::map<std::string, std::unique_ptr<metrics::LatencySnapshot>, StringViewCmp> histograms;
+    metrics::GetAndResetLatencies(&histograms);
+    ASSERT_EQ(1u, histograms.count(kName));
+    EXPECT_EQ(2u, histograms[kName]->count);
+    EXPECT_EQ(0, histograms[kName]->min);
+    EXPECT_EQ(1000, histograms[kName]->max);
+
+    EXPECT_EQ(0u, metrics::GetLatencySnapshot(kName)->count);
+    EXPECT_FALSE(metrics::GetLatencySnapshot("Latency.NonExisting"));
+}
+
+TEST_F(MetricsTest, Export_OpenMetrics)
+{
+    OCTK_HISTOGRAM_COUNTS_100("Export.Counts", 3);
+    OCTK_HISTOGRAM_COUNTS_100("Export.Counts", 5);
+    OCTK_LATENCY_HISTOGRAM_MS("Export.Latency", 7);
+
+    const std::string text = metrics::Export(metrics::ExportFormat::kOpenMetrics);
+    EXPECT_NE(std::string::npos, text.find("# TYPE Export_Counts histogram\n"));
+    EXPECT_NE(std::string::npos, text.find("Export_Counts_bucket{le=\"3\"} 1\n"));
+    EXPECT_NE(std::string::npos, text.find("Export_Counts_bucket{le=\"5\"} 2\n"));
+    EXPECT_NE(std::string::npos, text.find("Export_Counts_bucket{le=\"+Inf\"} 2\n"));
+    EXPECT_NE(std::string::npos, text.find("Export_Counts_sum 8\n"));
+    EXPECT_NE(std::string::npos, text.find("# TYPE Export_Latency summary\n"));
+    EXPECT_NE(std::string::npos, text.find("Export_Latency{quantile=\"0.99\"} 7\n"));
+    EXPECT_NE(std::string::npos, text.find("Export_Latency_count 1\n"));
+    EXPECT_EQ(text.size() - 6, text.rfind("# EOF\n"));
+}
+
+TEST_F(MetricsTest, Export_TextAndFile)
+{
+    OCTK_HISTOGRAM_BOOLEAN("Export.Boolean", 1);
+
+    const std::string text = metrics::Export(metrics::ExportFormat::kText);
+    EXPECT_NE(std::string::npos, text.find("Export.Boolean [1, 2] samples=1 {1: 1}\n"));
+
+    const std::string path = ::testing::TempDir() + "octk_metrics_export.txt";
+    ASSERT_TRUE(metrics::ExportToFile(path, metrics::ExportFormat::kText));
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_EQ(text, content.str());
+    std::remove(path.c_str());
+}
 #endif
 
 OCTK_END_NAMESPACE
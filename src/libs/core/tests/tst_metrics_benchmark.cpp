@@ -0,0 +1,76 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+#include <openctk/core/metrics.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+std::once_flag enableOnce;
+
+void metricsSetup(const benchmark::State &) { std::call_once(enableOnce, [] { metrics::Enable(); }); }
+} // namespace
+
+void BM_HistogramAdd(benchmark::State &state)
+{
+    int i = 0;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        OCTK_HISTOGRAM_COUNTS_1000("Benchmark.Counts", ++i & 1023);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_HistogramAddWideRange(benchmark::State &state)
+{
+    int i = 0;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        OCTK_HISTOGRAM_COUNTS_1G("Benchmark.Counts1G", (++i & 0xffff) * 997);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_LatencyHistogramAdd(benchmark::State &state)
+{
+    int64_t i = 0;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        OCTK_LATENCY_HISTOGRAM_US("Benchmark.Latency", ++i & 0xfffff);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_HistogramAdd)->Setup(metricsSetup)->ThreadRange(1, 8);
+BENCHMARK(BM_HistogramAddWideRange)->Setup(metricsSetup)->ThreadRange(1, 8);
+BENCHMARK(BM_LatencyHistogramAdd)->Setup(metricsSetup)->ThreadRange(1, 8);
+
+OCTK_END_NAMESPACE
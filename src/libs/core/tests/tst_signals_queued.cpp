@@ -0,0 +1,239 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+#include <openctk/core/task_queue_thread.hpp>
+#include <openctk/core/semaphore.hpp>
+#include <openctk/core/signals.hpp>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+OCTK_CXX14_CONSTEXPR TimeDelta kTimeout = TimeDelta::Millis(1000);
+
+// A task queue running its tasks only when asked to, counting how many were posted.
+class ManualTaskQueue final : public TaskQueueBase
+{
+public:
+    using TaskQueueBase::postTask;
+
+    void destroy() override { }
+    bool cancelTask(const Task *) override { return false; }
+    void postTask(const Task::SharedPtr &task, const SourceLocation &) override
+    {
+        ++mPostCount;
+        mTasks.push_back(task);
+    }
+    void postDelayedTask(const Task::SharedPtr &task, const TimeDelta &, const SourceLocation &location) override
+    {
+        this->postTask(task, location);
+    }
+
+    size_t postCount() const { return mPostCount; }
+    size_t pendingCount() const { return mTasks.size(); }
+
+    void runAll()
+    {
+        CurrentSetter setter(this);
+        while (!mTasks.empty())
+        {
+            auto tasks = std::move(mTasks);
+            mTasks.clear();
+            for (auto &task : tasks)
+            {
+                task->run();
+            }
+        }
+    }
+    void dropAll() { mTasks.clear(); }
+
+private:
+    std::vector<Task::SharedPtr> mTasks;
+    size_t mPostCount{0};
+};
+} // namespace
+
+TEST(SignalsQueuedTest, DeliversOnTargetQueue)
+{
+    auto taskQueue = TaskQueueThread::makeShared();
+    Semaphore done;
+    std::atomic<bool> onQueue{false};
+    std::string received;
+
+    Signal<const std::string &> sig;
+    sig.connect_queued(taskQueue.get(),
+                       [&](const std::string &value)
+                       {
+                           onQueue = taskQueue->isCurrent();
+                           received = value;
+                           done.release();
+                       });
+    {
+        std::string value = "queued";
+        sig(value);
+    }
+    ASSERT_TRUE(done.tryAcquireFor(1, std::chrono::microseconds(kTimeout.us())));
+    EXPECT_TRUE(onQueue);
+    EXPECT_EQ(received, "queued");
+}
+
+TEST(SignalsQueuedTest, CoalescesEmissionsIntoOneBatch)
+{
+    ManualTaskQueue taskQueue;
+    std::vector<int> first;
+    std::vector<int> second;
+
+    Signal<int> sig1;
+    Signal<int> sig2;
+    sig1.connect_queued(&taskQueue, [&](int i) { first.push_back(i); });
+    sig1.connect_queued(&taskQueue, [&](int i) { second.push_back(i); });
+    sig2.connect_queued(&taskQueue, [&](int i) { second.push_back(-i); });
+
+    for (int i = 0; i < 100; ++i)
+    {
+        sig1(i);
+    }
+    sig2(1);
+    EXPECT_EQ(taskQueue.postCount(), 1u);
+    EXPECT_TRUE(first.empty());
+
+    taskQueue.runAll();
+    ASSERT_EQ(first.size(), 100u);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(first[i], i);
+    }
+    EXPECT_EQ(second.size(), 101u);
+
+    // the next burst posts a new batch
+    sig1(7);
+    sig1(8);
+    EXPECT_EQ(taskQueue.postCount(), 2u);
+    taskQueue.runAll();
+    EXPECT_EQ(first.back(), 8);
+}
+
+TEST(SignalsQueuedTest, EmissionDuringDeliveryPostsNextBatch)
+{
+    ManualTaskQueue taskQueue;
+    std::vector<int> received;
+
+    Signal<int> sig;
+    sig.connect_queued(&taskQueue,
+                       [&](int i)
+                       {
+                           received.push_back(i);
+                           if (i < 3)
+                           {
+                               sig(i + 1);
+                           }
+                       });
+    sig(0);
+    taskQueue.runAll();
+    EXPECT_EQ(received, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(taskQueue.postCount(), 4u);
+}
+
+TEST(SignalsQueuedTest, DropsCallsAfterReceiverDies)
+{
+    ManualTaskQueue taskQueue;
+    int count = 0;
+
+    Signal<int> sig;
+    {
+        TaskQueueBase::SafetyFlag::ScopedDetached safety;
+        sig.connect_queued(&taskQueue, safety.flag(), [&](int i) { count += i; });
+        sig(1);
+        EXPECT_EQ(taskQueue.postCount(), 1u);
+    }
+    taskQueue.runAll();
+    EXPECT_EQ(count, 0);
+
+    // the next emission notices the dead receiver and disconnects the slot
+    sig(1);
+    EXPECT_EQ(sig.slot_count(), 0u);
+    EXPECT_EQ(taskQueue.postCount(), 1u);
+}
+
+TEST(SignalsQueuedTest, DisconnectDropsPendingCalls)
+{
+    ManualTaskQueue taskQueue;
+    int count = 0;
+
+    Signal<int> sig;
+    auto conn = sig.connect_queued(&taskQueue, [&](int i) { count += i; });
+    sig(1);
+    sig(2);
+    conn.disconnect();
+    taskQueue.runAll();
+    EXPECT_EQ(count, 0);
+}
+
+TEST(SignalsQueuedTest, AbandonedBatchIsReposted)
+{
+    ManualTaskQueue taskQueue;
+    int count = 0;
+
+    Signal<int> sig;
+    sig.connect_queued(&taskQueue, [&](int i) { count += i; });
+    sig(1);
+    taskQueue.dropAll();
+
+    sig(2);
+    EXPECT_EQ(taskQueue.postCount(), 2u);
+    taskQueue.runAll();
+    EXPECT_EQ(count, 2);
+}
+
+TEST(SignalsQueuedTest, BlockingQueuedWaitsForSlot)
+{
+    auto taskQueue = TaskQueueThread::makeShared();
+    std::atomic<bool> onQueue{false};
+    int result = 0;
+
+    Signal<int, int &> sig;
+    sig.connect_queued(
+        taskQueue.get(),
+        [&](int value, int &out)
+        {
+            onQueue = taskQueue->isCurrent();
+            out = value * 2;
+        },
+        signals::ConnectionType::kBlockingQueued);
+    sig(21, result);
+    EXPECT_TRUE(onQueue);
+    EXPECT_EQ(result, 42);
+
+    // emitting from the target queue calls the slot inline instead of dead locking
+    taskQueue->sendTask([&] { sig(4, result); });
+    EXPECT_EQ(result, 8);
+}
+
+OCTK_END_NAMESPACE
@@ -61,6 +61,35 @@ TEST(SimpleStringBuilder, Format)
     EXPECT_EQ(0, strcmp(sb.str(), "Here we go - This is a hex formatted value: 0xdeadbeef"));
 }
 
+TEST(SimpleStringBuilder, FmtFormat)
+{
+    char sb_buf[100];
+    SimpleStringBuilder sb(sb_buf);
+    sb << "Here we go - ";
+    sb.Format(FMT_STRING("This is a hex formatted value: {:#010x}, {}"), 3735928559ULL, "done");
+    EXPECT_EQ(0, strcmp(sb.str(), "Here we go - This is a hex formatted value: 0xdeadbeef, done"));
+    EXPECT_EQ(strlen(sb.str()), sb.size());
+}
+
+TEST(SimpleStringBuilder, NumbersMatchPrintf)
+{
+    const double values[] = {0.0, -0.0, 0.1, 1e-5, 123456.0, 1234567.0, 999999.5, 1e300, -2.5e-300};
+    for (const double value : values)
+    {
+        char expected[64];
+        std::snprintf(expected, sizeof(expected), "%g:%g:%Lg", value, static_cast<float>(value),
+                      static_cast<long double>(value));
+        char sb_buf[100];
+        SimpleStringBuilder sb(sb_buf);
+        sb << value << ':' << static_cast<float>(value) << ':' << static_cast<long double>(value);
+        EXPECT_STREQ(expected, sb.str());
+    }
+    char sb_buf[100];
+    SimpleStringBuilder sb(sb_buf);
+    sb << -2147483647 - 1 << ':' << 4294967295u << ':' << -9223372036854775807ll - 1 << ':' << 18446744073709551615ull;
+    EXPECT_STREQ("-2147483648:4294967295:-9223372036854775808:18446744073709551615", sb.str());
+}
+
 TEST(SimpleStringBuilder, StdString)
 {
     char sb_buf[100];
@@ -187,6 +216,14 @@ TEST(StringBuilder, Format)
     EXPECT_EQ(sb.str(), "Here we go - This is a hex formatted value: 0xdeadbeef");
 }
 
+TEST(StringBuilder, FmtFormat)
+{
+    StringBuilder sb;
+    sb << "a=" << 1;
+    sb.Format(FMT_STRING(" b={:.3f} c={}"), 2.5, StringView("view")).Format(" d={:>4}", 7);
+    EXPECT_EQ("a=1 b=2.500 c=view d=   7", sb.str());
+}
+
 TEST(StringBuilder, StdString)
 {
     StringBuilder sb;
@@ -126,3 +126,46 @@ TEST(StringToNumberTest, TestSpecificValues)
     EXPECT_EQ(utils::nullopt, utils::stringToNumber<int8_t>("256"));
     EXPECT_EQ(utils::nullopt, utils::stringToNumber<int8_t>("-256"));
 }
+
+TEST(StringToNumberTest, TestBases)
+{
+    EXPECT_EQ(31, utils::stringToNumber<int>("1F", 16));
+    // Like for base 10, the first character has to be a decimal digit or a minus sign.
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<int>("ff", 16));
+    EXPECT_EQ(255, utils::stringToNumber<int>("0xFF", 16));
+    EXPECT_EQ(-255, utils::stringToNumber<int>("-0xff", 0));
+    EXPECT_EQ(8, utils::stringToNumber<int>("010", 0));
+    EXPECT_EQ(10, utils::stringToNumber<int>("10", 0));
+    EXPECT_EQ(0, utils::stringToNumber<int>("0", 0));
+    EXPECT_EQ(-35, utils::stringToNumber<int>("-z", 36));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<int>("08", 0));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<int>("0x", 16));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<int>("12", 1));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<int>("12", 37));
+    EXPECT_EQ(std::numeric_limits<uint64_t>::max(), utils::stringToNumber<uint64_t>("0xffffffffffffffff", 16));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<uint64_t>("0x10000000000000000", 16));
+}
+
+TEST(StringToNumberTest, TestFloatingPoint)
+{
+    EXPECT_EQ(0.5, utils::stringToNumber<double>("0.5"));
+    EXPECT_EQ(-1e-5, utils::stringToNumber<double>("-1e-5"));
+    EXPECT_EQ(1.5f, utils::stringToNumber<float>("1.5"));
+    EXPECT_EQ(std::numeric_limits<double>::max(), utils::stringToNumber<double>("1.7976931348623157e308"));
+    EXPECT_EQ(std::numeric_limits<double>::denorm_min(), utils::stringToNumber<double>("4.9406564584124654e-324"));
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), utils::stringToNumber<double>("inf"));
+    EXPECT_EQ(0.25L, utils::stringToNumber<long double>("0.25"));
+
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>("1e400"));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>("1e-400"));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<float>("1e39"));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>(" 1.5"));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>("1.5 "));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>("+1.5"));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>("0x1p3"));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>("."));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>(""));
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>(StringView()));
+    const char kEmbeddedNul[] = {'1', '.', '\0', '5'};
+    EXPECT_EQ(utils::nullopt, utils::stringToNumber<double>(StringView(kEmbeddedNul, sizeof(kEmbeddedNul))));
+}
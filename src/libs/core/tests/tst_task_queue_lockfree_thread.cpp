@@ -0,0 +1,187 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/task_queue_lockfree_thread.hpp>
+#include <openctk/core/repeating_task.hpp>
+#include <openctk/core/elapsed_timer.hpp>
+#include <openctk/core/semaphore.hpp>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+OCTK_CXX14_CONSTEXPR TimeDelta kTimeout = TimeDelta::Millis(1000);
+} // namespace
+
+TEST(TaskQueueLockFreeThreadTest, PostTask)
+{
+    Semaphore done;
+    auto taskQueue = TaskQueueLockFreeThread::makeShared();
+    taskQueue->postTask(
+        [&]()
+        {
+            EXPECT_TRUE(taskQueue->isCurrent());
+            done.release();
+        });
+    EXPECT_TRUE(done.tryAcquireFor(1, std::chrono::microseconds(kTimeout.us())));
+}
+
+TEST(TaskQueueLockFreeThreadTest, PostTaskOrder)
+{
+    const int runs = 10000;
+    std::vector<int> order;
+    Semaphore done;
+    auto taskQueue = TaskQueueLockFreeThread::makeShared();
+    for (int i = 0; i < runs; ++i)
+    {
+        taskQueue->postTask([&order, i]() { order.push_back(i); });
+    }
+    taskQueue->postTask([&]() { done.release(); });
+    EXPECT_TRUE(done.tryAcquireFor(1, std::chrono::microseconds(kTimeout.us())));
+    ASSERT_EQ(order.size(), size_t(runs));
+    for (int i = 0; i < runs; ++i)
+    {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(TaskQueueLockFreeThreadTest, PostTaskManyProducers)
+{
+    const int producers = 4;
+    const int runs = 10000;
+    std::atomic<int> count{0};
+    auto taskQueue = TaskQueueLockFreeThread::makeShared();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; ++i)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for (int j = 0; j < runs; ++j)
+                {
+                    taskQueue->postTask([&]() { count.fetch_add(1); });
+                }
+            });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    taskQueue->sendTask([]() { });
+    EXPECT_EQ(count.load(), producers * runs);
+}
+
+TEST(TaskQueueLockFreeThreadTest, PostDelayedTask)
+{
+    Semaphore done;
+    ElapsedTimer timer;
+    auto taskQueue = TaskQueueLockFreeThread::makeShared();
+    timer.start();
+    taskQueue->postDelayedTask([&]() { done.release(); }, TimeDelta::Millis(3));
+    EXPECT_TRUE(done.tryAcquireFor(1, std::chrono::microseconds(kTimeout.us())));
+    EXPECT_GE(timer.elapsed(), 3);
+}
+
+TEST(TaskQueueLockFreeThreadTest, PostDelayedTaskOrder)
+{
+    // the 300ms task starts in the second wheel level and has to cascade down
+    std::vector<int> order;
+    std::mutex mutex;
+    Semaphore done;
+    auto taskQueue = TaskQueueLockFreeThread::makeShared();
+    const auto record = [&](int value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(value);
+    };
+    taskQueue->postDelayedTask([&]() { record(300); done.release(); }, TimeDelta::Millis(300));
+    taskQueue->postDelayedTask([&]() { record(20); }, TimeDelta::Millis(20));
+    taskQueue->postDelayedTask([&]() { record(1); }, TimeDelta::Millis(1));
+    taskQueue->postDelayedTask([&]() { record(100); }, TimeDelta::Millis(100));
+    taskQueue->postTask([&]() { record(0); });
+    EXPECT_TRUE(done.tryAcquireFor(1, std::chrono::microseconds(kTimeout.us())));
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(order, std::vector<int>({0, 1, 20, 100, 300}));
+}
+
+TEST(TaskQueueLockFreeThreadTest, CancelTaskHandle)
+{
+    std::atomic<bool> ran{false};
+    Semaphore done;
+    auto taskQueue = TaskQueueLockFreeThread::makeShared();
+    auto handle = taskQueue->postCancelableDelayedTask([&]() { ran.store(true); }, TimeDelta::Millis(20));
+    EXPECT_TRUE(handle.isValid());
+    EXPECT_TRUE(handle.isPending());
+    EXPECT_TRUE(handle.cancel());
+    EXPECT_FALSE(handle.isPending());
+    taskQueue->postDelayedTask([&]() { done.release(); }, TimeDelta::Millis(40));
+    EXPECT_TRUE(done.tryAcquireFor(1, std::chrono::microseconds(kTimeout.us())));
+    EXPECT_FALSE(ran.load());
+
+    auto executed = taskQueue->postCancelableTask([]() { });
+    taskQueue->sendTask([]() { });
+    EXPECT_FALSE(executed.isPending());
+    EXPECT_FALSE(executed.cancel());
+}
+
+TEST(TaskQueueLockFreeThreadTest, CancelTask)
+{
+    std::atomic<int> count{0};
+    auto taskQueue = TaskQueueLockFreeThread::makeShared();
+    auto task = Task::create(Task::Func([&]() { count.fetch_add(1); }));
+    taskQueue->postDelayedTask(task, TimeDelta::Millis(20));
+    taskQueue->postDelayedTask(task, TimeDelta::Seconds(10));
+    EXPECT_TRUE(taskQueue->cancelTask(task.get()));
+    EXPECT_FALSE(taskQueue->cancelTask(task.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_EQ(count.load(), 0);
+}
+
+TEST(TaskQueueLockFreeThreadTest, RepeatingTask)
+{
+    std::atomic<int> count{0};
+    Semaphore done;
+    auto taskQueue = TaskQueueLockFreeThread::makeShared();
+    RepeatingTaskHandle::start(taskQueue.get(),
+                               [&]()
+                               {
+                                   if (3 == count.fetch_add(1) + 1)
+                                   {
+                                       done.release();
+                                       return TimeDelta::PlusInfinity();
+                                   }
+                                   return TimeDelta::Millis(5);
+                               });
+    EXPECT_TRUE(done.tryAcquireFor(1, std::chrono::microseconds(kTimeout.us())));
+    EXPECT_EQ(count.load(), 3);
+}
+
+OCTK_END_NAMESPACE
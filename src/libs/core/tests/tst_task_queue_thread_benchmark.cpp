@@ -0,0 +1,95 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/core/task_queue_lockfree_thread.hpp>
+#include <openctk/core/task_queue_thread.hpp>
+#include <openctk/core/semaphore.hpp>
+
+#include <atomic>
+
+#include <benchmark/benchmark.h>
+
+using namespace octk;
+
+namespace
+{
+/**
+ * Every benchmark thread posts a batch of tiny tasks and waits until the queue has run them.
+ */
+void postTinyTasks(benchmark::State &state, TaskQueueBase *taskQueue, bool delayed)
+{
+    const int64_t batch = state.range(0);
+    std::atomic<int64_t> done{0};
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        done.store(0);
+        for (int64_t i = 0; i < batch; ++i)
+        {
+            if (delayed)
+            {
+                taskQueue->postDelayedTask([&done]() { done.fetch_add(1, std::memory_order_relaxed); },
+                                           TimeDelta::Millis(1 + i % 8));
+            }
+            else
+            {
+                taskQueue->postTask([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        }
+        while (done.load(std::memory_order_acquire) < batch)
+        {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+TaskQueueBase *taskQueueThread()
+{
+    static auto taskQueue = TaskQueueThread::makeShared();
+    return taskQueue.get();
+}
+
+TaskQueueBase *taskQueueLockFreeThread()
+{
+    static auto taskQueue = TaskQueueLockFreeThread::makeShared();
+    return taskQueue.get();
+}
+} // namespace
+
+void BM_TaskQueueThreadPostTask(benchmark::State &state) { postTinyTasks(state, taskQueueThread(), false); }
+void BM_TaskQueueLockFreeThreadPostTask(benchmark::State &state)
+{
+    postTinyTasks(state, taskQueueLockFreeThread(), false);
+}
+void BM_TaskQueueThreadPostDelayedTask(benchmark::State &state) { postTinyTasks(state, taskQueueThread(), true); }
+void BM_TaskQueueLockFreeThreadPostDelayedTask(benchmark::State &state)
+{
+    postTinyTasks(state, taskQueueLockFreeThread(), true);
+}
+
+BENCHMARK(BM_TaskQueueThreadPostTask)->Arg(1000)->Threads(1)->Threads(4)->UseRealTime();
+BENCHMARK(BM_TaskQueueLockFreeThreadPostTask)->Arg(1000)->Threads(1)->Threads(4)->UseRealTime();
+BENCHMARK(BM_TaskQueueThreadPostDelayedTask)->Arg(1000)->UseRealTime();
+BENCHMARK(BM_TaskQueueLockFreeThreadPostDelayedTask)->Arg(1000)->UseRealTime();
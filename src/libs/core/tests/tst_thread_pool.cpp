@@ -1248,4 +1248,185 @@ TEST(ThreadPoolTest, WaitForDoneAfterCancel)
     }
 }
 
+
+TEST(ThreadPoolTest, WorkStealingRunMultiple)
+{
+    const int runs = 10000;
+    std::atomic<int> localCount{0};
+    {
+        ThreadPool manager;
+        manager.setSchedulerMode(ThreadPool::SchedulerMode::kWorkStealing);
+        EXPECT_EQ(manager.schedulerMode(), ThreadPool::SchedulerMode::kWorkStealing);
+        for (int i = 0; i < runs; ++i)
+        {
+            manager.start([&]() { localCount.fetch_add(1); });
+        }
+        EXPECT_TRUE(manager.waitForDone());
+        EXPECT_EQ(manager.taskCount(), 0u);
+    }
+    EXPECT_EQ(localCount.load(), runs);
+}
+
+TEST(ThreadPoolTest, WorkStealingManyProducers)
+{
+    const int producers = 4;
+    const int runs = 5000;
+    std::atomic<int> localCount{0};
+    ThreadPool manager;
+    manager.setMaxThreadCount(4);
+    manager.setSchedulerMode(ThreadPool::SchedulerMode::kWorkStealing);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; ++i)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for (int j = 0; j < runs; ++j)
+                {
+                    manager.start([&]() { localCount.fetch_add(1); });
+                }
+            });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_TRUE(manager.waitForDone());
+    EXPECT_EQ(localCount.load(), producers * runs);
+}
+
+TEST(ThreadPoolTest, WorkStealingNestedStart)
+{
+    const int runs = 100;
+    std::atomic<int> localCount{0};
+    ThreadPool manager;
+    manager.setSchedulerMode(ThreadPool::SchedulerMode::kWorkStealing);
+    for (int i = 0; i < runs; ++i)
+    {
+        manager.start(
+            [&]()
+            {
+                for (int j = 0; j < runs; ++j)
+                {
+                    manager.start([&]() { localCount.fetch_add(1); });
+                }
+            });
+    }
+    EXPECT_TRUE(manager.waitForDone());
+    EXPECT_EQ(localCount.load(), runs * runs);
+}
+
+TEST(ThreadPoolTest, WorkStealingPriority)
+{
+    // tasks started from a pool thread stay on its local queue, which keeps the priority order
+    std::vector<int> order;
+    std::mutex mutex;
+    ThreadPool manager;
+    manager.setMaxThreadCount(1);
+    manager.setSchedulerMode(ThreadPool::SchedulerMode::kWorkStealing);
+    manager.start(
+        [&]()
+        {
+            const auto record = [&](int value)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(value);
+            };
+            manager.start([=]() { record(0); }, ThreadPool::Priority::kLow);
+            manager.start([=]() { record(1); }, ThreadPool::Priority::kNormal);
+            manager.start([=]() { record(2); }, ThreadPool::Priority::kHighest);
+            manager.start([=]() { record(3); }, ThreadPool::Priority::kNormal);
+        });
+    EXPECT_TRUE(manager.waitForDone());
+    EXPECT_EQ(order, std::vector<int>({2, 1, 3, 0}));
+}
+
+TEST(ThreadPoolTest, WorkStealingSwitchMode)
+{
+    Semaphore sem;
+    Semaphore started;
+    std::atomic<int> localCount{0};
+    ThreadPool manager;
+    manager.setMaxThreadCount(1);
+    manager.setSchedulerMode(ThreadPool::SchedulerMode::kWorkStealing);
+    manager.start(
+        [&]()
+        {
+            started.release();
+            sem.acquire();
+        });
+    started.acquire();
+    for (int i = 0; i < 10; ++i)
+    {
+        manager.start([&]() { localCount.fetch_add(1); });
+    }
+    // tasks that are not yet started move to the shared queue
+    manager.setSchedulerMode(ThreadPool::SchedulerMode::kSharedQueue);
+    EXPECT_EQ(manager.schedulerMode(), ThreadPool::SchedulerMode::kSharedQueue);
+    EXPECT_EQ(manager.taskCount(), 10u);
+    sem.release();
+    EXPECT_TRUE(manager.waitForDone());
+    EXPECT_EQ(localCount.load(), 10);
+}
+
+TEST(ThreadPoolTest, WorkStealingCancelAndClear)
+{
+    Semaphore sem;
+    Semaphore started;
+    std::atomic<int> localCount{0};
+    ThreadPool manager;
+    manager.setMaxThreadCount(1);
+    manager.setSchedulerMode(ThreadPool::SchedulerMode::kWorkStealing);
+    manager.start(
+        [&]()
+        {
+            started.release();
+            sem.acquire();
+        });
+    started.acquire();
+    auto task = Task::create(Task::Func([&]() { localCount.fetch_add(100); }));
+    manager.start(task);
+    for (int i = 0; i < 10; ++i)
+    {
+        manager.start([&]() { localCount.fetch_add(1); });
+    }
+    EXPECT_TRUE(manager.cancel(task.get()));
+    EXPECT_EQ(manager.taskCount(), 10u);
+    manager.clear();
+    EXPECT_EQ(manager.taskCount(), 0u);
+    sem.release();
+    EXPECT_TRUE(manager.waitForDone());
+    EXPECT_EQ(localCount.load(), 0);
+}
+
+TEST(ThreadPoolTest, WorkStealingReserveThread)
+{
+    Semaphore sem;
+    std::atomic<int> localCount{0};
+    ThreadPool manager;
+    manager.setMaxThreadCount(1);
+    manager.setSchedulerMode(ThreadPool::SchedulerMode::kWorkStealing);
+    manager.start(
+        [&]()
+        {
+            // let another thread run the queued tasks while this one waits
+            manager.releaseThread();
+            sem.acquire();
+            manager.reserveThread();
+        });
+    for (int i = 0; i < 10; ++i)
+    {
+        manager.start(
+            [&]()
+            {
+                if (10 == localCount.fetch_add(1) + 1)
+                {
+                    sem.release();
+                }
+            });
+    }
+    EXPECT_TRUE(manager.waitForDone());
+    EXPECT_EQ(localCount.load(), 10);
+}
+
 OCTK_END_NAMESPACE
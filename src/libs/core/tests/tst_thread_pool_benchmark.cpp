@@ -0,0 +1,116 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2025~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+
+#include <openctk/core/thread_pool.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+using namespace octk;
+
+namespace
+{
+ThreadPool *sharedQueuePool()
+{
+    static ThreadPool pool;
+    return &pool;
+}
+
+ThreadPool *workStealingPool()
+{
+    static ThreadPool *pool = []()
+    {
+        static ThreadPool pool;
+        pool.setSchedulerMode(ThreadPool::SchedulerMode::kWorkStealing);
+        return &pool;
+    }();
+    return pool;
+}
+
+/**
+ * Every benchmark thread is one producer, it submits a batch of tiny tasks and waits for them to complete.
+ */
+void runTinyTasks(benchmark::State &state, ThreadPool *pool)
+{
+    const int64_t batch = state.range(0);
+    std::atomic<int64_t> done{0};
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        done.store(0);
+        for (int64_t i = 0; i < batch; ++i)
+        {
+            pool->start([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+        }
+        while (done.load(std::memory_order_acquire) < batch)
+        {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+/**
+ * One task per item fans out its children from inside the pool, which hits the local queue push path.
+ */
+void runNestedTinyTasks(benchmark::State &state, ThreadPool *pool)
+{
+    const int64_t batch = state.range(0);
+    std::atomic<int64_t> done{0};
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        done.store(0);
+        for (int64_t i = 0; i < 16; ++i)
+        {
+            pool->start(
+                [pool, batch, &done]()
+                {
+                    for (int64_t j = 0; j < batch / 16; ++j)
+                    {
+                        pool->start([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                });
+        }
+        while (done.load(std::memory_order_acquire) < batch / 16 * 16)
+        {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (batch / 16 * 16));
+}
+} // namespace
+
+void BM_SharedQueueTinyTasks(benchmark::State &state) { runTinyTasks(state, sharedQueuePool()); }
+void BM_WorkStealingTinyTasks(benchmark::State &state) { runTinyTasks(state, workStealingPool()); }
+void BM_SharedQueueNestedTinyTasks(benchmark::State &state) { runNestedTinyTasks(state, sharedQueuePool()); }
+void BM_WorkStealingNestedTinyTasks(benchmark::State &state) { runNestedTinyTasks(state, workStealingPool()); }
+
+BENCHMARK(BM_SharedQueueTinyTasks)->Arg(1000)->Threads(1)->Threads(4)->ThreadPerCpu()->UseRealTime();
+BENCHMARK(BM_WorkStealingTinyTasks)->Arg(1000)->Threads(1)->Threads(4)->ThreadPerCpu()->UseRealTime();
+BENCHMARK(BM_SharedQueueNestedTinyTasks)->Arg(1024)->UseRealTime();
+BENCHMARK(BM_WorkStealingNestedTinyTasks)->Arg(1024)->UseRealTime();
@@ -0,0 +1 @@
+#include "../../source/capture/camera/camera_buffer_v4l2_p.hpp"
@@ -0,0 +1 @@
+#include "../../source/capture/camera/camera_reactor_v4l2_p.hpp"
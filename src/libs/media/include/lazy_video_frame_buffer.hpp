@@ -0,0 +1 @@
+#include "../source/video/lazy_video_frame_buffer.hpp"
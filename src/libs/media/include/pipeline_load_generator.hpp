@@ -0,0 +1 @@
+#include "../source/capture/custom/pipeline_load_generator.hpp"
@@ -0,0 +1 @@
+#include "../source/video/video_frame_transform.hpp"
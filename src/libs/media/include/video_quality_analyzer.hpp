@@ -0,0 +1 @@
+#include "../source/video/video_quality_analyzer.hpp"
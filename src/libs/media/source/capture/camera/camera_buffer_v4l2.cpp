@@ -0,0 +1,305 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/detail/camera_buffer_v4l2_p.hpp>
+#include <openctk/media/i420_buffer.hpp>
+#include <openctk/core/checks.hpp>
+#include <openctk/media/yuv.hpp>
+
+#include <cstring>
+#include <vector>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+// Bytes per pixel in the first plane of `videoType`, 0 for compressed formats and those libyuv can't take padded.
+int firstPlaneBytesPerPixel(VideoType videoType)
+{
+    switch (videoType)
+    {
+        case VideoType::kI420:
+        case VideoType::kI422:
+        case VideoType::kI444:
+        case VideoType::kI400:
+        case VideoType::kNV12:
+        case VideoType::kNV21:
+        case VideoType::kYV12: return 1;
+        case VideoType::kYUY2:
+        case VideoType::kUYVY:
+        case VideoType::kRGB565: return 2;
+        case VideoType::kRGB24:
+        case VideoType::kBGR24:
+        case VideoType::kRAW: return 3;
+        case VideoType::kARGB:
+        case VideoType::kBGRA:
+        case VideoType::kABGR:
+        case VideoType::kRGBA: return 4;
+        default: return 0;
+    }
+}
+} // namespace
+
+CameraFrameBufferV4L2::CameraFrameBufferV4L2(int width,
+                                             int height,
+                                             int stride,
+                                             VideoType videoType,
+                                             const uint8_t *data,
+                                             size_t size,
+                                             int dmabufFd,
+                                             std::function<void()> noLongerUsed)
+    : mWidth(width)
+    , mHeight(height)
+    , mStride(stride)
+    , mVideoType(videoType)
+    , mData(data)
+    , mSize(size)
+    , mDmabufFd(dmabufFd)
+    , mNoLongerUsedCallback(std::move(noLongerUsed))
+{
+}
+
+CameraFrameBufferV4L2::CameraFrameBufferV4L2(std::shared_ptr<VideoFrameBuffer> planar,
+                                             VideoType videoType,
+                                             const uint8_t *data,
+                                             size_t size,
+                                             int dmabufFd)
+    : mWidth(planar->width())
+    , mHeight(planar->height())
+    , mStride(0)
+    , mVideoType(videoType)
+    , mData(data)
+    , mSize(size)
+    , mDmabufFd(dmabufFd)
+    , mPlanar(std::move(planar))
+{
+    OCTK_DCHECK(mPlanar->type() == Type::kNV12 || mPlanar->type() == Type::kI420);
+}
+
+CameraFrameBufferV4L2::~CameraFrameBufferV4L2()
+{
+    if (mNoLongerUsedCallback)
+    {
+        mNoLongerUsedCallback();
+    }
+}
+
+std::shared_ptr<I420BufferInterface> CameraFrameBufferV4L2::toI420()
+{
+    if (mPlanar)
+    {
+        return mPlanar->toI420();
+    }
+    // libyuv derives the source stride from the source width, so padded rows are described by a wider source that
+    // gets cropped to mWidth. Strides that aren't a whole number of pixels are repacked first.
+    const uint8_t *sample = mData;
+    size_t sampleSize = mSize;
+    int srcWidth = mWidth;
+    std::vector<uint8_t> packed;
+    const int bytesPerPixel = firstPlaneBytesPerPixel(mVideoType);
+    if (bytesPerPixel > 0 && mStride > mWidth * bytesPerPixel)
+    {
+        const bool evenPairs = (mVideoType != VideoType::kYUY2 && mVideoType != VideoType::kUYVY) ||
+                               (mStride / bytesPerPixel) % 2 == 0;
+        if (mStride % bytesPerPixel == 0 && evenPairs)
+        {
+            srcWidth = mStride / bytesPerPixel;
+        }
+        else
+        {
+            const size_t rowSize = static_cast<size_t>(mWidth) * bytesPerPixel;
+            const int rows = std::min<int>(mHeight, static_cast<int>(mSize / mStride));
+            packed.resize(rowSize * mHeight);
+            for (int y = 0; y < rows; ++y)
+            {
+                std::memcpy(packed.data() + rowSize * y, mData + static_cast<size_t>(mStride) * y, rowSize);
+            }
+            sample = packed.data();
+            sampleSize = packed.size();
+        }
+    }
+    auto buffer = I420Buffer::create(mWidth, mHeight);
+    const auto result = utils::yuv::convertToI420(sample,
+                                                  sampleSize,
+                                                  buffer->MutableDataY(),
+                                                  buffer->strideY(),
+                                                  buffer->MutableDataU(),
+                                                  buffer->strideU(),
+                                                  buffer->MutableDataV(),
+                                                  buffer->strideV(),
+                                                  0,
+                                                  0,
+                                                  srcWidth,
+                                                  mHeight,
+                                                  mWidth,
+                                                  mHeight,
+                                                  VideoRotation::kAngle0,
+                                                  mVideoType);
+    if (!result)
+    {
+        OCTK_WARNING() << "Failed to convert " << utils::videoTypeName(mVideoType) << " capture buffer to I420";
+        return nullptr;
+    }
+    return buffer;
+}
+
+std::shared_ptr<VideoFrameBuffer> CameraFrameBufferV4L2::getMappedFrameBuffer(ArrayView<Type> types)
+{
+    if (!mPlanar)
+    {
+        return nullptr;
+    }
+    for (auto type : types)
+    {
+        if (type == mPlanar->type())
+        {
+            return mPlanar;
+        }
+    }
+    for (auto type : types)
+    {
+        // NV12 to I420 only moves the chroma samples, the conversion is lossless.
+        if (Type::kI420 == type)
+        {
+            return mPlanar->toI420();
+        }
+    }
+    return nullptr;
+}
+
+std::string CameraFrameBufferV4L2::storageRepresentation() const
+{
+    return std::string("V4L2 ") + utils::videoTypeName(mVideoType);
+}
+
+CameraBufferQueueV4L2::CameraBufferQueueV4L2(std::vector<Slot> slots, RequeueFunction requeue, ReleaseFunction release)
+    : mSlots(std::move(slots))
+    , mWrapped(mSlots.size(), false)
+    , mRequeue(std::move(requeue))
+    , mRelease(std::move(release))
+{
+}
+
+CameraBufferQueueV4L2::~CameraBufferQueueV4L2()
+{
+    if (mRelease)
+    {
+        for (auto slot : mSlots)
+        {
+            mRelease(slot);
+        }
+    }
+}
+
+size_t CameraBufferQueueV4L2::outstanding() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mOutstanding;
+}
+
+bool CameraBufferQueueV4L2::requeue(uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    OCTK_DCHECK(!mWrapped[index]);
+    return !mStopped && mRequeue(index, mSlots[index]);
+}
+
+std::shared_ptr<VideoFrameBuffer> CameraBufferQueueV4L2::wrap(uint32_t index,
+                                                              size_t bytesUsed,
+                                                              const CameraCapture::Capability &capability,
+                                                              int stride)
+{
+    OCTK_DCHECK_LT(index, mSlots.size());
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        OCTK_DCHECK(!mWrapped[index]);
+        mWrapped[index] = true;
+        ++mOutstanding;
+    }
+    // Keep the queue, and with it the device memory, alive until the last reference to the frame is dropped.
+    auto self = this->shared_from_this();
+    auto noLongerUsed = [self, index]() { self->recycle(index); };
+
+    const int width = capability.width;
+    const int height = std::abs(capability.height);
+    const auto data = static_cast<const uint8_t *>(mSlots[index].start);
+    const int dmabufFd = mSlots[index].dmabufFd;
+    std::shared_ptr<VideoFrameBuffer> planar;
+    switch (capability.videoType)
+    {
+        case VideoType::kNV12:
+        {
+            const int strideY = std::max(stride, width);
+            const uint8_t *dataUV = data + strideY * height;
+            planar = utils::wrapNV12Buffer(width, height, data, strideY, dataUV, strideY, noLongerUsed);
+            break;
+        }
+        case VideoType::kI420:
+        {
+            const int strideY = std::max(stride, width);
+            const int strideUV = (strideY + 1) / 2;
+            const int chromaHeight = (height + 1) / 2;
+            const uint8_t *dataU = data + strideY * height;
+            const uint8_t *dataV = dataU + strideUV * chromaHeight;
+            planar =
+                utils::wrapI420Buffer(width, height, data, strideY, dataU, strideUV, dataV, strideUV, noLongerUsed);
+            break;
+        }
+        default:
+            return std::make_shared<CameraFrameBufferV4L2>(width,
+                                                           height,
+                                                           stride,
+                                                           capability.videoType,
+                                                           data,
+                                                           bytesUsed,
+                                                           dmabufFd,
+                                                           noLongerUsed);
+    }
+    if (dmabufFd < 0)
+    {
+        return planar;
+    }
+    // Hardware encoders import the dma-buf, software consumers map the planar view.
+    return std::make_shared<CameraFrameBufferV4L2>(std::move(planar), capability.videoType, data, bytesUsed, dmabufFd);
+}
+
+void CameraBufferQueueV4L2::stop()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopped = true;
+}
+
+void CameraBufferQueueV4L2::recycle(uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    OCTK_DCHECK(mWrapped[index]);
+    mWrapped[index] = false;
+    --mOutstanding;
+    if (!mStopped && !mRequeue(index, mSlots[index]))
+    {
+        OCTK_WARNING() << "Failed to requeue capture buffer " << index;
+    }
+}
+
+OCTK_END_NAMESPACE
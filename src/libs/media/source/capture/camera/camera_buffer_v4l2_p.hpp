@@ -0,0 +1,153 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#pragma once
+
+#include <openctk/media/video_frame_buffer.hpp>
+#include <openctk/media/camera_capture.hpp>
+
+#include <mutex>
+#include <vector>
+#include <functional>
+
+OCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief Native frame buffer that references a dequeued capture buffer without copying it.
+ * Used for device formats that have no planar view (YUY2, MJPG, packed RGB), toI420() converts on demand. In
+ * Options::Memory::kDmaBuf mode NV12 and I420 buffers are wrapped as well, so that the exported dma-buf travels with
+ * the frame; their planes are reachable through planar() and getMappedFrameBuffer().
+ */
+class CameraFrameBufferV4L2 : public VideoFrameBuffer
+{
+public:
+    /**
+     * @brief Wraps a capture buffer without planar view, `stride` is the driver's bytes per line of the first plane.
+     */
+    CameraFrameBufferV4L2(int width,
+                          int height,
+                          int stride,
+                          VideoType videoType,
+                          const uint8_t *data,
+                          size_t size,
+                          int dmabufFd,
+                          std::function<void()> noLongerUsed);
+    /**
+     * @brief Wraps the planar view `planar` (kNV12 or kI420) of a capture buffer, which owns the release callback.
+     */
+    CameraFrameBufferV4L2(std::shared_ptr<VideoFrameBuffer> planar,
+                          VideoType videoType,
+                          const uint8_t *data,
+                          size_t size,
+                          int dmabufFd);
+    ~CameraFrameBufferV4L2() override;
+
+    Type type() const override { return Type::kNative; }
+    int width() const override { return mWidth; }
+    int height() const override { return mHeight; }
+    std::shared_ptr<I420BufferInterface> toI420() override;
+    std::shared_ptr<VideoFrameBuffer> getMappedFrameBuffer(ArrayView<Type> types) override;
+    std::string storageRepresentation() const override;
+
+    VideoType videoType() const { return mVideoType; }
+    const uint8_t *data() const { return mData; }
+    size_t size() const { return mSize; }
+    // Exported dma-buf of the capture buffer, -1 unless the capture runs in Options::Memory::kDmaBuf mode.
+    int dmabufFd() const { return mDmabufFd; }
+    // Zero copy kNV12 or kI420 view of the planes, nullptr for packed formats.
+    const std::shared_ptr<VideoFrameBuffer> &planar() const { return mPlanar; }
+
+private:
+    const int mWidth;
+    const int mHeight;
+    const int mStride;
+    const VideoType mVideoType;
+    const uint8_t *const mData;
+    const size_t mSize;
+    const int mDmabufFd;
+    const std::shared_ptr<VideoFrameBuffer> mPlanar;
+    std::function<void()> mNoLongerUsedCallback;
+};
+
+/**
+ * @brief Owns the capture buffers of a streaming V4L2 device and hands them out as zero copy frame buffers.
+ * A wrapped buffer goes back to the device through the requeue function once its last reference is dropped. After
+ * stop() buffers are no longer requeued, the memory stays valid until the queue and every wrapped frame are gone.
+ */
+class CameraBufferQueueV4L2 : public std::enable_shared_from_this<CameraBufferQueueV4L2>
+{
+public:
+    using SharedPtr = std::shared_ptr<CameraBufferQueueV4L2>;
+
+    struct Slot
+    {
+        void *start{nullptr};
+        size_t length{0};
+        int dmabufFd{-1};
+    };
+    using RequeueFunction = std::function<bool(uint32_t index, const Slot &slot)>;
+    using ReleaseFunction = std::function<void(Slot &slot)>;
+
+    CameraBufferQueueV4L2(std::vector<Slot> slots, RequeueFunction requeue, ReleaseFunction release);
+    ~CameraBufferQueueV4L2();
+
+    size_t size() const { return mSlots.size(); }
+    const Slot &slot(uint32_t index) const { return mSlots[index]; }
+
+    /**
+     * @brief Returns how many wrapped buffers are still held downstream.
+     */
+    size_t outstanding() const;
+
+    /**
+     * @brief Returns a dequeued buffer to the device right away.
+     */
+    bool requeue(uint32_t index);
+
+    /**
+     * @brief Wraps the dequeued buffer `index` into a frame buffer referencing the device memory.
+     * NV12 and I420 buffers get planar views, any other format a CameraFrameBufferV4L2. Buffers exported as dma-buf
+     * are always wrapped in a CameraFrameBufferV4L2 so that dmabufFd() stays available.
+     * @param stride bytes per line of the first plane as reported by the driver.
+     */
+    std::shared_ptr<VideoFrameBuffer> wrap(uint32_t index,
+                                           size_t bytesUsed,
+                                           const CameraCapture::Capability &capability,
+                                           int stride);
+
+    void stop();
+
+private:
+    void recycle(uint32_t index);
+
+    mutable std::mutex mMutex;
+    const std::vector<Slot> mSlots;
+    std::vector<bool> mWrapped OCTK_ATTRIBUTE_GUARDED_BY(mMutex);
+    size_t mOutstanding OCTK_ATTRIBUTE_GUARDED_BY(mMutex) = 0;
+    bool mStopped OCTK_ATTRIBUTE_GUARDED_BY(mMutex) = false;
+    RequeueFunction mRequeue;
+    ReleaseFunction mRelease;
+};
+
+OCTK_END_NAMESPACE
@@ -26,6 +26,7 @@
 #include <openctk/media/video_rotation.hpp>
 #include <openctk/core/string_utils.hpp>
 #include <openctk/media/i420_buffer.hpp>
+#include <openctk/core/metrics.hpp>
 #include <openctk/core/checks.hpp>
 #include <openctk/media/yuv.hpp>
 
@@ -259,7 +260,7 @@ CameraCapture::DeviceInfo::SharedPtr CameraCapture::createDeviceInfo(Options *op
 CameraCapture::SharedPtr CameraCapture::create(const char *deviceId, Options *options)
 {
 #if defined(OCTK_OS_LINUX)
-    auto capture = std::make_shared<CameraCaptureV4L2>();
+    auto capture = std::make_shared<CameraCaptureV4L2>(options);
     if (capture->init(deviceId))
     {
         return capture;
@@ -273,7 +274,7 @@ CameraCapture::SharedPtr CameraCapture::create(const char *deviceNameUTF8,
                                                Options *options)
 {
 #if defined(OCTK_OS_LINUX)
-    auto capture = std::make_shared<CameraCaptureV4L2>();
+    auto capture = std::make_shared<CameraCaptureV4L2>(options);
     if (capture->init(deviceNameUTF8, deviceUniqueIdUTF8))
     {
         return capture;
@@ -328,6 +329,7 @@ int32_t CameraCapturePrivate::incomingFrame(uint8_t *videoFrame,
     std::unique_lock<std::mutex> lock(mApiMutex);
     const auto apply_rotation = mApplyRotation;
     const auto rotateFrame = mVideoRotation;
+    const auto framesInFlight = mFramesInFlight;
     lock.unlock();
 
     const int32_t width = frameInfo.width;
@@ -355,8 +357,6 @@ int32_t CameraCapturePrivate::incomingFrame(uint8_t *videoFrame,
         }
     }
 
-    int stride_y = width;
-    int stride_uv = (width + 1) / 2;
     int target_width = width;
     int target_height = abs(height);
 
@@ -373,7 +373,7 @@ int32_t CameraCapturePrivate::incomingFrame(uint8_t *videoFrame,
     // Setting absolute height (in case it was negative).
     // In Windows, the image starts bottom left, instead of top left.
     // Setting a negative source height, inverts the image (within LibYuv).
-    auto buffer = I420Buffer::create(target_width, target_height, stride_y, stride_uv, stride_uv);
+    auto buffer = this->acquireFrameBuffer(target_width, target_height, framesInFlight);
     const auto conversionResult = utils::yuv::convertToI420(videoFrame,
                                                             videoFrameLength,
                                                             buffer.get()->MutableDataY(),
@@ -401,7 +401,7 @@ int32_t CameraCapturePrivate::incomingFrame(uint8_t *videoFrame,
                                   .setVideoFrameBuffer(buffer)
                                   .setRtpTimestamp(0)
                                   .setTimestampMSecs(DateTime::TimeMillis())
-                                  .setRotation(!mApplyRotation ? mVideoRotation : VideoRotation::kAngle0)
+                                  .setRotation(!apply_rotation ? rotateFrame : VideoRotation::kAngle0)
                                   .build();
     captureFrame.setNtpTimeMSecs(captureTime);
 
@@ -410,12 +410,97 @@ int32_t CameraCapturePrivate::incomingFrame(uint8_t *videoFrame,
     return 0;
 }
 
+bool CameraCapturePrivate::isRotationApplied() const
+{
+    std::lock_guard<std::mutex> lock(mApiMutex);
+    return mApplyRotation && mVideoRotation != VideoRotation::kAngle0;
+}
+
+int32_t CameraCapturePrivate::incomingBuffer(std::shared_ptr<VideoFrameBuffer> buffer, int64_t captureTime)
+{
+    OCTK_CHECK_RUNS_SERIALIZED(&mCaptureChecker);
+    std::unique_lock<std::mutex> lock(mApiMutex);
+    // Buffers are delivered as they are, a pending rotation is only signalled.
+    const auto rotateFrame = mVideoRotation;
+    lock.unlock();
+
+    VideoFrame captureFrame = VideoFrame::Builder()
+                                  .setVideoFrameBuffer(std::move(buffer))
+                                  .setRtpTimestamp(0)
+                                  .setTimestampMSecs(DateTime::TimeMillis())
+                                  .setRotation(rotateFrame)
+                                  .build();
+    captureFrame.setNtpTimeMSecs(captureTime);
+
+    lock.lock();
+    this->deliverCapturedFrame(captureFrame);
+    return 0;
+}
+
+std::shared_ptr<I420Buffer> CameraCapturePrivate::acquireFrameBuffer(int width, int height, int framesInFlight)
+{
+    OCTK_CHECK_RUNS_SERIALIZED(&mCaptureChecker);
+    const size_t poolSize = framesInFlight > 0 ? static_cast<size_t>(framesInFlight) + 1 : 0;
+    // Shrinking fails while more buffers are held downstream, retry on the next frame.
+    if (poolSize != mBufferPoolSize && mBufferPool.Resize(poolSize))
+    {
+        mBufferPoolSize = poolSize;
+    }
+
+    const auto allocations = mBufferPool.AllocationCount();
+    auto buffer = mBufferPool.CreateI420Buffer(width, height);
+    if (!buffer)
+    {
+        buffer = I420Buffer::create(width, height);
+        mBufferPoolMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (mBufferPool.AllocationCount() != allocations)
+    {
+        mBufferPoolMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+    return buffer;
+}
+
+void CameraCapturePrivate::resetCaptureStats()
+{
+    std::lock_guard<std::mutex> lock(mApiMutex);
+    mStats = CameraCapture::Stats();
+    mFirstDeliveryTimeNanos = mLastDeliveryTimeNanos = 0;
+    mFrameIntervalNanos = mJitterNanos = 0;
+    mCaptureCpuTimeNanos.store(0, std::memory_order_relaxed);
+}
+
+void CameraCapturePrivate::addCaptureCpuTime(int64_t nanos)
+{
+    mCaptureCpuTimeNanos.fetch_add(nanos, std::memory_order_relaxed);
+}
+
 int32_t CameraCapturePrivate::deliverCapturedFrame(VideoFrame &captureFrame)
 {
     OCTK_CHECK_RUNS_SERIALIZED(&mCaptureChecker);
 
     this->updateFrameCount(); // frame count used for local frame rate callback.
 
+    // Interarrival jitter as in RFC 3550, J += (|D| - J) / 16 with D the change of the delivery interval.
+    const int64_t nowNanos = DateTime::TimeNanos();
+    if (0 == mFirstDeliveryTimeNanos)
+    {
+        mFirstDeliveryTimeNanos = nowNanos;
+    }
+    else
+    {
+        const int64_t intervalNanos = nowNanos - mLastDeliveryTimeNanos;
+        if (mFrameIntervalNanos > 0)
+        {
+            mJitterNanos += (std::abs(intervalNanos - mFrameIntervalNanos) - mJitterNanos) / 16;
+            OCTK_HISTOGRAM_COUNTS_1000("OpenCTK.Media.CameraCapture.JitterMs",
+                                       static_cast<int>(mJitterNanos / DateTime::kNSecsPerMSec));
+        }
+        mFrameIntervalNanos = intervalNanos;
+    }
+    mLastDeliveryTimeNanos = nowNanos;
+    ++mStats.framesDelivered;
+
     if (mDataCallBack)
     {
         mDataCallBack->onFrame(captureFrame);
@@ -487,6 +572,42 @@ int32_t CameraCapture::setCaptureRotation(VideoRotation rotation)
     return 0;
 }
 
+void CameraCapture::setFramesInFlight(int framesInFlight)
+{
+    OCTK_D(CameraCapture);
+    std::lock_guard<std::mutex> lock(d->mApiMutex);
+    d->mFramesInFlight = std::max(framesInFlight, 0);
+}
+
+int CameraCapture::framesInFlight() const
+{
+    OCTK_D(const CameraCapture);
+    std::lock_guard<std::mutex> lock(d->mApiMutex);
+    return d->mFramesInFlight;
+}
+
+uint64_t CameraCapture::bufferPoolMisses() const
+{
+    OCTK_D(const CameraCapture);
+    return d->mBufferPoolMisses.load(std::memory_order_relaxed);
+}
+
+CameraCapture::Stats CameraCapture::captureStats() const
+{
+    OCTK_D(const CameraCapture);
+    std::lock_guard<std::mutex> lock(d->mApiMutex);
+    Stats stats = d->mStats;
+    stats.frameIntervalUSecs = d->mFrameIntervalNanos / DateTime::kNSecsPerUSec;
+    stats.jitterUSecs = d->mJitterNanos / DateTime::kNSecsPerUSec;
+    stats.cpuTimeUSecs = d->mCaptureCpuTimeNanos.load(std::memory_order_relaxed) / DateTime::kNSecsPerUSec;
+    const int64_t elapsedNanos = d->mLastDeliveryTimeNanos - d->mFirstDeliveryTimeNanos;
+    if (elapsedNanos > 0)
+    {
+        stats.cpuUsagePercent = 100.0 * d->mCaptureCpuTimeNanos.load(std::memory_order_relaxed) / elapsedNanos;
+    }
+    return stats;
+}
+
 bool CameraCapture::getApplyRotation()
 {
     OCTK_D(CameraCapture);
@@ -52,6 +52,9 @@ public:
     OCTK_STATIC_CONSTANT_NUMBER(kFrameRateCountHistorySize, 90)
     OCTK_STATIC_CONSTANT_NUMBER(kFrameRateHistoryWindowMs, 2000)
 
+    OCTK_STATIC_CONSTANT_NUMBER(kDefaultFramesInFlight, 3) // Frames the sinks may hold before the pool misses
+    OCTK_STATIC_CONSTANT_NUMBER(kDefaultCaptureBuffers, 4) // Buffers queued to the capture device
+
     using SharedPtr = std::shared_ptr<CameraCapture>;
 
     struct Capability final
@@ -175,9 +178,27 @@ public:
             virtual ~Callback() = default;
         };
 
+        /**
+         * @brief How capture buffers are shared with the device.
+         * kMmap maps driver allocated buffers, kUserPtr lets the driver fill page aligned buffers allocated by us and
+         * kDmaBuf additionally exports the driver buffers as dma-buf file descriptors for hardware consumers.
+         */
+        enum class Memory
+        {
+            kMmap,
+            kUserPtr,
+            kDmaBuf
+        };
+
         // Status Init(Callback *callback);
 
         bool allowPipeWire{false};
+        // Deliver frames that reference the device buffers instead of converting every frame to I420. NV12 and I420
+        // devices produce planar views, other formats native buffers converted on toI420(). A buffer goes back to
+        // the device once the last consumer releases it, so sinks must not hold more than captureBuffers - 1 frames.
+        bool zeroCopy{false};
+        Memory memory{Memory::kMmap};
+        int captureBuffers{kDefaultCaptureBuffers};
 
         Options() = default;
         ~Options() = default;
@@ -185,6 +206,18 @@ public:
         bool operator==(const Options &other) const { return !operator!=(other); }
     };
 
+    struct Stats final
+    {
+        uint64_t framesDelivered{0};
+        // Smoothed interval between delivered frames and its smoothed deviation (RFC 3550 interarrival jitter).
+        int64_t frameIntervalUSecs{0};
+        int64_t jitterUSecs{0};
+        // CPU time spent dequeuing, converting and delivering frames, and its share of the wall clock time since the
+        // first delivered frame.
+        int64_t cpuTimeUSecs{0};
+        double cpuUsagePercent{0.0};
+    };
+
     static DeviceInfo::SharedPtr createDeviceInfo(Options *options = nullptr);
     static SharedPtr create(const char *deviceId, Options *options = nullptr);
     static SharedPtr create(const char *deviceNameUTF8, const char *deviceUniqueIdUTF8, Options *options = nullptr);
@@ -256,6 +289,29 @@ public:
      */
     virtual bool setApplyRotation(bool enable);
 
+    /**
+     * @brief Set how many captured frames the registered sinks may hold at the same time.
+     * Captured frames are converted into buffers recycled from a pool of framesInFlight + 1 buffers. A frame captured
+     * while every pooled buffer is still held downstream falls back to a heap allocation and counts as a pool miss.
+     * Zero disables the pool.
+     * @param framesInFlight
+     */
+    void setFramesInFlight(int framesInFlight);
+    int framesInFlight() const;
+
+    /**
+     * @brief Returns how many captured frames needed a freshly allocated buffer, including the pool warm up.
+     * @return
+     */
+    uint64_t bufferPoolMisses() const;
+
+    /**
+     * @brief Returns the frame delivery statistics of the running capture, reset by startCapture().
+     * The jitter of every delivered frame is also sampled into the "OpenCTK.Media.CameraCapture.JitterMs" histogram.
+     * @return
+     */
+    Stats captureStats() const;
+
     static void test();
 
 protected:
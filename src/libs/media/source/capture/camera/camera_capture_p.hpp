@@ -24,11 +24,14 @@
 
 #pragma once
 
+#include <openctk/media/video_frame_buffer_pool.hpp>
 #include <openctk/core/context_checker.hpp>
 #include <openctk/media/camera_capture.hpp>
 #include <openctk/core/race_checker.hpp>
 #include <openctk/core/date_time.hpp>
 
+#include <atomic>
+
 OCTK_BEGIN_NAMESPACE
 
 class CameraCapture::DeviceInfoPrivate
@@ -65,6 +68,13 @@ public:
                           const Capability& frameInfo,
                           int64_t captureTime = 0);
     int32_t deliverCapturedFrame(VideoFrame &captureFrame);
+    // Delivers a buffer that needs no conversion, callers must convert instead while isRotationApplied().
+    int32_t incomingBuffer(std::shared_ptr<VideoFrameBuffer> buffer, int64_t captureTime = 0);
+    bool isRotationApplied() const;
+    std::shared_ptr<I420Buffer> acquireFrameBuffer(int width, int height, int framesInFlight);
+    void resetCaptureStats();
+    // Accounts CPU time a backend spent on the capture outside of incomingFrame()/incomingBuffer().
+    void addCaptureCpuTime(int64_t nanos);
 
 protected:
     // Calls to the public API must happen on a single thread.
@@ -76,7 +86,7 @@ protected:
     char* mDeviceName OCTK_ATTRIBUTE_GUARDED_BY(mApiChecker) = nullptr;
     // current Device unique name;
     char* mDeviceUniqueId OCTK_ATTRIBUTE_GUARDED_BY(mApiChecker) = nullptr;
-    std::mutex mApiMutex;
+    mutable std::mutex mApiMutex;
     // Should be set by platform dependent code in StartCapture.
     Capability mRequestedCapability OCTK_ATTRIBUTE_GUARDED_BY(mApiChecker);
 
@@ -96,6 +106,20 @@ private:
     VideoRotation mVideoRotation OCTK_ATTRIBUTE_GUARDED_BY(mApiMutex) = VideoRotation::kAngle0;
     // Indicate whether rotation should be applied before delivered externally.
     bool mApplyRotation OCTK_ATTRIBUTE_GUARDED_BY(mApiMutex) = false;
+    // Frames the sinks may hold, the capture pool keeps one more buffer for the frame being converted.
+    int mFramesInFlight OCTK_ATTRIBUTE_GUARDED_BY(mApiMutex) = CameraCapture::kDefaultFramesInFlight;
+
+    VideoFrameBufferPool mBufferPool OCTK_ATTRIBUTE_GUARDED_BY(mCaptureChecker){
+        false, CameraCapture::kDefaultFramesInFlight + 1};
+    size_t mBufferPoolSize OCTK_ATTRIBUTE_GUARDED_BY(mCaptureChecker) = CameraCapture::kDefaultFramesInFlight + 1;
+    std::atomic<uint64_t> mBufferPoolMisses{0};
+
+    CameraCapture::Stats mStats OCTK_ATTRIBUTE_GUARDED_BY(mApiMutex);
+    int64_t mFirstDeliveryTimeNanos OCTK_ATTRIBUTE_GUARDED_BY(mApiMutex) = 0;
+    int64_t mLastDeliveryTimeNanos OCTK_ATTRIBUTE_GUARDED_BY(mApiMutex) = 0;
+    int64_t mFrameIntervalNanos OCTK_ATTRIBUTE_GUARDED_BY(mApiMutex) = 0;
+    int64_t mJitterNanos OCTK_ATTRIBUTE_GUARDED_BY(mApiMutex) = 0;
+    std::atomic<int64_t> mCaptureCpuTimeNanos{0};
 
 protected:
     OCTK_DEFINE_PPTR(CameraCapture)
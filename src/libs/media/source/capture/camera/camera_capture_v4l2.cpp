@@ -1,9 +1,13 @@
 #include <openctk/media/detail/camera_capture_v4l2_p.hpp>
+#include <openctk/media/detail/camera_reactor_v4l2_p.hpp>
+#include <openctk/media/detail/camera_buffer_v4l2_p.hpp>
 #include <openctk/media/detail/camera_capture_p.hpp>
-#include <openctk/core/platform_thread.hpp>
+#include <openctk/core/task_queue_thread.hpp>
+#include <openctk/core/aligned_malloc.hpp>
+#include <openctk/core/algorithm.hpp>
 
 #include <linux/videodev2.h>
-#include <sys/select.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <unistd.h>
@@ -48,28 +52,49 @@ inline std::string getFourccName(uint32_t fourcc)
     name.push_back(static_cast<char>((fourcc >> 24) & 0xFF));
     return name;
 }
+
+inline int64_t threadCpuTimeNanos()
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) < 0)
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
 } // namespace detail
 
 class CameraCaptureV4L2Private : public CameraCapturePrivate
 {
 public:
-    struct Buffer
-    {
-        void *start;
-        size_t length;
-    };
     using Capability = CameraCapture::Capability;
+    using Options = CameraCapture::Options;
 
-    OCTK_STATIC_CONSTANT_NUMBER(kNoOfV4L2Bufffers, 4)
+    OCTK_STATIC_CONSTANT_NUMBER(kMinV4L2Buffers, 2)
+    OCTK_STATIC_CONSTANT_NUMBER(kMaxV4L2Buffers, 32)
 
-    explicit CameraCaptureV4L2Private(CameraCaptureV4L2 *p);
+    CameraCaptureV4L2Private(CameraCaptureV4L2 *p, const Options *options);
     ~CameraCaptureV4L2Private() override;
 
+    uint32_t v4l2Memory() const
+    {
+        return mOptions.memory == Options::Memory::kUserPtr ? V4L2_MEMORY_USERPTR : V4L2_MEMORY_MMAP;
+    }
     bool deAllocateVideoBuffers();
     bool allocateVideoBuffers();
-    bool captureProcess();
-
-    PlatformThread::SharedPtr mCaptureThread OCTK_ATTRIBUTE_GUARDED_BY(mApiChecker);
+    // Runs on a reactor thread whenever the device is readable, dequeues the filled buffers and hands them to the
+    // capture worker. Returns false to park the device until a buffer is queued back.
+    bool captureProcess(uint32_t events);
+    void processBuffer(const CameraBufferQueueV4L2::SharedPtr &queue,
+                       uint32_t index,
+                       size_t bytesUsed,
+                       const Capability &capability,
+                       uint32_t bytesPerLine);
+
+    // Shared by every capturing camera, replaces a polling thread per device.
+    CameraReactorV4L2::SharedPtr mReactor OCTK_ATTRIBUTE_GUARDED_BY(mApiChecker);
+    // Converts and delivers the frames of this camera, so a slow conversion never stalls the other devices.
+    TaskQueueBase::SharedPtr mCaptureWorker OCTK_ATTRIBUTE_GUARDED_BY(mApiChecker);
 
     std::mutex mCaptureMutex OCTK_ATTRIBUTE_ACQUIRED_BEFORE(mApiMutex);
     bool mQuit OCTK_ATTRIBUTE_GUARDED_BY(mCaptureMutex);
@@ -77,19 +102,22 @@ public:
     std::string mDeviceId OCTK_ATTRIBUTE_GUARDED_BY(mApiChecker) = "";
     int32_t mDeviceFd OCTK_ATTRIBUTE_GUARDED_BY(mCaptureChecker) = -1;
 
-    int32_t mBuffersAllocatedByDevice OCTK_ATTRIBUTE_GUARDED_BY(mCaptureMutex) = -1;
+    const Options mOptions;
     Capability mConfiguredCapability OCTK_ATTRIBUTE_GUARDED_BY(mCaptureChecker);
+    uint32_t mBytesPerLine OCTK_ATTRIBUTE_GUARDED_BY(mCaptureChecker) = 0;
+    uint32_t mSizeImage OCTK_ATTRIBUTE_GUARDED_BY(mCaptureChecker) = 0;
     bool mStreaming OCTK_ATTRIBUTE_GUARDED_BY(mCaptureChecker) = false;
     bool mCaptureStarted OCTK_ATTRIBUTE_GUARDED_BY(mApiChecker) = false;
-    Buffer *mPoolBuffer OCTK_ATTRIBUTE_GUARDED_BY(mCaptureMutex) = nullptr;
+    CameraBufferQueueV4L2::SharedPtr mBufferQueue OCTK_ATTRIBUTE_GUARDED_BY(mCaptureMutex);
 
 private:
     OCTK_DECLARE_PUBLIC(CameraCaptureV4L2)
     OCTK_DISABLE_COPY_MOVE(CameraCaptureV4L2Private)
 };
 
-CameraCaptureV4L2Private::CameraCaptureV4L2Private(CameraCaptureV4L2 *p)
+CameraCaptureV4L2Private::CameraCaptureV4L2Private(CameraCaptureV4L2 *p, const Options *options)
     : CameraCapturePrivate(p)
+    , mOptions(options ? *options : Options())
 {
 }
 
@@ -100,6 +128,12 @@ CameraCaptureV4L2Private::~CameraCaptureV4L2Private()
 bool CameraCaptureV4L2Private::deAllocateVideoBuffers()
 {
     OCTK_CHECK_RUNS_SERIALIZED(&mCaptureChecker);
+    // Stop requeueing from consumers still holding zero copy frames, they keep the memory alive until released.
+    if (mBufferQueue)
+    {
+        mBufferQueue->stop();
+    }
+
     // turn off stream FIRST to stop DMA before unmapping buffers
     enum v4l2_buf_type type;
     type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -108,28 +142,23 @@ bool CameraCaptureV4L2Private::deAllocateVideoBuffers()
         OCTK_INFO() << "VIDIOC_STREAMOFF error. errno: " << errno;
     }
 
-    // unmap buffers after stream is stopped
-    for (int i = 0; i < mBuffersAllocatedByDevice; i++)
-    {
-        munmap(mPoolBuffer[i].start, mPoolBuffer[i].length);
-    }
-
-    delete[] mPoolBuffer;
-    mPoolBuffer = nullptr;
-    mBuffersAllocatedByDevice = -1;
-
+    // buffers are unmapped once the last frame referencing them is gone
+    mBufferQueue.reset();
     return true;
 }
 
 bool CameraCaptureV4L2Private::allocateVideoBuffers()
 {
     OCTK_CHECK_RUNS_SERIALIZED(&mCaptureChecker);
+    const uint32_t memory = this->v4l2Memory();
+    const int bufferCount = utils::clamp(mOptions.captureBuffers, int(kMinV4L2Buffers), int(kMaxV4L2Buffers));
+
     struct v4l2_requestbuffers rbuffer;
     memset(&rbuffer, 0, sizeof(v4l2_requestbuffers));
 
     rbuffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    rbuffer.memory = V4L2_MEMORY_MMAP;
-    rbuffer.count = kNoOfV4L2Bufffers;
+    rbuffer.memory = memory;
+    rbuffer.count = bufferCount;
 
     if (ioctl(mDeviceFd, VIDIOC_REQBUFS, &rbuffer) < 0)
     {
@@ -146,133 +175,201 @@ bool CameraCaptureV4L2Private::allocateVideoBuffers()
         return false;
     }
 
-    if (rbuffer.count > kNoOfV4L2Bufffers)
+    if (rbuffer.count > static_cast<uint32_t>(bufferCount))
     {
-        rbuffer.count = kNoOfV4L2Bufffers;
+        rbuffer.count = bufferCount;
     }
 
-    mBuffersAllocatedByDevice = rbuffer.count;
-
-    // Map the buffers
-    mPoolBuffer = new Buffer[rbuffer.count];
+    const auto releaseSlot = [memory](CameraBufferQueueV4L2::Slot &slot)
+    {
+        if (slot.dmabufFd >= 0)
+        {
+            close(slot.dmabufFd);
+        }
+        if (memory == V4L2_MEMORY_USERPTR)
+        {
+            utils::alignedFree(slot.start);
+        }
+        else if (slot.start && MAP_FAILED != slot.start)
+        {
+            munmap(slot.start, slot.length);
+        }
+    };
 
-    for (unsigned int i = 0; i < rbuffer.count; i++)
+    // Map or allocate the buffers
+    std::vector<CameraBufferQueueV4L2::Slot> slots(rbuffer.count);
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    bool success = true;
+    for (unsigned int i = 0; i < rbuffer.count && success; i++)
     {
         struct v4l2_buffer buffer;
         memset(&buffer, 0, sizeof(v4l2_buffer));
         buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.memory = memory;
         buffer.index = i;
 
+        if (memory == V4L2_MEMORY_USERPTR)
+        {
+            slots[i].length = (mSizeImage + pageSize - 1) / pageSize * pageSize;
+            slots[i].start = utils::alignedMalloc(slots[i].length, pageSize);
+            success = nullptr != slots[i].start;
+            continue;
+        }
+
         if (ioctl(mDeviceFd, VIDIOC_QUERYBUF, &buffer) < 0)
         {
-            return false;
+            success = false;
+            break;
         }
 
-        mPoolBuffer[i]
-            .start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, mDeviceFd, buffer.m.offset);
+        slots[i].start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, mDeviceFd, buffer.m.offset);
+        if (MAP_FAILED == slots[i].start)
+        {
+            success = false;
+            break;
+        }
+        slots[i].length = buffer.length;
 
-        if (MAP_FAILED == mPoolBuffer[i].start)
+        if (mOptions.memory == Options::Memory::kDmaBuf)
         {
-            for (unsigned int j = 0; j < i; j++)
+            struct v4l2_exportbuffer expbuf;
+            memset(&expbuf, 0, sizeof(expbuf));
+            expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            expbuf.index = i;
+            expbuf.flags = O_CLOEXEC | O_RDONLY;
+            if (ioctl(mDeviceFd, VIDIOC_EXPBUF, &expbuf) < 0)
             {
-                munmap(mPoolBuffer[j].start, mPoolBuffer[j].length);
+                OCTK_WARNING() << "VIDIOC_EXPBUF failed on " << mDeviceId << ", errno:" << errno;
+                success = false;
+                break;
             }
-            return false;
+            slots[i].dmabufFd = expbuf.fd;
         }
+    }
 
-        mPoolBuffer[i].length = buffer.length;
+    const int fd = mDeviceFd;
+    const auto reactor = mReactor;
+    auto queue = std::make_shared<CameraBufferQueueV4L2>(
+        std::move(slots),
+        [fd, memory, reactor](uint32_t index, const CameraBufferQueueV4L2::Slot &slot)
+        {
+            struct v4l2_buffer buffer;
+            memset(&buffer, 0, sizeof(v4l2_buffer));
+            buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buffer.memory = memory;
+            buffer.index = index;
+            if (memory == V4L2_MEMORY_USERPTR)
+            {
+                buffer.m.userptr = reinterpret_cast<unsigned long>(slot.start);
+                buffer.length = slot.length;
+            }
+            if (ioctl(fd, VIDIOC_QBUF, &buffer) < 0)
+            {
+                return false;
+            }
+            // the device may have been parked with every buffer held downstream
+            if (reactor)
+            {
+                reactor->resume(fd);
+            }
+            return true;
+        },
+        releaseSlot);
+    if (!success)
+    {
+        return false;
+    }
 
-        if (ioctl(mDeviceFd, VIDIOC_QBUF, &buffer) < 0)
+    mBufferQueue = queue;
+    for (uint32_t i = 0; i < mBufferQueue->size(); i++)
+    {
+        if (!mBufferQueue->requeue(i))
         {
+            mBufferQueue.reset();
             return false;
         }
     }
     return true;
 }
 
-bool CameraCaptureV4L2Private::captureProcess()
+bool CameraCaptureV4L2Private::captureProcess(uint32_t events)
 {
-    //    OCTK_TRACE() << "CameraCaptureV4L2Private::captureProcess():enter";
-    OCTK_CHECK_RUNS_SERIALIZED(&mCaptureChecker);
-
-    int retVal = 0;
-    fd_set rSet;
-    struct timeval timeout;
-
-    FD_ZERO(&rSet);
-    FD_SET(mDeviceFd, &rSet);
-    timeout.tv_sec = 1;
-    timeout.tv_usec = 0;
-
-    // mDeviceFd written only in StartCapture, when this thread isn't running.
-    //    OCTK_TRACE() << "CameraCaptureV4L2Private::captureProcess():select start";
-    retVal = select(mDeviceFd + 1, &rSet, NULL, NULL, &timeout);
-    //    OCTK_TRACE() << "CameraCaptureV4L2Private::captureProcess():select finish";
-
+    const int64_t cpuStartNanos = detail::threadCpuTimeNanos();
+    size_t dequeued = 0;
+    bool rearm = true;
     {
         std::lock_guard<std::mutex> lock(mCaptureMutex);
-        //        OCTK_TRACE() << "CameraCaptureV4L2Private::captureProcess():mCaptureMutex";
-
-        if (mQuit)
+        if (mQuit || !mStreaming)
         {
             return false;
         }
 
-        if (retVal < 0 && errno != EINTR) // continue if interrupted
-        {
-            // select failed
-            //            OCTK_TRACE() << "CameraCaptureV4L2Private::captureProcess():select failed";
-            return false;
-        }
-        else if (retVal == 0)
+        // mDeviceFd and the configuration are written only in StartCapture, when the device isn't registered.
+        while (true)
         {
-            // select timed out
-            //            OCTK_TRACE() << "CameraCaptureV4L2Private::captureProcess():select timed out";
-            return true;
-        }
-        else if (!FD_ISSET(mDeviceFd, &rSet))
-        {
-            // not event on camera handle
-            //            OCTK_TRACE() << "CameraCaptureV4L2Private::captureProcess():select not event";
-            return true;
-        }
-
-        if (mStreaming)
-        {
-            //            OCTK_TRACE() << "CameraCaptureV4L2Private::captureProcess():ioctl buffer----------";
             struct v4l2_buffer buf;
             memset(&buf, 0, sizeof(struct v4l2_buffer));
             buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-            buf.memory = V4L2_MEMORY_MMAP;
-            // dequeue a buffer - repeat until dequeued properly!
-            while (ioctl(mDeviceFd, VIDIOC_DQBUF, &buf) < 0)
+            buf.memory = this->v4l2Memory();
+            if (ioctl(mDeviceFd, VIDIOC_DQBUF, &buf) < 0)
             {
-                if (errno != EINTR)
+                if (EINTR == errno)
                 {
-                    OCTK_INFO() << "could not sync on a buffer on device " << strerror(errno);
-                    return true;
+                    continue;
                 }
+                if (EAGAIN != errno || (events & (EPOLLERR | EPOLLHUP) && 0 == dequeued))
+                {
+                    // EPOLLERR without a filled buffer means nothing is queued to the device, wait for a requeue.
+                    if (EAGAIN != errno)
+                    {
+                        OCTK_INFO() << "could not sync on a buffer on device " << strerror(errno);
+                    }
+                    rearm = false;
+                }
+                break;
             }
+            ++dequeued;
+
+            const auto queue = mBufferQueue;
+            const auto capability = mConfiguredCapability;
+            const auto bytesPerLine = mBytesPerLine;
+            const auto index = buf.index;
+            const size_t bytesUsed = buf.bytesused;
+            mCaptureWorker->postTask([this, queue, index, bytesUsed, capability, bytesPerLine]()
+                                     { this->processBuffer(queue, index, bytesUsed, capability, bytesPerLine); });
+        }
+    }
+    this->addCaptureCpuTime(detail::threadCpuTimeNanos() - cpuStartNanos);
+    return rearm;
+}
 
-            // convert to to I420 if needed
-            //            OCTK_TRACE() << "CameraCaptureV4L2Private::captureProcess():incomingFrame";
-            this->incomingFrame(reinterpret_cast<uint8_t *>(mPoolBuffer[buf.index].start),
-                                buf.bytesused,
-                                mConfiguredCapability);
-            // enqueue the buffer again
-            if (ioctl(mDeviceFd, VIDIOC_QBUF, &buf) == -1)
-            {
-                OCTK_INFO() << "Failed to enqueue capture buffer";
-            }
+void CameraCaptureV4L2Private::processBuffer(const CameraBufferQueueV4L2::SharedPtr &queue,
+                                             uint32_t index,
+                                             size_t bytesUsed,
+                                             const Capability &capability,
+                                             uint32_t bytesPerLine)
+{
+    const int64_t cpuStartNanos = detail::threadCpuTimeNanos();
+    // hand out the device buffer itself, it is requeued when the last consumer drops the frame
+    if (mOptions.zeroCopy && !this->isRotationApplied())
+    {
+        this->incomingBuffer(queue->wrap(index, bytesUsed, capability, bytesPerLine));
+    }
+    else
+    {
+        // convert to to I420 if needed
+        this->incomingFrame(reinterpret_cast<uint8_t *>(queue->slot(index).start), bytesUsed, capability);
+        // enqueue the buffer again
+        if (!queue->requeue(index))
+        {
+            OCTK_INFO() << "Failed to enqueue capture buffer";
         }
     }
-    usleep(0);
-    return true;
+    this->addCaptureCpuTime(detail::threadCpuTimeNanos() - cpuStartNanos);
 }
 
-CameraCaptureV4L2::CameraCaptureV4L2()
-    : CameraCapture(new CameraCaptureV4L2Private(this))
+CameraCaptureV4L2::CameraCaptureV4L2(const Options *options)
+    : CameraCapture(new CameraCaptureV4L2Private(this, options))
 {
 }
 
@@ -499,6 +596,8 @@ Status CameraCaptureV4L2::startCapture(const Capability &capability)
     // initialize current width and height
     d->mConfiguredCapability.width = video_fmt.fmt.pix.width;
     d->mConfiguredCapability.height = video_fmt.fmt.pix.height;
+    d->mBytesPerLine = video_fmt.fmt.pix.bytesperline;
+    d->mSizeImage = video_fmt.fmt.pix.sizeimage;
 
     // Trying to set frame rate, before check driver capability.
     bool driver_framerate_support = true;
@@ -542,6 +641,10 @@ Status CameraCaptureV4L2::startCapture(const Capability &capability)
         }
     }
 
+    if (!d->mReactor)
+    {
+        d->mReactor = CameraReactorV4L2::shared();
+    }
     if (!d->allocateVideoBuffers())
     {
         const auto errstr = utils::fmt::format("failed to allocate video capture buffers for {}", d->mDeviceId);
@@ -571,19 +674,25 @@ Status CameraCaptureV4L2::startCapture(const Capability &capability)
     d->mRequestedCapability = capability;
     d->mCaptureStarted = true;
     d->mStreaming = true;
+    d->resetCaptureStats();
 
-    // start capture thread;
-    if (!d->mCaptureThread.get())
+    // start capture worker and watch the device on the shared reactor
+    if (!d->mCaptureWorker)
     {
         d->mQuit = false;
-        d->mCaptureThread = PlatformThread::create(
-            [=]
-            {
-                while (d->captureProcess())
-                {
-                }
-            });
-        d->mCaptureThread->start(PlatformThread::Priority::kHighest);
+        d->mCaptureWorker = TaskQueueThread::create();
+        if (!d->mReactor->add(d->mDeviceFd, [d](uint32_t events) { return d->captureProcess(events); }))
+        {
+            const auto errstr = utils::fmt::format("failed to watch {} for captured frames", d->mDeviceId);
+            OCTK_WARNING() << errstr;
+            d->mCaptureWorker.reset();
+            d->mCaptureStarted = false;
+            d->mStreaming = false;
+            d->deAllocateVideoBuffers();
+            close(d->mDeviceFd);
+            d->mDeviceFd = -1;
+            return Error::create(errstr);
+        }
     }
     return Status::ok;
 }
@@ -594,14 +703,15 @@ int32_t CameraCaptureV4L2::stopCapture()
     OCTK_DCHECK_RUN_ON(&d->mApiChecker);
     ;
 
-    if (d->mCaptureThread.get())
+    if (d->mCaptureWorker)
     {
         {
             std::lock_guard<std::mutex> lock(d->mCaptureMutex);
             d->mQuit = true;
         }
-        // Make sure the capture thread stops using the mutex.
-        d->mCaptureThread->wait();
+        // Make sure the reactor and the worker stop using the device, frames still queued to the worker are dropped.
+        d->mReactor->remove(d->mDeviceFd);
+        d->mCaptureWorker.reset();
     }
 
     d->mCaptureStarted = false;
@@ -618,6 +728,7 @@ int32_t CameraCaptureV4L2::stopCapture()
 
         d->mRequestedCapability = d->mConfiguredCapability = Capability();
     }
+    d->mReactor.reset();
 
     return 0;
 }
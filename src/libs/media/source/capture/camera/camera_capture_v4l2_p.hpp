@@ -32,7 +32,7 @@ class CameraCaptureV4L2Private;
 class CameraCaptureV4L2 : public CameraCapture
 {
 public:
-    CameraCaptureV4L2();
+    explicit CameraCaptureV4L2(const Options *options = nullptr);
     ~CameraCaptureV4L2() override;
 
     Status startCapture(const Capability &capability) override;
@@ -0,0 +1,267 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/detail/camera_reactor_v4l2_p.hpp>
+#include <openctk/core/logging.hpp>
+#include <openctk/core/checks.hpp>
+
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include <algorithm>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+// epoll data of the wakeup eventfd, registered descriptors get ids starting at 1.
+static constexpr uint64_t kWakeupId = 0;
+} // namespace detail
+
+CameraReactorV4L2::CameraReactorV4L2(int threads)
+{
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    mWakeupFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (mEpollFd < 0 || mWakeupFd < 0)
+    {
+        OCTK_WARNING() << "Failed to create the camera reactor, errno:" << errno << " " << strerror(errno);
+        if (mEpollFd >= 0)
+        {
+            close(mEpollFd);
+            mEpollFd = -1;
+        }
+        return;
+    }
+
+    // The wakeup event stays signalled once written, so every reactor thread sees it and exits.
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u64 = detail::kWakeupId;
+    epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mWakeupFd, &event);
+
+    for (int i = 0; i < std::max(threads, 1); ++i)
+    {
+        auto thread = PlatformThread::create([this]() { this->run(); });
+        thread->setName("CameraReactorV4L2");
+        thread->start(PlatformThread::Priority::kHighest);
+        mThreads.push_back(std::move(thread));
+    }
+}
+
+CameraReactorV4L2::~CameraReactorV4L2()
+{
+    mQuit.store(true);
+    if (mWakeupFd >= 0)
+    {
+        const uint64_t value = 1;
+        if (write(mWakeupFd, &value, sizeof(value)) < 0)
+        {
+            OCTK_WARNING() << "Failed to wake up the camera reactor, errno:" << errno;
+        }
+    }
+    for (auto &thread : mThreads)
+    {
+        thread->wait();
+    }
+    if (mWakeupFd >= 0)
+    {
+        close(mWakeupFd);
+    }
+    if (mEpollFd >= 0)
+    {
+        close(mEpollFd);
+    }
+}
+
+CameraReactorV4L2::SharedPtr CameraReactorV4L2::shared()
+{
+    static std::mutex mutex;
+    static std::weak_ptr<CameraReactorV4L2> instance;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto reactor = instance.lock();
+    if (!reactor)
+    {
+        reactor = std::make_shared<CameraReactorV4L2>();
+        instance = reactor;
+    }
+    return reactor;
+}
+
+size_t CameraReactorV4L2::size() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEntries.size();
+}
+
+bool CameraReactorV4L2::add(int fd, Handler handler)
+{
+    OCTK_DCHECK(handler);
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!this->isValid())
+    {
+        return false;
+    }
+    const auto id = mNextId++;
+    auto &entry = mEntries[id];
+    entry.fd = fd;
+    entry.handler = std::move(handler);
+    if (!this->arm(fd, id, true))
+    {
+        mEntries.erase(id);
+        return false;
+    }
+    entry.armed = true;
+    return true;
+}
+
+void CameraReactorV4L2::remove(int fd)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (auto iter = mEntries.begin(); iter != mEntries.end(); ++iter)
+    {
+        if (iter->second.fd != fd)
+        {
+            continue;
+        }
+        epoll_ctl(mEpollFd, EPOLL_CTL_DEL, fd, nullptr);
+        iter->second.fd = -1;
+        if (!iter->second.running)
+        {
+            mEntries.erase(iter);
+        }
+        else if (iter->second.runningThread != PlatformThread::currentThreadId())
+        {
+            // run() drops the entry once the handler returned, a handler removing itself does not wait for that.
+            const auto id = iter->first;
+            mIdleCondition.wait(lock, [this, id]() { return mEntries.find(id) == mEntries.end(); });
+        }
+        return;
+    }
+}
+
+void CameraReactorV4L2::resume(int fd)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto &item : mEntries)
+    {
+        auto &entry = item.second;
+        if (entry.fd != fd)
+        {
+            continue;
+        }
+        if (entry.running)
+        {
+            entry.resumeRequested = true;
+        }
+        else if (!entry.armed)
+        {
+            entry.armed = this->arm(fd, item.first, false);
+        }
+        return;
+    }
+}
+
+bool CameraReactorV4L2::arm(int fd, uint64_t id, bool add)
+{
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLPRI | EPOLLONESHOT;
+    event.data.u64 = id;
+    if (epoll_ctl(mEpollFd, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) < 0)
+    {
+        OCTK_WARNING() << "Failed to watch capture device fd " << fd << ", errno:" << errno << " " << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void CameraReactorV4L2::run()
+{
+    struct epoll_event events[kMaxEvents];
+    while (!mQuit.load(std::memory_order_relaxed))
+    {
+        const int count = epoll_wait(mEpollFd, events, kMaxEvents, -1);
+        if (count < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            OCTK_WARNING() << "Camera reactor epoll_wait failed, errno:" << errno << " " << strerror(errno);
+            break;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            const uint64_t id = events[i].data.u64;
+            if (detail::kWakeupId == id)
+            {
+                continue;
+            }
+
+            const Handler *handler = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                auto iter = mEntries.find(id);
+                // removed after epoll_wait returned
+                if (iter == mEntries.end() || iter->second.fd < 0)
+                {
+                    continue;
+                }
+                iter->second.armed = false;
+                iter->second.running = true;
+                iter->second.resumeRequested = false;
+                iter->second.runningThread = PlatformThread::currentThreadId();
+                // entries are only erased once their handler returned
+                handler = &iter->second.handler;
+            }
+
+            const bool rearm = (*handler)(events[i].events);
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto iter = mEntries.find(id);
+            if (iter == mEntries.end())
+            {
+                continue;
+            }
+            auto &entry = iter->second;
+            entry.running = false;
+            if (entry.fd < 0)
+            {
+                mEntries.erase(iter);
+            }
+            else if (rearm || entry.resumeRequested)
+            {
+                entry.armed = this->arm(entry.fd, id, false);
+            }
+            mIdleCondition.notify_all();
+        }
+    }
+}
+
+OCTK_END_NAMESPACE
@@ -0,0 +1,100 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#pragma once
+
+#include <openctk/core/platform_thread.hpp>
+#include <openctk/core/global.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <map>
+
+OCTK_BEGIN_NAMESPACE
+
+/**
+ * @brief Multiplexes the file descriptors of many capture devices on a few epoll threads.
+ * Every registered descriptor is armed one shot, so its handler never runs concurrently with itself and is armed
+ * again once it returns true. A handler returning false parks the descriptor until resume() is called, which lets a
+ * device that has no queued buffers wait for a consumer instead of spinning on EPOLLERR.
+ */
+class CameraReactorV4L2 final
+{
+public:
+    using SharedPtr = std::shared_ptr<CameraReactorV4L2>;
+    using Handler = std::function<bool(uint32_t events)>;
+
+    OCTK_STATIC_CONSTANT_NUMBER(kMaxEvents, 16)
+
+    explicit CameraReactorV4L2(int threads = 1);
+    ~CameraReactorV4L2();
+
+    /**
+     * @brief Returns the reactor shared by all cameras of the process.
+     * It is created on first use and its threads exit once the last camera released it.
+     */
+    static SharedPtr shared();
+
+    bool isValid() const { return mEpollFd >= 0; }
+    int threadCount() const { return static_cast<int>(mThreads.size()); }
+    size_t size() const;
+
+    bool add(int fd, Handler handler);
+    /**
+     * @brief Stops watching fd, waiting for a running handler to return unless called from that handler.
+     */
+    void remove(int fd);
+    /**
+     * @brief Arms a parked descriptor again, safe to call from any thread.
+     */
+    void resume(int fd);
+
+private:
+    struct Entry
+    {
+        int fd{-1};
+        Handler handler;
+        bool armed{false};
+        bool resumeRequested{false};
+        PlatformThread::Id runningThread{0};
+        bool running{false};
+    };
+
+    bool arm(int fd, uint64_t id, bool add);
+    void run();
+
+    mutable std::mutex mMutex;
+    std::condition_variable mIdleCondition;
+    std::map<uint64_t, Entry> mEntries OCTK_ATTRIBUTE_GUARDED_BY(mMutex);
+    uint64_t mNextId OCTK_ATTRIBUTE_GUARDED_BY(mMutex) = 1;
+    std::vector<PlatformThread::UniquePtr> mThreads;
+    std::atomic<bool> mQuit{false};
+    int mEpollFd{-1};
+    int mWakeupFd{-1};
+};
+
+OCTK_END_NAMESPACE
@@ -74,6 +74,28 @@ UniquePointer<FrameGeneratorInterface> CreateFromNV12FileFrameGenerator(std::vec
 
     return utils::make_unique<NV12FileGenerator>(files, width, height, frame_repeat_count);
 }
+
+UniquePointer<MappedYuvFileGenerator> CreateFromMappedYuvFileFrameGenerator(
+    std::vector<std::string> filenames,
+    FrameGeneratorInterface::OutputType type,
+    size_t width,
+    size_t height,
+    int frame_repeat_count,
+    const MappedYuvFileGenerator::Options &options)
+{
+    OCTK_DCHECK(!filenames.empty());
+    auto generator = utils::make_unique<MappedYuvFileGenerator>(filenames,
+                                                                type,
+                                                                width,
+                                                                height,
+                                                                frame_repeat_count,
+                                                                options);
+    if (0 == generator->frameCount())
+    {
+        return nullptr;
+    }
+    return generator;
+}
 //
 // absl::Nonnull <UniquePointer<FrameGeneratorInterface>>
 // CreateFromIvfFileFrameGenerator(const RtcContext &env,
@@ -112,6 +134,32 @@ UniquePointer<FrameGeneratorInterface> CreateScrollingInputFromYuvFilesFrameGene
                                                             pause_time_ms);
 }
 
+UniquePointer<FrameGeneratorInterface> CreateScrollingInputFromMappedYuvFilesFrameGenerator(
+    Clock *clock,
+    std::vector<std::string> filenames,
+    size_t source_width,
+    size_t source_height,
+    size_t target_width,
+    size_t target_height,
+    int64_t scroll_time_ms,
+    int64_t pause_time_ms)
+{
+    auto mapped_generator = CreateFromMappedYuvFileFrameGenerator(std::move(filenames),
+                                                                  FrameGeneratorInterface::OutputType::kI420,
+                                                                  source_width,
+                                                                  source_height);
+    if (!mapped_generator)
+    {
+        return nullptr;
+    }
+    return utils::make_unique<ScrollingImageFrameGenerator>(clock,
+                                                            std::move(mapped_generator),
+                                                            target_width,
+                                                            target_height,
+                                                            scroll_time_ms,
+                                                            pause_time_ms);
+}
+
 UniquePointer<FrameGeneratorInterface> CreateSlideFrameGenerator(int width, int height, int frame_repeat_count)
 {
     return utils::make_unique<SlideGenerator>(width, height, frame_repeat_count);
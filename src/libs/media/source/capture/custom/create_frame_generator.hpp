@@ -70,6 +70,17 @@ OCTK_MEDIA_API UniquePointer<FrameGeneratorInterface> CreateFromNV12FileFrameGen
     size_t height,
     int frame_repeat_count = 1);
 
+// Creates a frame generator that repeatedly plays a set of I420 or NV12 files
+// mapped into memory, frames point into the mapping instead of being copied.
+// Returns nullptr if none of the files holds a whole frame.
+OCTK_MEDIA_API UniquePointer<MappedYuvFileGenerator> CreateFromMappedYuvFileFrameGenerator(
+    std::vector<std::string> filenames,
+    FrameGeneratorInterface::OutputType type,
+    size_t width,
+    size_t height,
+    int frame_repeat_count = 1,
+    const MappedYuvFileGenerator::Options &options = MappedYuvFileGenerator::Options());
+
 // absl::Nonnull <UniquePointer<FrameGeneratorInterface>>
 // CreateFromIvfFileFrameGenerator(const RtcContext &env,
 //                                 StringView filename,
@@ -93,6 +104,19 @@ OCTK_MEDIA_API UniquePointer<FrameGeneratorInterface> CreateScrollingInputFromYu
     int64_t scroll_time_ms,
     int64_t pause_time_ms);
 
+// Same as above, but the yuv files are mapped into memory and the scrolled
+// image jumps straight to the file to show instead of reading all files in
+// between. Returns nullptr if none of the files holds a whole frame.
+OCTK_MEDIA_API UniquePointer<FrameGeneratorInterface> CreateScrollingInputFromMappedYuvFilesFrameGenerator(
+    Clock *clock,
+    std::vector<std::string> filenames,
+    size_t source_width,
+    size_t source_height,
+    size_t target_width,
+    size_t target_height,
+    int64_t scroll_time_ms,
+    int64_t pause_time_ms);
+
 // Creates a frame generator that produces randomly generated slides. It fills
 // the frames with randomly sized and colored squares.
 // `frame_repeat_count` determines how many times each slide is shown.
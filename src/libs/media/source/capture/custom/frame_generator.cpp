@@ -34,6 +34,19 @@
 
 #include <libyuv.h>
 
+#if defined(OCTK_OS_WIN)
+#    include <windows.h>
+#else
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    include <fcntl.h>
+#endif
+
+#include <unordered_map>
+#include <cerrno>
+#include <mutex>
+
 OCTK_BEGIN_NAMESPACE
 
 const char *FrameGeneratorInterface::outputTypeToString(FrameGeneratorInterface::OutputType type)
@@ -2366,6 +2379,299 @@ bool NV12FileGenerator::readnextFrame()
     return frame_index_ != prev_frame_index || file_index_ != prev_file_index;
 }
 
+/**
+ * Read-only mapping of a whole file. Mappings opened with share = true are kept in a process wide registry while any
+ * generator uses them, so generators playing the same clip map it once.
+ */
+class MappedVideoFile
+{
+public:
+    static std::shared_ptr<MappedVideoFile> open(const std::string &path, bool share)
+    {
+        static std::mutex mutex;
+        static std::unordered_map<std::string, std::weak_ptr<MappedVideoFile>> mappings;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (share)
+        {
+            auto iter = mappings.find(path);
+            if (iter != mappings.end())
+            {
+                if (auto mapping = iter->second.lock())
+                {
+                    return mapping;
+                }
+            }
+        }
+        std::shared_ptr<MappedVideoFile> mapping(new MappedVideoFile(path));
+        if (!mapping->data())
+        {
+            return nullptr;
+        }
+        if (share)
+        {
+            mappings[path] = mapping;
+            // Drop registry entries of mappings that are gone.
+            for (auto iter = mappings.begin(); iter != mappings.end();)
+            {
+                iter = iter->second.expired() ? mappings.erase(iter) : std::next(iter);
+            }
+        }
+        return mapping;
+    }
+
+    ~MappedVideoFile()
+    {
+#if defined(OCTK_OS_WIN)
+        if (mData)
+        {
+            UnmapViewOfFile(mData);
+        }
+#else
+        if (mData)
+        {
+            munmap(const_cast<uint8_t *>(mData), mSize);
+        }
+#endif
+    }
+
+    const uint8_t *data() const { return mData; }
+    size_t size() const { return mSize; }
+
+    // Asks the kernel to read the given range in the background, a hint only.
+    void willNeed(size_t offset, size_t length) const
+    {
+#if defined(OCTK_OS_UNIX)
+        const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t begin = offset / pageSize * pageSize;
+        const size_t end = std::min(offset + length, mSize);
+        if (mData && end > begin)
+        {
+            madvise(const_cast<uint8_t *>(mData) + begin, end - begin, MADV_WILLNEED);
+        }
+#endif
+    }
+
+    void adviseHugePages() const
+    {
+#if defined(OCTK_OS_LINUX) && defined(MADV_HUGEPAGE)
+        if (mData && 0 != madvise(const_cast<uint8_t *>(mData), mSize, MADV_HUGEPAGE))
+        {
+            OCTK_INFO() << "MappedYuvFileGenerator: no huge pages for mapping, errno " << errno;
+        }
+#endif
+    }
+
+private:
+    explicit MappedVideoFile(const std::string &path)
+    {
+#if defined(OCTK_OS_WIN)
+        HANDLE file = CreateFileA(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  nullptr);
+        if (INVALID_HANDLE_VALUE == file)
+        {
+            OCTK_WARNING() << "MappedYuvFileGenerator: failed to open '" << path << "'";
+            return;
+        }
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping)
+            {
+                mData = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                mSize = mData ? static_cast<size_t>(size.QuadPart) : 0;
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+        {
+            OCTK_WARNING() << "MappedYuvFileGenerator: failed to open '" << path << "'";
+            return;
+        }
+        struct stat status;
+        if (0 == fstat(file, &status) && status.st_size > 0)
+        {
+            void *data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+            if (MAP_FAILED != data)
+            {
+                mData = static_cast<const uint8_t *>(data);
+                mSize = static_cast<size_t>(status.st_size);
+            }
+        }
+        ::close(file);
+#endif
+        if (!mData)
+        {
+            OCTK_WARNING() << "MappedYuvFileGenerator: failed to map '" << path << "'";
+        }
+    }
+
+    const uint8_t *mData = nullptr;
+    size_t mSize = 0;
+};
+
+MappedYuvFileGenerator::MappedYuvFileGenerator(const std::vector<std::string> &filenames,
+                                               OutputType type,
+                                               size_t width,
+                                               size_t height,
+                                               int frame_repeat_count)
+    : MappedYuvFileGenerator(filenames, type, width, height, frame_repeat_count, Options())
+{
+}
+
+MappedYuvFileGenerator::MappedYuvFileGenerator(const std::vector<std::string> &filenames,
+                                               OutputType type,
+                                               size_t width,
+                                               size_t height,
+                                               int frame_repeat_count,
+                                               const Options &options)
+    : type_(type)
+    , width_(width)
+    , height_(height)
+    , frame_size_(utils::videoTypeBufferSize(OutputType::kNV12 == type ? VideoType::kNV12 : VideoType::kI420,
+                                             static_cast<int>(width_),
+                                             static_cast<int>(height_)))
+    , frame_display_count_(frame_repeat_count)
+    , options_(options)
+    , frame_count_(0)
+    , next_frame_(0)
+    , last_frame_(std::numeric_limits<size_t>::max())
+    , current_display_count_(0)
+{
+    OCTK_DCHECK(OutputType::kI420 == type || OutputType::kNV12 == type);
+    OCTK_DCHECK_GT(width, 0);
+    OCTK_DCHECK_GT(height, 0);
+    OCTK_DCHECK_GT(frame_repeat_count, 0);
+    for (const std::string &filename : filenames)
+    {
+        std::shared_ptr<MappedVideoFile> file = MappedVideoFile::open(filename, options_.shareMappings);
+        if (!file)
+        {
+            continue;
+        }
+        const size_t frames = file->size() / frame_size_;
+        if (0 == frames)
+        {
+            OCTK_WARNING() << "MappedYuvFileGenerator: '" << filename << "' holds no whole frame";
+            continue;
+        }
+        if (options_.hugePages)
+        {
+            file->adviseHugePages();
+        }
+        files_.push_back(std::move(file));
+        first_frames_.push_back(frame_count_);
+        frame_count_ += frames;
+    }
+    this->readAhead(0, this->readaheadFrames());
+}
+
+MappedYuvFileGenerator::~MappedYuvFileGenerator() = default;
+
+FrameGeneratorInterface::VideoFrameData MappedYuvFileGenerator::nextFrame()
+{
+    // Empty update by default.
+    VideoFrame::UpdateRect update_rect{0, 0, 0, 0};
+    if (current_display_count_ == 0 && frame_count_ > 0)
+    {
+        // Full update on a new frame from file.
+        if (next_frame_ != last_frame_ || !last_buffer_)
+        {
+            last_buffer_ = this->frameAt(next_frame_);
+            last_frame_ = next_frame_;
+            update_rect = VideoFrame::UpdateRect{static_cast<int>(width_), static_cast<int>(height_), 0, 0};
+        }
+        next_frame_ = (next_frame_ + 1) % frame_count_;
+        // The window before already covers all but its last frame.
+        const size_t frames = this->readaheadFrames();
+        if (frames > 0)
+        {
+            this->readAhead(next_frame_ + frames - 1, 1);
+        }
+    }
+    if (++current_display_count_ >= frame_display_count_)
+    {
+        current_display_count_ = 0;
+    }
+
+    return VideoFrameData(last_buffer_, update_rect);
+}
+
+FrameGeneratorInterface::Resolution MappedYuvFileGenerator::getResolution() const
+{
+    return {width_, height_};
+}
+
+std::shared_ptr<VideoFrameBuffer> MappedYuvFileGenerator::frameAt(size_t index) const
+{
+    if (index >= frame_count_)
+    {
+        return nullptr;
+    }
+    const size_t file_index = this->fileIndexOf(index);
+    const std::shared_ptr<MappedVideoFile> &file = files_[file_index];
+    const uint8_t *data = file->data() + (index - first_frames_[file_index]) * frame_size_;
+    const int width = static_cast<int>(width_);
+    const int height = static_cast<int>(height_);
+    const int chroma_width = (width + 1) / 2;
+    const int chroma_height = (height + 1) / 2;
+    // The buffers keep the mapping alive.
+    if (OutputType::kNV12 == type_)
+    {
+        return utils::wrapNV12Buffer(width,
+                                     height,
+                                     data,
+                                     width,
+                                     data + width * height,
+                                     chroma_width * 2,
+                                     [file] {});
+    }
+    return utils::wrapI420Buffer(width,
+                                 height,
+                                 data,
+                                 width,
+                                 data + width * height,
+                                 chroma_width,
+                                 data + width * height + chroma_width * chroma_height,
+                                 chroma_width,
+                                 [file] {});
+}
+
+bool MappedYuvFileGenerator::seek(size_t index)
+{
+    if (index >= frame_count_)
+    {
+        return false;
+    }
+    next_frame_ = index;
+    current_display_count_ = 0;
+    this->readAhead(index, this->readaheadFrames());
+    return true;
+}
+
+size_t MappedYuvFileGenerator::fileIndexOf(size_t index) const
+{
+    return std::upper_bound(first_frames_.begin(), first_frames_.end(), index) - first_frames_.begin() - 1;
+}
+
+void MappedYuvFileGenerator::readAhead(size_t first, size_t frames) const
+{
+    for (size_t i = 0; i < frames && frame_count_ > 0; ++i)
+    {
+        const size_t frame = (first + i) % frame_count_;
+        const size_t file_index = this->fileIndexOf(frame);
+        files_[file_index]->willNeed((frame - first_frames_[file_index]) * frame_size_, frame_size_);
+    }
+}
+
 SlideGenerator::SlideGenerator(int width, int height, int frame_repeat_count)
     : width_(width)
     , height_(height)
@@ -2455,7 +2761,7 @@ ScrollingImageFrameGenerator::ScrollingImageFrameGenerator(Clock *clock,
     , prev_frame_not_scrolled_(false)
     , current_source_frame_(nullptr, utils::nullopt)
     , current_frame_(nullptr, utils::nullopt)
-    , file_generator_(files, source_width, source_height, 1)
+    , file_generator_(new YuvFileGenerator(files, source_width, source_height, 1))
 {
     OCTK_DCHECK(clock_ != nullptr);
     OCTK_DCHECK_GT(num_frames_, 0);
@@ -2466,6 +2772,34 @@ ScrollingImageFrameGenerator::ScrollingImageFrameGenerator(Clock *clock,
     OCTK_DCHECK_GT(scroll_time_ms + pause_time_ms, 0);
 }
 
+ScrollingImageFrameGenerator::ScrollingImageFrameGenerator(Clock *clock,
+                                                           std::unique_ptr<MappedYuvFileGenerator> mapped_generator,
+                                                           size_t target_width,
+                                                           size_t target_height,
+                                                           int64_t scroll_time_ms,
+                                                           int64_t pause_time_ms)
+    : clock_(clock)
+    , start_time_(clock->TimeInMilliseconds())
+    , scroll_time_(scroll_time_ms)
+    , pause_time_(pause_time_ms)
+    , num_frames_(mapped_generator->frameCount())
+    , target_width_(static_cast<int>(target_width))
+    , target_height_(static_cast<int>(target_height))
+    , current_frame_num_(num_frames_ - 1)
+    , prev_frame_not_scrolled_(false)
+    , current_source_frame_(nullptr, utils::nullopt)
+    , current_frame_(nullptr, utils::nullopt)
+    , mapped_generator_(std::move(mapped_generator))
+{
+    OCTK_DCHECK(clock_ != nullptr);
+    OCTK_DCHECK_GT(num_frames_, 0);
+    OCTK_DCHECK_GE(mapped_generator_->getResolution().height, target_height);
+    OCTK_DCHECK_GE(mapped_generator_->getResolution().width, target_width);
+    OCTK_DCHECK_GE(scroll_time_ms, 0);
+    OCTK_DCHECK_GE(pause_time_ms, 0);
+    OCTK_DCHECK_GT(scroll_time_ms + pause_time_ms, 0);
+}
+
 FrameGeneratorInterface::VideoFrameData ScrollingImageFrameGenerator::nextFrame()
 {
     const int64_t kFrameDisplayTime = scroll_time_ + pause_time_;
@@ -2510,9 +2844,25 @@ FrameGeneratorInterface::Resolution ScrollingImageFrameGenerator::getResolution(
 void ScrollingImageFrameGenerator::updateSourceFrame(size_t frame_num)
 {
     VideoFrame::UpdateRect acc_update{0, 0, 0, 0};
+    if (mapped_generator_)
+    {
+        // Random access, frames that are skipped are never touched.
+        if (current_frame_num_ != frame_num || !current_source_frame_.buffer)
+        {
+            current_source_frame_.buffer = mapped_generator_->frameAt(frame_num);
+            const auto resolution = mapped_generator_->getResolution();
+            acc_update = VideoFrame::UpdateRect{static_cast<int>(resolution.width),
+                                                static_cast<int>(resolution.height),
+                                                0,
+                                                0};
+            current_frame_num_ = frame_num;
+        }
+        current_source_frame_.updateRect = acc_update;
+        return;
+    }
     while (current_frame_num_ != frame_num)
     {
-        current_source_frame_ = file_generator_.nextFrame();
+        current_source_frame_ = file_generator_->nextFrame();
         if (current_source_frame_.updateRect)
         {
             acc_update.unionRect(*current_source_frame_.updateRect);
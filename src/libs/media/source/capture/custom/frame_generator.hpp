@@ -37,6 +37,7 @@
 #include <openctk/core/mutex.hpp>
 #include <openctk/core/clock.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -228,6 +229,82 @@ private:
     std::shared_ptr<NV12Buffer> last_read_buffer_;
 };
 
+class MappedVideoFile;
+
+/**
+ * @details MappedYuvFileGenerator plays raw I420 or NV12 files like YuvFileGenerator and NV12FileGenerator, but maps
+ * the files into memory instead of reading them. Frames are read-only buffers pointing straight into the mapping, so
+ * no frame data is copied, and generators playing the same file in one process share one mapping. Many generators
+ * replaying one clip therefore cost one copy of it in the page cache. The frames after the current one are prefetched
+ * with madvise(MADV_WILLNEED), frameAt() and seek() give random access to all frames of all files.
+ */
+class OCTK_MEDIA_API MappedYuvFileGenerator : public FrameGeneratorInterface
+{
+public:
+    struct Options
+    {
+        // Frames after the current one the kernel is asked to read ahead.
+        int readaheadFrames = 4;
+        // Requests transparent huge pages for the mapping, only file systems supporting them (e.g. tmpfs) honor it.
+        bool hugePages = false;
+        // Reuses the mapping of another generator playing the same file.
+        bool shareMappings = true;
+    };
+
+    // `type` is kI420 or kNV12, files that can't be mapped are skipped and a trailing partial frame is ignored.
+    MappedYuvFileGenerator(const std::vector<std::string> &filenames,
+                           OutputType type,
+                           size_t width,
+                           size_t height,
+                           int frame_repeat_count);
+    MappedYuvFileGenerator(const std::vector<std::string> &filenames,
+                           OutputType type,
+                           size_t width,
+                           size_t height,
+                           int frame_repeat_count,
+                           const Options &options);
+    ~MappedYuvFileGenerator() override;
+
+    // Returns a nullptr buffer if no file holds a whole frame.
+    VideoFrameData nextFrame() override;
+    void changeResolution(size_t width, size_t height) override
+    {
+        OCTK_WARNING() << "MappedYuvFileGenerator::changeResolution not implemented";
+    }
+    Resolution getResolution() const override;
+
+    StringView typeString() const override { return "MappedYuvFileGenerator"; }
+    Optional<int> fps() const override { return utils::nullopt; }
+
+    // Number of whole frames in all files.
+    size_t frameCount() const { return frame_count_; }
+    // Returns frame `index` counted over all files, nullptr if index >= frameCount().
+    std::shared_ptr<VideoFrameBuffer> frameAt(size_t index) const;
+    // Makes frame `index` the next new frame returned by nextFrame().
+    bool seek(size_t index);
+
+private:
+    size_t readaheadFrames() const { return static_cast<size_t>(std::max(options_.readaheadFrames, 0)); }
+    size_t fileIndexOf(size_t index) const;
+    // Prefetches `frames` frames starting at frame `first`, wrapping around the end.
+    void readAhead(size_t first, size_t frames) const;
+
+    const OutputType type_;
+    const size_t width_;
+    const size_t height_;
+    const size_t frame_size_;
+    const int frame_display_count_;
+    const Options options_;
+    std::vector<std::shared_ptr<MappedVideoFile>> files_;
+    // Index of the first frame of each file.
+    std::vector<size_t> first_frames_;
+    size_t frame_count_;
+    size_t next_frame_;
+    size_t last_frame_;
+    int current_display_count_;
+    std::shared_ptr<VideoFrameBuffer> last_buffer_;
+};
+
 // SlideGenerator works similarly to YuvFileGenerator but it fills the frames
 // with randomly sized and colored squares instead of reading their content
 // from files.
@@ -270,6 +347,13 @@ public:
                                  size_t target_height,
                                  int64_t scroll_time_ms,
                                  int64_t pause_time_ms);
+    // Reads the source images from a mapped generator and jumps straight to the frame to show.
+    ScrollingImageFrameGenerator(Clock *clock,
+                                 std::unique_ptr<MappedYuvFileGenerator> mapped_generator,
+                                 size_t target_width,
+                                 size_t target_height,
+                                 int64_t scroll_time_ms,
+                                 int64_t pause_time_ms);
     ~ScrollingImageFrameGenerator() override = default;
 
     VideoFrameData nextFrame() override;
@@ -298,7 +382,8 @@ private:
     bool prev_frame_not_scrolled_;
     VideoFrameData current_source_frame_;
     VideoFrameData current_frame_;
-    YuvFileGenerator file_generator_;
+    std::unique_ptr<YuvFileGenerator> file_generator_;
+    std::unique_ptr<MappedYuvFileGenerator> mapped_generator_;
 };
 
 OCTK_END_NAMESPACE
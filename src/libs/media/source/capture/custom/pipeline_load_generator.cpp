@@ -0,0 +1,397 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include "pipeline_load_generator.hpp"
+#include <openctk/media/video_frame_buffer_pool.hpp>
+#include <openctk/media/video_broadcaster.hpp>
+#include <openctk/media/video_adapter.hpp>
+#include <openctk/core/date_time.hpp>
+#include <openctk/core/checks.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <chrono>
+
+OCTK_BEGIN_NAMESPACE
+
+const char *PipelineLoadGenerator::modeToString(Mode mode)
+{
+    switch (mode)
+    {
+        case Mode::kClosedLoop: return "closedLoop";
+        case Mode::kOpenLoop: return "openLoop";
+        default: OCTK_DCHECK_NOTREACHED();
+    }
+    return "";
+}
+
+PipelineLoadGenerator::LatencyHistogram::LatencyHistogram()
+    : mCount(0)
+    , mSum(0)
+    , mMin(std::numeric_limits<int64_t>::max())
+    , mMax(0)
+{
+    mBuckets.fill(0);
+}
+
+int PipelineLoadGenerator::LatencyHistogram::bucketOf(int64_t value)
+{
+    const uint64_t magnitude = static_cast<uint64_t>(std::max<int64_t>(value, 0));
+    if (magnitude < (1u << kSubBucketBits))
+    {
+        return static_cast<int>(magnitude);
+    }
+    int exponent = 0;
+    while ((magnitude >> exponent) > 1)
+    {
+        ++exponent;
+    }
+    const int shift = exponent - kSubBucketBits;
+    const int subBucket = static_cast<int>((magnitude >> shift) & ((1u << kSubBucketBits) - 1));
+    return ((exponent - kSubBucketBits + 1) << kSubBucketBits) + subBucket;
+}
+
+int64_t PipelineLoadGenerator::LatencyHistogram::bucketUpperBound(int bucket)
+{
+    if (bucket < (1 << kSubBucketBits))
+    {
+        return bucket;
+    }
+    const int shift = (bucket >> kSubBucketBits) - 1;
+    const int64_t subBucket = bucket & ((1 << kSubBucketBits) - 1);
+    return (((int64_t(1) << kSubBucketBits) + subBucket + 1) << shift) - 1;
+}
+
+void PipelineLoadGenerator::LatencyHistogram::add(int64_t valueUSecs)
+{
+    ++mBuckets[bucketOf(valueUSecs)];
+    ++mCount;
+    mSum += valueUSecs;
+    mMin = std::min(mMin, valueUSecs);
+    mMax = std::max(mMax, valueUSecs);
+}
+
+void PipelineLoadGenerator::LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (int i = 0; i < kBuckets; ++i)
+    {
+        mBuckets[i] += other.mBuckets[i];
+    }
+    mCount += other.mCount;
+    mSum += other.mSum;
+    mMin = std::min(mMin, other.mMin);
+    mMax = std::max(mMax, other.mMax);
+}
+
+int64_t PipelineLoadGenerator::LatencyHistogram::percentile(double percentile) const
+{
+    if (0 == mCount)
+    {
+        return 0;
+    }
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(clamped / 100.0 * mCount + 0.5));
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i)
+    {
+        seen += mBuckets[i];
+        if (seen >= rank)
+        {
+            return std::min(std::max(bucketUpperBound(i), mMin), mMax);
+        }
+    }
+    return mMax;
+}
+
+Json PipelineLoadGenerator::LatencyHistogram::toJson() const
+{
+    Json json;
+    json["count"] = mCount;
+    json["min"] = this->min();
+    json["mean"] = this->mean();
+    json["p50"] = this->percentile(50);
+    json["p90"] = this->percentile(90);
+    json["p99"] = this->percentile(99);
+    json["p999"] = this->percentile(99.9);
+    json["max"] = mMax;
+    return json;
+}
+
+Json PipelineLoadGenerator::Report::toJson() const
+{
+    Json json;
+    json["mode"] = modeToString(mode);
+    json["sources"] = sources;
+    json["sinksPerSource"] = sinksPerSource;
+    json["elapsedUSecs"] = elapsedUSecs;
+    json["frames"]["generated"] = framesGenerated;
+    json["frames"]["missed"] = framesMissed;
+    json["frames"]["droppedByAdapter"] = framesDroppedByAdapter;
+    json["frames"]["droppedBySinkQueues"] = framesDroppedBySinkQueues;
+    json["frames"]["delivered"] = framesDelivered;
+    json["throughput"]["sourceFps"] = sourceFps;
+    json["throughput"]["sinkFps"] = sinkFps;
+    json["latencyUSecs"]["generate"] = generateLatency.toJson();
+    json["latencyUSecs"]["adapt"] = adaptLatency.toJson();
+    json["latencyUSecs"]["deliver"] = deliverLatency.toJson();
+    json["latencyUSecs"]["endToEnd"] = endToEndLatency.toJson();
+    return json;
+}
+
+std::string PipelineLoadGenerator::Report::toJsonString(int indent) const { return this->toJson().dump(indent); }
+
+class PipelineLoadGenerator::Sink : public VideoSinkInterface<VideoFrame>
+{
+public:
+    explicit Sink(bool convertToI420)
+        : mConvertToI420(convertToI420)
+    {
+    }
+
+    // Called by one thread at a time, the source thread or the delivery worker of this sink.
+    void onFrame(const VideoFrame &frame) override
+    {
+        if (mConvertToI420)
+        {
+            const auto buffer = frame.videoFrameBuffer()->toI420();
+            mChecksum += buffer ? buffer->dataY()[0] : 0;
+        }
+        mLatency.add(DateTime::steadyTimeUSecs() - frame.timestampUSecs());
+    }
+
+    const LatencyHistogram &latency() const { return mLatency; }
+
+private:
+    const bool mConvertToI420;
+    LatencyHistogram mLatency;
+    uint64_t mChecksum = 0;
+};
+
+class PipelineLoadGenerator::Source
+{
+public:
+    Source(const Config &config, int index)
+        : mConfig(config)
+    {
+        if (config.generatorFactory)
+        {
+            mGenerator = config.generatorFactory(index);
+        }
+        if (!mGenerator)
+        {
+            mGenerator = utils::make_unique<SquareGenerator>(config.width,
+                                                             config.height,
+                                                             FrameGeneratorInterface::OutputType::kI420,
+                                                             10);
+        }
+        VideoSinkWants wants;
+        if (config.sinkMaxPixelCount > 0)
+        {
+            wants.maxPixelCount = config.sinkMaxPixelCount;
+        }
+        if (config.sinkMaxFps > 0)
+        {
+            wants.maxFramerateFps = config.sinkMaxFps;
+        }
+        VideoBroadcaster::SinkOptions options;
+        options.async = config.asyncSinks;
+        options.queueSize = config.sinkQueueSize;
+        for (int i = 0; i < config.sinksPerSource; ++i)
+        {
+            mSinks.emplace_back(new Sink(config.sinksConvertToI420));
+            mBroadcaster.addOrUpdateSink(mSinks.back().get(), wants, options);
+        }
+        mAdapter.OnSinkWants(mBroadcaster.wants());
+    }
+
+    void run(int64_t startUSecs, int64_t endUSecs)
+    {
+        const bool openLoop = Mode::kOpenLoop == mConfig.mode;
+        const int64_t interval = 1000000 / std::max(mConfig.fps, 1);
+        int64_t scheduled = startUSecs;
+        while (true)
+        {
+            int64_t captureTime = DateTime::steadyTimeUSecs();
+            if (openLoop)
+            {
+                if (captureTime < scheduled)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(scheduled - captureTime));
+                    captureTime = DateTime::steadyTimeUSecs();
+                }
+                // Frames whose slot has passed completely are skipped, the late ones keep their scheduled time.
+                const int64_t missed = (captureTime - scheduled) / interval;
+                mMissed += missed;
+                captureTime = scheduled + missed * interval;
+                scheduled = captureTime + interval;
+            }
+            if (captureTime >= endUSecs)
+            {
+                break;
+            }
+            this->pushFrame(captureTime);
+        }
+    }
+
+    void collect(Report &report)
+    {
+        report.framesGenerated += mGenerated;
+        report.framesMissed += mMissed;
+        report.framesDroppedByAdapter += mDroppedByAdapter;
+        report.generateLatency.merge(mGenerateLatency);
+        report.adaptLatency.merge(mAdaptLatency);
+        report.deliverLatency.merge(mDeliverLatency);
+        for (const auto &sink : mSinks)
+        {
+            // frames still queued for an async sink are delivered or dropped before they are counted
+            mBroadcaster.flushSink(sink.get());
+            const auto stats = mBroadcaster.sinkStats(sink.get());
+            mBroadcaster.removeSink(sink.get());
+            if (stats)
+            {
+                report.framesDroppedBySinkQueues += stats->framesDropped;
+            }
+            report.framesDelivered += sink->latency().count();
+            report.endToEndLatency.merge(sink->latency());
+        }
+    }
+
+private:
+    void pushFrame(int64_t captureTime)
+    {
+        const int64_t generateStart = DateTime::steadyTimeUSecs();
+        VideoFrame frame = VideoFrame::Builder()
+                               .setVideoFrameBuffer(mGenerator->nextFrame().buffer)
+                               .setTimestampUSecs(captureTime)
+                               .build();
+        ++mGenerated;
+        const int64_t adaptStart = DateTime::steadyTimeUSecs();
+        mGenerateLatency.add(adaptStart - generateStart);
+
+        int croppedWidth = 0;
+        int croppedHeight = 0;
+        int outWidth = 0;
+        int outHeight = 0;
+        if (!mAdapter.adaptFrameResolution(frame.width(),
+                                           frame.height(),
+                                           captureTime * 1000,
+                                           &croppedWidth,
+                                           &croppedHeight,
+                                           &outWidth,
+                                           &outHeight))
+        {
+            ++mDroppedByAdapter;
+            mAdaptLatency.add(DateTime::steadyTimeUSecs() - adaptStart);
+            return;
+        }
+        if (outWidth != frame.width() || outHeight != frame.height())
+        {
+            std::shared_ptr<I420Buffer> scaled = mPool.CreateI420Buffer(outWidth, outHeight);
+            scaled->cropAndScaleFrom(*frame.videoFrameBuffer()->toI420(),
+                                     (frame.width() - croppedWidth) / 2,
+                                     (frame.height() - croppedHeight) / 2,
+                                     croppedWidth,
+                                     croppedHeight);
+            frame = VideoFrame::Builder().setVideoFrameBuffer(scaled).setTimestampUSecs(captureTime).build();
+        }
+        const int64_t deliverStart = DateTime::steadyTimeUSecs();
+        mAdaptLatency.add(deliverStart - adaptStart);
+
+        mBroadcaster.onFrame(frame);
+        mDeliverLatency.add(DateTime::steadyTimeUSecs() - deliverStart);
+    }
+
+    const Config &mConfig;
+    std::unique_ptr<FrameGeneratorInterface> mGenerator;
+    VideoAdapter mAdapter;
+    VideoBroadcaster mBroadcaster;
+    VideoFrameBufferPool mPool;
+    std::vector<std::unique_ptr<Sink>> mSinks;
+    uint64_t mGenerated = 0;
+    uint64_t mMissed = 0;
+    uint64_t mDroppedByAdapter = 0;
+    LatencyHistogram mGenerateLatency;
+    LatencyHistogram mAdaptLatency;
+    LatencyHistogram mDeliverLatency;
+};
+
+PipelineLoadGenerator::PipelineLoadGenerator(const Config &config)
+    : mConfig(config)
+{
+    OCTK_DCHECK_GT(config.sources, 0);
+    OCTK_DCHECK_GE(config.sinksPerSource, 0);
+    OCTK_DCHECK_GT(config.durationMSecs, 0);
+}
+
+PipelineLoadGenerator::~PipelineLoadGenerator() = default;
+
+PipelineLoadGenerator::Report PipelineLoadGenerator::run()
+{
+    std::vector<std::unique_ptr<Source>> sources;
+    for (int i = 0; i < mConfig.sources; ++i)
+    {
+        sources.emplace_back(new Source(mConfig, i));
+    }
+
+    // Sources start together once all threads are up.
+    const int64_t startUSecs = DateTime::steadyTimeUSecs() + 10000;
+    const int64_t endUSecs = startUSecs + mConfig.durationMSecs * 1000;
+    std::vector<std::thread> threads;
+    for (const auto &source : sources)
+    {
+        Source *pointer = source.get();
+        threads.emplace_back(
+            [pointer, startUSecs, endUSecs]
+            {
+                const int64_t now = DateTime::steadyTimeUSecs();
+                if (now < startUSecs)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(startUSecs - now));
+                }
+                pointer->run(startUSecs, endUSecs);
+            });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    const int64_t elapsedUSecs = std::max<int64_t>(DateTime::steadyTimeUSecs() - startUSecs, 1);
+
+    Report report;
+    report.mode = mConfig.mode;
+    report.sources = mConfig.sources;
+    report.sinksPerSource = mConfig.sinksPerSource;
+    for (const auto &source : sources)
+    {
+        source->collect(report);
+    }
+    report.elapsedUSecs = elapsedUSecs;
+    const double seconds = report.elapsedUSecs / 1e6;
+    report.sourceFps = (report.framesGenerated - report.framesDroppedByAdapter) / seconds;
+    report.sinkFps = report.framesDelivered / seconds;
+    return report;
+}
+
+OCTK_END_NAMESPACE
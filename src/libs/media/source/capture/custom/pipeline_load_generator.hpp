@@ -0,0 +1,154 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#pragma once
+
+#include <openctk/media/frame_generator.hpp>
+#include <openctk/core/json.hpp>
+
+#include <functional>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <array>
+
+OCTK_BEGIN_NAMESPACE
+
+/**
+ * Benchmark harness that drives a number of virtual sources through VideoAdapter -> VideoBroadcaster -> sinks.
+ * Every source runs on its own thread with its own frame generator, adapter and broadcaster. In closed loop mode a
+ * source pushes the next frame as soon as the previous one was delivered, measuring the maximum throughput. In open
+ * loop mode frames are scheduled at a fixed rate, a source that falls behind skips the frames it missed and latency
+ * is measured from the scheduled time, so a stalled pipeline shows up in the latency instead of hiding in a lower
+ * send rate. run() reports per stage latency histograms, throughput and dropped frames, Report::toJson() gives
+ * stable keys for regression tracking.
+ */
+class OCTK_MEDIA_API PipelineLoadGenerator
+{
+public:
+    enum class Mode
+    {
+        kClosedLoop,
+        kOpenLoop
+    };
+    static const char *modeToString(Mode mode);
+
+    struct Config
+    {
+        Mode mode = Mode::kClosedLoop;
+        int sources = 1;
+        int sinksPerSource = 1;
+        int width = 640;
+        int height = 360;
+        // Frames per second of every source in open loop mode.
+        int fps = 30;
+        int64_t durationMSecs = 1000;
+        // Sink wants, downscaling or frame dropping by the adapters is part of the measured pipeline.
+        int sinkMaxPixelCount = 0;
+        int sinkMaxFps = 0;
+        // Deliver through the asynchronous sink queues of the broadcaster.
+        bool asyncSinks = false;
+        size_t sinkQueueSize = 2;
+        // Sinks convert every frame to I420, otherwise they only record the latency.
+        bool sinksConvertToI420 = true;
+        // Creates the generator of a source, unset or returning nullptr uses a SquareGenerator of width x height.
+        std::function<std::unique_ptr<FrameGeneratorInterface>(int source)> generatorFactory;
+    };
+
+    /**
+     * Log-linear latency histogram in microseconds: 16 linear sub-buckets per power of two, so percentiles are
+     * exact up to 16us and within 1/16 of the value above.
+     */
+    class OCTK_MEDIA_API LatencyHistogram
+    {
+    public:
+        LatencyHistogram();
+
+        void add(int64_t valueUSecs);
+        void merge(const LatencyHistogram &other);
+
+        uint64_t count() const { return mCount; }
+        int64_t min() const { return mCount ? mMin : 0; }
+        int64_t max() const { return mMax; }
+        double mean() const { return mCount ? static_cast<double>(mSum) / mCount : 0.0; }
+        // Upper bound of the bucket holding the given percentile, 0 <= percentile <= 100.
+        int64_t percentile(double percentile) const;
+
+        Json toJson() const;
+
+    private:
+        static int bucketOf(int64_t value);
+        static int64_t bucketUpperBound(int bucket);
+
+        static constexpr int kSubBucketBits = 4;
+        static constexpr int kBuckets = (64 - kSubBucketBits + 1) << kSubBucketBits;
+        std::array<uint64_t, kBuckets> mBuckets;
+        uint64_t mCount;
+        int64_t mSum;
+        int64_t mMin;
+        int64_t mMax;
+    };
+
+    struct Report
+    {
+        Mode mode = Mode::kClosedLoop;
+        int sources = 0;
+        int sinksPerSource = 0;
+        int64_t elapsedUSecs = 0;
+        uint64_t framesGenerated = 0;
+        // Open loop frames whose time slot had passed before the source got to them.
+        uint64_t framesMissed = 0;
+        uint64_t framesDroppedByAdapter = 0;
+        uint64_t framesDroppedBySinkQueues = 0;
+        uint64_t framesDelivered = 0;
+        // Frames through the broadcasters and frames into sinks per second, over all sources.
+        double sourceFps = 0.0;
+        double sinkFps = 0.0;
+        // Frame generator, adapter including scaling, broadcaster onFrame() and capture time until a sink got it.
+        LatencyHistogram generateLatency;
+        LatencyHistogram adaptLatency;
+        LatencyHistogram deliverLatency;
+        LatencyHistogram endToEndLatency;
+
+        Json toJson() const;
+        std::string toJsonString(int indent = 2) const;
+    };
+
+    explicit PipelineLoadGenerator(const Config &config);
+    ~PipelineLoadGenerator();
+
+    const Config &config() const { return mConfig; }
+
+    // Runs all sources for Config::durationMSecs and returns the merged report, blocks until done.
+    Report run();
+
+private:
+    class Source;
+    class Sink;
+
+    const Config mConfig;
+};
+
+OCTK_END_NAMESPACE
@@ -78,6 +78,7 @@
 #include <api/media_stream_interface.h>
 #include <api/video/video_frame.h>
 #include <api/video/i420_buffer.h>
+#include <api/video/nv12_buffer.h>
 #include <api/scoped_refptr.h>
 
 #include <media/engine/internal_decoder_factory.h>
@@ -96,6 +97,7 @@
 #include <rtc_base/logging.h>
 
 #include <future> // std::promise, std::future
+#include <mutex>  // std::call_once
 
 namespace webrtc
 {
@@ -601,22 +603,24 @@ std::string join(T &val, std::string delim)
 class RtcVideoFrameWebRTC : public RtcVideoFrame
 {
 public:
-    RtcVideoFrameWebRTC(webrtc::scoped_refptr<webrtc::I420BufferInterface> buffer,
+    RtcVideoFrameWebRTC(webrtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer,
                         webrtc::VideoRotation rotation,
                         int64_t timestamp_us,
                         uint16_t id)
-        : mWebRTCI420Buffer(buffer)
+        : mWebRTCBuffer(std::move(buffer))
         , mTimestampUSecs(timestamp_us)
         , mWebRTCRotation(rotation)
         , mId(id)
     {
+        this->init();
     }
     RtcVideoFrameWebRTC(const webrtc::VideoFrame &frame)
-        : mWebRTCI420Buffer(frame.video_frame_buffer()->ToI420())
+        : mWebRTCBuffer(frame.video_frame_buffer())
         , mTimestampUSecs(frame.timestamp_us())
         , mWebRTCRotation(frame.rotation())
         , mId(frame.id())
     {
+        this->init();
     }
 
     ~RtcVideoFrameWebRTC() override { }
@@ -627,13 +631,13 @@ public:
 
     SharedPtr copy() override
     {
-        return SharedPtr(new RtcVideoFrameWebRTC(mWebRTCI420Buffer, mWebRTCRotation, mTimestampUSecs, mId),
+        return SharedPtr(new RtcVideoFrameWebRTC(mWebRTCBuffer, mWebRTCRotation, mTimestampUSecs, mId),
                          [](RtcVideoFrameWebRTC *p) { delete p; });
     }
 
-    int width() const override { return mWebRTCI420Buffer->width(); }
-    int height() const override { return mWebRTCI420Buffer->height(); }
-    Format format() const override { return Format::kI420; }
+    int width() const override { return mWebRTCBuffer->width(); }
+    int height() const override { return mWebRTCBuffer->height(); }
+    Format format() const override { return mFormat; }
 
     uint16_t id() const override { return mId; }
     int64_t timestampUSecs() const override { return mTimestampUSecs; }
@@ -641,14 +645,16 @@ public:
 
     // Returns pointer to the pixel data for a given plane. The memory is owned by
     // the VideoFrameBuffer object and must not be freed by the caller.
-    const uint8_t *dataY() const override { return mWebRTCI420Buffer->GetI420()->DataY(); }
-    const uint8_t *dataU() const override { return mWebRTCI420Buffer->GetI420()->DataU(); }
-    const uint8_t *dataV() const override { return mWebRTCI420Buffer->GetI420()->DataV(); }
+    const uint8_t *dataY() const override { return mWebRTCNV12 ? mWebRTCNV12->DataY() : this->i420()->DataY(); }
+    const uint8_t *dataU() const override { return this->i420()->DataU(); }
+    const uint8_t *dataV() const override { return this->i420()->DataV(); }
+    const uint8_t *dataUV() const override { return mWebRTCNV12 ? mWebRTCNV12->DataUV() : nullptr; }
 
     // Returns the number of bytes between successive rows for a given plane.
-    int strideY() const override { return mWebRTCI420Buffer->GetI420()->StrideY(); }
-    int strideU() const override { return mWebRTCI420Buffer->GetI420()->StrideU(); }
-    int strideV() const override { return mWebRTCI420Buffer->GetI420()->StrideV(); }
+    int strideY() const override { return mWebRTCNV12 ? mWebRTCNV12->StrideY() : this->i420()->StrideY(); }
+    int strideU() const override { return this->i420()->StrideU(); }
+    int strideV() const override { return this->i420()->StrideV(); }
+    int strideUV() const override { return mWebRTCNV12 ? mWebRTCNV12->StrideUV() : 0; }
 
     // int convertToARGB(BufferType type, uint8_t *dstArgb, int dstStrideArgb, int dstWidth, int dstHeight) override
     // {
@@ -656,9 +662,42 @@ public:
     // }
 
 private:
+    void init()
+    {
+        switch (mWebRTCBuffer->type())
+        {
+            case webrtc::VideoFrameBuffer::Type::kI420:
+            case webrtc::VideoFrameBuffer::Type::kI420A:
+                mFormat = Format::kI420;
+                mWebRTCI420 = mWebRTCBuffer->GetI420();
+                break;
+            case webrtc::VideoFrameBuffer::Type::kNV12:
+                mFormat = Format::kNV12;
+                mWebRTCNV12 = mWebRTCBuffer->GetNV12();
+                break;
+            default: mFormat = Format::kNative; break;
+        }
+    }
+
+    // Native (e.g. texture) and NV12 buffers are only converted when a planar accessor is used, at most once.
+    const webrtc::I420BufferInterface *i420() const
+    {
+        if (mWebRTCI420)
+        {
+            return mWebRTCI420;
+        }
+        std::call_once(mConvertOnce, [this]() { mWebRTCConverted = mWebRTCBuffer->ToI420(); });
+        return mWebRTCConverted.get();
+    }
+
     uint16_t mId{0};
     int64_t mTimestampUSecs{0};
-    webrtc::scoped_refptr<webrtc::I420BufferInterface> mWebRTCI420Buffer;
+    Format mFormat{Format::kNative};
+    webrtc::scoped_refptr<webrtc::VideoFrameBuffer> mWebRTCBuffer;
+    const webrtc::I420BufferInterface *mWebRTCI420{nullptr};
+    const webrtc::NV12BufferInterface *mWebRTCNV12{nullptr};
+    mutable std::once_flag mConvertOnce;
+    mutable webrtc::scoped_refptr<webrtc::I420BufferInterface> mWebRTCConverted;
     webrtc::VideoRotation mWebRTCRotation{webrtc::kVideoRotation_0};
 };
 
@@ -948,7 +987,7 @@ protected:
     // VideoSinkInterface implementation
     void OnFrame(const webrtc::VideoFrame &frame) override
     {
-        auto videoFrame = RtcVideoFrameWebRTC::create(frame);
+        auto videoFrame = mFramePool.create<RtcVideoFrameWebRTC>(frame);
         /*webrtc::MutexLock lock(mMutex.get());
         for (const auto &sink : mVideoSinks)
         {
@@ -959,6 +998,7 @@ protected:
 
     webrtc::scoped_refptr<webrtc::VideoTrackInterface> mWebRTCVideoTrack;
     RtcVideoBroadcaster mVideoBroadcaster;
+    RtcVideoFramePool mFramePool;
     // std::vector<RtcVideoSink *> mVideoSinks;
     // std::unique_ptr<webrtc::Mutex> mMutex;
 };
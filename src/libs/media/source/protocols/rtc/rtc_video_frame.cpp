@@ -25,41 +25,47 @@
 #include <openctk/media/frame_generator_capturer.hpp>
 #include "rtc_video_frame.hpp"
 #include <openctk/core/date_time.hpp>
+#include <openctk/core/spinlock.hpp>
 #include <openctk/media/yuv.hpp>
 
+#include <mutex> // std::call_once
+#include <vector>
+
 OCTK_BEGIN_NAMESPACE
 
 class RtcVideoFrameDefault : public RtcVideoFrame
 {
 public:
     RtcVideoFrameDefault(const VideoFrame &frame)
-        : mI420Buffer(frame.videoFrameBuffer()->toI420())
+        : mBuffer(frame.videoFrameBuffer())
         , mTimestampUSecs(frame.timestampUSecs())
         , mVideoRotation(frame.rotation())
         , mId(frame.id())
     {
+        this->init();
     }
-    RtcVideoFrameDefault(std::shared_ptr<I420BufferInterface> buffer,
+    RtcVideoFrameDefault(std::shared_ptr<VideoFrameBuffer> buffer,
                          VideoRotation rotation,
                          int64_t timestamp_us,
                          uint16_t id)
-        : mI420Buffer(buffer)
+        : mBuffer(std::move(buffer))
         , mTimestampUSecs(timestamp_us)
         , mVideoRotation(rotation)
         , mId(id)
     {
+        this->init();
     }
     ~RtcVideoFrameDefault() override = default;
 
     SharedPtr copy() override
     {
-        return SharedPtr(new RtcVideoFrameDefault(mI420Buffer, mVideoRotation, mTimestampUSecs, mId),
+        return SharedPtr(new RtcVideoFrameDefault(mBuffer, mVideoRotation, mTimestampUSecs, mId),
                          [](RtcVideoFrameDefault *p) { delete p; });
     }
 
-    int width() const override { return mI420Buffer->width(); }
-    int height() const override { return mI420Buffer->height(); }
-    Format format() const override { return Format::kI420; }
+    int width() const override { return mBuffer->width(); }
+    int height() const override { return mBuffer->height(); }
+    Format format() const override { return mFormat; }
 
     uint16_t id() const override { return mId; }
     int64_t timestampUSecs() const override { return mTimestampUSecs; }
@@ -75,26 +81,160 @@ public:
         return Rotation::kAngle0;
     }
 
-    const uint8_t *dataY() const override { return mI420Buffer->dataY(); }
-    const uint8_t *dataU() const override { return mI420Buffer->dataU(); }
-    const uint8_t *dataV() const override { return mI420Buffer->dataV(); }
+    const uint8_t *dataY() const override { return mNV12 ? mNV12->dataY() : this->i420()->dataY(); }
+    const uint8_t *dataU() const override { return this->i420()->dataU(); }
+    const uint8_t *dataV() const override { return this->i420()->dataV(); }
+    const uint8_t *dataUV() const override { return mNV12 ? mNV12->dataUV() : nullptr; }
 
-    int strideY() const override { return mI420Buffer->strideY(); }
-    int strideU() const override { return mI420Buffer->strideU(); }
-    int strideV() const override { return mI420Buffer->strideV(); }
+    int strideY() const override { return mNV12 ? mNV12->strideY() : this->i420()->strideY(); }
+    int strideU() const override { return this->i420()->strideU(); }
+    int strideV() const override { return this->i420()->strideV(); }
+    int strideUV() const override { return mNV12 ? mNV12->strideUV() : 0; }
 
 private:
+    void init()
+    {
+        switch (mBuffer->type())
+        {
+        case VideoFrameBuffer::Type::kI420:
+        case VideoFrameBuffer::Type::kI420A:
+            mFormat = Format::kI420;
+            mI420 = mBuffer->getI420();
+            break;
+        case VideoFrameBuffer::Type::kNV12:
+            mFormat = Format::kNV12;
+            mNV12 = mBuffer->getNV12();
+            break;
+        default: mFormat = Format::kNative; break;
+        }
+    }
+
+    // Planar view of the frame, converted on first use when the wrapped buffer is not I420.
+    const I420BufferInterface *i420() const
+    {
+        if (mI420)
+        {
+            return mI420;
+        }
+        std::call_once(mConvertOnce, [this]() { mConverted = mBuffer->toI420(); });
+        return mConverted.get();
+    }
+
     uint16_t mId{0};
     int64_t mTimestampUSecs{0};
-    std::shared_ptr<I420BufferInterface> mI420Buffer;
+    std::shared_ptr<VideoFrameBuffer> mBuffer;
     VideoRotation mVideoRotation{VideoRotation::kAngle0};
+    Format mFormat{Format::kNative};
+    const I420BufferInterface *mI420{nullptr};
+    const NV12BufferInterface *mNV12{nullptr};
+    mutable std::once_flag mConvertOnce;
+    mutable std::shared_ptr<I420BufferInterface> mConverted;
+};
+
+class RtcVideoFramePool::State
+{
+public:
+    explicit State(size_t capacity)
+        : capacity(capacity)
+    {
+        free.reserve(capacity);
+    }
+    ~State()
+    {
+        for (auto block : free)
+        {
+            ::operator delete(block);
+        }
+    }
+
+    SpinLock lock;
+    std::vector<void *> free;
+    size_t blockSize{0};
+    const size_t capacity;
+    uint64_t hits{0};
+    uint64_t misses{0};
+    size_t refs{1}; // the pool's own reference plus one per block in flight, guarded by lock
 };
 
+RtcVideoFramePool::RtcVideoFramePool(size_t capacity)
+    : mState(new State(capacity))
+{
+}
+
+RtcVideoFramePool::~RtcVideoFramePool()
+{
+    bool last = false;
+    {
+        std::lock_guard<SpinLock> locker(mState->lock);
+        last = 0 == --mState->refs;
+    }
+    if (last)
+    {
+        delete mState;
+    }
+}
+
+RtcVideoFramePool::Stats RtcVideoFramePool::stats() const
+{
+    std::lock_guard<SpinLock> locker(mState->lock);
+    Stats stats;
+    stats.hits = mState->hits;
+    stats.misses = mState->misses;
+    stats.free = mState->free.size();
+    return stats;
+}
+
+void *RtcVideoFramePool::allocate(State *state, size_t bytes)
+{
+    {
+        std::lock_guard<SpinLock> locker(state->lock);
+        ++state->refs;
+        if (bytes == state->blockSize && !state->free.empty())
+        {
+            void *block = state->free.back();
+            state->free.pop_back();
+            ++state->hits;
+            return block;
+        }
+        ++state->misses;
+    }
+    return ::operator new(bytes);
+}
+
+void RtcVideoFramePool::deallocate(State *state, void *block, size_t bytes)
+{
+    bool last = false;
+    {
+        std::lock_guard<SpinLock> locker(state->lock);
+        last = 0 == --state->refs;
+        if (0 == state->blockSize)
+        {
+            // every block of a pool holds the same frame type, the first one released fixes the size
+            state->blockSize = bytes;
+        }
+        if (bytes == state->blockSize && state->free.size() < state->capacity)
+        {
+            state->free.push_back(block);
+            block = nullptr;
+        }
+    }
+    ::operator delete(block);
+    if (last)
+    {
+        delete state;
+    }
+}
+
 RtcVideoFrame::SharedPtr RtcVideoFrame::create(const VideoFrame &frame)
 {
     return utils::make_shared<RtcVideoFrameDefault>(frame);
 }
 
+RtcVideoFrame::SharedPtr RtcVideoFrame::create(const VideoFrame &frame, RtcVideoFramePool &pool)
+{
+    return pool.create<RtcVideoFrameDefault>(frame);
+}
+
 RtcVideoFrame::SharedPtr RtcVideoFrame::createI420(const uint8_t *data, int width, int height, int64_t timestampUSecs)
 {
     auto buffer = I420Buffer::create(width, height);
@@ -180,13 +320,14 @@ public:
     void onFrame(const VideoFrame &frame) override
     {
         const auto sinks = mPPtr->sinks();
-        const auto rtcFrame = RtcVideoFrame::create(frame);
+        const auto rtcFrame = RtcVideoFrame::create(frame, mFramePool);
         for (const auto &sink : sinks)
         {
             sink->onData(rtcFrame);
         }
     }
 
+    RtcVideoFramePool mFramePool;
     std::unique_ptr<FrameGeneratorCapturerVideoTrackSource> mGeneratorSource;
     const std::string mName;
     int mHeight;
@@ -283,7 +424,7 @@ public:
     void onFrame(const VideoFrame &frame) override
     {
         const auto sinks = mPPtr->sinks();
-        const auto rtcFrame = RtcVideoFrame::create(frame);
+        const auto rtcFrame = RtcVideoFrame::create(frame, mFramePool);
         for (const auto &sink : sinks)
         {
             sink->onData(rtcFrame);
@@ -305,6 +446,7 @@ public:
 
     void removeSink(VideoSinkInterface<VideoFrame> *sink) override { mVideoSinks.erase(sink); }
 
+    RtcVideoFramePool mFramePool;
     CameraCapture::SharedPtr mCapture;
     std::set<VideoSinkInterface<VideoFrame> *> mVideoSinks;
 
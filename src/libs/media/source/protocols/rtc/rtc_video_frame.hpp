@@ -29,17 +29,23 @@
 #include <openctk/core/shared_pointer.hpp>
 #include <openctk/core/source_sink.hpp>
 
+#include <memory>
+
 OCTK_BEGIN_NAMESPACE
 
+class RtcVideoFramePool;
+
 class RtcVideoFrame
 {
 public:
     using SharedPtr = SharedPointer<RtcVideoFrame>;
 
+    // Layout of the buffer the frame wraps, frames keep the format they were received in.
     enum class Format
     {
         kI420,
-        kNV12
+        kNV12,
+        kNative // backend specific storage, e.g. a texture, only reachable through the I420 accessors
     };
 
     enum class Rotation
@@ -51,6 +57,7 @@ public:
     };
 
     static SharedPtr create(const VideoFrame &frame);
+    static SharedPtr create(const VideoFrame &frame, RtcVideoFramePool &pool);
     static SharedPtr createI420(const uint8_t *data, int width, int height, int64_t timestampUSecs = 0);
     static SharedPtr createFromARGB(const uint8_t *data, int width, int height, int64_t timestampUSecs = 0);
     static SharedPtr createFromRGBA(const uint8_t *data, int width, int height, int64_t timestampUSecs = 0);
@@ -69,14 +76,19 @@ public:
 
     // Returns pointer to the pixel data for a given plane. The memory is owned by
     // the VideoFrameBuffer object and must not be freed by the caller.
+    // The Y plane is the frame's own for kI420 and kNV12. The U and V planes are the frame's own for kI420, other
+    // formats are converted to I420 once, on the first access to a plane they do not have.
     virtual const uint8_t *dataY() const = 0;
     virtual const uint8_t *dataU() const = 0;
     virtual const uint8_t *dataV() const = 0;
+    // Interleaved chroma plane of kNV12 frames, nullptr for other formats.
+    virtual const uint8_t *dataUV() const = 0;
 
     // Returns the number of bytes between successive rows for a given plane.
     virtual int strideY() const = 0;
     virtual int strideU() const = 0;
     virtual int strideV() const = 0;
+    virtual int strideUV() const = 0;
 
     //virtual int convertToARGB(BufferType type, uint8_t *dstArgb, int dstStrideArgb, int dstWidth, int dstHeight) = 0;
 
@@ -84,6 +96,77 @@ protected:
     virtual ~RtcVideoFrame() { }
 };
 
+/**
+ * Recycles the storage of RtcVideoFrame wrappers together with their shared pointer control block, so that bridging
+ * a frame does not allocate once the pool is warm. Frames are still destroyed when their last reference goes away,
+ * which releases their buffer right away, only the memory goes back to the pool. Thread safe: frames may be created
+ * and released on any thread and may outlive the pool.
+ */
+class OCTK_MEDIA_API RtcVideoFramePool
+{
+    class State;
+
+public:
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t free = 0;
+    };
+
+    // Keeps at most `capacity` free blocks, frames in flight above that are allocated and freed as usual.
+    explicit RtcVideoFramePool(size_t capacity = 16);
+    ~RtcVideoFramePool();
+
+    template <typename T, typename... Args>
+    std::shared_ptr<T> create(Args &&...args)
+    {
+        return std::allocate_shared<T>(Allocator<T>(mState), std::forward<Args>(args)...);
+    }
+
+    Stats stats() const;
+
+private:
+    template <typename U>
+    struct Allocator
+    {
+        using value_type = U;
+
+        explicit Allocator(State *state)
+            : mState(state)
+        {
+        }
+        template <typename V>
+        Allocator(const Allocator<V> &other)
+            : mState(other.mState)
+        {
+        }
+
+        U *allocate(size_t n) { return static_cast<U *>(RtcVideoFramePool::allocate(mState, n * sizeof(U))); }
+        void deallocate(U *block, size_t n) { RtcVideoFramePool::deallocate(mState, block, n * sizeof(U)); }
+
+        template <typename V>
+        bool operator==(const Allocator<V> &other) const
+        {
+            return mState == other.mState;
+        }
+        template <typename V>
+        bool operator!=(const Allocator<V> &other) const
+        {
+            return mState != other.mState;
+        }
+
+        // every block handed out holds a reference on the state, copies of the allocator do not need one
+        State *mState;
+    };
+
+    static void *allocate(State *state, size_t bytes);
+    static void deallocate(State *state, void *block, size_t bytes);
+
+    State *mState;
+    OCTK_DISABLE_COPY_MOVE(RtcVideoFramePool)
+};
+
 using RtcVideoSink = Sink<SharedPointer<RtcVideoFrame>>;
 using RtcVideoSinkCallback = SinkCallback<SharedPointer<RtcVideoFrame>>;
 
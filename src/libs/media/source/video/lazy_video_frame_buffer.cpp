@@ -0,0 +1,179 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/lazy_video_frame_buffer.hpp>
+#include <openctk/media/rgba_buffer.hpp>
+#include <openctk/core/checks.hpp>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+std::atomic<uint64_t> &totalConversions()
+{
+    static std::atomic<uint64_t> conversions{0};
+    return conversions;
+}
+
+std::atomic<uint64_t> &totalConversionsAvoided()
+{
+    static std::atomic<uint64_t> avoided{0};
+    return avoided;
+}
+} // namespace
+
+std::shared_ptr<LazyVideoFrameBuffer> LazyVideoFrameBuffer::create(std::shared_ptr<VideoFrameBuffer> buffer)
+{
+    auto lazy = std::dynamic_pointer_cast<LazyVideoFrameBuffer>(buffer);
+    return lazy ? lazy : std::make_shared<LazyVideoFrameBuffer>(std::move(buffer));
+}
+
+LazyVideoFrameBuffer::LazyVideoFrameBuffer(std::shared_ptr<VideoFrameBuffer> buffer)
+    : mBuffer(std::move(buffer))
+{
+    OCTK_CHECK(mBuffer);
+}
+
+LazyVideoFrameBuffer::~LazyVideoFrameBuffer() = default;
+
+std::shared_ptr<I420BufferInterface> LazyVideoFrameBuffer::toI420()
+{
+    bool ran = false;
+    std::call_once(mI420Once,
+                   [this, &ran]()
+                   {
+                       mI420 = mBuffer->toI420();
+                       mI420Ready.store(true, std::memory_order_release);
+                       ran = true;
+                   });
+    ran ? this->converted() : this->avoided();
+    return mI420;
+}
+
+std::shared_ptr<RGBABufferInterface> LazyVideoFrameBuffer::toRGBA()
+{
+    bool ran = false;
+    std::call_once(mRGBAOnce,
+                   [this, &ran]()
+                   {
+                       if (Type::kRGBA == mBuffer->type())
+                       {
+                           mRGBA = std::static_pointer_cast<RGBABufferInterface>(mBuffer);
+                           return;
+                       }
+                       // Goes through the memoized I420 buffer, which counts for itself.
+                       const auto i420 = this->toI420();
+                       mRGBA = i420 ? RGBABuffer::copy(*i420) : nullptr;
+                       ran = true;
+                   });
+    ran ? this->converted() : this->avoided();
+    return mRGBA;
+}
+
+const I420BufferInterface *LazyVideoFrameBuffer::getI420() const
+{
+    if (const auto i420 = mBuffer->getI420())
+    {
+        return i420;
+    }
+    return mI420Ready.load(std::memory_order_acquire) ? mI420.get() : nullptr;
+}
+
+std::shared_ptr<VideoFrameBuffer> LazyVideoFrameBuffer::cropAndScale(int offsetX,
+                                                                     int offsetY,
+                                                                     int cropWidth,
+                                                                     int cropHeight,
+                                                                     int scaledWidth,
+                                                                     int scaledHeight)
+{
+    return mBuffer->cropAndScale(offsetX, offsetY, cropWidth, cropHeight, scaledWidth, scaledHeight);
+}
+
+std::shared_ptr<VideoFrameBuffer> LazyVideoFrameBuffer::getMappedFrameBuffer(ArrayView<Type> types)
+{
+    const auto type = mBuffer->type();
+    for (const auto wanted : types)
+    {
+        if (wanted == type)
+        {
+            this->avoided();
+            return mBuffer;
+        }
+    }
+    if (Type::kNative == type)
+    {
+        if (auto mapped = mBuffer->getMappedFrameBuffer(types))
+        {
+            this->avoided();
+            return mapped;
+        }
+    }
+    for (const auto wanted : types)
+    {
+        if (Type::kI420 == wanted)
+        {
+            return this->toI420();
+        }
+        if (Type::kRGBA == wanted)
+        {
+            return this->toRGBA();
+        }
+    }
+    return nullptr;
+}
+
+std::string LazyVideoFrameBuffer::storageRepresentation() const
+{
+    return "Lazy(" + mBuffer->storageRepresentation() + ")";
+}
+
+LazyVideoFrameBuffer::Stats LazyVideoFrameBuffer::stats() const
+{
+    Stats stats;
+    stats.conversions = mConversions.load(std::memory_order_relaxed);
+    stats.conversionsAvoided = mConversionsAvoided.load(std::memory_order_relaxed);
+    return stats;
+}
+
+LazyVideoFrameBuffer::Stats LazyVideoFrameBuffer::totalStats()
+{
+    Stats stats;
+    stats.conversions = totalConversions().load(std::memory_order_relaxed);
+    stats.conversionsAvoided = totalConversionsAvoided().load(std::memory_order_relaxed);
+    return stats;
+}
+
+void LazyVideoFrameBuffer::converted()
+{
+    mConversions.fetch_add(1, std::memory_order_relaxed);
+    totalConversions().fetch_add(1, std::memory_order_relaxed);
+}
+
+void LazyVideoFrameBuffer::avoided()
+{
+    mConversionsAvoided.fetch_add(1, std::memory_order_relaxed);
+    totalConversionsAvoided().fetch_add(1, std::memory_order_relaxed);
+}
+
+OCTK_END_NAMESPACE
@@ -0,0 +1,97 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#pragma once
+
+#include <openctk/media/video_frame_buffer.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+OCTK_BEGIN_NAMESPACE
+
+/**
+ * Native frame buffer that wraps another buffer and converts it at most once per format.
+ * The first toI420() / toRGBA() call converts the wrapped buffer, concurrent and later calls of any thread share that
+ * result, so sinks fanned out from one frame don't each pay for the conversion. getMappedFrameBuffer() hands out the
+ * wrapped buffer when its format is asked for and falls back to the memoized conversions otherwise.
+ * The converted buffers are shared between all callers and must be treated as read only.
+ */
+class OCTK_MEDIA_API LazyVideoFrameBuffer : public VideoFrameBuffer
+{
+public:
+    struct Stats final
+    {
+        // Conversions actually run on the wrapped buffer.
+        uint64_t conversions{0};
+        // Calls answered with a memoized conversion or with the wrapped buffer itself.
+        uint64_t conversionsAvoided{0};
+    };
+
+    // Wraps buffer, returns it unchanged if it already is a LazyVideoFrameBuffer.
+    static std::shared_ptr<LazyVideoFrameBuffer> create(std::shared_ptr<VideoFrameBuffer> buffer);
+
+    explicit LazyVideoFrameBuffer(std::shared_ptr<VideoFrameBuffer> buffer);
+    ~LazyVideoFrameBuffer() override;
+
+    const std::shared_ptr<VideoFrameBuffer> &buffer() const { return mBuffer; }
+
+    Type type() const override { return Type::kNative; }
+    int width() const override { return mBuffer->width(); }
+    int height() const override { return mBuffer->height(); }
+
+    std::shared_ptr<I420BufferInterface> toI420() override;
+    std::shared_ptr<RGBABufferInterface> toRGBA() override;
+    // The wrapped buffer if it is I420, else the memoized conversion once toI420() ran.
+    const I420BufferInterface *getI420() const override;
+    std::shared_ptr<VideoFrameBuffer> cropAndScale(int offsetX,
+                                                   int offsetY,
+                                                   int cropWidth,
+                                                   int cropHeight,
+                                                   int scaledWidth,
+                                                   int scaledHeight) override;
+    std::shared_ptr<VideoFrameBuffer> getMappedFrameBuffer(ArrayView<Type> types) override;
+    std::string storageRepresentation() const override;
+
+    Stats stats() const;
+    // Sums of the stats of every LazyVideoFrameBuffer of the process.
+    static Stats totalStats();
+
+private:
+    void converted();
+    void avoided();
+
+    const std::shared_ptr<VideoFrameBuffer> mBuffer;
+    std::once_flag mI420Once;
+    std::once_flag mRGBAOnce;
+    std::shared_ptr<I420BufferInterface> mI420;
+    std::shared_ptr<RGBABufferInterface> mRGBA;
+    // Set after mI420 was written, getI420() must not read it while the conversion runs.
+    std::atomic<bool> mI420Ready{false};
+    std::atomic<uint64_t> mConversions{0};
+    std::atomic<uint64_t> mConversionsAvoided{0};
+};
+
+OCTK_END_NAMESPACE
@@ -24,55 +24,343 @@
 
 #include <openctk/media/video_source_interface.hpp>
 #include <openctk/media/video_sink_interface.hpp>
+#include <openctk/media/lazy_video_frame_buffer.hpp>
 #include <openctk/media/video_frame_buffer.hpp>
 #include "video_broadcaster.hpp"
 #include <openctk/media/video_rotation.hpp>
 #include <openctk/media/i420_buffer.hpp>
 #include <openctk/media/video_frame.hpp>
+#include <openctk/core/task_queue_thread.hpp>
+#include <openctk/core/date_time.hpp>
 #include <openctk/core/numeric.hpp>
 #include <openctk/core/logging.hpp>
 
+#include <condition_variable>
 #include <algorithm>
 #include <vector>
+#include <deque>
 
 OCTK_BEGIN_NAMESPACE
 
+/**
+ * Delivery state of one sink, shared between the sink snapshots and the broadcaster.
+ * Calls into the sink are counted so close() can wait for a delivery in progress on another thread.
+ */
+class VideoBroadcaster::SinkState final
+{
+public:
+    SinkState(VideoSinkInterface<VideoFrame> *sink, const SinkOptions &options)
+        : mSink(sink)
+        , mOptions(options)
+    {
+        if (mOptions.async)
+        {
+            mWorker = TaskQueueThread::create();
+        }
+    }
+    ~SinkState()
+    {
+        this->close();
+        // joins the worker, its pending drain tasks only reference this object
+        mWorker.reset();
+    }
+
+    const SinkOptions &options() const { return mOptions; }
+    bool hasOptions(const SinkOptions &options) const
+    {
+        return mOptions.async == options.async && (!mOptions.async || mOptions.queueSize == options.queueSize);
+    }
+
+    void deliver(const VideoFrame &frame, int64_t startNanos)
+    {
+        if (!mWorker)
+        {
+            if (this->enter())
+            {
+                this->invoke(frame, startNanos);
+                this->leave();
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mClosed.load())
+        {
+            return;
+        }
+        while (!mQueue.empty() && mQueue.size() >= std::max<size_t>(mOptions.queueSize, 1))
+        {
+            mQueue.pop_front();
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        mQueue.emplace_back(frame, startNanos);
+        if (!mDrainScheduled)
+        {
+            mDrainScheduled = true;
+            mWorker->postTask([this]() { this->drain(); });
+        }
+    }
+
+    void discarded()
+    {
+        if (!mWorker)
+        {
+            if (this->enter())
+            {
+                mSink->onDiscardedFrame();
+                this->leave();
+            }
+            return;
+        }
+        mWorker->postTask(
+            [this]()
+            {
+                if (this->enter())
+                {
+                    mSink->onDiscardedFrame();
+                    this->leave();
+                }
+            });
+    }
+
+    // Waits for the drain of the frames queued so far, the worker runs its tasks in order.
+    void flush()
+    {
+        if (mWorker)
+        {
+            mWorker->sendTask([]() {});
+        }
+    }
+
+    // Stops delivering and waits for a call into the sink in progress, queued frames are dropped.
+    void close()
+    {
+        mClosed.store(true);
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDropped.fetch_add(mQueue.size(), std::memory_order_relaxed);
+        mQueue.clear();
+        mIdleCondition.wait(lock, [this]() { return 0 == mCalls.load(); });
+    }
+
+    SinkStats stats() const
+    {
+        SinkStats stats;
+        stats.framesDelivered = mDelivered.load(std::memory_order_relaxed);
+        stats.framesDropped = mDropped.load(std::memory_order_relaxed);
+        stats.lastLatencyUSecs = mLastLatencyNanos.load(std::memory_order_relaxed) / DateTime::kNSecsPerUSec;
+        stats.maxLatencyUSecs = mMaxLatencyNanos.load(std::memory_order_relaxed) / DateTime::kNSecsPerUSec;
+        if (stats.framesDelivered > 0)
+        {
+            stats.averageLatencyUSecs = mTotalLatencyNanos.load(std::memory_order_relaxed) /
+                                        static_cast<int64_t>(stats.framesDelivered) / DateTime::kNSecsPerUSec;
+        }
+        return stats;
+    }
+
+private:
+    bool enter()
+    {
+        mCalls.fetch_add(1);
+        if (mClosed.load())
+        {
+            this->leave();
+            return false;
+        }
+        return true;
+    }
+    void leave()
+    {
+        if (1 == mCalls.fetch_sub(1) && mClosed.load())
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mIdleCondition.notify_all();
+        }
+    }
+
+    void invoke(const VideoFrame &frame, int64_t startNanos)
+    {
+        mSink->onFrame(frame);
+        const int64_t latencyNanos = DateTime::TimeNanos() - startNanos;
+        mDelivered.fetch_add(1, std::memory_order_relaxed);
+        mLastLatencyNanos.store(latencyNanos, std::memory_order_relaxed);
+        mTotalLatencyNanos.fetch_add(latencyNanos, std::memory_order_relaxed);
+        int64_t maxNanos = mMaxLatencyNanos.load(std::memory_order_relaxed);
+        while (latencyNanos > maxNanos &&
+               !mMaxLatencyNanos.compare_exchange_weak(maxNanos, latencyNanos, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void drain()
+    {
+        while (true)
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            if (mQueue.empty())
+            {
+                mDrainScheduled = false;
+                return;
+            }
+            auto item = std::move(mQueue.front());
+            mQueue.pop_front();
+            lock.unlock();
+
+            if (this->enter())
+            {
+                this->invoke(item.first, item.second);
+                this->leave();
+            }
+        }
+    }
+
+    VideoSinkInterface<VideoFrame> *const mSink;
+    const SinkOptions mOptions;
+    TaskQueueBase::SharedPtr mWorker;
+
+    std::atomic<bool> mClosed{false};
+    std::atomic<int> mCalls{0};
+    mutable std::mutex mMutex;
+    std::condition_variable mIdleCondition;
+    std::deque<std::pair<VideoFrame, int64_t>> mQueue OCTK_ATTRIBUTE_GUARDED_BY(mMutex);
+    bool mDrainScheduled OCTK_ATTRIBUTE_GUARDED_BY(mMutex) = false;
+
+    std::atomic<uint64_t> mDelivered{0};
+    std::atomic<uint64_t> mDropped{0};
+    std::atomic<int64_t> mLastLatencyNanos{0};
+    std::atomic<int64_t> mTotalLatencyNanos{0};
+    std::atomic<int64_t> mMaxLatencyNanos{0};
+};
+
+// Immutable view of the sinks read by onFrame(), replaced as a whole whenever a sink changes.
+struct VideoBroadcaster::Snapshot final
+{
+    struct Entry
+    {
+        VideoSinkWants wants;
+        std::shared_ptr<SinkState> state;
+    };
+    std::vector<Entry> entries;
+    uint64_t sinksGeneration{0};
+};
+
 VideoBroadcaster::VideoBroadcaster() = default;
-VideoBroadcaster::~VideoBroadcaster() = default;
+
+VideoBroadcaster::~VideoBroadcaster()
+{
+    std::atomic_store(&mSnapshot, std::shared_ptr<const Snapshot>());
+    for (auto &item : mSinkStates)
+    {
+        item.second->close();
+    }
+}
 
 void VideoBroadcaster::addOrUpdateSink(VideoSinkInterface<VideoFrame> *sink, const VideoSinkWants &wants)
+{
+    SinkOptions options;
+    {
+        // keep the delivery mode of a known sink
+        std::lock_guard<std::mutex> lock(mSinksAndWantsMutex);
+        const auto iter = mSinkStates.find(sink);
+        if (iter != mSinkStates.end())
+        {
+            options = iter->second->options();
+        }
+    }
+    this->addOrUpdateSink(sink, wants, options);
+}
+
+void VideoBroadcaster::addOrUpdateSink(VideoSinkInterface<VideoFrame> *sink,
+                                       const VideoSinkWants &wants,
+                                       const SinkOptions &options)
 {
     OCTK_DCHECK(sink != nullptr);
-    std::lock_guard<std::mutex> lock(mSinksAndWantsMutex);
-    if (!FindSinkPair(sink))
+    std::shared_ptr<SinkState> retired;
     {
-        // `Sink` is a new sink, which didn't receive previous frame.
-        mPreviousFrameSentToAllSinks = false;
+        std::lock_guard<std::mutex> lock(mSinksAndWantsMutex);
+        if (!FindSinkPair(sink))
+        {
+            // `Sink` is a new sink, which didn't receive previous frame.
+            ++mSinksGeneration;
 
-        if (mLastConstraints.has_value())
+            if (mLastConstraints.has_value())
+            {
+                OCTK_INFO() << __func__ << " forwarding stored constraints min_fps "
+                            << mLastConstraints->minFps.value_or(-1) << " maxFps "
+                            << mLastConstraints->maxFps.value_or(-1);
+                sink->onConstraintsChanged(*mLastConstraints);
+            }
+        }
+        VideoSourceBase::addOrUpdateSink(sink, wants);
+        auto &state = mSinkStates[sink];
+        if (!state || !state->hasOptions(options))
         {
-            OCTK_INFO() << __func__ << " forwarding stored constraints min_fps "
-                        << mLastConstraints->minFps.value_or(-1) << " maxFps "
-                        << mLastConstraints->maxFps.value_or(-1);
-            sink->onConstraintsChanged(*mLastConstraints);
+            retired = std::move(state);
+            state = std::make_shared<SinkState>(sink, options);
         }
+        UpdateWants();
+        PublishSinks();
+    }
+    // Waits for a delivery through the old state outside the lock, the sink may query the broadcaster meanwhile.
+    if (retired)
+    {
+        retired->close();
     }
-    VideoSourceBase::addOrUpdateSink(sink, wants);
-    UpdateWants();
 }
 
 void VideoBroadcaster::removeSink(VideoSinkInterface<VideoFrame> *sink)
 {
     OCTK_DCHECK(sink != nullptr);
+    std::shared_ptr<SinkState> retired;
+    {
+        std::lock_guard<std::mutex> lock(mSinksAndWantsMutex);
+        VideoSourceBase::removeSink(sink);
+        const auto iter = mSinkStates.find(sink);
+        if (iter != mSinkStates.end())
+        {
+            retired = std::move(iter->second);
+            mSinkStates.erase(iter);
+        }
+        UpdateWants();
+        PublishSinks();
+    }
+    if (retired)
+    {
+        retired->close();
+    }
+}
+
+Optional<VideoBroadcaster::SinkStats> VideoBroadcaster::sinkStats(const VideoSinkInterface<VideoFrame> *sink) const
+{
     std::lock_guard<std::mutex> lock(mSinksAndWantsMutex);
-    VideoSourceBase::removeSink(sink);
-    UpdateWants();
+    const auto iter = mSinkStates.find(sink);
+    if (iter == mSinkStates.end())
+    {
+        return utils::nullopt;
+    }
+    return iter->second->stats();
+}
+
+void VideoBroadcaster::flushSink(const VideoSinkInterface<VideoFrame> *sink) const
+{
+    std::shared_ptr<SinkState> state;
+    {
+        std::lock_guard<std::mutex> lock(mSinksAndWantsMutex);
+        const auto iter = mSinkStates.find(sink);
+        if (iter != mSinkStates.end())
+        {
+            state = iter->second;
+        }
+    }
+    if (state)
+    {
+        state->flush();
+    }
 }
 
 bool VideoBroadcaster::frameWanted() const
 {
-    std::lock_guard<std::mutex> lock(mSinksAndWantsMutex);
-    return !this->sinkPairs().empty();
+    const auto snapshot = std::atomic_load_explicit(&mSnapshot, std::memory_order_acquire);
+    return snapshot && !snapshot->entries.empty();
 }
 
 VideoSinkWants VideoBroadcaster::wants() const
@@ -83,22 +371,35 @@ VideoSinkWants VideoBroadcaster::wants() const
 
 void VideoBroadcaster::onFrame(const VideoFrame &frame)
 {
-    std::lock_guard<std::mutex> lock(mSinksAndWantsMutex);
+    const int64_t startNanos = DateTime::TimeNanos();
+    const auto snapshot = std::atomic_load_explicit(&mSnapshot, std::memory_order_acquire);
+    if (!snapshot)
+    {
+        return;
+    }
+    Optional<VideoFrame> sharedFrame;
+    if (snapshot->entries.size() > 1 && mShareConversions.load(std::memory_order_relaxed))
+    {
+        sharedFrame = frame;
+        sharedFrame->setVideoFrameBuffer(LazyVideoFrameBuffer::create(frame.videoFrameBuffer()));
+    }
+    const VideoFrame &delivered = sharedFrame.has_value() ? *sharedFrame : frame;
+    const bool previousFrameSentToAllSinks = mFullySentGeneration.load() == snapshot->sinksGeneration;
     bool currentFrameWasDiscarded = false;
-    for (auto &sinkPair : this->sinkPairs())
+    for (auto &entry : snapshot->entries)
     {
-        if (sinkPair.wants.rotationApplied && frame.rotation() != VideoRotation::kAngle0)
+        if (entry.wants.rotationApplied && delivered.rotation() != VideoRotation::kAngle0)
         {
             // Calls to OnFrame are not synchronized with changes to the sink wants.
             // When rotationApplied is set to true, one or a few frames may get here
             // with rotation still pending. Protect sinks that don't expect any
             // pending rotation.
             OCTK_INFO() << "Discarding frame with unexpected rotation.";
-            sinkPair.sink->onDiscardedFrame();
+            entry.state->discarded();
             currentFrameWasDiscarded = true;
             continue;
         }
-        if (sinkPair.wants.blackFrames)
+        if (entry.wants.blackFrames)
         {
             VideoFrame blackFrame = VideoFrame::Builder()
                                         .setVideoFrameBuffer(GetBlackFrameBuffer(frame.width(), frame.height()))
@@ -106,30 +407,41 @@ void VideoBroadcaster::onFrame(const VideoFrame &frame)
                                         .setTimestampUSecs(frame.timestampUSecs())
                                         .setId(frame.id())
                                         .build();
-            sinkPair.sink->onFrame(blackFrame);
+            entry.state->deliver(blackFrame, startNanos);
         }
-        else if (!mPreviousFrameSentToAllSinks && frame.hasUpdateRect())
+        else if (!previousFrameSentToAllSinks && frame.hasUpdateRect())
         {
             // Since last frame was not sent to some sinks, no reliable update
             // information is available, so we need to clear the update rect.
-            VideoFrame copy = VideoFrame::copy(frame);
+            VideoFrame copy = VideoFrame::copy(delivered);
             copy.clearUpdateRect();
-            sinkPair.sink->onFrame(copy);
+            entry.state->deliver(copy, startNanos);
         }
         else
         {
-            sinkPair.sink->onFrame(frame);
+            entry.state->deliver(delivered, startNanos);
         }
     }
-    mPreviousFrameSentToAllSinks = !currentFrameWasDiscarded;
+    mFullySentGeneration.store(currentFrameWasDiscarded ? 0 : snapshot->sinksGeneration);
+}
+
+void VideoBroadcaster::setShareConversions(bool enabled)
+{
+    mShareConversions.store(enabled, std::memory_order_relaxed);
 }
 
+bool VideoBroadcaster::shareConversions() const { return mShareConversions.load(std::memory_order_relaxed); }
+
 void VideoBroadcaster::onDiscardedFrame()
 {
-    std::lock_guard<std::mutex> lock(mSinksAndWantsMutex);
-    for (auto &sinkPair : sinkPairs())
+    const auto snapshot = std::atomic_load_explicit(&mSnapshot, std::memory_order_acquire);
+    if (!snapshot)
     {
-        sinkPair.sink->onDiscardedFrame();
+        return;
+    }
+    for (auto &entry : snapshot->entries)
+    {
+        entry.state->discarded();
     }
 }
 
@@ -145,6 +457,23 @@ void VideoBroadcaster::processConstraints(const VideoTrackSourceConstraints &con
     }
 }
 
+void VideoBroadcaster::PublishSinks()
+{
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->sinksGeneration = mSinksGeneration;
+    snapshot->entries.reserve(sinkPairs().size());
+    for (auto &sinkPair : sinkPairs())
+    {
+        Snapshot::Entry entry;
+        entry.wants = sinkPair.wants;
+        entry.state = mSinkStates[sinkPair.sink];
+        snapshot->entries.push_back(std::move(entry));
+    }
+    std::atomic_store_explicit(&mSnapshot,
+                               std::shared_ptr<const Snapshot>(std::move(snapshot)),
+                               std::memory_order_release);
+}
+
 void VideoBroadcaster::UpdateWants()
 {
     VideoSinkWants wants;
@@ -233,16 +562,17 @@ void VideoBroadcaster::UpdateWants()
     mCurrentWants = wants;
 }
 
-const std::shared_ptr<VideoFrameBuffer> &VideoBroadcaster::GetBlackFrameBuffer(int width, int height)
+std::shared_ptr<VideoFrameBuffer> VideoBroadcaster::GetBlackFrameBuffer(int width, int height)
 {
-    if (!mBlackFrameBuffer || mBlackFrameBuffer->width() != width || mBlackFrameBuffer->height() != height)
+    auto buffer = std::atomic_load(&mBlackFrameBuffer);
+    if (!buffer || buffer->width() != width || buffer->height() != height)
     {
-        std::shared_ptr<I420Buffer> buffer = I420Buffer::create(width, height);
-        I420Buffer::SetBlack(buffer.get());
-        mBlackFrameBuffer = buffer;
+        std::shared_ptr<I420Buffer> black = I420Buffer::create(width, height);
+        I420Buffer::SetBlack(black.get());
+        buffer = black;
+        std::atomic_store(&mBlackFrameBuffer, buffer);
     }
-
-    return mBlackFrameBuffer;
+    return buffer;
 }
 
 OCTK_END_NAMESPACE
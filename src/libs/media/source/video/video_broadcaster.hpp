@@ -31,7 +31,9 @@
 #include <openctk/media/video_source_base.hpp>
 #include <openctk/core/optional.hpp>
 
+#include <atomic>
 #include <mutex>
+#include <map>
 
 OCTK_BEGIN_NAMESPACE
 /**
@@ -40,10 +42,32 @@ OCTK_BEGIN_NAMESPACE
  *      The class is threadsafe; methods may be called on any thread.
  *      This is needed because VideoStreamEncoder calls AddOrUpdateSink both on the worker thread and on the
  *      encoder task queue.
+ *      Frames are fanned out over a copy-on-write snapshot of the sinks, so delivery takes no lock shared with
+ *      other sinks or with sink updates. Sinks must not add or remove sinks from within their onFrame().
  */
 class OCTK_MEDIA_API VideoBroadcaster : public VideoSourceBase, public VideoSinkInterface<VideoFrame>
 {
 public:
+    OCTK_STATIC_CONSTANT_NUMBER(kDefaultQueueSize, 2)
+
+    struct SinkOptions final
+    {
+        // Deliver on a worker thread of the sink instead of the thread calling onFrame(), so a slow sink like a
+        // preview renderer cannot stall the others. When queueSize frames are pending the oldest one is dropped.
+        bool async{false};
+        size_t queueSize{kDefaultQueueSize};
+    };
+
+    struct SinkStats final
+    {
+        uint64_t framesDelivered{0};
+        uint64_t framesDropped{0};
+        // Time from onFrame() of the broadcaster until the sink returned from its onFrame(), queueing included.
+        int64_t lastLatencyUSecs{0};
+        int64_t averageLatencyUSecs{0};
+        int64_t maxLatencyUSecs{0};
+    };
+
     VideoBroadcaster();
     ~VideoBroadcaster() override;
 
@@ -55,8 +79,39 @@ public:
      * @param wants
      */
     void addOrUpdateSink(VideoSinkInterface<VideoFrame> *sink, const VideoSinkWants &wants) override;
+    /**
+     * @brief Adds or updates a sink together with how frames are delivered to it.
+     * @details Switching the delivery mode of a sink drops the frames still queued for it.
+     */
+    void addOrUpdateSink(VideoSinkInterface<VideoFrame> *sink,
+                         const VideoSinkWants &wants,
+                         const SinkOptions &options);
+    /**
+     * @brief Removes a sink, waiting for a delivery to it still in progress on another thread.
+     * @details Once it returns the sink is never called again and may be destroyed.
+     */
     void removeSink(VideoSinkInterface<VideoFrame> *sink) override;
 
+    /**
+     * @return Returns the delivery statistics of the sink, nullopt if it was not added.
+     */
+    Optional<SinkStats> sinkStats(const VideoSinkInterface<VideoFrame> *sink) const;
+
+    /**
+     * @brief Waits until the frames queued for an async sink so far were delivered or dropped.
+     * @details Returns immediately for synchronous and unknown sinks. Must not be called from the sink's onFrame().
+     */
+    void flushSink(const VideoSinkInterface<VideoFrame> *sink) const;
+
+    /**
+     * @brief Shares pixel format conversions between the sinks of a frame, off by default.
+     * @details Frames delivered to more than one sink are wrapped into a LazyVideoFrameBuffer, so toI420() and
+     *      toRGBA() convert once per frame however many sinks call them. Sinks then see a kNative buffer and get the
+     *      original one through getMappedFrameBuffer().
+     */
+    void setShareConversions(bool enabled);
+    bool shareConversions() const;
+
     /**
      * @return Returns true if the next frame will be delivered to at least one sink.
      */
@@ -81,15 +136,25 @@ public:
     void processConstraints(const VideoTrackSourceConstraints &constraints);
 
 protected:
+    class SinkState;
+    struct Snapshot;
+
     void UpdateWants() OCTK_ATTRIBUTE_EXCLUSIVE_LOCKS_REQUIRED(mSinksAndWantsMutex);
-    const std::shared_ptr<VideoFrameBuffer> &GetBlackFrameBuffer(int width, int height)
-        OCTK_ATTRIBUTE_EXCLUSIVE_LOCKS_REQUIRED(mSinksAndWantsMutex);
+    void PublishSinks() OCTK_ATTRIBUTE_EXCLUSIVE_LOCKS_REQUIRED(mSinksAndWantsMutex);
+    std::shared_ptr<VideoFrameBuffer> GetBlackFrameBuffer(int width, int height);
 
     mutable std::mutex mSinksAndWantsMutex;
 
     VideoSinkWants mCurrentWants OCTK_ATTRIBUTE_GUARDED_BY(mSinksAndWantsMutex);
+    // Read and replaced with the std::atomic_load/atomic_store overloads, onFrame() never takes the mutex.
+    std::shared_ptr<const Snapshot> mSnapshot;
     std::shared_ptr<VideoFrameBuffer> mBlackFrameBuffer;
-    bool mPreviousFrameSentToAllSinks OCTK_ATTRIBUTE_GUARDED_BY(mSinksAndWantsMutex) = true;
+    std::map<const VideoSinkInterface<VideoFrame> *, std::shared_ptr<SinkState>> mSinkStates
+        OCTK_ATTRIBUTE_GUARDED_BY(mSinksAndWantsMutex);
+    // Bumped whenever a sink is added, a frame sent to every sink of that generation keeps its update rect.
+    uint64_t mSinksGeneration OCTK_ATTRIBUTE_GUARDED_BY(mSinksAndWantsMutex) = 0;
+    std::atomic<uint64_t> mFullySentGeneration{0};
+    std::atomic<bool> mShareConversions{false};
     Optional<VideoTrackSourceConstraints> mLastConstraints OCTK_ATTRIBUTE_GUARDED_BY(mSinksAndWantsMutex);
 };
 
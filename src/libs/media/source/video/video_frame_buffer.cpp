@@ -735,6 +735,80 @@ std::shared_ptr<I410BufferInterface> wrapI410Buffer(int width,
         new WrappedYuv16BBuffer<
             I410BufferBase>(width, height, yPlane, yStride, uPlane, uStride, vPlane, vStride, noLongerUsed));
 }
+
+class WrappedNV12Buffer : public NV12BufferInterface
+{
+public:
+    WrappedNV12Buffer(int width,
+                      int height,
+                      const uint8_t *yPlane,
+                      int yStride,
+                      const uint8_t *uvPlane,
+                      int uvStride,
+                      std::function<void()> noLongerUsed)
+        : mWidth(width)
+          , mHeight(height)
+          , mYPlane(yPlane)
+          , mUVPlane(uvPlane)
+          , mYStride(yStride)
+          , mUVStride(uvStride)
+          , mNoLongerUsedCallback(noLongerUsed)
+    {
+    }
+
+    ~WrappedNV12Buffer() override { mNoLongerUsedCallback(); }
+
+    int width() const override { return mWidth; }
+
+    int height() const override { return mHeight; }
+
+    const uint8_t *dataY() const override { return mYPlane; }
+
+    const uint8_t *dataUV() const override { return mUVPlane; }
+
+    int strideY() const override { return mYStride; }
+
+    int strideUV() const override { return mUVStride; }
+
+    std::shared_ptr<I420BufferInterface> toI420() final
+    {
+        std::shared_ptr<I420Buffer> i420Buffer = I420Buffer::create(this->width(), this->height());
+        libyuv::NV12ToI420(this->dataY(),
+                           this->strideY(),
+                           this->dataUV(),
+                           this->strideUV(),
+                           i420Buffer->MutableDataY(),
+                           i420Buffer->strideY(),
+                           i420Buffer->MutableDataU(),
+                           i420Buffer->strideU(),
+                           i420Buffer->MutableDataV(),
+                           i420Buffer->strideV(),
+                           this->width(),
+                           this->height());
+        return i420Buffer;
+    }
+
+private:
+    const int mWidth;
+    const int mHeight;
+    const uint8_t *const mYPlane;
+    const uint8_t *const mUVPlane;
+    const int mYStride;
+    const int mUVStride;
+    std::function<void()> mNoLongerUsedCallback;
+};
+
+std::shared_ptr<NV12BufferInterface> wrapNV12Buffer(int width,
+                                                    int height,
+                                                    const uint8_t *yPlane,
+                                                    int yStride,
+                                                    const uint8_t *uvPlane,
+                                                    int uvStride,
+                                                    std::function<void()> noLongerUsed)
+{
+    return std::shared_ptr<NV12BufferInterface>(
+        new WrappedNV12Buffer(width, height, yPlane, yStride, uvPlane, uvStride, noLongerUsed));
+}
 } // namespace utils
 
 OCTK_END_NAMESPACE
\ No newline at end of file
@@ -449,6 +449,14 @@ std::shared_ptr<I410BufferInterface> wrapI410Buffer(int width,
                                                     const uint16_t *vPlane,
                                                     int vStride,
                                                     std::function<void()> noLongerUsed);
+
+std::shared_ptr<NV12BufferInterface> wrapNV12Buffer(int width,
+                                                    int height,
+                                                    const uint8_t *yPlane,
+                                                    int yStride,
+                                                    const uint8_t *uvPlane,
+                                                    int uvStride,
+                                                    std::function<void()> noLongerUsed);
 } // namespace utils
 
 OCTK_END_NAMESPACE
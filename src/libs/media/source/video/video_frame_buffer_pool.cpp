@@ -26,54 +26,337 @@
 #include "video_frame_buffer_pool.hpp"
 #include <openctk/core/checks.hpp>
 
-#include <limits>
+#if defined(OCTK_OS_LINUX)
+#    include <sys/syscall.h>
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+#include <unordered_map>
+#include <iterator>
+#include <vector>
+#include <deque>
+#include <mutex>
 
 OCTK_BEGIN_NAMESPACE
 
 namespace
 {
-bool HasOneRef(const std::shared_ptr<VideoFrameBuffer> &buffer)
+struct ShapeKey
 {
-    // Cast to RefCountedObject is safe because this function is only called
-    // on locally created VideoFrameBuffers, which are either
-    // `RefCountedObject<I420Buffer>`, `RefCountedObject<I444Buffer>` or
-    // `RefCountedObject<NV12Buffer>`.
-    switch (buffer->type())
+    VideoFrameBuffer::Type type;
+    int width;
+    int height;
+    int stride;
+
+    bool operator==(const ShapeKey &other) const
+    {
+        return type == other.type && width == other.width && height == other.height && stride == other.stride;
+    }
+};
+
+struct ShapeKeyHash
+{
+    size_t operator()(const ShapeKey &key) const
+    {
+        size_t hash = static_cast<size_t>(key.type);
+        hash = hash * 1000003u + static_cast<size_t>(key.width);
+        hash = hash * 1000003u + static_cast<size_t>(key.height);
+        return hash * 1000003u + static_cast<size_t>(key.stride);
+    }
+};
+
+// A buffer waiting in a free list. ~VideoFrameBuffer() is protected, destroy deletes it through its concrete type.
+struct FreeBuffer
+{
+    VideoFrameBuffer *buffer;
+    void (*destroy)(VideoFrameBuffer *);
+    // Order in which buffers were returned, trimming releases the smallest first.
+    uint64_t sequence;
+};
+
+template <typename T> void destroyBuffer(VideoFrameBuffer *buffer) { delete static_cast<T *>(buffer); }
+
+// Zero fills new buffers of the formats that support it.
+void initializeData(VideoFrameBuffer *) { }
+void initializeData(I420Buffer *buffer) { buffer->InitializeData(); }
+void initializeData(I422Buffer *buffer) { buffer->InitializeData(); }
+void initializeData(I444Buffer *buffer) { buffer->InitializeData(); }
+void initializeData(I410Buffer *buffer) { buffer->InitializeData(); }
+void initializeData(NV12Buffer *buffer) { buffer->InitializeData(); }
+
+size_t pixelBytes(int width, int height, int chromaWidth, int chromaHeight, size_t bytesPerSample)
+{
+    return (static_cast<size_t>(width) * height + 2 * static_cast<size_t>(chromaWidth) * chromaHeight) *
+           bytesPerSample;
+}
+
+// Applies the memory placement hints of the options to the whole pages of a freshly allocated, untouched buffer.
+void adviseMemory(void *data, size_t size, const VideoFrameBufferPool::Options &options)
+{
+#if defined(OCTK_OS_LINUX)
+    const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + pageSize - 1) & ~(pageSize - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(data) + size) & ~(pageSize - 1);
+    if (end <= begin)
+    {
+        return;
+    }
+#    if defined(MADV_HUGEPAGE)
+    // Transparent huge pages are 2MiB, smaller ranges can't be backed by one.
+    if (options.hugePages && end - begin >= 2 * 1024 * 1024)
+    {
+        madvise(reinterpret_cast<void *>(begin), end - begin, MADV_HUGEPAGE);
+    }
+#    endif
+#    if defined(SYS_mbind)
+    unsigned long nodeMask[16] = {0};
+    const int maskBits = static_cast<int>(sizeof(nodeMask) * 8);
+    if (options.numaNode >= 0 && options.numaNode < maskBits)
+    {
+        const int kMpolPreferred = 1;
+        const int longBits = static_cast<int>(sizeof(unsigned long) * 8);
+        nodeMask[options.numaNode / longBits] |= 1UL << (options.numaNode % longBits);
+        syscall(SYS_mbind, begin, end - begin, kMpolPreferred, nodeMask, maskBits, 0);
+    }
+#    endif
+#else
+    (void)data;
+    (void)size;
+    (void)options;
+#endif
+}
+} // namespace
+
+// State shared by the pool and the deleters of the buffers it handed out, outlives the pool until every buffer is
+// back.
+class VideoFrameBufferPool::Shared : public std::enable_shared_from_this<VideoFrameBufferPool::Shared>
+{
+public:
+    explicit Shared(const Options &options)
+        : mOptions(options)
+        , mMaxBuffersPerShape(options.maxBuffersPerShape)
+    {
+    }
+
+    template <typename T, typename Allocate>
+    std::shared_ptr<T> acquire(VideoFrameBuffer::Type type,
+                               int width,
+                               int height,
+                               int stride,
+                               size_t bytes,
+                               Allocate allocate)
+    {
+        const ShapeKey key{type, width, height, stride};
+        T *buffer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto &shape = mShapes[key];
+            if (!shape.free.empty())
+            {
+                buffer = static_cast<T *>(shape.free.back().buffer);
+                shape.free.pop_back();
+                mFreeBytes -= bytes;
+                ++mHits;
+            }
+            else if (shape.count >= mMaxBuffersPerShape)
+            {
+                ++mExhausted;
+                if (0 == shape.count)
+                {
+                    mShapes.erase(key);
+                }
+                return nullptr;
+            }
+            else
+            {
+                ++shape.count;
+                mResidentBytes += bytes;
+                ++mMisses;
+            }
+            ++mInUse;
+        }
+        if (!buffer)
+        {
+            buffer = allocate();
+            adviseMemory(buffer->MutableDataY(), bytes, mOptions);
+            if (mOptions.zeroInitialize)
+            {
+                initializeData(buffer);
+            }
+        }
+        auto self = this->shared_from_this();
+        return std::shared_ptr<T>(buffer,
+                                  [self, key, bytes](T *released)
+                                  { self->release(key, bytes, FreeBuffer{released, &destroyBuffer<T>, 0}); });
+    }
+
+    bool resize(size_t maxBuffersPerShape)
     {
-        case VideoFrameBuffer::Type::kI420:
+        std::vector<FreeBuffer> trimmed;
         {
-            return std::dynamic_pointer_cast<I420Buffer>(buffer).use_count() == 2;
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (const auto &item : mShapes)
+            {
+                if (item.second.count - item.second.free.size() > maxBuffersPerShape)
+                {
+                    return false;
+                }
+            }
+            mMaxBuffersPerShape = maxBuffersPerShape;
+            for (auto iter = mShapes.begin(); iter != mShapes.end();)
+            {
+                auto &shape = iter->second;
+                while (shape.count > maxBuffersPerShape)
+                {
+                    this->dropOldest(shape, trimmed);
+                }
+                iter = this->eraseIfEmpty(iter);
+            }
         }
-        case VideoFrameBuffer::Type::kI444:
+        this->destroy(trimmed);
+        return true;
+    }
+
+    void trim(size_t maxFreeBytes)
+    {
+        std::vector<FreeBuffer> trimmed;
         {
-            return std::dynamic_pointer_cast<I444Buffer>(buffer).use_count() == 2;
+            std::lock_guard<std::mutex> lock(mMutex);
+            this->trimLocked(maxFreeBytes, trimmed);
         }
-        case VideoFrameBuffer::Type::kI422:
+        this->destroy(trimmed);
+    }
+
+    void close()
+    {
+        std::vector<FreeBuffer> trimmed;
         {
-            return std::dynamic_pointer_cast<I422Buffer>(buffer).use_count() == 2;
+            std::lock_guard<std::mutex> lock(mMutex);
+            mClosed = true;
+            this->trimLocked(0, trimmed);
         }
-        case VideoFrameBuffer::Type::kI010:
+        this->destroy(trimmed);
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Stats stats;
+        stats.hits = mHits;
+        stats.misses = mMisses;
+        stats.exhausted = mExhausted;
+        stats.trimmed = mTrimmed;
+        stats.buffersInUse = mInUse;
+        for (const auto &item : mShapes)
         {
-            return std::dynamic_pointer_cast<I010Buffer>(buffer).use_count() == 2;
+            stats.buffersFree += item.second.free.size();
         }
-        case VideoFrameBuffer::Type::kI210:
+        stats.bytesResident = mResidentBytes;
+        stats.bytesFree = mFreeBytes;
+        return stats;
+    }
+
+private:
+    struct Shape
+    {
+        // Most recently returned buffers at the back, they are the ones still warm in cache.
+        std::deque<FreeBuffer> free;
+        // Buffers of this shape in use or free.
+        size_t count{0};
+        size_t bytes{0};
+    };
+    using Shapes = std::unordered_map<ShapeKey, Shape, ShapeKeyHash>;
+
+    void release(const ShapeKey &key, size_t bytes, FreeBuffer buffer)
+    {
+        std::vector<FreeBuffer> trimmed;
         {
-            return std::dynamic_pointer_cast<I210Buffer>(buffer).use_count() == 2;
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mInUse;
+            auto iter = mShapes.find(key);
+            OCTK_DCHECK(iter != mShapes.end());
+            auto &shape = iter->second;
+            shape.bytes = bytes;
+            if (mClosed || shape.count > mMaxBuffersPerShape)
+            {
+                --shape.count;
+                mResidentBytes -= bytes;
+                trimmed.push_back(buffer);
+                this->eraseIfEmpty(iter);
+            }
+            else
+            {
+                buffer.sequence = ++mSequence;
+                shape.free.push_back(buffer);
+                mFreeBytes += bytes;
+                this->trimLocked(mOptions.highWaterBytes, trimmed);
+            }
         }
-        case VideoFrameBuffer::Type::kI410:
+        this->destroy(trimmed);
+    }
+
+    void trimLocked(size_t maxFreeBytes, std::vector<FreeBuffer> &trimmed)
+    {
+        while (mFreeBytes > maxFreeBytes)
         {
-            return std::dynamic_pointer_cast<I410Buffer>(buffer).use_count() == 2;
+            auto oldest = mShapes.end();
+            for (auto iter = mShapes.begin(); iter != mShapes.end(); ++iter)
+            {
+                if (!iter->second.free.empty() &&
+                    (oldest == mShapes.end() ||
+                     iter->second.free.front().sequence < oldest->second.free.front().sequence))
+                {
+                    oldest = iter;
+                }
+            }
+            if (oldest == mShapes.end())
+            {
+                break;
+            }
+            this->dropOldest(oldest->second, trimmed);
+            this->eraseIfEmpty(oldest);
         }
-        case VideoFrameBuffer::Type::kNV12:
+    }
+
+    void dropOldest(Shape &shape, std::vector<FreeBuffer> &trimmed)
+    {
+        OCTK_DCHECK(!shape.free.empty());
+        trimmed.push_back(shape.free.front());
+        shape.free.pop_front();
+        --shape.count;
+        mFreeBytes -= shape.bytes;
+        mResidentBytes -= shape.bytes;
+        ++mTrimmed;
+    }
+
+    Shapes::iterator eraseIfEmpty(Shapes::iterator iter)
+    {
+        return 0 == iter->second.count ? mShapes.erase(iter) : std::next(iter);
+    }
+
+    void destroy(std::vector<FreeBuffer> &buffers)
+    {
+        for (const auto &buffer : buffers)
         {
-            return std::dynamic_pointer_cast<NV12Buffer>(buffer).use_count() == 2;
+            buffer.destroy(buffer.buffer);
         }
-        default: OCTK_DCHECK_NOTREACHED();
     }
-    return false;
-}
 
-} // namespace
+    const Options mOptions;
+    mutable std::mutex mMutex;
+    Shapes mShapes;
+    size_t mMaxBuffersPerShape;
+    bool mClosed{false};
+    uint64_t mSequence{0};
+    uint64_t mHits{0};
+    uint64_t mMisses{0};
+    uint64_t mExhausted{0};
+    uint64_t mTrimmed{0};
+    size_t mInUse{0};
+    size_t mResidentBytes{0};
+    size_t mFreeBytes{0};
+};
 
 VideoFrameBufferPool::VideoFrameBufferPool()
     : VideoFrameBufferPool(false)
@@ -86,274 +369,104 @@ VideoFrameBufferPool::VideoFrameBufferPool(bool zero_initialize)
 }
 
 VideoFrameBufferPool::VideoFrameBufferPool(bool zero_initialize, size_t max_number_of_buffers)
-    : zero_initialize_(zero_initialize)
-    , max_number_of_buffers_(max_number_of_buffers)
+    : VideoFrameBufferPool(
+          [&]()
+          {
+              Options options;
+              options.zeroInitialize = zero_initialize;
+              options.maxBuffersPerShape = max_number_of_buffers;
+              return options;
+          }())
 {
 }
 
-VideoFrameBufferPool::~VideoFrameBufferPool() = default;
-
-void VideoFrameBufferPool::Release()
+VideoFrameBufferPool::VideoFrameBufferPool(const Options &options)
+    : shared_(std::make_shared<Shared>(options))
 {
-    buffers_.clear();
 }
 
-bool VideoFrameBufferPool::Resize(size_t max_number_of_buffers)
-{
-    OCTK_DCHECK_RUNS_SERIALIZED(&race_checker_);
-    size_t used_buffers_count = 0;
-    for (const std::shared_ptr<VideoFrameBuffer> &buffer : buffers_)
-    {
-        // If the buffer is in use, the ref count will be >= 2, one from the list we
-        // are looping over and one from the application. If the ref count is 1,
-        // then the list we are looping over holds the only reference and it's safe
-        // to reuse.
-        if (!HasOneRef(buffer))
-        {
-            used_buffers_count++;
-        }
-    }
-    if (used_buffers_count > max_number_of_buffers)
-    {
-        return false;
-    }
-    max_number_of_buffers_ = max_number_of_buffers;
+VideoFrameBufferPool::~VideoFrameBufferPool() { shared_->close(); }
 
-    size_t buffers_to_purge = buffers_.size() - max_number_of_buffers_;
-    auto iter = buffers_.begin();
-    while (iter != buffers_.end() && buffers_to_purge > 0)
-    {
-        if (HasOneRef(*iter))
-        {
-            iter = buffers_.erase(iter);
-            buffers_to_purge--;
-        }
-        else
-        {
-            ++iter;
-        }
-    }
-    return true;
-}
+void VideoFrameBufferPool::Release() { shared_->trim(0); }
 
-std::shared_ptr<I420Buffer> VideoFrameBufferPool::CreateI420Buffer(int width, int height)
-{
-    OCTK_DCHECK_RUNS_SERIALIZED(&race_checker_);
+bool VideoFrameBufferPool::Resize(size_t max_number_of_buffers) { return shared_->resize(max_number_of_buffers); }
 
-    std::shared_ptr<VideoFrameBuffer> existing_buffer = GetExistingBuffer(width, height, VideoFrameBuffer::Type::kI420);
-    if (existing_buffer)
-    {
-        // Cast is safe because the only way kI420 buffer is created is
-        // in the same function below, where `RefCountedObject<I420Buffer>` is
-        // created.
-        auto raw_buffer = std::dynamic_pointer_cast<I420Buffer>(existing_buffer);
-        // Creates a new scoped_refptr, which is also pointing to the same
-        // RefCountedObject as buffer, increasing ref count.
-        return raw_buffer;
-    }
+size_t VideoFrameBufferPool::AllocationCount() const { return shared_->stats().misses; }
 
-    if (buffers_.size() >= max_number_of_buffers_)
-        return nullptr;
-    // Allocate new buffer.
-    std::shared_ptr<I420Buffer> buffer = std::make_shared<I420Buffer>(width, height);
+void VideoFrameBufferPool::Trim(size_t max_free_bytes) { shared_->trim(max_free_bytes); }
 
-    if (zero_initialize_)
-        buffer->InitializeData();
+VideoFrameBufferPool::Stats VideoFrameBufferPool::GetStats() const { return shared_->stats(); }
 
-    buffers_.push_back(buffer);
-    return buffer;
+std::shared_ptr<I420Buffer> VideoFrameBufferPool::CreateI420Buffer(int width, int height)
+{
+    return shared_->acquire<I420Buffer>(VideoFrameBuffer::Type::kI420,
+                                        width,
+                                        height,
+                                        width,
+                                        pixelBytes(width, height, (width + 1) / 2, (height + 1) / 2, 1),
+                                        [=]() { return new I420Buffer(width, height); });
 }
 
 std::shared_ptr<I444Buffer> VideoFrameBufferPool::CreateI444Buffer(int width, int height)
 {
-    OCTK_DCHECK_RUNS_SERIALIZED(&race_checker_);
-
-    std::shared_ptr<VideoFrameBuffer> existing_buffer = GetExistingBuffer(width, height, VideoFrameBuffer::Type::kI444);
-    if (existing_buffer)
-    {
-        // Cast is safe because the only way kI444 buffer is created is
-        // in the same function below, where |RefCountedObject<I444Buffer>|
-        // is created.
-        auto raw_buffer = std::dynamic_pointer_cast<I444Buffer>(existing_buffer);
-        // Creates a new scoped_refptr, which is also pointing to the same
-        // RefCountedObject as buffer, increasing ref count.
-        return raw_buffer;
-    }
-
-    if (buffers_.size() >= max_number_of_buffers_)
-        return nullptr;
-    // Allocate new buffer.
-    std::shared_ptr<I444Buffer> buffer = std::make_shared<I444Buffer>(width, height);
-
-    if (zero_initialize_)
-        buffer->InitializeData();
-
-    buffers_.push_back(buffer);
-    return buffer;
+    return shared_->acquire<I444Buffer>(VideoFrameBuffer::Type::kI444,
+                                        width,
+                                        height,
+                                        width,
+                                        pixelBytes(width, height, width, height, 1),
+                                        [=]() { return new I444Buffer(width, height); });
 }
 
 std::shared_ptr<I422Buffer> VideoFrameBufferPool::CreateI422Buffer(int width, int height)
 {
-    OCTK_DCHECK_RUNS_SERIALIZED(&race_checker_);
-
-    std::shared_ptr<VideoFrameBuffer> existing_buffer = GetExistingBuffer(width, height, VideoFrameBuffer::Type::kI422);
-    if (existing_buffer)
-    {
-        // Cast is safe because the only way kI422 buffer is created is
-        // in the same function below, where |RefCountedObject<I422Buffer>|
-        // is created.
-        auto raw_buffer = std::dynamic_pointer_cast<I422Buffer>(existing_buffer);
-        // Creates a new scoped_refptr, which is also pointing to the same
-        // RefCountedObject as buffer, increasing ref count.
-        return raw_buffer;
-    }
-
-    if (buffers_.size() >= max_number_of_buffers_)
-        return nullptr;
-    // Allocate new buffer.
-    std::shared_ptr<I422Buffer> buffer = std::make_shared<I422Buffer>(width, height);
-
-    if (zero_initialize_)
-        buffer->InitializeData();
-
-    buffers_.push_back(buffer);
-    return buffer;
+    return shared_->acquire<I422Buffer>(VideoFrameBuffer::Type::kI422,
+                                        width,
+                                        height,
+                                        width,
+                                        pixelBytes(width, height, (width + 1) / 2, height, 1),
+                                        [=]() { return new I422Buffer(width, height); });
 }
 
 std::shared_ptr<NV12Buffer> VideoFrameBufferPool::CreateNV12Buffer(int width, int height)
 {
-    OCTK_DCHECK_RUNS_SERIALIZED(&race_checker_);
-
-    std::shared_ptr<VideoFrameBuffer> existing_buffer = GetExistingBuffer(width, height, VideoFrameBuffer::Type::kNV12);
-    if (existing_buffer)
-    {
-        // Cast is safe because the only way kI420 buffer is created is
-        // in the same function below, where `RefCountedObject<I420Buffer>` is
-        // created.
-        auto raw_buffer = std::dynamic_pointer_cast<NV12Buffer>(existing_buffer);
-        // Creates a new scoped_refptr, which is also pointing to the same
-        // RefCountedObject as buffer, increasing ref count.
-        return raw_buffer;
-    }
-
-    if (buffers_.size() >= max_number_of_buffers_)
-        return nullptr;
-    // Allocate new buffer.
-    std::shared_ptr<NV12Buffer> buffer = std::make_shared<NV12Buffer>(width, height);
-
-    if (zero_initialize_)
-        buffer->InitializeData();
-
-    buffers_.push_back(buffer);
-    return buffer;
+    return shared_->acquire<NV12Buffer>(VideoFrameBuffer::Type::kNV12,
+                                        width,
+                                        height,
+                                        width,
+                                        pixelBytes(width, height, (width + 1) / 2, (height + 1) / 2, 1),
+                                        [=]() { return new NV12Buffer(width, height); });
 }
 
 std::shared_ptr<I010Buffer> VideoFrameBufferPool::CreateI010Buffer(int width, int height)
 {
-    OCTK_DCHECK_RUNS_SERIALIZED(&race_checker_);
-
-    std::shared_ptr<VideoFrameBuffer> existing_buffer = GetExistingBuffer(width, height, VideoFrameBuffer::Type::kI010);
-    if (existing_buffer)
-    {
-        // Cast is safe because the only way kI010 buffer is created is
-        // in the same function below, where |RefCountedObject<I010Buffer>|
-        // is created.
-        auto raw_buffer = std::dynamic_pointer_cast<I010Buffer>(existing_buffer);
-        // Creates a new scoped_refptr, which is also pointing to the same
-        // RefCountedObject as buffer, increasing ref count.
-        return raw_buffer;
-    }
-
-    if (buffers_.size() >= max_number_of_buffers_)
-        return nullptr;
-    // Allocate new buffer.
-    std::shared_ptr<I010Buffer> buffer = I010Buffer::Create(width, height);
-
-    buffers_.push_back(buffer);
-    return buffer;
+    return shared_->acquire<I010Buffer>(
+        VideoFrameBuffer::Type::kI010,
+        width,
+        height,
+        width,
+        pixelBytes(width, height, (width + 1) / 2, (height + 1) / 2, 2),
+        [=]() { return new I010Buffer(width, height, width, (width + 1) / 2, (width + 1) / 2); });
 }
 
 std::shared_ptr<I210Buffer> VideoFrameBufferPool::CreateI210Buffer(int width, int height)
 {
-    OCTK_DCHECK_RUNS_SERIALIZED(&race_checker_);
-
-    std::shared_ptr<VideoFrameBuffer> existing_buffer = GetExistingBuffer(width, height, VideoFrameBuffer::Type::kI210);
-    if (existing_buffer)
-    {
-        // Cast is safe because the only way kI210 buffer is created is
-        // in the same function below, where |RefCountedObject<I210Buffer>|
-        // is created.
-        auto raw_buffer = std::dynamic_pointer_cast<I210Buffer>(existing_buffer);
-        // Creates a new scoped_refptr, which is also pointing to the same
-        // RefCountedObject as buffer, increasing ref count.
-        return raw_buffer;
-    }
-
-    if (buffers_.size() >= max_number_of_buffers_)
-        return nullptr;
-    // Allocate new buffer.
-    std::shared_ptr<I210Buffer> buffer = I210Buffer::Create(width, height);
-
-    buffers_.push_back(buffer);
-    return buffer;
+    return shared_->acquire<I210Buffer>(
+        VideoFrameBuffer::Type::kI210,
+        width,
+        height,
+        width,
+        pixelBytes(width, height, (width + 1) / 2, height, 2),
+        [=]() { return new I210Buffer(width, height, width, (width + 1) / 2, (width + 1) / 2); });
 }
 
 std::shared_ptr<I410Buffer> VideoFrameBufferPool::CreateI410Buffer(int width, int height)
 {
-    OCTK_DCHECK_RUNS_SERIALIZED(&race_checker_);
-
-    std::shared_ptr<VideoFrameBuffer> existing_buffer = GetExistingBuffer(width, height, VideoFrameBuffer::Type::kI410);
-    if (existing_buffer)
-    {
-        // Cast is safe because the only way kI410 buffer is created is
-        // in the same function below, where |RefCountedObject<I410Buffer>|
-        // is created.
-        auto raw_buffer = std::dynamic_pointer_cast<I410Buffer>(existing_buffer);
-        // Creates a new scoped_refptr, which is also pointing to the same
-        // RefCountedObject as buffer, increasing ref count.
-        return raw_buffer;
-    }
-
-    if (buffers_.size() >= max_number_of_buffers_)
-        return nullptr;
-    // Allocate new buffer.
-    std::shared_ptr<I410Buffer> buffer = I410Buffer::Create(width, height);
-
-    buffers_.push_back(buffer);
-    return buffer;
-}
-
-std::shared_ptr<VideoFrameBuffer> VideoFrameBufferPool::GetExistingBuffer(int width,
-                                                                          int height,
-                                                                          VideoFrameBuffer::Type type)
-{
-    // Release buffers with wrong resolution or different type.
-    for (auto it = buffers_.begin(); it != buffers_.end();)
-    {
-        const auto &buffer = *it;
-        if (buffer->width() != width || buffer->height() != height || buffer->type() != type)
-        {
-            it = buffers_.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
-    // Look for a free buffer.
-    for (const std::shared_ptr<VideoFrameBuffer> &buffer : buffers_)
-    {
-        // If the buffer is in use, the ref count will be >= 2, one from the list we
-        // are looping over and one from the application. If the ref count is 1,
-        // then the list we are looping over holds the only reference and it's safe
-        // to reuse.
-        if (HasOneRef(buffer))
-        {
-            OCTK_CHECK(buffer->type() == type);
-            return buffer;
-        }
-    }
-    return nullptr;
+    return shared_->acquire<I410Buffer>(VideoFrameBuffer::Type::kI410,
+                                        width,
+                                        height,
+                                        width,
+                                        pixelBytes(width, height, width, height, 2),
+                                        [=]() { return new I410Buffer(width, height); });
 }
 
-OCTK_END_NAMESPACE
\ No newline at end of file
+OCTK_END_NAMESPACE
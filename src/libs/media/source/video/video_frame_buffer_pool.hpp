@@ -25,7 +25,6 @@
 
 #pragma once
 
-#include <openctk/core/race_checker.hpp>
 #include <openctk/media/i010_buffer.hpp>
 #include <openctk/media/i210_buffer.hpp>
 #include <openctk/media/i410_buffer.hpp>
@@ -36,29 +35,66 @@
 
 #include <stddef.h>
 
-#include <list>
+#include <limits>
+#include <memory>
 
 OCTK_BEGIN_NAMESPACE
 
-// Simple buffer pool to avoid unnecessary allocations of video frame buffers.
-// The pool manages the memory of the I420Buffer/NV12Buffer returned from
-// Create(I420|NV12)Buffer. When the buffer is destructed, the memory is
-// returned to the pool for use by subsequent calls to Create(I420|NV12)Buffer.
-// If the resolution passed to Create(I420|NV12)Buffer changes or requested
-// pixel format changes, old buffers will be purged from the pool.
-// Note that Create(I420|NV12)Buffer will crash if more than
-// kMaxNumberOfFramesBeforeCrash are created. This is to prevent memory leaks
-// where frames are not returned.
-class VideoFrameBufferPool
+// Thread safe pool that recycles the memory of video frame buffers.
+// Free buffers are kept in one list per shape (pixel format, width, height and
+// stride), so a Create(I420|NV12|...)Buffer call takes a free buffer in O(1) and
+// several shapes can be pooled side by side. A buffer goes back to its list from
+// the deleter of the returned shared_ptr when its last reference is dropped, on
+// whatever thread that happens. Free buffers beyond Options::highWaterBytes are
+// released, least recently returned first. Buffers handed out stay valid after
+// the pool is destroyed, they are freed instead of returned then.
+class OCTK_MEDIA_API VideoFrameBufferPool
 {
 public:
+    struct Options final
+    {
+        // If true, newly allocated buffers are zero-initialized. Note that recycled
+        // buffers are not zero'd before reuse. This is required of buffers used by
+        // FFmpeg according to http://crbug.com/390941, which only requires it for the
+        // initial allocation (as shown by FFmpeg's own buffer allocation code). It
+        // has to do with "Use-of-uninitialized-value" on "Linux_msan_chrome".
+        bool zeroInitialize{false};
+        // Max number of buffers of one shape, in use or free. Create(I420|NV12)Buffer
+        // returns null when all of them are in use.
+        size_t maxBuffersPerShape{std::numeric_limits<size_t>::max()};
+        // Bytes free buffers may hold before they are trimmed.
+        size_t highWaterBytes{256 * 1024 * 1024};
+        // Ask for transparent huge pages on the pixel memory of large buffers (Linux only).
+        bool hugePages{false};
+        // Preferred NUMA node of the pixel memory of new buffers, -1 leaves it to the kernel (Linux only).
+        int numaNode{-1};
+    };
+
+    struct Stats final
+    {
+        // Create calls served from a free list.
+        uint64_t hits{0};
+        // Create calls that allocated a new buffer.
+        uint64_t misses{0};
+        // Create calls that failed because maxBuffersPerShape buffers were in use.
+        uint64_t exhausted{0};
+        // Free buffers released by trimming, Resize() or Release().
+        uint64_t trimmed{0};
+        size_t buffersInUse{0};
+        size_t buffersFree{0};
+        // Pixel bytes of all buffers allocated by the pool and not yet freed, in use or not.
+        size_t bytesResident{0};
+        size_t bytesFree{0};
+    };
+
     VideoFrameBufferPool();
     explicit VideoFrameBufferPool(bool zero_initialize);
     VideoFrameBufferPool(bool zero_initialize, size_t max_number_of_buffers);
+    explicit VideoFrameBufferPool(const Options &options);
     ~VideoFrameBufferPool();
 
     // Returns a buffer from the pool. If no suitable buffer exist in the pool
-    // and there are less than `max_number_of_buffers` pending, a buffer is
+    // and there are less than `max_number_of_buffers` of that shape, a buffer is
     // created. Returns null otherwise.
     std::shared_ptr<I420Buffer> CreateI420Buffer(int width, int height);
     std::shared_ptr<I422Buffer> CreateI422Buffer(int width, int height);
@@ -68,28 +104,27 @@ public:
     std::shared_ptr<I410Buffer> CreateI410Buffer(int width, int height);
     std::shared_ptr<NV12Buffer> CreateNV12Buffer(int width, int height);
 
-    // Changes the max amount of buffers in the pool to the new value.
-    // Returns true if change was successful and false if the amount of already
-    // allocated buffers is bigger than new value.
+    // Changes the max amount of buffers per shape to the new value.
+    // Returns true if change was successful and false if more buffers of a
+    // shape are in use than the new value.
     bool Resize(size_t max_number_of_buffers);
 
-    // Clears buffers_ and detaches the thread checker so that it can be reused
-    // later from another thread.
+    // Returns how many buffers this pool has allocated so far. A call to
+    // Create(I420|NV12)Buffer that leaves this unchanged recycled a buffer.
+    size_t AllocationCount() const;
+
+    // Releases free buffers, least recently returned first, until they hold at
+    // most `max_free_bytes`.
+    void Trim(size_t max_free_bytes);
+
+    Stats GetStats() const;
+
+    // Releases all free buffers. Buffers still in use return to the pool later.
     void Release();
 
 private:
-    std::shared_ptr<VideoFrameBuffer> GetExistingBuffer(int width, int height, VideoFrameBuffer::Type type);
-
-    RaceChecker race_checker_;
-    std::list<std::shared_ptr<VideoFrameBuffer>> buffers_;
-    // If true, newly allocated buffers are zero-initialized. Note that recycled
-    // buffers are not zero'd before reuse. This is required of buffers used by
-    // FFmpeg according to http://crbug.com/390941, which only requires it for the
-    // initial allocation (as shown by FFmpeg's own buffer allocation code). It
-    // has to do with "Use-of-uninitialized-value" on "Linux_msan_chrome".
-    const bool zero_initialize_;
-    // Max number of buffers this pool can have pending.
-    size_t max_number_of_buffers_;
+    class Shared;
+    const std::shared_ptr<Shared> shared_;
 };
 
-OCTK_END_NAMESPACE
\ No newline at end of file
+OCTK_END_NAMESPACE
@@ -0,0 +1,213 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/video_frame_transform.hpp>
+#include <openctk/core/logging.hpp>
+
+OCTK_BEGIN_NAMESPACE
+
+VideoFrameTransform &VideoFrameTransform::setCrop(int offsetX, int offsetY, int width, int height)
+{
+    mCropX = offsetX;
+    mCropY = offsetY;
+    mCropWidth = width;
+    mCropHeight = height;
+    return *this;
+}
+
+VideoFrameTransform &VideoFrameTransform::setScale(int width, int height)
+{
+    mScaleWidth = width;
+    mScaleHeight = height;
+    return *this;
+}
+
+VideoFrameTransform &VideoFrameTransform::setRotation(VideoRotation rotation)
+{
+    mRotation = rotation;
+    return *this;
+}
+
+VideoFrameTransform &VideoFrameTransform::setOutputType(VideoFrameBuffer::Type type)
+{
+    OCTK_DCHECK(VideoFrameBuffer::Type::kI420 == type || VideoFrameBuffer::Type::kNV12 == type);
+    mOutputType = type;
+    return *this;
+}
+
+VideoFrameTransform &VideoFrameTransform::setFilterMode(utils::yuv::FilterMode mode)
+{
+    mFilterMode = mode;
+    return *this;
+}
+
+VideoFrameTransform &VideoFrameTransform::setBufferPool(VideoFrameBufferPool *pool)
+{
+    mBufferPool = pool;
+    return *this;
+}
+
+int VideoFrameTransform::outputWidth(int srcWidth, int srcHeight) const
+{
+    int width = 0;
+    int height = 0;
+    this->scaledSize(srcWidth, srcHeight, &width, &height);
+    return VideoRotation::kAngle90 == mRotation || VideoRotation::kAngle270 == mRotation ? height : width;
+}
+
+int VideoFrameTransform::outputHeight(int srcWidth, int srcHeight) const
+{
+    int width = 0;
+    int height = 0;
+    this->scaledSize(srcWidth, srcHeight, &width, &height);
+    return VideoRotation::kAngle90 == mRotation || VideoRotation::kAngle270 == mRotation ? width : height;
+}
+
+std::shared_ptr<VideoFrameBuffer> VideoFrameTransform::apply(VideoFrameBuffer &src) const
+{
+    const int width = this->outputWidth(src.width(), src.height());
+    const int height = this->outputHeight(src.width(), src.height());
+    if (VideoFrameBuffer::Type::kNV12 == mOutputType)
+    {
+        auto buffer = mBufferPool ? mBufferPool->CreateNV12Buffer(width, height) : NV12Buffer::create(width, height);
+        return buffer && this->applyTo(src, *buffer) ? buffer : nullptr;
+    }
+    auto buffer = mBufferPool ? mBufferPool->CreateI420Buffer(width, height) : I420Buffer::create(width, height);
+    return buffer && this->applyTo(src, *buffer) ? buffer : nullptr;
+}
+
+bool VideoFrameTransform::applyTo(VideoFrameBuffer &src, I420Buffer &dst) const
+{
+    utils::yuv::Planes420 planes;
+    planes.type = VideoType::kI420;
+    planes.dataY = dst.MutableDataY();
+    planes.strideY = dst.strideY();
+    planes.dataU = dst.MutableDataU();
+    planes.strideU = dst.strideU();
+    planes.dataV = dst.MutableDataV();
+    planes.strideV = dst.strideV();
+    planes.width = dst.width();
+    planes.height = dst.height();
+    return this->transform(src, planes);
+}
+
+bool VideoFrameTransform::applyTo(VideoFrameBuffer &src, NV12Buffer &dst) const
+{
+    utils::yuv::Planes420 planes;
+    planes.type = VideoType::kNV12;
+    planes.dataY = dst.MutableDataY();
+    planes.strideY = dst.strideY();
+    planes.dataU = dst.MutableDataUV();
+    planes.strideU = dst.strideUV();
+    planes.width = dst.width();
+    planes.height = dst.height();
+    return this->transform(src, planes);
+}
+
+bool VideoFrameTransform::transform(VideoFrameBuffer &src, const utils::yuv::Planes420 &dst) const
+{
+    if (dst.width != this->outputWidth(src.width(), src.height()) ||
+        dst.height != this->outputHeight(src.width(), src.height()))
+    {
+        OCTK_WARNING() << "VideoFrameTransform: destination " << dst.width << "x" << dst.height
+                       << " doesn't match the transform output size";
+        return false;
+    }
+    // Native buffers that can hand out a planar view are read in place.
+    std::shared_ptr<VideoFrameBuffer> mapped;
+    if (VideoFrameBuffer::Type::kNative == src.type())
+    {
+        VideoFrameBuffer::Type types[] = {VideoFrameBuffer::Type::kNV12, VideoFrameBuffer::Type::kI420};
+        mapped = src.getMappedFrameBuffer(types);
+    }
+    VideoFrameBuffer &input = mapped ? *mapped : src;
+    utils::yuv::ConstPlanes420 planes;
+    std::shared_ptr<I420BufferInterface> converted;
+    if (VideoFrameBuffer::Type::kNV12 == input.type())
+    {
+        const NV12BufferInterface *nv12 = input.getNV12();
+        planes.type = VideoType::kNV12;
+        planes.dataY = nv12->dataY();
+        planes.strideY = nv12->strideY();
+        planes.dataU = nv12->dataUV();
+        planes.strideU = nv12->strideUV();
+    }
+    else
+    {
+        const I420BufferInterface *i420 = input.getI420();
+        if (!i420)
+        {
+            converted = input.toI420();
+            if (!converted)
+            {
+                OCTK_WARNING() << "VideoFrameTransform: failed to convert " << input.storageRepresentation() << " to I420";
+                return false;
+            }
+            i420 = converted.get();
+        }
+        planes.type = VideoType::kI420;
+        planes.dataY = i420->dataY();
+        planes.strideY = i420->strideY();
+        planes.dataU = i420->dataU();
+        planes.strideU = i420->strideU();
+        planes.dataV = i420->dataV();
+        planes.strideV = i420->strideV();
+    }
+    planes.width = src.width();
+    planes.height = src.height();
+
+    const bool cropped = mCropWidth > 0 && mCropHeight > 0;
+    const int cropX = cropped ? mCropX : 0;
+    const int cropY = cropped ? mCropY : 0;
+    const int cropWidth = cropped ? mCropWidth : src.width();
+    const int cropHeight = cropped ? mCropHeight : src.height();
+    if (!utils::yuv::cropScaleRotate(planes, cropX, cropY, cropWidth, cropHeight, dst, mRotation, mFilterMode))
+    {
+        OCTK_WARNING() << "VideoFrameTransform: crop " << cropWidth << "x" << cropHeight << "+" << cropX << "+"
+                       << cropY << " doesn't fit into " << src.width() << "x" << src.height();
+        return false;
+    }
+    return true;
+}
+
+void VideoFrameTransform::scaledSize(int srcWidth, int srcHeight, int *width, int *height) const
+{
+    if (mScaleWidth > 0 && mScaleHeight > 0)
+    {
+        *width = mScaleWidth;
+        *height = mScaleHeight;
+    }
+    else if (mCropWidth > 0 && mCropHeight > 0)
+    {
+        *width = mCropWidth;
+        *height = mCropHeight;
+    }
+    else
+    {
+        *width = srcWidth;
+        *height = srcHeight;
+    }
+}
+
+OCTK_END_NAMESPACE
@@ -0,0 +1,96 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#pragma once
+
+#include <openctk/media/video_frame_buffer_pool.hpp>
+#include <openctk/media/video_frame_buffer.hpp>
+#include <openctk/media/video_rotation.hpp>
+#include <openctk/media/yuv.hpp>
+
+#include <memory>
+
+OCTK_BEGIN_NAMESPACE
+
+/**
+ * Declarative crop, scale, rotate and convert descriptor for frame buffers.
+ * The steps always run in that order: the crop rectangle of the source is scaled to the scale size,
+ * rotated and converted to the output type. apply() executes them as one fused pass through
+ * utils::yuv::cropScaleRotate(), so unlike chaining cropAndScale(), I420Buffer::Rotate() and toI420() no full size
+ * intermediate frame is written. kI420 and kNV12 sources are read in place, native buffers through
+ * getMappedFrameBuffer() and other buffer types are converted with toI420() first. The transform itself holds no frame
+ * state, one instance can be applied from several threads as long as its buffer pool is only used from one of them.
+ */
+class OCTK_MEDIA_API VideoFrameTransform
+{
+public:
+    VideoFrameTransform() = default;
+
+    // Crops the source to the given rectangle, a zero width or height uses the whole source frame.
+    VideoFrameTransform &setCrop(int offsetX, int offsetY, int width, int height);
+    // Scales the cropped image to the given size before rotation, a zero width or height keeps the crop size.
+    VideoFrameTransform &setScale(int width, int height);
+    VideoFrameTransform &setRotation(VideoRotation rotation);
+    // kI420 (default) or kNV12.
+    VideoFrameTransform &setOutputType(VideoFrameBuffer::Type type);
+    VideoFrameTransform &setFilterMode(utils::yuv::FilterMode mode);
+    // Output buffers are taken from pool instead of being allocated, nullptr allocates a new buffer per frame.
+    VideoFrameTransform &setBufferPool(VideoFrameBufferPool *pool);
+
+    VideoRotation rotation() const { return mRotation; }
+    VideoFrameBuffer::Type outputType() const { return mOutputType; }
+    utils::yuv::FilterMode filterMode() const { return mFilterMode; }
+    VideoFrameBufferPool *bufferPool() const { return mBufferPool; }
+
+    // Size of the output buffer for a source of the given size, including the rotation.
+    int outputWidth(int srcWidth, int srcHeight) const;
+    int outputHeight(int srcWidth, int srcHeight) const;
+
+    /**
+     * Returns a new kI420 / kNV12 buffer holding the transformed src.
+     * Returns nullptr if the crop rectangle doesn't fit into src, src can't be converted to I420 or the buffer pool
+     * is exhausted.
+     */
+    std::shared_ptr<VideoFrameBuffer> apply(VideoFrameBuffer &src) const;
+    // Transforms src into dst, dst has to be outputWidth() x outputHeight() of src.
+    bool applyTo(VideoFrameBuffer &src, I420Buffer &dst) const;
+    bool applyTo(VideoFrameBuffer &src, NV12Buffer &dst) const;
+
+private:
+    void scaledSize(int srcWidth, int srcHeight, int *width, int *height) const;
+    bool transform(VideoFrameBuffer &src, const utils::yuv::Planes420 &dst) const;
+
+    int mCropX = 0;
+    int mCropY = 0;
+    int mCropWidth = 0;
+    int mCropHeight = 0;
+    int mScaleWidth = 0;
+    int mScaleHeight = 0;
+    VideoRotation mRotation = VideoRotation::kAngle0;
+    VideoFrameBuffer::Type mOutputType = VideoFrameBuffer::Type::kI420;
+    utils::yuv::FilterMode mFilterMode = utils::yuv::FilterMode::kFilterBox;
+    VideoFrameBufferPool *mBufferPool = nullptr;
+};
+
+OCTK_END_NAMESPACE
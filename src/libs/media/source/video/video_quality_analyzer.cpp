@@ -0,0 +1,340 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/video_quality_analyzer.hpp>
+#include <openctk/core/thread_pool.hpp>
+#include <openctk/core/logging.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <cmath>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace detail
+{
+static const char kLogMagic[8] = {'O', 'C', 'T', 'K', 'V', 'Q', 'M', '\0'};
+static const uint32_t kLogVersion = 1;
+static const uint32_t kLogRecordSize = sizeof(uint32_t) + 9 * sizeof(float);
+
+static bool writeLogRecord(std::FILE *file, const VideoQualityAnalyzer::FrameResult &result)
+{
+    uint8_t record[kLogRecordSize];
+    uint8_t *data = record;
+    std::memcpy(data, &result.frameIndex, sizeof(uint32_t));
+    data += sizeof(uint32_t);
+    std::memcpy(data, result.psnr, sizeof(result.psnr));
+    data += sizeof(result.psnr);
+    std::memcpy(data, result.ssim, sizeof(result.ssim));
+    data += sizeof(result.ssim);
+    std::memcpy(data, result.msssim, sizeof(result.msssim));
+    return 1 == std::fwrite(record, kLogRecordSize, 1, file);
+}
+
+static bool readPlane(std::FILE *file, uint8_t *data, int stride, int width, int height)
+{
+    for (int y = 0; y < height; ++y)
+    {
+        if (1 != std::fread(data + y * stride, width, 1, file))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool readI420(std::FILE *file, I420Buffer &buffer)
+{
+    const int chromaWidth = buffer.chromaWidth();
+    const int chromaHeight = buffer.chromaHeight();
+    return readPlane(file, buffer.MutableDataY(), buffer.strideY(), buffer.width(), buffer.height()) &&
+           readPlane(file, buffer.MutableDataU(), buffer.strideU(), chromaWidth, chromaHeight) &&
+           readPlane(file, buffer.MutableDataV(), buffer.strideV(), chromaWidth, chromaHeight);
+}
+} // namespace detail
+
+VideoQualityAnalyzer::VideoQualityAnalyzer()
+    : VideoQualityAnalyzer(Options())
+{
+}
+
+VideoQualityAnalyzer::VideoQualityAnalyzer(const Options &options)
+    : mOptions(options)
+    , mWorkers(options.workers > 0 ? options.workers : std::max(ThreadPool::idealThreadCount(), 1))
+    , mMaxPendingFrames(options.maxPendingFrames > 0 ? options.maxPendingFrames : 2 * mWorkers)
+    , mFilePool(false, 2 * (static_cast<size_t>(mMaxPendingFrames) + 1))
+{
+    if (!mOptions.logPath.empty())
+    {
+        mLog = std::fopen(mOptions.logPath.c_str(), "wb");
+        const uint32_t header[] = {mOptions.metrics, detail::kLogRecordSize};
+        if (!mLog || 1 != std::fwrite(detail::kLogMagic, sizeof(detail::kLogMagic), 1, mLog) ||
+            1 != std::fwrite(&detail::kLogVersion, sizeof(uint32_t), 1, mLog) ||
+            1 != std::fwrite(header, sizeof(header), 1, mLog))
+        {
+            OCTK_WARNING() << "VideoQualityAnalyzer: can't write log " << mOptions.logPath;
+            mLogFailed = true;
+        }
+    }
+}
+
+VideoQualityAnalyzer::~VideoQualityAnalyzer()
+{
+    this->flush();
+    if (mLog)
+    {
+        std::fclose(mLog);
+    }
+}
+
+uint32_t VideoQualityAnalyzer::addFrame(std::shared_ptr<I420BufferInterface> ref,
+                                        std::shared_ptr<I420BufferInterface> test)
+{
+    OCTK_DCHECK(ref && test);
+    bool startWorker = false;
+    uint32_t frameIndex = 0;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this] { return mPending < mMaxPendingFrames; });
+        frameIndex = mNextFrame++;
+        mResults.emplace_back();
+        mDone.push_back(false);
+        mJobs.push_back({frameIndex, std::move(ref), std::move(test)});
+        ++mPending;
+        if (mRunning < mWorkers)
+        {
+            ++mRunning;
+            startWorker = true;
+        }
+    }
+    if (startWorker)
+    {
+        ThreadPool::defaultInstance()->start([this] { this->work(); });
+    }
+    return frameIndex;
+}
+
+uint32_t VideoQualityAnalyzer::addFrame(const VideoFrame &ref, const VideoFrame &test)
+{
+    return this->addFrame(ref.videoFrameBuffer()->toI420(), test.videoFrameBuffer()->toI420());
+}
+
+int VideoQualityAnalyzer::addFiles(const std::string &refPath, const std::string &testPath, int width, int height)
+{
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> refFile(std::fopen(refPath.c_str(), "rb"), &std::fclose);
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> testFile(std::fopen(testPath.c_str(), "rb"), &std::fclose);
+    if (!refFile || !testFile)
+    {
+        OCTK_WARNING() << "VideoQualityAnalyzer: can't open " << (refFile ? testPath : refPath);
+        return -1;
+    }
+    int frames = 0;
+    while (true)
+    {
+        // The pool holds enough buffers for all pending frames, addFrame() blocks before it runs dry.
+        std::shared_ptr<I420Buffer> ref = mFilePool.CreateI420Buffer(width, height);
+        std::shared_ptr<I420Buffer> test = mFilePool.CreateI420Buffer(width, height);
+        if (!ref || !test)
+        {
+            OCTK_WARNING() << "VideoQualityAnalyzer: frame buffer pool exhausted";
+            break;
+        }
+        if (!detail::readI420(refFile.get(), *ref) || !detail::readI420(testFile.get(), *test))
+        {
+            break;
+        }
+        this->addFrame(std::move(ref), std::move(test));
+        ++frames;
+    }
+    return frames;
+}
+
+bool VideoQualityAnalyzer::flush()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait(lock, [this] { return 0 == mPending && 0 == mRunning; });
+    if (mLog && 0 != std::fflush(mLog))
+    {
+        mLogFailed = true;
+    }
+    return !mLogFailed;
+}
+
+std::vector<VideoQualityAnalyzer::FrameResult> VideoQualityAnalyzer::results() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return std::vector<FrameResult>(mResults.begin(), mResults.begin() + mCompleted);
+}
+
+VideoQualityAnalyzer::Summary VideoQualityAnalyzer::summary() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    Summary summary;
+    summary.frames = static_cast<int>(mCompleted);
+    for (uint32_t i = 0; i < mCompleted; ++i)
+    {
+        for (int plane = 0; plane < kPlaneCount; ++plane)
+        {
+            summary.psnr[plane] += mResults[i].psnr[plane];
+            summary.ssim[plane] += mResults[i].ssim[plane];
+            summary.msssim[plane] += mResults[i].msssim[plane];
+        }
+    }
+    for (int plane = 0; plane < kPlaneCount && summary.frames > 0; ++plane)
+    {
+        summary.psnr[plane] /= summary.frames;
+        summary.ssim[plane] /= summary.frames;
+        summary.msssim[plane] /= summary.frames;
+    }
+    return summary;
+}
+
+VideoQualityAnalyzer::FrameResult VideoQualityAnalyzer::analyze(const I420BufferInterface &ref,
+                                                                const I420BufferInterface &test,
+                                                                uint32_t metrics)
+{
+    const I420BufferInterface *compared = &test;
+    if (ref.width() != test.width() || ref.height() != test.height())
+    {
+        // Reused by the next frame of this thread, clips keep their size.
+        static thread_local std::shared_ptr<I420Buffer> scaled;
+        if (!scaled || scaled->width() != ref.width() || scaled->height() != ref.height())
+        {
+            scaled = I420Buffer::create(ref.width(), ref.height());
+        }
+        scaled->scaleFrom(test);
+        compared = scaled.get();
+    }
+
+    const uint8_t *refData[kPlaneCount] = {ref.dataY(), ref.dataU(), ref.dataV()};
+    const int refStrides[kPlaneCount] = {ref.strideY(), ref.strideU(), ref.strideV()};
+    const uint8_t *testData[kPlaneCount] = {compared->dataY(), compared->dataU(), compared->dataV()};
+    const int testStrides[kPlaneCount] = {compared->strideY(), compared->strideU(), compared->strideV()};
+    const int widths[kPlaneCount] = {ref.width(), ref.chromaWidth(), ref.chromaWidth()};
+    const int heights[kPlaneCount] = {ref.height(), ref.chromaHeight(), ref.chromaHeight()};
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    FrameResult result;
+    for (int plane = 0; plane < kPlaneCount; ++plane)
+    {
+        const uint8_t *a = refData[plane];
+        const uint8_t *b = testData[plane];
+        const int strideA = refStrides[plane];
+        const int strideB = testStrides[plane];
+        const int width = widths[plane];
+        const int height = heights[plane];
+        result.psnr[plane] = nan;
+        result.ssim[plane] = nan;
+        result.msssim[plane] = nan;
+        if (metrics & kPSNR)
+        {
+            const uint64_t sse = utils::yuv::planeSumSquareError(a, strideA, b, strideB, width, height);
+            result.psnr[plane] = static_cast<float>(
+                utils::yuv::psnrFromSumSquareError(sse, static_cast<uint64_t>(width) * height));
+        }
+        if (metrics & kSSIM)
+        {
+            result.ssim[plane] = static_cast<float>(utils::yuv::planeSSIM(a, strideA, b, strideB, width, height));
+        }
+        if (metrics & kMSSSIM)
+        {
+            result.msssim[plane] = static_cast<float>(utils::yuv::planeMSSSIM(a, strideA, b, strideB, width, height));
+        }
+    }
+    return result;
+}
+
+bool VideoQualityAnalyzer::readLog(const std::string &path, std::vector<FrameResult> &results)
+{
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+    if (!file)
+    {
+        return false;
+    }
+    char magic[sizeof(detail::kLogMagic)];
+    uint32_t header[3];
+    if (1 != std::fread(magic, sizeof(magic), 1, file.get()) ||
+        1 != std::fread(header, sizeof(header), 1, file.get()) ||
+        0 != std::memcmp(magic, detail::kLogMagic, sizeof(magic)) || detail::kLogVersion != header[0] ||
+        detail::kLogRecordSize != header[2])
+    {
+        return false;
+    }
+    results.clear();
+    uint8_t record[detail::kLogRecordSize];
+    while (1 == std::fread(record, sizeof(record), 1, file.get()))
+    {
+        FrameResult result;
+        const uint8_t *data = record;
+        std::memcpy(&result.frameIndex, data, sizeof(uint32_t));
+        data += sizeof(uint32_t);
+        std::memcpy(result.psnr, data, sizeof(result.psnr));
+        data += sizeof(result.psnr);
+        std::memcpy(result.ssim, data, sizeof(result.ssim));
+        data += sizeof(result.ssim);
+        std::memcpy(result.msssim, data, sizeof(result.msssim));
+        results.push_back(result);
+    }
+    return true;
+}
+
+void VideoQualityAnalyzer::work()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mJobs.empty())
+    {
+        Job job = std::move(mJobs.front());
+        mJobs.pop_front();
+        lock.unlock();
+        FrameResult result = analyze(*job.ref, *job.test, mOptions.metrics);
+        result.frameIndex = job.frameIndex;
+        // Return the buffers to their pool before addFrame() can wake up and ask for new ones.
+        job.ref.reset();
+        job.test.reset();
+        lock.lock();
+        this->finishFrame(result);
+    }
+    --mRunning;
+    mCondition.notify_all();
+}
+
+void VideoQualityAnalyzer::finishFrame(const FrameResult &result)
+{
+    mResults[result.frameIndex] = result;
+    mDone[result.frameIndex] = true;
+    --mPending;
+    while (mCompleted < mDone.size() && mDone[mCompleted])
+    {
+        if (mLog && !mLogFailed && !detail::writeLogRecord(mLog, mResults[mCompleted]))
+        {
+            OCTK_WARNING() << "VideoQualityAnalyzer: can't write log " << mOptions.logPath;
+            mLogFailed = true;
+        }
+        ++mCompleted;
+    }
+    mCondition.notify_all();
+}
+
+OCTK_END_NAMESPACE
@@ -0,0 +1,162 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#pragma once
+
+#include <openctk/media/video_frame_buffer_pool.hpp>
+#include <openctk/media/video_frame.hpp>
+#include <openctk/media/yuv.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+OCTK_BEGIN_NAMESPACE
+
+/**
+ * Batch full reference quality analysis of I420 frame pairs. Pairs are queued with addFrame() or streamed from raw
+ * I420 files with addFiles() and analyzed on ThreadPool::defaultInstance(), one frame per worker, with the plane
+ * kernels of utils::yuv (planeSumSquareError(), planeSSIM() and planeMSSSIM()). Test frames of a different size are
+ * scaled to the reference size first. Results are kept in frame order and, if Options::logPath is set, appended to a
+ * binary log as soon as all earlier frames are done:
+ *
+ *   header: char magic[8] = "OCTKVQM", uint32 version = 1, uint32 metrics, uint32 recordSize = 40
+ *   record: uint32 frameIndex, float psnr[3], float ssim[3], float msssim[3]
+ *
+ * in host byte order, with NaN for metrics that were not requested. readLog() reads it back.
+ */
+class OCTK_MEDIA_API VideoQualityAnalyzer
+{
+public:
+    enum Metric : uint32_t
+    {
+        kPSNR = 1 << 0,
+        kSSIM = 1 << 1,
+        kMSSSIM = 1 << 2,
+        kAllMetrics = kPSNR | kSSIM | kMSSSIM
+    };
+
+    enum Plane
+    {
+        kPlaneY = 0,
+        kPlaneU = 1,
+        kPlaneV = 2,
+        kPlaneCount = 3
+    };
+
+    struct Options
+    {
+        // Metric flags to compute.
+        uint32_t metrics = kAllMetrics;
+        // Frames analyzed at the same time, 0 uses ThreadPool::idealThreadCount().
+        int workers = 0;
+        // addFrame() blocks while this many frames are queued or being analyzed, 0 uses twice the workers.
+        int maxPendingFrames = 0;
+        // Binary per frame log, empty disables logging.
+        std::string logPath;
+    };
+
+    struct FrameResult
+    {
+        uint32_t frameIndex = 0;
+        float psnr[kPlaneCount];
+        float ssim[kPlaneCount];
+        float msssim[kPlaneCount];
+    };
+
+    // Per plane means over all analyzed frames.
+    struct Summary
+    {
+        int frames = 0;
+        double psnr[kPlaneCount] = {};
+        double ssim[kPlaneCount] = {};
+        double msssim[kPlaneCount] = {};
+    };
+
+    VideoQualityAnalyzer();
+    explicit VideoQualityAnalyzer(const Options &options);
+    // Waits for all queued frames.
+    ~VideoQualityAnalyzer();
+
+    const Options &options() const { return mOptions; }
+
+    /**
+     * Queues a frame pair and returns its frame index. Blocks while Options::maxPendingFrames frames are pending.
+     * The buffers are referenced until the frame is analyzed, so they must not be written to until then.
+     */
+    uint32_t addFrame(std::shared_ptr<I420BufferInterface> ref, std::shared_ptr<I420BufferInterface> test);
+    uint32_t addFrame(const VideoFrame &ref, const VideoFrame &test);
+    /**
+     * Reads both raw I420 files of the given size frame by frame and queues every pair, stopping at the end of the
+     * shorter file. Returns the number of queued frames or -1 if a file can't be opened.
+     */
+    int addFiles(const std::string &refPath, const std::string &testPath, int width, int height);
+
+    // Waits until all queued frames are analyzed and logged, returns false if writing the log failed.
+    bool flush();
+
+    // Results of the analyzed frames in frame order, call flush() first to get all of them.
+    std::vector<FrameResult> results() const;
+    Summary summary() const;
+
+    // Analyzes one frame pair on the calling thread.
+    static FrameResult analyze(const I420BufferInterface &ref, const I420BufferInterface &test, uint32_t metrics);
+    // Reads a log written by an analyzer, returns false if it is no valid log.
+    static bool readLog(const std::string &path, std::vector<FrameResult> &results);
+
+private:
+    struct Job
+    {
+        uint32_t frameIndex;
+        std::shared_ptr<I420BufferInterface> ref;
+        std::shared_ptr<I420BufferInterface> test;
+    };
+
+    void work();
+    void finishFrame(const FrameResult &result);
+
+    const Options mOptions;
+    const int mWorkers;
+    const int mMaxPendingFrames;
+    VideoFrameBufferPool mFilePool;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<Job> mJobs;
+    std::vector<FrameResult> mResults;
+    std::vector<bool> mDone;
+    uint32_t mNextFrame = 0;
+    uint32_t mCompleted = 0;
+    int mPending = 0;
+    int mRunning = 0;
+    std::FILE *mLog = nullptr;
+    bool mLogFailed = false;
+};
+
+OCTK_END_NAMESPACE
@@ -23,13 +23,38 @@
 ***********************************************************************************************************************/
 
 #include <openctk/media/i420_buffer.hpp>
+#include <openctk/core/function_view.hpp>
+#include <openctk/core/thread_pool.hpp>
+#include <openctk/core/processor.hpp>
 #include <openctk/core/checks.hpp>
 #include "yuv.hpp"
 
 #include <libyuv.h>
 
+#if (defined(OCTK_PROCESSOR_X86_64) || defined(OCTK_PROCESSOR_X86_32)) &&                                            \
+    (defined(OCTK_CC_GNU) || defined(OCTK_CC_MSVC))
+#    define OCTK_YUV_X86 1
+#    include <immintrin.h>
+#    if defined(OCTK_CC_MSVC) && !defined(OCTK_CC_CLANG)
+#        include <intrin.h>
+#        define OCTK_YUV_TARGET(features)
+#    else
+#        define OCTK_YUV_TARGET(features) __attribute__((target(features)))
+#    endif
+#elif defined(__ARM_NEON)
+#    define OCTK_YUV_NEON 1
+#    include <arm_neon.h>
+#endif
+
+#include <condition_variable>
+#include <algorithm>
 #include <cstdint>
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
+#include <cmath>
+#include <mutex>
 
 OCTK_BEGIN_NAMESPACE
 
@@ -66,6 +91,700 @@ libyuv::FourCC videoTypeToFourCC(VideoType videoType)
     OCTK_CHECK_NOTREACHED();
     return libyuv::FOURCC_ANY;
 }
+
+static inline std::atomic<int> &sliceCount()
+{
+    static std::atomic<int> count{0};
+    return count;
+}
+
+static inline std::atomic<int> &sliceCacheBytes()
+{
+    static std::atomic<int> bytes{yuv::SliceOptions().sliceCacheBytes};
+    return bytes;
+}
+
+static inline std::atomic<int> &minSlicedPixels()
+{
+    static std::atomic<int> pixels{yuv::SliceOptions().minSlicedPixels};
+    return pixels;
+}
+
+static int sliceWorkers(int width, int height)
+{
+    const int count = sliceCount().load(std::memory_order_relaxed);
+    if (static_cast<int64_t>(width) * height < minSlicedPixels().load(std::memory_order_relaxed))
+    {
+        return 1;
+    }
+    return count > 0 ? count : ThreadPool::idealThreadCount();
+}
+
+// Runs task(0..taskCount-1) on up to workers threads. The calling thread takes tasks too, so a conversion started on a
+// pool thread can't wait for pool threads that never get scheduled.
+static void runParallel(int taskCount, int workers, FunctionView<void(int)> task)
+{
+    struct State
+    {
+        std::atomic<int> next{0};
+        std::atomic<int> pending{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<State>();
+    state->pending.store(taskCount);
+    // Pool threads only touch the task while the caller waits for the index they claimed.
+    const auto function = &task;
+    const auto drain = [state, function, taskCount]()
+    {
+        for (int index = state->next.fetch_add(1); index < taskCount; index = state->next.fetch_add(1))
+        {
+            (*function)(index);
+            if (1 == state->pending.fetch_sub(1))
+            {
+                std::lock_guard<std::mutex> locker(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+    for (int i = 1; i < std::min(workers, taskCount); ++i)
+    {
+        ThreadPool::defaultInstance()->start(drain);
+    }
+    drain();
+    std::unique_lock<std::mutex> locker(state->mutex);
+    state->finished.wait(locker, [&state]() { return 0 == state->pending.load(); });
+}
+
+/**
+ * Splits height rows into slices of a multiple of rowAlignment rows and runs slice(firstRow, rowCount) for each.
+ * rowBytes are the source and destination bytes one row touches, slices are sized to keep their rows in cache.
+ */
+static void runSlices(int width,
+                      int height,
+                      int rowBytes,
+                      FunctionView<void(int, int)> slice,
+                      int rowAlignment = 2)
+{
+    const int workers = sliceWorkers(width, height);
+    if (workers <= 1 || height < 2 * rowAlignment)
+    {
+        slice(0, height);
+        return;
+    }
+    const int alignedRows = (height + rowAlignment - 1) / rowAlignment;
+    int sliceUnits = std::max(sliceCacheBytes().load(std::memory_order_relaxed) / std::max(rowBytes, 1), 1);
+    sliceUnits = std::max(sliceUnits / rowAlignment, 1);
+    // Never fewer slices than workers, small frames would otherwise run on one thread.
+    sliceUnits = std::min(sliceUnits, (alignedRows + workers - 1) / workers);
+    const int sliceRows = sliceUnits * rowAlignment;
+    const int slices = (height + sliceRows - 1) / sliceRows;
+    if (slices <= 1)
+    {
+        slice(0, height);
+        return;
+    }
+    runParallel(slices,
+                workers,
+                [&](int index)
+                {
+                    const int firstRow = index * sliceRows;
+                    slice(firstRow, std::min(sliceRows, height - firstRow));
+                });
+}
+
+// Runs plane(0..planes-1) concurrently for scales that can't be split into rows.
+static void runPlanes(int width, int height, int planes, FunctionView<void(int)> plane)
+{
+    const int workers = sliceWorkers(width, height);
+    if (workers <= 1)
+    {
+        for (int i = 0; i < planes; ++i)
+        {
+            plane(i);
+        }
+        return;
+    }
+    runParallel(planes, workers, plane);
+}
+
+/**
+ * Returns the destination row alignment that lets a 4:2:0 scale run slice by slice with results identical to a full
+ * frame scale, 0 if it has to run as a whole.
+ * libyuv steps through source rows in 16.16 fixed point with a start offset that only depends on the step, for a
+ * downscale with an exact step every slice starting on a whole source row samples like the full frame does.
+ * Upscales derive their step from the full heights and can't be sliced.
+ */
+static int scaleRowAlignment(int srcHeight, int dstHeight)
+{
+    if (dstHeight <= 0 || dstHeight > srcHeight || srcHeight % 2 || dstHeight % 2 ||
+        (static_cast<int64_t>(srcHeight) << 16) % dstHeight)
+    {
+        return 0;
+    }
+    const int srcChromaHeight = srcHeight / 2;
+    const int dstChromaHeight = dstHeight / 2;
+    int a = srcChromaHeight;
+    int b = dstChromaHeight;
+    while (b)
+    {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return 2 * (dstChromaHeight / a);
+}
+
+static void fillI420(uint8_t *buffer, int width, int height)
+{
+    runSlices(width,
+              height,
+              width * 3 / 2,
+              [&](int y, int rows)
+              {
+                  libyuv::I420Rect(OCTK_I420_Y_PTR(buffer, width, height),
+                                   OCTK_I420_Y_STRIDE(width),
+                                   OCTK_I420_U_PTR(buffer, width, height),
+                                   OCTK_I420_U_STRIDE(width),
+                                   OCTK_I420_V_PTR(buffer, width, height),
+                                   OCTK_I420_V_STRIDE(width),
+                                   0,
+                                   y,
+                                   width,
+                                   rows,
+                                   0,
+                                   128,
+                                   128);
+              });
+}
+
+// Returns planes limited to the given rectangle, x and y have to be even.
+template <typename Planes> static Planes subPlanes(Planes planes, int x, int y, int width, int height)
+{
+    planes.dataY += planes.strideY * y + x;
+    if (VideoType::kNV12 == planes.type)
+    {
+        planes.dataU += planes.strideU * (y / 2) + x;
+    }
+    else
+    {
+        planes.dataU += planes.strideU * (y / 2) + x / 2;
+        planes.dataV += planes.strideV * (y / 2) + x / 2;
+    }
+    planes.width = width;
+    planes.height = height;
+    return planes;
+}
+
+// Returns a scratch buffer of the calling thread, reused between frames as long as requests stay slice sized.
+static uint8_t *scratchBuffer(size_t size, std::unique_ptr<uint8_t[]> &oversized)
+{
+    static thread_local std::vector<uint8_t> buffer;
+    if (size > 4 * static_cast<size_t>(std::max(sliceCacheBytes().load(std::memory_order_relaxed), 0)))
+    {
+        oversized.reset(new uint8_t[size]);
+        return oversized.get();
+    }
+    if (buffer.size() < size)
+    {
+        buffer.resize(size);
+    }
+    return buffer.data();
+}
+
+/**
+ * Writes strip, rows y..y+strip.height of the unrotated scaled image, rotated and converted to its place in dst.
+ * scratch holds the rotated chroma planes of an I420 strip that is merged into a kNV12 dst.
+ */
+static void rotateStrip(const yuv::ConstPlanes420 &strip,
+                        const yuv::Planes420 &dst,
+                        int y,
+                        int scaledHeight,
+                        VideoRotation rotation,
+                        uint8_t *scratch)
+{
+    int dstRow = 0;
+    int dstColumn = 0;
+    switch (rotation)
+    {
+        case VideoRotation::kAngle0: dstRow = y; break;
+        case VideoRotation::kAngle90: dstColumn = scaledHeight - y - strip.height; break;
+        case VideoRotation::kAngle180: dstRow = scaledHeight - y - strip.height; break;
+        case VideoRotation::kAngle270: dstColumn = y; break;
+    }
+    const auto target = subPlanes(dst, dstColumn, dstRow, dst.width, dst.height);
+    const auto mode = static_cast<libyuv::RotationMode>(rotation);
+    const int chromaWidth = (strip.width + 1) / 2;
+    const int chromaHeight = (strip.height + 1) / 2;
+    if (VideoType::kI420 == dst.type)
+    {
+        if (VideoType::kNV12 == strip.type)
+        {
+            libyuv::NV12ToI420Rotate(strip.dataY,
+                                     strip.strideY,
+                                     strip.dataU,
+                                     strip.strideU,
+                                     target.dataY,
+                                     target.strideY,
+                                     target.dataU,
+                                     target.strideU,
+                                     target.dataV,
+                                     target.strideV,
+                                     strip.width,
+                                     strip.height,
+                                     mode);
+        }
+        else
+        {
+            libyuv::I420Rotate(strip.dataY,
+                               strip.strideY,
+                               strip.dataU,
+                               strip.strideU,
+                               strip.dataV,
+                               strip.strideV,
+                               target.dataY,
+                               target.strideY,
+                               target.dataU,
+                               target.strideU,
+                               target.dataV,
+                               target.strideV,
+                               strip.width,
+                               strip.height,
+                               mode);
+        }
+        return;
+    }
+    if (VideoRotation::kAngle0 == rotation && VideoType::kI420 == strip.type)
+    {
+        libyuv::I420ToNV12(strip.dataY,
+                           strip.strideY,
+                           strip.dataU,
+                           strip.strideU,
+                           strip.dataV,
+                           strip.strideV,
+                           target.dataY,
+                           target.strideY,
+                           target.dataU,
+                           target.strideU,
+                           strip.width,
+                           strip.height);
+        return;
+    }
+    libyuv::RotatePlane(strip.dataY, strip.strideY, target.dataY, target.strideY, strip.width, strip.height, mode);
+    if (VideoType::kNV12 == strip.type)
+    {
+        // Interleaved UV pairs rotate like the pixels of a 16 bit plane.
+        OCTK_DCHECK(0 == strip.strideU % 2 && 0 == target.strideU % 2);
+        libyuv::RotatePlane_16(reinterpret_cast<const uint16_t *>(strip.dataU),
+                               strip.strideU / 2,
+                               reinterpret_cast<uint16_t *>(target.dataU),
+                               target.strideU / 2,
+                               chromaWidth,
+                               chromaHeight,
+                               mode);
+        return;
+    }
+    const bool transposed = VideoRotation::kAngle90 == rotation || VideoRotation::kAngle270 == rotation;
+    const int rotatedWidth = transposed ? chromaHeight : chromaWidth;
+    const int rotatedHeight = transposed ? chromaWidth : chromaHeight;
+    uint8_t *rotatedU = scratch;
+    uint8_t *rotatedV = scratch + rotatedWidth * rotatedHeight;
+    libyuv::RotatePlane(strip.dataU, strip.strideU, rotatedU, rotatedWidth, chromaWidth, chromaHeight, mode);
+    libyuv::RotatePlane(strip.dataV, strip.strideV, rotatedV, rotatedWidth, chromaWidth, chromaHeight, mode);
+    libyuv::MergeUVPlane(rotatedU,
+                         rotatedWidth,
+                         rotatedV,
+                         rotatedWidth,
+                         target.dataU,
+                         target.strideU,
+                         rotatedWidth,
+                         rotatedHeight);
+}
+
+// Returns src scaled to width x height in a buffer of the calling thread that is reused by the next comparison.
+static const I420Buffer &scaledForComparison(const I420BufferInterface &src, int width, int height)
+{
+    static thread_local std::shared_ptr<I420Buffer> buffer;
+    if (!buffer || buffer->width() != width || buffer->height() != height)
+    {
+        buffer = I420Buffer::create(width, height);
+    }
+    buffer->scaleFrom(src);
+    return *buffer;
+}
+
+/**
+ * SSIM statistics of a window: sums of a, b, a * a, b * b and a * b. The SSIM functions compare 8x8 windows on a
+ * 4 pixel grid, every window is the sum of four 4x4 blocks, so every pixel is only read once.
+ */
+template <typename T> struct BasicSsimSums
+{
+    T a = 0;
+    T b = 0;
+    T aa = 0;
+    T bb = 0;
+    T ab = 0;
+};
+using SsimSums = BasicSsimSums<uint32_t>;
+
+// Per column sums of 4 rows, one array per statistic.
+struct SsimColumns
+{
+    std::vector<uint32_t> a, b, aa, bb, ab;
+
+    void resize(int width)
+    {
+        a.resize(width);
+        b.resize(width);
+        aa.resize(width);
+        bb.resize(width);
+        ab.resize(width);
+    }
+};
+
+static void ssimColumnsC(const uint8_t *a,
+                         int strideA,
+                         const uint8_t *b,
+                         int strideB,
+                         int x,
+                         int width,
+                         SsimColumns &columns)
+{
+    for (; x < width; ++x)
+    {
+        uint32_t sa = 0, sb = 0, saa = 0, sbb = 0, sab = 0;
+        for (int row = 0; row < 4; ++row)
+        {
+            const uint32_t va = a[row * strideA + x];
+            const uint32_t vb = b[row * strideB + x];
+            sa += va;
+            sb += vb;
+            saa += va * va;
+            sbb += vb * vb;
+            sab += va * vb;
+        }
+        columns.a[x] = sa;
+        columns.b[x] = sb;
+        columns.aa[x] = saa;
+        columns.bb[x] = sbb;
+        columns.ab[x] = sab;
+    }
+}
+
+/**
+ * The vector kernels fill columns with the sums of the 4 rows starting at a and b for a prefix of the width and return
+ * its length, ssimColumnsC() finishes the rest. The products of two 8 bit samples fit into 16 bits, so the kernels
+ * multiply 16 bit lanes and only widen to 32 bits for accumulation.
+ */
+using SsimColumnsKernel =
+    int (*)(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, SsimColumns &columns);
+
+static int ssimColumnsNone(const uint8_t *, int, const uint8_t *, int, int, SsimColumns &) { return 0; }
+
+#if OCTK_YUV_X86
+OCTK_YUV_TARGET("avx2") static inline void storeColumns16(uint32_t *dst, __m256i sums)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_cvtepu16_epi32(_mm256_castsi256_si128(sums)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 8),
+                        _mm256_cvtepu16_epi32(_mm256_extracti128_si256(sums, 1)));
+}
+
+OCTK_YUV_TARGET("avx2") static inline void addProducts16(__m256i &low, __m256i &high, __m256i products)
+{
+    low = _mm256_add_epi32(low, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(products)));
+    high = _mm256_add_epi32(high, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(products, 1)));
+}
+
+OCTK_YUV_TARGET("avx2")
+static int ssimColumnsAvx2(const uint8_t *a,
+                           int strideA,
+                           const uint8_t *b,
+                           int strideB,
+                           int width,
+                           SsimColumns &columns)
+{
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        __m256i sa = _mm256_setzero_si256(), sb = _mm256_setzero_si256();
+        __m256i saaLow = _mm256_setzero_si256(), saaHigh = _mm256_setzero_si256();
+        __m256i sbbLow = _mm256_setzero_si256(), sbbHigh = _mm256_setzero_si256();
+        __m256i sabLow = _mm256_setzero_si256(), sabHigh = _mm256_setzero_si256();
+        for (int row = 0; row < 4; ++row)
+        {
+            const __m256i va = _mm256_cvtepu8_epi16(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + row * strideA + x)));
+            const __m256i vb = _mm256_cvtepu8_epi16(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + row * strideB + x)));
+            sa = _mm256_add_epi16(sa, va);
+            sb = _mm256_add_epi16(sb, vb);
+            addProducts16(saaLow, saaHigh, _mm256_mullo_epi16(va, va));
+            addProducts16(sbbLow, sbbHigh, _mm256_mullo_epi16(vb, vb));
+            addProducts16(sabLow, sabHigh, _mm256_mullo_epi16(va, vb));
+        }
+        storeColumns16(&columns.a[x], sa);
+        storeColumns16(&columns.b[x], sb);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&columns.aa[x]), saaLow);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&columns.aa[x + 8]), saaHigh);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&columns.bb[x]), sbbLow);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&columns.bb[x + 8]), sbbHigh);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&columns.ab[x]), sabLow);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&columns.ab[x + 8]), sabHigh);
+    }
+    return x;
+}
+
+OCTK_YUV_TARGET("sse2") static inline void storeColumns8(uint32_t *dst, __m128i sums)
+{
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi16(sums, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4), _mm_unpackhi_epi16(sums, zero));
+}
+
+OCTK_YUV_TARGET("sse2") static inline void addProducts8(__m128i &low, __m128i &high, __m128i products)
+{
+    const __m128i zero = _mm_setzero_si128();
+    low = _mm_add_epi32(low, _mm_unpacklo_epi16(products, zero));
+    high = _mm_add_epi32(high, _mm_unpackhi_epi16(products, zero));
+}
+
+OCTK_YUV_TARGET("sse2")
+static int ssimColumnsSse2(const uint8_t *a,
+                           int strideA,
+                           const uint8_t *b,
+                           int strideB,
+                           int width,
+                           SsimColumns &columns)
+{
+    int x = 0;
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 8 <= width; x += 8)
+    {
+        __m128i sa = zero, sb = zero, saaLow = zero, saaHigh = zero;
+        __m128i sbbLow = zero, sbbHigh = zero, sabLow = zero, sabHigh = zero;
+        for (int row = 0; row < 4; ++row)
+        {
+            const __m128i va = _mm_unpacklo_epi8(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i *>(a + row * strideA + x)), zero);
+            const __m128i vb = _mm_unpacklo_epi8(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i *>(b + row * strideB + x)), zero);
+            sa = _mm_add_epi16(sa, va);
+            sb = _mm_add_epi16(sb, vb);
+            addProducts8(saaLow, saaHigh, _mm_mullo_epi16(va, va));
+            addProducts8(sbbLow, sbbHigh, _mm_mullo_epi16(vb, vb));
+            addProducts8(sabLow, sabHigh, _mm_mullo_epi16(va, vb));
+        }
+        storeColumns8(&columns.a[x], sa);
+        storeColumns8(&columns.b[x], sb);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&columns.aa[x]), saaLow);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&columns.aa[x + 4]), saaHigh);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&columns.bb[x]), sbbLow);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&columns.bb[x + 4]), sbbHigh);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&columns.ab[x]), sabLow);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&columns.ab[x + 4]), sabHigh);
+    }
+    return x;
+}
+#elif OCTK_YUV_NEON
+static int ssimColumnsNeon(const uint8_t *a,
+                           int strideA,
+                           const uint8_t *b,
+                           int strideB,
+                           int width,
+                           SsimColumns &columns)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        uint16x8_t sa = vdupq_n_u16(0), sb = vdupq_n_u16(0);
+        uint32x4_t saaLow = vdupq_n_u32(0), saaHigh = vdupq_n_u32(0);
+        uint32x4_t sbbLow = vdupq_n_u32(0), sbbHigh = vdupq_n_u32(0);
+        uint32x4_t sabLow = vdupq_n_u32(0), sabHigh = vdupq_n_u32(0);
+        for (int row = 0; row < 4; ++row)
+        {
+            const uint8x8_t va = vld1_u8(a + row * strideA + x);
+            const uint8x8_t vb = vld1_u8(b + row * strideB + x);
+            sa = vaddw_u8(sa, va);
+            sb = vaddw_u8(sb, vb);
+            const uint16x8_t aa = vmull_u8(va, va);
+            const uint16x8_t bb = vmull_u8(vb, vb);
+            const uint16x8_t ab = vmull_u8(va, vb);
+            saaLow = vaddw_u16(saaLow, vget_low_u16(aa));
+            saaHigh = vaddw_u16(saaHigh, vget_high_u16(aa));
+            sbbLow = vaddw_u16(sbbLow, vget_low_u16(bb));
+            sbbHigh = vaddw_u16(sbbHigh, vget_high_u16(bb));
+            sabLow = vaddw_u16(sabLow, vget_low_u16(ab));
+            sabHigh = vaddw_u16(sabHigh, vget_high_u16(ab));
+        }
+        vst1q_u32(&columns.a[x], vmovl_u16(vget_low_u16(sa)));
+        vst1q_u32(&columns.a[x + 4], vmovl_u16(vget_high_u16(sa)));
+        vst1q_u32(&columns.b[x], vmovl_u16(vget_low_u16(sb)));
+        vst1q_u32(&columns.b[x + 4], vmovl_u16(vget_high_u16(sb)));
+        vst1q_u32(&columns.aa[x], saaLow);
+        vst1q_u32(&columns.aa[x + 4], saaHigh);
+        vst1q_u32(&columns.bb[x], sbbLow);
+        vst1q_u32(&columns.bb[x + 4], sbbHigh);
+        vst1q_u32(&columns.ab[x], sabLow);
+        vst1q_u32(&columns.ab[x + 4], sabHigh);
+    }
+    return x;
+}
+#endif
+
+static SsimColumnsKernel selectSsimColumnsKernel()
+{
+#if OCTK_YUV_X86
+#    if defined(OCTK_CC_MSVC) && !defined(OCTK_CC_CLANG)
+    int info[4] = {0};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2 = 0 != (info[3] & (1 << 26));
+    const bool osSavesYmm = (0 != (info[2] & (1 << 27))) && (6 == (_xgetbv(0) & 6));
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osSavesYmm)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = 0 != (info[1] & (1 << 5));
+    }
+#    else
+    __builtin_cpu_init();
+    const bool sse2 = __builtin_cpu_supports("sse2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#    endif
+    if (avx2)
+    {
+        return ssimColumnsAvx2;
+    }
+    if (sse2)
+    {
+        return ssimColumnsSse2;
+    }
+#elif OCTK_YUV_NEON
+    return ssimColumnsNeon;
+#endif
+    return ssimColumnsNone;
+}
+
+// Fills columns with the sums of the 4 rows starting at a and b.
+static void ssimColumns(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, SsimColumns &columns)
+{
+    static const SsimColumnsKernel kernel = selectSsimColumnsKernel();
+    const int x = kernel(a, strideA, b, strideB, width, columns);
+    ssimColumnsC(a, strideA, b, strideB, x, width, columns);
+}
+
+// Reduces every 4 columns to the sums of one 4x4 block.
+static void ssimBlocks(const SsimColumns &columns, int blocks, SsimSums *sums)
+{
+    for (int i = 0; i < blocks; ++i)
+    {
+        const int x = i * 4;
+        SsimSums &block = sums[i];
+        block.a = columns.a[x] + columns.a[x + 1] + columns.a[x + 2] + columns.a[x + 3];
+        block.b = columns.b[x] + columns.b[x + 1] + columns.b[x + 2] + columns.b[x + 3];
+        block.aa = columns.aa[x] + columns.aa[x + 1] + columns.aa[x + 2] + columns.aa[x + 3];
+        block.bb = columns.bb[x] + columns.bb[x + 1] + columns.bb[x + 2] + columns.bb[x + 3];
+        block.ab = columns.ab[x] + columns.ab[x + 1] + columns.ab[x + 2] + columns.ab[x + 3];
+    }
+}
+
+/**
+ * Luminance and contrast-structure terms of a window of samples pixels, with the SSIM constants
+ * C1 = (0.01 * 255)^2 and C2 = (0.03 * 255)^2 scaled by samples^2 so the sums don't have to be normalized.
+ */
+template <typename T>
+static void ssimWindow(const BasicSsimSums<T> &sums, double samples, double &luminance, double &contrastStructure)
+{
+    const double c1 = 6.5025 * samples * samples;
+    const double c2 = 58.5225 * samples * samples;
+    const double sa = sums.a;
+    const double sb = sums.b;
+    const double meanAB = sa * sb;
+    const double meanAA = sa * sa;
+    const double meanBB = sb * sb;
+    luminance = (2.0 * meanAB + c1) / (meanAA + meanBB + c1);
+    contrastStructure = (2.0 * (samples * sums.ab - meanAB) + c2) /
+                        (samples * (static_cast<double>(sums.aa) + sums.bb) - meanAA - meanBB + c2);
+}
+
+/**
+ * Returns the mean SSIM of the 8x8 windows of the planes, contrastStructure receives the mean contrast-structure
+ * term that MS-SSIM uses for all but the coarsest scale. Planes smaller than one window are compared as one window.
+ */
+static double planeSsim(const uint8_t *a,
+                        int strideA,
+                        const uint8_t *b,
+                        int strideB,
+                        int width,
+                        int height,
+                        double *contrastStructure)
+{
+    const int blocksX = width / 4;
+    const int blocksY = height / 4;
+    double luminance = 1.0;
+    double cs = 1.0;
+    if (blocksX < 2 || blocksY < 2)
+    {
+        // a thin plane can be arbitrarily long, its squares overflow 32 bit sums from about 66000 pixels on
+        BasicSsimSums<uint64_t> sums;
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const uint64_t va = a[y * strideA + x];
+                const uint64_t vb = b[y * strideB + x];
+                sums.a += va;
+                sums.b += vb;
+                sums.aa += va * va;
+                sums.bb += vb * vb;
+                sums.ab += va * vb;
+            }
+        }
+        ssimWindow(sums, static_cast<double>(width) * height, luminance, cs);
+        if (contrastStructure)
+        {
+            *contrastStructure = cs;
+        }
+        return luminance * cs;
+    }
+
+    static thread_local SsimColumns columns;
+    static thread_local std::vector<SsimSums> blockRows;
+    columns.resize(blocksX * 4);
+    blockRows.resize(2 * blocksX);
+    SsimSums *previous = blockRows.data();
+    SsimSums *current = previous + blocksX;
+    double ssimSum = 0.0;
+    double csSum = 0.0;
+    for (int blockY = 0; blockY < blocksY; ++blockY)
+    {
+        ssimColumns(a + blockY * 4 * strideA, strideA, b + blockY * 4 * strideB, strideB, blocksX * 4, columns);
+        ssimBlocks(columns, blocksX, current);
+        if (blockY > 0)
+        {
+            for (int i = 0; i + 1 < blocksX; ++i)
+            {
+                SsimSums window;
+                window.a = previous[i].a + previous[i + 1].a + current[i].a + current[i + 1].a;
+                window.b = previous[i].b + previous[i + 1].b + current[i].b + current[i + 1].b;
+                window.aa = previous[i].aa + previous[i + 1].aa + current[i].aa + current[i + 1].aa;
+                window.bb = previous[i].bb + previous[i + 1].bb + current[i].bb + current[i + 1].bb;
+                window.ab = previous[i].ab + previous[i + 1].ab + current[i].ab + current[i + 1].ab;
+                ssimWindow(window, 64.0, luminance, cs);
+                ssimSum += luminance * cs;
+                csSum += cs;
+            }
+        }
+        std::swap(previous, current);
+    }
+    const double windows = static_cast<double>(blocksX - 1) * (blocksY - 1);
+    if (contrastStructure)
+    {
+        *contrastStructure = csSum / windows;
+    }
+    return ssimSum / windows;
+}
 } // namespace detail
 
 int ExtractBuffer(const std::shared_ptr<I420BufferInterface> &input_frame, size_t size, uint8_t *buffer)
@@ -261,9 +980,7 @@ double I420PSNR(const I420BufferInterface &ref_buffer, const I420BufferInterface
     OCTK_DCHECK_GE(ref_buffer.height(), test_buffer.height());
     if ((ref_buffer.width() != test_buffer.width()) || (ref_buffer.height() != test_buffer.height()))
     {
-        std::shared_ptr<I420Buffer> scaled_buffer = I420Buffer::create(ref_buffer.width(), ref_buffer.height());
-        scaled_buffer->scaleFrom(test_buffer);
-        return I420PSNR(ref_buffer, *scaled_buffer);
+        return I420PSNR(ref_buffer, detail::scaledForComparison(test_buffer, ref_buffer.width(), ref_buffer.height()));
     }
     double psnr = libyuv::I420Psnr(ref_buffer.dataY(),
                                    ref_buffer.strideY(),
@@ -300,9 +1017,8 @@ double I420WeightedPSNR(const I420BufferInterface &ref_buffer, const I420BufferI
     OCTK_DCHECK_GE(ref_buffer.height(), test_buffer.height());
     if ((ref_buffer.width() != test_buffer.width()) || (ref_buffer.height() != test_buffer.height()))
     {
-        std::shared_ptr<I420Buffer> scaled_ref_buffer = I420Buffer::create(test_buffer.width(), test_buffer.height());
-        scaled_ref_buffer->scaleFrom(ref_buffer);
-        return I420WeightedPSNR(*scaled_ref_buffer, test_buffer);
+        return I420WeightedPSNR(detail::scaledForComparison(ref_buffer, test_buffer.width(), test_buffer.height()),
+                                test_buffer);
     }
 
     // Luma.
@@ -395,9 +1111,7 @@ double I420SSIM(const I420BufferInterface &ref_buffer, const I420BufferInterface
     OCTK_DCHECK_GE(ref_buffer.height(), test_buffer.height());
     if ((ref_buffer.width() != test_buffer.width()) || (ref_buffer.height() != test_buffer.height()))
     {
-        std::shared_ptr<I420Buffer> scaled_buffer = I420Buffer::create(ref_buffer.width(), ref_buffer.height());
-        scaled_buffer->scaleFrom(test_buffer);
-        return I420SSIM(ref_buffer, *scaled_buffer);
+        return I420SSIM(ref_buffer, detail::scaledForComparison(test_buffer, ref_buffer.width(), ref_buffer.height()));
     }
     return libyuv::I420Ssim(ref_buffer.dataY(),
                             ref_buffer.strideY(),
@@ -523,18 +1237,24 @@ void NV12ToI420Scaler::NV12ToI420Scale(const uint8_t *src_y,
         // No scaling.
         tmp_uv_planes_.clear();
         tmp_uv_planes_.shrink_to_fit();
-        libyuv::NV12ToI420(src_y,
-                           src_stride_y,
-                           src_uv,
-                           src_stride_uv,
-                           dst_y,
-                           dst_stride_y,
-                           dst_u,
-                           dst_stride_u,
-                           dst_v,
-                           dst_stride_v,
-                           src_width,
-                           src_height);
+        detail::runSlices(src_width,
+                          src_height,
+                          src_width * 3,
+                          [&](int y, int rows)
+                          {
+                              libyuv::NV12ToI420(src_y + src_stride_y * y,
+                                                 src_stride_y,
+                                                 src_uv + src_stride_uv * (y / 2),
+                                                 src_stride_uv,
+                                                 dst_y + dst_stride_y * y,
+                                                 dst_stride_y,
+                                                 dst_u + dst_stride_u * (y / 2),
+                                                 dst_stride_u,
+                                                 dst_v + dst_stride_v * (y / 2),
+                                                 dst_stride_v,
+                                                 src_width,
+                                                 rows);
+                          });
         return;
     }
 
@@ -548,30 +1268,60 @@ void NV12ToI420Scaler::NV12ToI420Scale(const uint8_t *src_y,
     // Split source UV plane into separate U and V plane using the temporary data.
     uint8_t *const src_u = tmp_uv_planes_.data();
     uint8_t *const src_v = tmp_uv_planes_.data() + src_uv_width * src_uv_height;
-    libyuv::SplitUVPlane(src_uv, src_stride_uv, src_u, src_uv_width, src_v, src_uv_width, src_uv_width, src_uv_height);
+    detail::runSlices(src_width,
+                      src_uv_height,
+                      src_uv_width * 4,
+                      [&](int y, int rows)
+                      {
+                          libyuv::SplitUVPlane(src_uv + src_stride_uv * y,
+                                               src_stride_uv,
+                                               src_u + src_uv_width * y,
+                                               src_uv_width,
+                                               src_v + src_uv_width * y,
+                                               src_uv_width,
+                                               src_uv_width,
+                                               rows);
+                      },
+                      1);
 
     // Scale the planes into the destination.
-    libyuv::I420Scale(src_y,
-                      src_stride_y,
-                      src_u,
-                      src_uv_width,
-                      src_v,
-                      src_uv_width,
-                      src_width,
-                      src_height,
-                      dst_y,
-                      dst_stride_y,
-                      dst_u,
-                      dst_stride_u,
-                      dst_v,
-                      dst_stride_v,
-                      dst_width,
-                      dst_height,
-                      libyuv::kFilterBox);
+    yuv::scaleI420(src_y,
+                   src_stride_y,
+                   src_u,
+                   src_uv_width,
+                   src_v,
+                   src_uv_width,
+                   src_width,
+                   src_height,
+                   dst_y,
+                   dst_stride_y,
+                   dst_u,
+                   dst_stride_u,
+                   dst_v,
+                   dst_stride_v,
+                   dst_width,
+                   dst_height,
+                   yuv::FilterMode::kFilterBox);
 }
 
 namespace yuv
 {
+void setSliceOptions(const SliceOptions &options)
+{
+    detail::sliceCount().store(options.sliceCount);
+    detail::sliceCacheBytes().store(options.sliceCacheBytes);
+    detail::minSlicedPixels().store(options.minSlicedPixels);
+}
+
+SliceOptions sliceOptions()
+{
+    SliceOptions options;
+    options.sliceCount = detail::sliceCount().load();
+    options.sliceCacheBytes = detail::sliceCacheBytes().load();
+    options.minSlicedPixels = detail::minSlicedPixels().load();
+    return options;
+}
+
 void scaleI420(const uint8_t *srcY,
                int srcStrideY,
                const uint8_t *srcU,
@@ -590,23 +1340,84 @@ void scaleI420(const uint8_t *srcY,
                int dstHeight,
                FilterMode filtering)
 {
-    libyuv::I420Scale(srcY,
-                      srcStrideY,
-                      srcU,
-                      srcStrideU,
-                      srcV,
-                      srcStrideV,
-                      srcWidth,
-                      srcHeight,
-                      dstY,
-                      dstStrideY,
-                      dstU,
-                      dstStrideU,
-                      dstV,
-                      dstStrideV,
-                      dstWidth,
+    const auto filter = static_cast<libyuv::FilterMode>(filtering);
+    const int rowAlignment = detail::scaleRowAlignment(srcHeight, dstHeight);
+    if (rowAlignment)
+    {
+        detail::runSlices(dstWidth,
+                          dstHeight,
+                          dstWidth * 3 / 2 + srcWidth * 3 * srcHeight / dstHeight / 2,
+                          [&](int y, int rows)
+                          {
+                              const int srcRow = y * (srcHeight / 2) / (dstHeight / 2);
+                              const int srcRows = rows * (srcHeight / 2) / (dstHeight / 2);
+                              libyuv::I420Scale(srcY + srcStrideY * srcRow,
+                                                srcStrideY,
+                                                srcU + srcStrideU * (srcRow / 2),
+                                                srcStrideU,
+                                                srcV + srcStrideV * (srcRow / 2),
+                                                srcStrideV,
+                                                srcWidth,
+                                                srcRows,
+                                                dstY + dstStrideY * y,
+                                                dstStrideY,
+                                                dstU + dstStrideU * (y / 2),
+                                                dstStrideU,
+                                                dstV + dstStrideV * (y / 2),
+                                                dstStrideV,
+                                                dstWidth,
+                                                rows,
+                                                filter);
+                          },
+                          rowAlignment);
+        return;
+    }
+    const int srcChromaWidth = (srcWidth + 1) / 2;
+    const int srcChromaHeight = (srcHeight + 1) / 2;
+    const int dstChromaWidth = (dstWidth + 1) / 2;
+    const int dstChromaHeight = (dstHeight + 1) / 2;
+    detail::runPlanes(dstWidth,
                       dstHeight,
-                      static_cast<libyuv::FilterMode>(filtering));
+                      3,
+                      [&](int plane)
+                      {
+                          switch (plane)
+                          {
+                              case 0:
+                                  libyuv::ScalePlane(srcY,
+                                                     srcStrideY,
+                                                     srcWidth,
+                                                     srcHeight,
+                                                     dstY,
+                                                     dstStrideY,
+                                                     dstWidth,
+                                                     dstHeight,
+                                                     filter);
+                                  break;
+                              case 1:
+                                  libyuv::ScalePlane(srcU,
+                                                     srcStrideU,
+                                                     srcChromaWidth,
+                                                     srcChromaHeight,
+                                                     dstU,
+                                                     dstStrideU,
+                                                     dstChromaWidth,
+                                                     dstChromaHeight,
+                                                     filter);
+                                  break;
+                              default:
+                                  libyuv::ScalePlane(srcV,
+                                                     srcStrideV,
+                                                     srcChromaWidth,
+                                                     srcChromaHeight,
+                                                     dstV,
+                                                     dstStrideV,
+                                                     dstChromaWidth,
+                                                     dstChromaHeight,
+                                                     filter);
+                                  break;
+                          }
+                      });
 }
 
 void scaleI420(const uint8_t *srcBuffer,
@@ -617,23 +1428,23 @@ void scaleI420(const uint8_t *srcBuffer,
                int dstHeight,
                bool highestQuality)
 {
-    libyuv::I420Scale(OCTK_I420_Y_PTR(srcBuffer, srcWidth, srcHeight),
-                      OCTK_I420_Y_STRIDE(srcWidth),
-                      OCTK_I420_U_PTR(srcBuffer, srcWidth, srcHeight),
-                      OCTK_I420_U_STRIDE(srcWidth),
-                      OCTK_I420_V_PTR(srcBuffer, srcWidth, srcHeight),
-                      OCTK_I420_V_STRIDE(srcWidth),
-                      srcWidth,
-                      srcHeight,
-                      OCTK_I420_Y_PTR(dstBuffer, dstWidth, dstHeight),
-                      OCTK_I420_Y_STRIDE(dstWidth),
-                      OCTK_I420_U_PTR(dstBuffer, dstWidth, dstHeight),
-                      OCTK_I420_U_STRIDE(dstWidth),
-                      OCTK_I420_V_PTR(dstBuffer, dstWidth, dstHeight),
-                      OCTK_I420_V_STRIDE(dstWidth),
-                      dstWidth,
-                      dstHeight,
-                      highestQuality ? libyuv::kFilterBox : libyuv::kFilterBilinear);
+    scaleI420(OCTK_I420_Y_PTR(srcBuffer, srcWidth, srcHeight),
+              OCTK_I420_Y_STRIDE(srcWidth),
+              OCTK_I420_U_PTR(srcBuffer, srcWidth, srcHeight),
+              OCTK_I420_U_STRIDE(srcWidth),
+              OCTK_I420_V_PTR(srcBuffer, srcWidth, srcHeight),
+              OCTK_I420_V_STRIDE(srcWidth),
+              srcWidth,
+              srcHeight,
+              OCTK_I420_Y_PTR(dstBuffer, dstWidth, dstHeight),
+              OCTK_I420_Y_STRIDE(dstWidth),
+              OCTK_I420_U_PTR(dstBuffer, dstWidth, dstHeight),
+              OCTK_I420_U_STRIDE(dstWidth),
+              OCTK_I420_V_PTR(dstBuffer, dstWidth, dstHeight),
+              OCTK_I420_V_STRIDE(dstWidth),
+              dstWidth,
+              dstHeight,
+              highestQuality ? FilterMode::kFilterBox : FilterMode::kFilterBilinear);
 }
 
 void scaleARGB(const uint8_t *srcBuffer,
@@ -644,15 +1455,27 @@ void scaleARGB(const uint8_t *srcBuffer,
                int dstHeight,
                bool highestQuality)
 {
-    libyuv::ARGBScale(srcBuffer,
-                      OCTK_ARGB_STRIDE(srcWidth),
-                      srcWidth,
-                      srcHeight,
-                      dstBuffer,
-                      OCTK_ARGB_STRIDE(dstWidth),
-                      dstWidth,
+    // The clip variant samples every destination row like a full scale does, so any ratio can be sliced.
+    detail::runSlices(dstWidth,
                       dstHeight,
-                      highestQuality ? libyuv::kFilterBox : libyuv::kFilterBilinear);
+                      OCTK_ARGB_STRIDE(dstWidth) + OCTK_ARGB_STRIDE(srcWidth) * std::max(srcHeight / dstHeight, 1),
+                      [&](int y, int rows)
+                      {
+                          libyuv::ARGBScaleClip(srcBuffer,
+                                                OCTK_ARGB_STRIDE(srcWidth),
+                                                srcWidth,
+                                                srcHeight,
+                                                dstBuffer,
+                                                OCTK_ARGB_STRIDE(dstWidth),
+                                                dstWidth,
+                                                dstHeight,
+                                                0,
+                                                y,
+                                                dstWidth,
+                                                rows,
+                                                highestQuality ? libyuv::kFilterBox : libyuv::kFilterBilinear);
+                      },
+                      1);
 }
 
 void scaleNV12(const uint8_t *srcBuffer,
@@ -663,19 +1486,64 @@ void scaleNV12(const uint8_t *srcBuffer,
                int dstHeight,
                bool highestQuality)
 {
-    libyuv::NV12Scale(OCTK_NV12_Y_PTR(srcBuffer, srcWidth, srcHeight),
-                      OCTK_NV12_Y_STRIDE(srcWidth),
-                      OCTK_NV12_UV_PTR(srcBuffer, srcWidth, srcHeight),
-                      OCTK_NV12_UV_STRIDE(srcWidth),
-                      srcWidth,
-                      srcHeight,
-                      OCTK_NV12_Y_PTR(dstBuffer, dstWidth, dstHeight),
-                      OCTK_NV12_Y_STRIDE(dstWidth),
-                      OCTK_NV12_UV_PTR(dstBuffer, dstWidth, dstHeight),
-                      OCTK_NV12_UV_STRIDE(dstWidth),
-                      dstWidth,
+    const auto filter = highestQuality ? libyuv::kFilterBox : libyuv::kFilterBilinear;
+    const int rowAlignment = detail::scaleRowAlignment(srcHeight, dstHeight);
+    if (rowAlignment)
+    {
+        detail::runSlices(dstWidth,
+                          dstHeight,
+                          dstWidth * 3 / 2 + srcWidth * 3 * srcHeight / dstHeight / 2,
+                          [&](int y, int rows)
+                          {
+                              const int srcRow = y * (srcHeight / 2) / (dstHeight / 2);
+                              const int srcRows = rows * (srcHeight / 2) / (dstHeight / 2);
+                              libyuv::NV12Scale(OCTK_NV12_Y_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, 0, srcRow),
+                                                OCTK_NV12_Y_STRIDE(srcWidth),
+                                                OCTK_NV12_UV_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, 0, srcRow),
+                                                OCTK_NV12_UV_STRIDE(srcWidth),
+                                                srcWidth,
+                                                srcRows,
+                                                OCTK_NV12_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, 0, y),
+                                                OCTK_NV12_Y_STRIDE(dstWidth),
+                                                OCTK_NV12_UV_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, 0, y),
+                                                OCTK_NV12_UV_STRIDE(dstWidth),
+                                                dstWidth,
+                                                rows,
+                                                filter);
+                          },
+                          rowAlignment);
+        return;
+    }
+    detail::runPlanes(dstWidth,
                       dstHeight,
-                      highestQuality ? libyuv::kFilterBox : libyuv::kFilterBilinear);
+                      2,
+                      [&](int plane)
+                      {
+                          if (0 == plane)
+                          {
+                              libyuv::ScalePlane(OCTK_NV12_Y_PTR(srcBuffer, srcWidth, srcHeight),
+                                                 OCTK_NV12_Y_STRIDE(srcWidth),
+                                                 srcWidth,
+                                                 srcHeight,
+                                                 OCTK_NV12_Y_PTR(dstBuffer, dstWidth, dstHeight),
+                                                 OCTK_NV12_Y_STRIDE(dstWidth),
+                                                 dstWidth,
+                                                 dstHeight,
+                                                 filter);
+                          }
+                          else
+                          {
+                              libyuv::UVScale(OCTK_NV12_UV_PTR(srcBuffer, srcWidth, srcHeight),
+                                              OCTK_NV12_UV_STRIDE(srcWidth),
+                                              (srcWidth + 1) / 2,
+                                              (srcHeight + 1) / 2,
+                                              OCTK_NV12_UV_PTR(dstBuffer, dstWidth, dstHeight),
+                                              OCTK_NV12_UV_STRIDE(dstWidth),
+                                              (dstWidth + 1) / 2,
+                                              (dstHeight + 1) / 2,
+                                              filter);
+                          }
+                      });
 }
 
 void copyI420(const uint8_t *srcDataY,
@@ -716,19 +1584,7 @@ void copyCenterInI420(const uint8_t *srcBuffer,
                       int dstWidth,
                       int dstHeight)
 {
-    libyuv::I420Rect(OCTK_I420_Y_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_Y_STRIDE(dstWidth),
-                     OCTK_I420_U_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_U_STRIDE(dstWidth),
-                     OCTK_I420_V_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_V_STRIDE(dstWidth),
-                     0,
-                     0,
-                     dstWidth,
-                     dstHeight,
-                     0,
-                     128,
-                     128);
+    detail::fillI420(dstBuffer, dstWidth, dstHeight);
 
     const int fixWidth = std::min(srcWidth, dstWidth);
     const int fixHeight = std::min(srcHeight, dstHeight);
@@ -736,20 +1592,28 @@ void copyCenterInI420(const uint8_t *srcBuffer,
     const int yOffset = srcHeight > dstHeight ? (srcHeight - dstHeight) / 2 : 0;
     const int dstXOffset = srcWidth < dstWidth ? (dstWidth - srcWidth) / 2 : 0;
     const int dstYOffset = srcHeight < dstHeight ? (dstHeight - srcHeight) / 2 : 0;
-    libyuv::I420Copy(OCTK_I420_Y_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, yOffset),
-                     OCTK_I420_Y_STRIDE(srcWidth),
-                     OCTK_I420_U_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, yOffset),
-                     OCTK_I420_U_STRIDE(srcWidth),
-                     OCTK_I420_V_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, yOffset),
-                     OCTK_I420_V_STRIDE(srcWidth),
-                     OCTK_I420_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                     OCTK_I420_Y_STRIDE(dstWidth),
-                     OCTK_I420_U_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                     OCTK_I420_U_STRIDE(dstWidth),
-                     OCTK_I420_V_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                     OCTK_I420_V_STRIDE(dstWidth),
-                     fixWidth,
-                     fixHeight);
+    detail::runSlices(fixWidth,
+                      fixHeight,
+                      fixWidth * 3,
+                      [&](int y, int rows)
+                      {
+                          const int srcY = yOffset + y;
+                          const int dstY = dstYOffset + y;
+                          libyuv::I420Copy(OCTK_I420_Y_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, srcY),
+                                           OCTK_I420_Y_STRIDE(srcWidth),
+                                           OCTK_I420_U_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, srcY),
+                                           OCTK_I420_U_STRIDE(srcWidth),
+                                           OCTK_I420_V_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, srcY),
+                                           OCTK_I420_V_STRIDE(srcWidth),
+                                           OCTK_I420_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                           OCTK_I420_Y_STRIDE(dstWidth),
+                                           OCTK_I420_U_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                           OCTK_I420_U_STRIDE(dstWidth),
+                                           OCTK_I420_V_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                           OCTK_I420_V_STRIDE(dstWidth),
+                                           fixWidth,
+                                           rows);
+                      });
 }
 
 void copyCenterInNV12(const uint8_t *srcBuffer,
@@ -759,16 +1623,22 @@ void copyCenterInNV12(const uint8_t *srcBuffer,
                       int dstWidth,
                       int dstHeight)
 {
-    libyuv::SetPlane(OCTK_NV12_Y_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_NV12_Y_STRIDE(dstWidth),
-                     dstWidth,
-                     dstHeight,
-                     16);
-    libyuv::SetPlane(OCTK_NV12_UV_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_NV12_UV_STRIDE(dstWidth),
-                     dstWidth,
-                     dstHeight / 2,
-                     128);
+    detail::runSlices(dstWidth,
+                      dstHeight,
+                      dstWidth * 3 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::SetPlane(OCTK_NV12_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, 0, y),
+                                           OCTK_NV12_Y_STRIDE(dstWidth),
+                                           dstWidth,
+                                           rows,
+                                           16);
+                          libyuv::SetPlane(OCTK_NV12_UV_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, 0, y),
+                                           OCTK_NV12_UV_STRIDE(dstWidth),
+                                           dstWidth,
+                                           rows / 2,
+                                           128);
+                      });
 
     const int fixWidth = std::min(srcWidth, dstWidth);
     const int fixHeight = std::min(srcHeight, dstHeight);
@@ -776,16 +1646,24 @@ void copyCenterInNV12(const uint8_t *srcBuffer,
     const int yOffset = srcHeight > dstHeight ? (srcHeight - dstHeight) / 2 : 0;
     const int dstXOffset = srcWidth < dstWidth ? (dstWidth - srcWidth) / 2 : 0;
     const int dstYOffset = srcHeight < dstHeight ? (dstHeight - srcHeight) / 2 : 0;
-    libyuv::NV12Copy(OCTK_NV12_Y_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, yOffset),
-                     OCTK_NV12_Y_STRIDE(srcWidth),
-                     OCTK_NV12_UV_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, yOffset),
-                     OCTK_NV12_UV_STRIDE(srcWidth),
-                     OCTK_NV12_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                     OCTK_NV12_Y_STRIDE(dstWidth),
-                     OCTK_NV12_UV_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                     OCTK_NV12_UV_STRIDE(dstWidth),
-                     fixWidth,
-                     fixHeight);
+    detail::runSlices(fixWidth,
+                      fixHeight,
+                      fixWidth * 3,
+                      [&](int y, int rows)
+                      {
+                          const int srcY = yOffset + y;
+                          const int dstY = dstYOffset + y;
+                          libyuv::NV12Copy(OCTK_NV12_Y_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, srcY),
+                                           OCTK_NV12_Y_STRIDE(srcWidth),
+                                           OCTK_NV12_UV_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, srcY),
+                                           OCTK_NV12_UV_STRIDE(srcWidth),
+                                           OCTK_NV12_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                           OCTK_NV12_Y_STRIDE(dstWidth),
+                                           OCTK_NV12_UV_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                           OCTK_NV12_UV_STRIDE(dstWidth),
+                                           fixWidth,
+                                           rows);
+                      });
 }
 
 void copyCenterInARGB(const uint8_t *srcBuffer,
@@ -795,7 +1673,12 @@ void copyCenterInARGB(const uint8_t *srcBuffer,
                       int dstWidth,
                       int dstHeight)
 {
-    libyuv::ARGBRect(dstBuffer, OCTK_ARGB_STRIDE(dstWidth), 0, 0, dstWidth, dstHeight, 0);
+    detail::runSlices(dstWidth,
+                      dstHeight,
+                      OCTK_ARGB_STRIDE(dstWidth),
+                      [&](int y, int rows)
+                      { libyuv::ARGBRect(dstBuffer, OCTK_ARGB_STRIDE(dstWidth), 0, y, dstWidth, rows, 0); },
+                      1);
 
     const int fixWidth = std::min(srcWidth, dstWidth);
     const int fixHeight = std::min(srcHeight, dstHeight);
@@ -803,12 +1686,21 @@ void copyCenterInARGB(const uint8_t *srcBuffer,
     const int yOffset = srcHeight > dstHeight ? (srcHeight - dstHeight) / 2 : 0;
     const int dstXOffset = srcWidth < dstWidth ? (dstWidth - srcWidth) / 2 : 0;
     const int dstYOffset = srcHeight < dstHeight ? (dstHeight - srcHeight) / 2 : 0;
-    libyuv::ARGBCopy(OCTK_ARGB_OFFSET_PTR(srcBuffer, srcWidth, xOffset, yOffset),
-                     OCTK_ARGB_STRIDE(srcWidth),
-                     OCTK_ARGB_OFFSET_PTR(dstBuffer, dstWidth, dstXOffset, dstYOffset),
-                     OCTK_ARGB_STRIDE(dstWidth),
-                     fixWidth,
-                     fixHeight);
+    detail::runSlices(fixWidth,
+                      fixHeight,
+                      OCTK_ARGB_STRIDE(fixWidth) * 2,
+                      [&](int y, int rows)
+                      {
+                          const int srcY = yOffset + y;
+                          const int dstY = dstYOffset + y;
+                          libyuv::ARGBCopy(OCTK_ARGB_OFFSET_PTR(srcBuffer, srcWidth, xOffset, srcY),
+                                           OCTK_ARGB_STRIDE(srcWidth),
+                                           OCTK_ARGB_OFFSET_PTR(dstBuffer, dstWidth, dstXOffset, dstY),
+                                           OCTK_ARGB_STRIDE(dstWidth),
+                                           fixWidth,
+                                           rows);
+                      },
+                      1);
 }
 
 bool convertToI420(const uint8_t *sample,
@@ -828,237 +1720,393 @@ bool convertToI420(const uint8_t *sample,
                    VideoRotation rotation,
                    VideoType videoType)
 {
-    return 0 == libyuv::ConvertToI420(sample,
-                                      sampleSize,
-                                      dstY,
-                                      dstStrideY,
-                                      dstU,
-                                      dstStrideU,
-                                      dstV,
-                                      dstStrideV,
-                                      cropX,
-                                      cropY,
-                                      srcWidth,
-                                      srcHeight,
-                                      cropWidth,
-                                      cropHeight,
-                                      static_cast<libyuv::RotationMode>(rotation),
-                                      detail::videoTypeToFourCC(videoType));
+    const auto fourcc = detail::videoTypeToFourCC(videoType);
+    // Rotated, flipped and compressed samples are converted as a whole.
+    if (VideoRotation::kAngle0 != rotation || libyuv::FOURCC_MJPG == fourcc || srcHeight <= 0 ||
+        cropHeight <= 0 || cropY % 2)
+    {
+        return 0 == libyuv::ConvertToI420(sample,
+                                          sampleSize,
+                                          dstY,
+                                          dstStrideY,
+                                          dstU,
+                                          dstStrideU,
+                                          dstV,
+                                          dstStrideV,
+                                          cropX,
+                                          cropY,
+                                          srcWidth,
+                                          srcHeight,
+                                          cropWidth,
+                                          cropHeight,
+                                          static_cast<libyuv::RotationMode>(rotation),
+                                          fourcc);
+    }
+    std::atomic<bool> success{true};
+    detail::runSlices(cropWidth,
+                      cropHeight,
+                      cropWidth * 3 / 2 + srcWidth * 4,
+                      [&](int y, int rows)
+                      {
+                          if (0 != libyuv::ConvertToI420(sample,
+                                                         sampleSize,
+                                                         dstY + dstStrideY * y,
+                                                         dstStrideY,
+                                                         dstU + dstStrideU * (y / 2),
+                                                         dstStrideU,
+                                                         dstV + dstStrideV * (y / 2),
+                                                         dstStrideV,
+                                                         cropX,
+                                                         cropY + y,
+                                                         srcWidth,
+                                                         srcHeight,
+                                                         cropWidth,
+                                                         rows,
+                                                         libyuv::kRotate0,
+                                                         fourcc))
+                          {
+                              success.store(false);
+                          }
+                      });
+    return success.load();
 }
 
 void convertI420ToARGB(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::I420ToARGB(OCTK_I420_Y_PTR(srcBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(srcBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(srcBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       dstBuffer,
-                       OCTK_ARGB_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::I420ToARGB(OCTK_I420_Y_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             OCTK_ARGB_OFFSET_PTR(dstBuffer, width, 0, y),
+                                             OCTK_ARGB_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertI420ToABGR(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::I420ToABGR(OCTK_I420_Y_PTR(srcBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(srcBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(srcBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       dstBuffer,
-                       OCTK_ARGB_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::I420ToABGR(OCTK_I420_Y_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             OCTK_ARGB_OFFSET_PTR(dstBuffer, width, 0, y),
+                                             OCTK_ARGB_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertI420ToBGRA(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::I420ToBGRA(OCTK_I420_Y_PTR(srcBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(srcBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(srcBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       dstBuffer,
-                       OCTK_ARGB_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::I420ToBGRA(OCTK_I420_Y_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             OCTK_ARGB_OFFSET_PTR(dstBuffer, width, 0, y),
+                                             OCTK_ARGB_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertI420ToRGBA(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::I420ToRGBA(OCTK_I420_Y_PTR(srcBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(srcBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(srcBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       dstBuffer,
-                       OCTK_ARGB_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::I420ToRGBA(OCTK_I420_Y_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             OCTK_ARGB_OFFSET_PTR(dstBuffer, width, 0, y),
+                                             OCTK_ARGB_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertI420ToRGB24(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::I420ToRGB24(OCTK_I420_Y_PTR(srcBuffer, width, height),
-                        OCTK_I420_Y_STRIDE(width),
-                        OCTK_I420_U_PTR(srcBuffer, width, height),
-                        OCTK_I420_U_STRIDE(width),
-                        OCTK_I420_V_PTR(srcBuffer, width, height),
-                        OCTK_I420_V_STRIDE(width),
-                        dstBuffer,
-                        width * 3,
-                        width,
-                        height);
+    detail::runSlices(width,
+                      height,
+                      width * 9 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::I420ToRGB24(OCTK_I420_Y_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                              OCTK_I420_Y_STRIDE(width),
+                                              OCTK_I420_U_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                              OCTK_I420_U_STRIDE(width),
+                                              OCTK_I420_V_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                              OCTK_I420_V_STRIDE(width),
+                                              dstBuffer + width * 3 * y,
+                                              width * 3,
+                                              width,
+                                              rows);
+                      });
 }
 
 void convertI420ToNV12(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::I420ToNV12(OCTK_I420_Y_PTR(srcBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(srcBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(srcBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       OCTK_NV12_Y_PTR(dstBuffer, width, height),
-                       OCTK_NV12_Y_STRIDE(width),
-                       OCTK_NV12_UV_PTR(dstBuffer, width, height),
-                       OCTK_NV12_UV_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 3,
+                      [&](int y, int rows)
+                      {
+                          libyuv::I420ToNV12(OCTK_I420_Y_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             OCTK_NV12_Y_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_NV12_Y_STRIDE(width),
+                                             OCTK_NV12_UV_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_NV12_UV_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
+// BGRA little endian (argb in memory) to ARGB.
 void convertBGRAToARGB(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::BGRAToARGB(srcBuffer, width * 4, dstBuffer, width * 4, width, height);
+    detail::runSlices(width,
+                      height,
+                      width * 8,
+                      [&](int y, int rows)
+                      {
+                          libyuv::BGRAToARGB(srcBuffer + width * 4 * y,
+                                             width * 4,
+                                             dstBuffer + width * 4 * y,
+                                             width * 4,
+                                             width,
+                                             rows);
+                      },
+                      1);
 }
 
+// ABGR little endian (rgba in memory) to ARGB.
 void convertABGRToARGB(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::ABGRToARGB(srcBuffer, width * 4, dstBuffer, width * 4, width, height);
+    detail::runSlices(width,
+                      height,
+                      width * 8,
+                      [&](int y, int rows)
+                      {
+                          libyuv::ABGRToARGB(srcBuffer + width * 4 * y,
+                                             width * 4,
+                                             dstBuffer + width * 4 * y,
+                                             width * 4,
+                                             width,
+                                             rows);
+                      },
+                      1);
 }
 
+// RGBA little endian (abgr in memory) to ARGB.
 void convertRGBAToARGB(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::RGBAToARGB(srcBuffer, width * 4, dstBuffer, width * 4, width, height);
+    detail::runSlices(width,
+                      height,
+                      width * 8,
+                      [&](int y, int rows)
+                      {
+                          libyuv::RGBAToARGB(srcBuffer + width * 4 * y,
+                                             width * 4,
+                                             dstBuffer + width * 4 * y,
+                                             width * 4,
+                                             width,
+                                             rows);
+                      },
+                      1);
 }
 
 void convertI420ToNV21(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::I420ToNV21(OCTK_I420_Y_PTR(srcBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(srcBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(srcBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       OCTK_NV21_Y_PTR(dstBuffer, width, height),
-                       OCTK_NV21_Y_STRIDE(width),
-                       OCTK_NV21_VU_PTR(dstBuffer, width, height),
-                       OCTK_NV21_VU_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 3,
+                      [&](int y, int rows)
+                      {
+                          libyuv::I420ToNV21(OCTK_I420_Y_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             OCTK_NV21_Y_PTR(dstBuffer, width, height) + width * y,
+                                             OCTK_NV21_Y_STRIDE(width),
+                                             OCTK_NV21_VU_PTR(dstBuffer, width, height) + width * (y / 2),
+                                             OCTK_NV21_VU_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertARGBToI420(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::ARGBToI420(srcBuffer,
-                       width * 4,
-                       OCTK_I420_Y_PTR(dstBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(dstBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(dstBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::ARGBToI420(srcBuffer + width * 4 * y,
+                                             width * 4,
+                                             OCTK_I420_Y_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertABGRToI420(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::ABGRToI420(srcBuffer,
-                       width * 4,
-                       OCTK_I420_Y_PTR(dstBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(dstBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(dstBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::ABGRToI420(srcBuffer + width * 4 * y,
+                                             width * 4,
+                                             OCTK_I420_Y_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertBGRAToI420(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::BGRAToI420(srcBuffer,
-                       width * 4,
-                       OCTK_I420_Y_PTR(dstBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(dstBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(dstBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::BGRAToI420(srcBuffer + width * 4 * y,
+                                             width * 4,
+                                             OCTK_I420_Y_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertRGBAToI420(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::RGBAToI420(srcBuffer,
-                       width * 4,
-                       OCTK_I420_Y_PTR(dstBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(dstBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(dstBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::RGBAToI420(srcBuffer + width * 4 * y,
+                                             width * 4,
+                                             OCTK_I420_Y_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertNV21ToI420(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::RGB24ToI420(srcBuffer,
-                        width * 3,
-                        OCTK_I420_Y_PTR(dstBuffer, width, height),
-                        OCTK_I420_Y_STRIDE(width),
-                        OCTK_I420_U_PTR(dstBuffer, width, height),
-                        OCTK_I420_U_STRIDE(width),
-                        OCTK_I420_V_PTR(dstBuffer, width, height),
-                        OCTK_I420_V_STRIDE(width),
-                        width,
-                        height);
+    detail::runSlices(width,
+                      height,
+                      width * 9 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::RGB24ToI420(srcBuffer + width * 3 * y,
+                                              width * 3,
+                                              OCTK_I420_Y_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                              OCTK_I420_Y_STRIDE(width),
+                                              OCTK_I420_U_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                              OCTK_I420_U_STRIDE(width),
+                                              OCTK_I420_V_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                              OCTK_I420_V_STRIDE(width),
+                                              width,
+                                              rows);
+                      });
 }
 
 void convertNV12ToI420(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::NV12ToI420(OCTK_NV12_Y_PTR(srcBuffer, width, height),
-                       OCTK_NV12_Y_STRIDE(width),
-                       OCTK_NV12_UV_PTR(srcBuffer, width, height),
-                       OCTK_NV12_UV_STRIDE(width),
-                       OCTK_I420_Y_PTR(dstBuffer, width, height),
-                       OCTK_I420_Y_STRIDE(width),
-                       OCTK_I420_U_PTR(dstBuffer, width, height),
-                       OCTK_I420_U_STRIDE(width),
-                       OCTK_I420_V_PTR(dstBuffer, width, height),
-                       OCTK_I420_V_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 3,
+                      [&](int y, int rows)
+                      {
+                          libyuv::NV12ToI420(OCTK_NV12_Y_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_NV12_Y_STRIDE(width),
+                                             OCTK_NV12_UV_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_NV12_UV_STRIDE(width),
+                                             OCTK_I420_Y_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_Y_STRIDE(width),
+                                             OCTK_I420_U_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_U_STRIDE(width),
+                                             OCTK_I420_V_OFFSET_PTR(dstBuffer, width, height, 0, y),
+                                             OCTK_I420_V_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertNV12ToARGB(const uint8_t *srcBuffer, uint8_t *dstBuffer, int width, int height)
 {
-    libyuv::NV12ToARGB(OCTK_NV12_Y_PTR(srcBuffer, width, height),
-                       OCTK_NV12_Y_STRIDE(width),
-                       OCTK_NV12_UV_PTR(srcBuffer, width, height),
-                       OCTK_NV12_UV_STRIDE(width),
-                       dstBuffer,
-                       OCTK_ARGB_STRIDE(width),
-                       width,
-                       height);
+    detail::runSlices(width,
+                      height,
+                      width * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          libyuv::NV12ToARGB(OCTK_NV12_Y_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_NV12_Y_STRIDE(width),
+                                             OCTK_NV12_UV_OFFSET_PTR(srcBuffer, width, height, 0, y),
+                                             OCTK_NV12_UV_STRIDE(width),
+                                             OCTK_ARGB_OFFSET_PTR(dstBuffer, width, 0, y),
+                                             OCTK_ARGB_STRIDE(width),
+                                             width,
+                                             rows);
+                      });
 }
 
 void convertCenterInARGBToI420(const uint8_t *srcBuffer,
@@ -1068,19 +2116,7 @@ void convertCenterInARGBToI420(const uint8_t *srcBuffer,
                                int dstWidth,
                                int dstHeight)
 {
-    libyuv::I420Rect(OCTK_I420_Y_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_Y_STRIDE(dstWidth),
-                     OCTK_I420_U_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_U_STRIDE(dstWidth),
-                     OCTK_I420_V_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_V_STRIDE(dstWidth),
-                     0,
-                     0,
-                     dstWidth,
-                     dstHeight,
-                     0,
-                     128,
-                     128);
+    detail::fillI420(dstBuffer, dstWidth, dstHeight);
 
     const int fixWidth = std::min(srcWidth, dstWidth);
     const int fixHeight = std::min(srcHeight, dstHeight);
@@ -1088,16 +2124,24 @@ void convertCenterInARGBToI420(const uint8_t *srcBuffer,
     const int yOffset = srcHeight > dstHeight ? (srcHeight - dstHeight) / 2 : 0;
     const int dstXOffset = srcWidth < dstWidth ? (dstWidth - srcWidth) / 2 : 0;
     const int dstYOffset = srcHeight < dstHeight ? (dstHeight - srcHeight) / 2 : 0;
-    libyuv::ARGBToI420(OCTK_ARGB_OFFSET_PTR(srcBuffer, srcWidth, xOffset, yOffset),
-                       OCTK_ARGB_STRIDE(srcWidth),
-                       OCTK_I420_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                       OCTK_I420_Y_STRIDE(dstWidth),
-                       OCTK_I420_U_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                       OCTK_I420_U_STRIDE(dstWidth),
-                       OCTK_I420_V_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                       OCTK_I420_V_STRIDE(dstWidth),
-                       fixWidth,
-                       fixHeight);
+    detail::runSlices(fixWidth,
+                      fixHeight,
+                      fixWidth * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          const int srcY = yOffset + y;
+                          const int dstY = dstYOffset + y;
+                          libyuv::ARGBToI420(OCTK_ARGB_OFFSET_PTR(srcBuffer, srcWidth, xOffset, srcY),
+                                             OCTK_ARGB_STRIDE(srcWidth),
+                                             OCTK_I420_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                             OCTK_I420_Y_STRIDE(dstWidth),
+                                             OCTK_I420_U_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                             OCTK_I420_U_STRIDE(dstWidth),
+                                             OCTK_I420_V_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                             OCTK_I420_V_STRIDE(dstWidth),
+                                             fixWidth,
+                                             rows);
+                      });
 }
 
 void convertCenterInRGBAToI420(const uint8_t *srcBuffer,
@@ -1107,19 +2151,7 @@ void convertCenterInRGBAToI420(const uint8_t *srcBuffer,
                                int dstWidth,
                                int dstHeight)
 {
-    libyuv::I420Rect(OCTK_I420_Y_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_Y_STRIDE(dstWidth),
-                     OCTK_I420_U_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_U_STRIDE(dstWidth),
-                     OCTK_I420_V_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_V_STRIDE(dstWidth),
-                     0,
-                     0,
-                     dstWidth,
-                     dstHeight,
-                     0,
-                     128,
-                     128);
+    detail::fillI420(dstBuffer, dstWidth, dstHeight);
 
     const int fixWidth = std::min(srcWidth, dstWidth);
     const int fixHeight = std::min(srcHeight, dstHeight);
@@ -1127,16 +2159,24 @@ void convertCenterInRGBAToI420(const uint8_t *srcBuffer,
     const int yOffset = srcHeight > dstHeight ? (srcHeight - dstHeight) / 2 : 0;
     const int dstXOffset = srcWidth < dstWidth ? (dstWidth - srcWidth) / 2 : 0;
     const int dstYOffset = srcHeight < dstHeight ? (dstHeight - srcHeight) / 2 : 0;
-    libyuv::RGBAToI420(OCTK_ARGB_OFFSET_PTR(srcBuffer, srcWidth, xOffset, yOffset),
-                       OCTK_ARGB_STRIDE(srcWidth),
-                       OCTK_I420_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                       OCTK_I420_Y_STRIDE(dstWidth),
-                       OCTK_I420_U_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                       OCTK_I420_U_STRIDE(dstWidth),
-                       OCTK_I420_V_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                       OCTK_I420_V_STRIDE(dstWidth),
-                       fixWidth,
-                       fixHeight);
+    detail::runSlices(fixWidth,
+                      fixHeight,
+                      fixWidth * 11 / 2,
+                      [&](int y, int rows)
+                      {
+                          const int srcY = yOffset + y;
+                          const int dstY = dstYOffset + y;
+                          libyuv::RGBAToI420(OCTK_ARGB_OFFSET_PTR(srcBuffer, srcWidth, xOffset, srcY),
+                                             OCTK_ARGB_STRIDE(srcWidth),
+                                             OCTK_I420_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                             OCTK_I420_Y_STRIDE(dstWidth),
+                                             OCTK_I420_U_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                             OCTK_I420_U_STRIDE(dstWidth),
+                                             OCTK_I420_V_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                             OCTK_I420_V_STRIDE(dstWidth),
+                                             fixWidth,
+                                             rows);
+                      });
 }
 
 void convertCenterInNV12ToI420(const uint8_t *srcBuffer,
@@ -1146,19 +2186,7 @@ void convertCenterInNV12ToI420(const uint8_t *srcBuffer,
                                int dstWidth,
                                int dstHeight)
 {
-    libyuv::I420Rect(OCTK_I420_Y_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_Y_STRIDE(dstWidth),
-                     OCTK_I420_U_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_U_STRIDE(dstWidth),
-                     OCTK_I420_V_PTR(dstBuffer, dstWidth, dstHeight),
-                     OCTK_I420_V_STRIDE(dstWidth),
-                     0,
-                     0,
-                     dstWidth,
-                     dstHeight,
-                     0,
-                     128,
-                     128);
+    detail::fillI420(dstBuffer, dstWidth, dstHeight);
 
     const int fixWidth = std::min(srcWidth, dstWidth);
     const int fixHeight = std::min(srcHeight, dstHeight);
@@ -1166,20 +2194,274 @@ void convertCenterInNV12ToI420(const uint8_t *srcBuffer,
     const int yOffset = srcHeight > dstHeight ? (srcHeight - dstHeight) / 2 : 0;
     const int dstXOffset = srcWidth < dstWidth ? (dstWidth - srcWidth) / 2 : 0;
     const int dstYOffset = srcHeight < dstHeight ? (dstHeight - srcHeight) / 2 : 0;
-    libyuv::NV12ToI420(OCTK_NV12_Y_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, yOffset),
-                       OCTK_NV12_Y_STRIDE(srcWidth),
-                       OCTK_NV12_UV_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, yOffset),
-                       OCTK_NV12_UV_STRIDE(srcWidth),
-                       OCTK_I420_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                       OCTK_I420_Y_STRIDE(dstWidth),
-                       OCTK_I420_U_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                       OCTK_I420_U_STRIDE(dstWidth),
-                       OCTK_I420_V_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstYOffset),
-                       OCTK_I420_V_STRIDE(dstWidth),
-                       fixWidth,
-                       fixHeight);
+    detail::runSlices(fixWidth,
+                      fixHeight,
+                      fixWidth * 3,
+                      [&](int y, int rows)
+                      {
+                          const int srcY = yOffset + y;
+                          const int dstY = dstYOffset + y;
+                          libyuv::NV12ToI420(OCTK_NV12_Y_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, srcY),
+                                             OCTK_NV12_Y_STRIDE(srcWidth),
+                                             OCTK_NV12_UV_OFFSET_PTR(srcBuffer, srcWidth, srcHeight, xOffset, srcY),
+                                             OCTK_NV12_UV_STRIDE(srcWidth),
+                                             OCTK_I420_Y_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                             OCTK_I420_Y_STRIDE(dstWidth),
+                                             OCTK_I420_U_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                             OCTK_I420_U_STRIDE(dstWidth),
+                                             OCTK_I420_V_OFFSET_PTR(dstBuffer, dstWidth, dstHeight, dstXOffset, dstY),
+                                             OCTK_I420_V_STRIDE(dstWidth),
+                                             fixWidth,
+                                             rows);
+                      });
+}
+
+bool cropScaleRotate(const ConstPlanes420 &src,
+                     int cropX,
+                     int cropY,
+                     int cropWidth,
+                     int cropHeight,
+                     const Planes420 &dst,
+                     VideoRotation rotation,
+                     FilterMode filtering)
+{
+    const auto isSupported = [](VideoType type) { return VideoType::kI420 == type || VideoType::kNV12 == type; };
+    if (!isSupported(src.type) || !isSupported(dst.type) || cropX < 0 || cropY < 0 || cropWidth <= 0 ||
+        cropHeight <= 0 || cropX + cropWidth > src.width || cropY + cropHeight > src.height || dst.width <= 0 ||
+        dst.height <= 0)
+    {
+        return false;
+    }
+    const bool transposed = VideoRotation::kAngle90 == rotation || VideoRotation::kAngle270 == rotation;
+    const int scaledWidth = transposed ? dst.height : dst.width;
+    const int scaledHeight = transposed ? dst.width : dst.height;
+    const auto cropped = detail::subPlanes(src, cropX / 2 * 2, cropY / 2 * 2, cropWidth, cropHeight);
+    const bool scaled = scaledWidth != cropWidth || scaledHeight != cropHeight;
+    const bool direct = VideoRotation::kAngle0 == rotation && src.type == dst.type;
+    if (scaled && direct && VideoType::kI420 == src.type)
+    {
+        scaleI420(cropped.dataY,
+                  cropped.strideY,
+                  cropped.dataU,
+                  cropped.strideU,
+                  cropped.dataV,
+                  cropped.strideV,
+                  cropWidth,
+                  cropHeight,
+                  dst.dataY,
+                  dst.strideY,
+                  dst.dataU,
+                  dst.strideU,
+                  dst.dataV,
+                  dst.strideV,
+                  dst.width,
+                  dst.height,
+                  filtering);
+        return true;
+    }
+
+    const auto filter = static_cast<libyuv::FilterMode>(filtering);
+    const int chromaWidth = (scaledWidth + 1) / 2;
+    auto strip = [&](int y, int rows)
+    {
+        const int chromaRows = (rows + 1) / 2;
+        std::unique_ptr<uint8_t[]> oversized;
+        uint8_t *scratch = detail::scratchBuffer(scaledWidth * rows + 4 * chromaWidth * chromaRows, oversized);
+        if (!scaled)
+        {
+            detail::rotateStrip(detail::subPlanes(cropped, 0, y, cropWidth, rows),
+                                dst,
+                                y,
+                                scaledHeight,
+                                rotation,
+                                scratch);
+            return;
+        }
+        // Rows of a strip map to whole source rows, see scaleRowAlignment().
+        const bool whole = rows == scaledHeight;
+        const int srcRow = whole ? 0 : y * (cropHeight / 2) / (scaledHeight / 2);
+        const int srcRows = whole ? cropHeight : rows * (cropHeight / 2) / (scaledHeight / 2);
+        const auto input = detail::subPlanes(cropped, 0, srcRow, cropWidth, srcRows);
+        Planes420 output;
+        if (direct)
+        {
+            output = detail::subPlanes(dst, 0, y, scaledWidth, rows);
+        }
+        else
+        {
+            output.type = src.type;
+            output.dataY = scratch;
+            output.strideY = scaledWidth;
+            output.dataU = scratch + scaledWidth * rows;
+            output.strideU = VideoType::kNV12 == src.type ? 2 * chromaWidth : chromaWidth;
+            output.dataV = VideoType::kNV12 == src.type ? nullptr : output.dataU + chromaWidth * chromaRows;
+            output.strideV = VideoType::kNV12 == src.type ? 0 : chromaWidth;
+            output.width = scaledWidth;
+            output.height = rows;
+        }
+        if (VideoType::kNV12 == src.type)
+        {
+            libyuv::NV12Scale(input.dataY,
+                              input.strideY,
+                              input.dataU,
+                              input.strideU,
+                              cropWidth,
+                              srcRows,
+                              output.dataY,
+                              output.strideY,
+                              output.dataU,
+                              output.strideU,
+                              scaledWidth,
+                              rows,
+                              filter);
+        }
+        else
+        {
+            libyuv::I420Scale(input.dataY,
+                              input.strideY,
+                              input.dataU,
+                              input.strideU,
+                              input.dataV,
+                              input.strideV,
+                              cropWidth,
+                              srcRows,
+                              output.dataY,
+                              output.strideY,
+                              output.dataU,
+                              output.strideU,
+                              output.dataV,
+                              output.strideV,
+                              scaledWidth,
+                              rows,
+                              filter);
+        }
+        if (!direct)
+        {
+            ConstPlanes420 scaledStrip;
+            scaledStrip.type = output.type;
+            scaledStrip.dataY = output.dataY;
+            scaledStrip.strideY = output.strideY;
+            scaledStrip.dataU = output.dataU;
+            scaledStrip.strideU = output.strideU;
+            scaledStrip.dataV = output.dataV;
+            scaledStrip.strideV = output.strideV;
+            scaledStrip.width = scaledWidth;
+            scaledStrip.height = rows;
+            detail::rotateStrip(scaledStrip,
+                                dst,
+                                y,
+                                scaledHeight,
+                                rotation,
+                                scratch + scaledWidth * rows + 2 * chromaWidth * chromaRows);
+        }
+    };
+    const int rowAlignment = scaled ? detail::scaleRowAlignment(cropHeight, scaledHeight) : (scaledHeight % 2 ? 0 : 2);
+    if (!rowAlignment)
+    {
+        strip(0, scaledHeight);
+        return true;
+    }
+    const int srcRowBytes = cropWidth * 3 * cropHeight / scaledHeight / 2;
+    detail::runSlices(scaledWidth, scaledHeight, 3 * scaledWidth + srcRowBytes, strip, rowAlignment);
+    return true;
+}
+
+uint64_t planeSumSquareError(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height)
+{
+    return libyuv::ComputeSumSquareErrorPlane(a, strideA, b, strideB, width, height);
 }
 
+double psnrFromSumSquareError(uint64_t sse, uint64_t samples)
+{
+    const double psnr = libyuv::SumSquareErrorToPsnr(sse, samples);
+    return (psnr > kPerfectPSNR) ? kPerfectPSNR : psnr;
+}
+
+double planeSSIM(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height)
+{
+    if (!a || !b || width <= 0 || height <= 0)
+    {
+        return 0.0;
+    }
+    return detail::planeSsim(a, strideA, b, strideB, width, height, nullptr);
+}
+
+double planeMSSSIM(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height)
+{
+    static const double kWeights[] = {0.0448, 0.2856, 0.3001, 0.2363, 0.1333};
+    static const int kScales = sizeof(kWeights) / sizeof(kWeights[0]);
+    if (!a || !b || width <= 0 || height <= 0)
+    {
+        return 0.0;
+    }
+
+    int scales = 1;
+    while (scales < kScales && (width >> scales) >= 8 && (height >> scales) >= 8)
+    {
+        ++scales;
+    }
+    double weightSum = 0.0;
+    for (int i = 0; i < scales; ++i)
+    {
+        weightSum += kWeights[i];
+    }
+
+    // Both images of all scales below the first one share one buffer per thread.
+    static thread_local std::vector<uint8_t> pyramid;
+    size_t pyramidSize = 0;
+    for (int i = 1; i < scales; ++i)
+    {
+        pyramidSize += 2 * static_cast<size_t>(width >> i) * (height >> i);
+    }
+    if (pyramid.size() < pyramidSize)
+    {
+        pyramid.resize(pyramidSize);
+    }
+
+    double msssim = 1.0;
+    uint8_t *next = pyramid.data();
+    for (int i = 0; i < scales; ++i)
+    {
+        double cs = 1.0;
+        const double ssim = detail::planeSsim(a, strideA, b, strideB, width, height, &cs);
+        if (i + 1 == scales)
+        {
+            msssim *= std::pow(std::max(ssim, 0.0), kWeights[i] / weightSum);
+            break;
+        }
+        msssim *= std::pow(std::max(cs, 0.0), kWeights[i] / weightSum);
+
+        // Even sizes keep the 2x2 box filter exact, an odd last row or column is dropped.
+        const int halfWidth = width / 2;
+        const int halfHeight = height / 2;
+        uint8_t *halfA = next;
+        uint8_t *halfB = halfA + halfWidth * halfHeight;
+        next = halfB + halfWidth * halfHeight;
+        libyuv::ScalePlane(a,
+                           strideA,
+                           halfWidth * 2,
+                           halfHeight * 2,
+                           halfA,
+                           halfWidth,
+                           halfWidth,
+                           halfHeight,
+                           libyuv::kFilterBox);
+        libyuv::ScalePlane(b,
+                           strideB,
+                           halfWidth * 2,
+                           halfHeight * 2,
+                           halfB,
+                           halfWidth,
+                           halfWidth,
+                           halfHeight,
+                           libyuv::kFilterBox);
+        a = halfA;
+        b = halfB;
+        strideA = strideB = width = halfWidth;
+        height = halfHeight;
+    }
+    return msssim;
+}
 } // namespace yuv
 } // namespace utils
 
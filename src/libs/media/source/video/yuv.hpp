@@ -171,6 +171,25 @@ enum class FilterMode
     kFilterBox = 3       // Highest quality.
 };
 
+/**
+ * Controls how the conversion and scaling functions below split a frame into horizontal slices that run on
+ * ThreadPool::defaultInstance(). The calling thread converts slices as well and returns once the whole frame is done.
+ * Downscales whose height ratio is exact in libyuv's 16.16 stepping are sliced by rows, other scales run their planes
+ * concurrently, so sliced results are bit-exact with a single threaded call.
+ */
+struct SliceOptions
+{
+    // Upper bound of slices converted at the same time, 0 uses ThreadPool::idealThreadCount(), 1 disables slicing.
+    int sliceCount = 0;
+    // Source and destination bytes one slice should touch, keeps the rows of a slice inside a per-core L2 cache.
+    int sliceCacheBytes = 256 * 1024;
+    // Frames with fewer destination pixels are converted on the calling thread only.
+    int minSlicedPixels = 640 * 360;
+};
+
+OCTK_MEDIA_API void setSliceOptions(const SliceOptions &options);
+OCTK_MEDIA_API SliceOptions sliceOptions();
+
 OCTK_MEDIA_API void scaleI420(const uint8_t *srcY,
                               int srcStrideY,
                               const uint8_t *srcU,
@@ -323,6 +342,73 @@ OCTK_MEDIA_API void convertCenterInNV12ToI420(const uint8_t *srcBuffer,
                                               uint8_t *dstBuffer,
                                               int dstWidth,
                                               int dstHeight);
+
+// Read only planes of a kI420 or kNV12 image, kNV12 images keep their interleaved chroma in dataU / strideU.
+struct ConstPlanes420
+{
+    VideoType type = VideoType::kI420;
+    const uint8_t *dataY = nullptr;
+    int strideY = 0;
+    const uint8_t *dataU = nullptr;
+    int strideU = 0;
+    const uint8_t *dataV = nullptr;
+    int strideV = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// Writable planes of a kI420 or kNV12 image, kNV12 images keep their interleaved chroma in dataU / strideU.
+struct Planes420
+{
+    VideoType type = VideoType::kI420;
+    uint8_t *dataY = nullptr;
+    int strideY = 0;
+    uint8_t *dataU = nullptr;
+    int strideU = 0;
+    uint8_t *dataV = nullptr;
+    int strideV = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * Crops src to the given rectangle, scales it so that after rotation it fills dst and writes it rotated and
+ * converted to the dst pixel format, without materializing a full frame between the steps.
+ * The frame is processed in horizontal strips of the scaled image: each strip is scaled into a cache sized scratch
+ * buffer and rotated or converted straight into its place in dst. Strips run on ThreadPool::defaultInstance() as
+ * configured by setSliceOptions(). Unscaled transforms read the source rows directly, unrotated scales between
+ * equal formats write straight into dst. Crop offsets are rounded down to even values to keep chroma aligned.
+ * Returns false if the formats are not kI420 / kNV12 or the crop rectangle doesn't fit into src.
+ */
+OCTK_MEDIA_API bool cropScaleRotate(const ConstPlanes420 &src,
+                                    int cropX,
+                                    int cropY,
+                                    int cropWidth,
+                                    int cropHeight,
+                                    const Planes420 &dst,
+                                    VideoRotation rotation,
+                                    FilterMode filtering = FilterMode::kFilterBox);
+/**
+ * Full reference plane metrics used by VideoQualityAnalyzer. The sum of squared errors runs on libyuv's SIMD
+ * kernels, SSIM compares 8x8 windows on a 4 pixel grid with AVX2, SSE2 or NEON kernels and reuses per thread
+ * buffers, so none of these functions allocate once a thread has seen a plane of the same size.
+ */
+OCTK_MEDIA_API uint64_t planeSumSquareError(const uint8_t *a,
+                                            int strideA,
+                                            const uint8_t *b,
+                                            int strideB,
+                                            int width,
+                                            int height);
+// Returns the PSNR in decibel of samples compared samples, to a maximum of kPerfectPSNR.
+OCTK_MEDIA_API double psnrFromSumSquareError(uint64_t sse, uint64_t samples);
+OCTK_MEDIA_API double planeSSIM(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height);
+/**
+ * Multi-scale SSIM over up to 5 scales halved with a 2x2 box filter, weighted as in
+ * Z. Wang, E. P. Simoncelli and A. C. Bovik, "Multiscale structural similarity for image quality assessment,"
+ * Asilomar Conference on Signals, Systems & Computers, 2003.
+ * Scales stop before a plane gets smaller than 8x8, the weights of the remaining scales are renormalized.
+ */
+OCTK_MEDIA_API double planeMSSSIM(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height);
 } // namespace yuv
 } // namespace utils
 
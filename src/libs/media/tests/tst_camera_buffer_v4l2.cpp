@@ -0,0 +1,265 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/detail/camera_buffer_v4l2_p.hpp>
+#include <openctk/media/i420_buffer.hpp>
+
+#include <vector>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+/**
+ * Fake device keeping the buffers in plain memory and recording which ones were queued back.
+ */
+struct FakeDevice
+{
+    FakeDevice(size_t count, size_t length)
+        : memory(count, std::vector<uint8_t>(length, 0))
+    {
+    }
+
+    // With `firstDmabufFd` >= 0 the slots pretend to be exported as dma-bufs numbered from it, the fds are never used.
+    CameraBufferQueueV4L2::SharedPtr makeQueue(int firstDmabufFd = -1)
+    {
+        std::vector<CameraBufferQueueV4L2::Slot> slots;
+        for (auto &buffer : memory)
+        {
+            CameraBufferQueueV4L2::Slot slot;
+            slot.start = buffer.data();
+            slot.length = buffer.size();
+            slot.dmabufFd = firstDmabufFd < 0 ? -1 : firstDmabufFd + static_cast<int>(slots.size());
+            slots.push_back(slot);
+        }
+        return std::make_shared<CameraBufferQueueV4L2>(
+            std::move(slots),
+            [this](uint32_t index, const CameraBufferQueueV4L2::Slot &)
+            {
+                queued.push_back(index);
+                return true;
+            },
+            [this](CameraBufferQueueV4L2::Slot &) { ++released; });
+    }
+
+    std::vector<std::vector<uint8_t>> memory;
+    std::vector<uint32_t> queued;
+    int released{0};
+};
+
+CameraCapture::Capability capability(int width, int height, VideoType type)
+{
+    CameraCapture::Capability capability;
+    capability.width = width;
+    capability.height = height;
+    capability.videoType = type;
+    return capability;
+}
+} // namespace
+
+TEST(CameraBufferQueueV4L2Test, WrapsNV12WithoutCopy)
+{
+    FakeDevice device(2, 16 * 8 * 3 / 2);
+    auto queue = device.makeQueue();
+    auto buffer = queue->wrap(1, 16 * 8 * 3 / 2, capability(16, 8, VideoType::kNV12), 16);
+    ASSERT_EQ(buffer->type(), VideoFrameBuffer::Type::kNV12);
+    const auto nv12 = buffer->getNV12();
+    EXPECT_EQ(nv12->dataY(), device.memory[1].data());
+    EXPECT_EQ(nv12->dataUV(), device.memory[1].data() + 16 * 8);
+    EXPECT_EQ(nv12->strideUV(), 16);
+    EXPECT_EQ(queue->outstanding(), 1u);
+    EXPECT_TRUE(device.queued.empty());
+}
+
+TEST(CameraBufferQueueV4L2Test, WrapsI420WithStride)
+{
+    FakeDevice device(1, 32 * 8 * 3 / 2);
+    auto queue = device.makeQueue();
+    auto buffer = queue->wrap(0, 32 * 8 * 3 / 2, capability(30, 8, VideoType::kI420), 32);
+    ASSERT_EQ(buffer->type(), VideoFrameBuffer::Type::kI420);
+    const auto i420 = buffer->getI420();
+    EXPECT_EQ(i420->width(), 30);
+    EXPECT_EQ(i420->strideY(), 32);
+    EXPECT_EQ(i420->dataU(), device.memory[0].data() + 32 * 8);
+    EXPECT_EQ(i420->dataV(), device.memory[0].data() + 32 * 8 + 16 * 4);
+}
+
+TEST(CameraBufferQueueV4L2Test, RequeuesWhenLastConsumerReleases)
+{
+    FakeDevice device(2, 16 * 8 * 2);
+    auto queue = device.makeQueue();
+    auto buffer = queue->wrap(0, 16 * 8 * 2, capability(16, 8, VideoType::kYUY2), 32);
+    auto copy = buffer;
+    buffer.reset();
+    EXPECT_TRUE(device.queued.empty());
+    copy.reset();
+    ASSERT_EQ(device.queued.size(), 1u);
+    EXPECT_EQ(device.queued[0], 0u);
+    EXPECT_EQ(queue->outstanding(), 0u);
+
+    EXPECT_TRUE(queue->requeue(1));
+    EXPECT_EQ(device.queued.size(), 2u);
+}
+
+TEST(CameraBufferQueueV4L2Test, NativeConvertsOnDemand)
+{
+    FakeDevice device(1, 16 * 8 * 2);
+    // YUY2 black: Y = 16, U = V = 128
+    for (size_t i = 0; i < device.memory[0].size(); i += 2)
+    {
+        device.memory[0][i] = 16;
+        device.memory[0][i + 1] = 128;
+    }
+    auto queue = device.makeQueue();
+    auto buffer = queue->wrap(0, 16 * 8 * 2, capability(16, 8, VideoType::kYUY2), 32);
+    ASSERT_EQ(buffer->type(), VideoFrameBuffer::Type::kNative);
+    auto native = std::static_pointer_cast<CameraFrameBufferV4L2>(buffer);
+    EXPECT_EQ(native->data(), device.memory[0].data());
+    EXPECT_EQ(native->dmabufFd(), -1);
+    auto i420 = buffer->toI420();
+    ASSERT_TRUE(i420);
+    EXPECT_EQ(i420->dataY()[0], 16);
+    EXPECT_EQ(i420->dataU()[0], 128);
+    EXPECT_EQ(i420->dataV()[i420->strideV() + 1], 128);
+}
+
+namespace
+{
+// Wraps a `width` x 8 gradient of `type` twice, tightly packed and with rows padded to `stride` bytes, and expects
+// both to convert to the same I420 frame.
+void expectPaddedRowsIgnored(VideoType type, int width, int bytesPerPixel, int stride)
+{
+    const int height = 8;
+    const int rowSize = width * bytesPerPixel;
+    FakeDevice tight(1, rowSize * height);
+    FakeDevice padded(1, stride * height);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < rowSize; ++x)
+        {
+            const auto value = static_cast<uint8_t>(16 + (x * 7 + y * 13) % 200);
+            tight.memory[0][y * rowSize + x] = value;
+            padded.memory[0][y * stride + x] = value;
+        }
+        // Garbage in the padding must not leak into the picture.
+        std::memset(padded.memory[0].data() + y * stride + rowSize, 255, stride - rowSize);
+    }
+    auto expected = tight.makeQueue()->wrap(0, rowSize * height, capability(width, height, type), rowSize)->toI420();
+    auto actual = padded.makeQueue()->wrap(0, stride * height, capability(width, height, type), stride)->toI420();
+    ASSERT_TRUE(expected);
+    ASSERT_TRUE(actual);
+    auto planeEqual = [](const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            if (0 != std::memcmp(a + y * strideA, b + y * strideB, width))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    EXPECT_TRUE(planeEqual(expected->dataY(), expected->strideY(), actual->dataY(), actual->strideY(), width, height));
+    EXPECT_TRUE(
+        planeEqual(expected->dataU(), expected->strideU(), actual->dataU(), actual->strideU(), width / 2, height / 2));
+    EXPECT_TRUE(
+        planeEqual(expected->dataV(), expected->strideV(), actual->dataV(), actual->strideV(), width / 2, height / 2));
+}
+} // namespace
+
+TEST(CameraBufferQueueV4L2Test, NativeUsesBytesPerLine)
+{
+    expectPaddedRowsIgnored(VideoType::kYUY2, 16, 2, 48);
+    // 52 bytes per line isn't a whole number of RGB24 pixels.
+    expectPaddedRowsIgnored(VideoType::kRGB24, 16, 3, 52);
+}
+
+TEST(CameraBufferQueueV4L2Test, DmaBufNV12KeepsFdAndPlanes)
+{
+    FakeDevice device(2, 32 * 8 * 3 / 2);
+    std::memset(device.memory[1].data(), 16, 32 * 8);
+    std::memset(device.memory[1].data() + 32 * 8, 128, 32 * 4);
+    auto queue = device.makeQueue(40);
+    auto buffer = queue->wrap(1, 32 * 8 * 3 / 2, capability(30, 8, VideoType::kNV12), 32);
+    ASSERT_EQ(buffer->type(), VideoFrameBuffer::Type::kNative);
+    auto native = std::static_pointer_cast<CameraFrameBufferV4L2>(buffer);
+    EXPECT_EQ(native->dmabufFd(), 41);
+    EXPECT_EQ(native->videoType(), VideoType::kNV12);
+    EXPECT_EQ(native->width(), 30);
+
+    VideoFrameBuffer::Type nv12[] = {VideoFrameBuffer::Type::kNV12};
+    auto mapped = buffer->getMappedFrameBuffer(nv12);
+    ASSERT_TRUE(mapped);
+    const auto planes = mapped->getNV12();
+    EXPECT_EQ(planes->dataY(), device.memory[1].data());
+    EXPECT_EQ(planes->dataUV(), device.memory[1].data() + 32 * 8);
+    EXPECT_EQ(planes->strideY(), 32);
+
+    VideoFrameBuffer::Type rgba[] = {VideoFrameBuffer::Type::kRGBA};
+    EXPECT_FALSE(buffer->getMappedFrameBuffer(rgba));
+    auto i420 = buffer->toI420();
+    ASSERT_TRUE(i420);
+    EXPECT_EQ(i420->dataY()[29], 16);
+    EXPECT_EQ(i420->dataV()[0], 128);
+
+    mapped.reset();
+    native.reset();
+    buffer.reset();
+    ASSERT_EQ(device.queued.size(), 1u);
+    EXPECT_EQ(device.queued[0], 1u);
+    EXPECT_EQ(queue->outstanding(), 0u);
+}
+
+TEST(CameraBufferQueueV4L2Test, DmaBufI420IsNative)
+{
+    FakeDevice device(1, 16 * 8 * 3 / 2);
+    auto queue = device.makeQueue(7);
+    auto buffer = queue->wrap(0, 16 * 8 * 3 / 2, capability(16, 8, VideoType::kI420), 16);
+    ASSERT_EQ(buffer->type(), VideoFrameBuffer::Type::kNative);
+    auto native = std::static_pointer_cast<CameraFrameBufferV4L2>(buffer);
+    EXPECT_EQ(native->dmabufFd(), 7);
+    ASSERT_TRUE(native->planar());
+    EXPECT_EQ(native->planar()->getI420()->dataU(), device.memory[0].data() + 16 * 8);
+    VideoFrameBuffer::Type i420[] = {VideoFrameBuffer::Type::kI420};
+    EXPECT_EQ(buffer->getMappedFrameBuffer(i420), native->planar());
+}
+
+TEST(CameraBufferQueueV4L2Test, StopKeepsMemoryUntilReleased)
+{
+    FakeDevice device(2, 16 * 8 * 3 / 2);
+    auto queue = device.makeQueue();
+    auto buffer = queue->wrap(0, 16 * 8 * 3 / 2, capability(16, 8, VideoType::kNV12), 16);
+    queue->stop();
+    EXPECT_FALSE(queue->requeue(1));
+    queue.reset();
+    EXPECT_EQ(device.released, 0);
+    buffer.reset();
+    EXPECT_TRUE(device.queued.empty());
+    EXPECT_EQ(device.released, 2);
+}
+
+OCTK_END_NAMESPACE
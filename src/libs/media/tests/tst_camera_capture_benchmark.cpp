@@ -0,0 +1,156 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/detail/camera_capture_p.hpp>
+#include <openctk/media/create_frame_generator.hpp>
+#include <openctk/media/camera_capture.hpp>
+#include <openctk/core/date_time.hpp>
+
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+using namespace octk;
+
+namespace
+{
+/**
+ * Fake device feeding raw I420 frames rendered by the square frame generator into the capture path.
+ */
+class FakeCameraCapture : public CameraCapture
+{
+public:
+    FakeCameraCapture()
+        : CameraCapture(new CameraCapturePrivate(this))
+    {
+    }
+
+    int32_t captureFrame(uint8_t *data, size_t length, const Capability &capability)
+    {
+        OCTK_D(CameraCapture);
+        return d->incomingFrame(data, length, capability);
+    }
+
+protected:
+    bool init(const char *) override { return true; }
+    bool init(const char *, const char *) override { return true; }
+};
+
+/**
+ * Sink holding on to the last frames like an encoder queue would, measuring the capture to delivery latency.
+ */
+class HoldingSink : public VideoSinkInterface<VideoFrame>
+{
+public:
+    explicit HoldingSink(size_t held)
+        : mHeld(held)
+    {
+    }
+
+    void onFrame(const VideoFrame &frame) override
+    {
+        mLatenciesNanos.push_back(DateTime::TimeNanos() - mCaptureTimeNanos);
+        mFrames.push_back(frame);
+        if (mFrames.size() > mHeld)
+        {
+            mFrames.pop_front();
+        }
+    }
+
+    void beginCapture() { mCaptureTimeNanos = DateTime::TimeNanos(); }
+
+    double p99LatencyMicros()
+    {
+        if (mLatenciesNanos.empty())
+        {
+            return 0;
+        }
+        const auto index = mLatenciesNanos.size() * 99 / 100;
+        std::nth_element(mLatenciesNanos.begin(), mLatenciesNanos.begin() + index, mLatenciesNanos.end());
+        return mLatenciesNanos[index] / 1000.0;
+    }
+
+private:
+    const size_t mHeld;
+    int64_t mCaptureTimeNanos{0};
+    std::deque<VideoFrame> mFrames;
+    std::vector<int64_t> mLatenciesNanos;
+};
+
+/**
+ * Every benchmark thread drives its own fake camera at 1080p, range(0) selects pooled (1) or per frame allocated (0)
+ * capture buffers.
+ */
+void captureFrames(benchmark::State &state)
+{
+    const bool pooled = state.range(0) != 0;
+    CameraCapture::Capability capability;
+    capability.width = 1920;
+    capability.height = 1080;
+    capability.maxFPS = 60;
+    capability.videoType = VideoType::kI420;
+
+    auto generator = utils::CreateSquareFrameGenerator(capability.width, capability.height, utils::nullopt, 10);
+    auto source = generator->nextFrame().buffer->toI420();
+    std::vector<uint8_t> raw(utils::videoTypeBufferSize(VideoType::kI420, capability.width, capability.height));
+    const int chromaSize = source->chromaWidth() * source->chromaHeight();
+    for (int row = 0; row < source->height(); ++row)
+    {
+        std::copy_n(source->dataY() + row * source->strideY(), source->width(), raw.data() + row * source->width());
+    }
+    uint8_t *u = raw.data() + source->width() * source->height();
+    for (int row = 0; row < source->chromaHeight(); ++row)
+    {
+        std::copy_n(source->dataU() + row * source->strideU(), source->chromaWidth(), u + row * source->chromaWidth());
+        std::copy_n(source->dataV() + row * source->strideV(),
+                    source->chromaWidth(),
+                    u + chromaSize + row * source->chromaWidth());
+    }
+
+    FakeCameraCapture camera;
+    camera.setFramesInFlight(pooled ? CameraCapture::kDefaultFramesInFlight : 0);
+    HoldingSink sink(CameraCapture::kDefaultFramesInFlight);
+    camera.registerCaptureDataCallback(&sink);
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        sink.beginCapture();
+        camera.captureFrame(raw.data(), raw.size(), capability);
+    }
+    camera.deregisterCaptureDataCallback();
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["allocs_per_frame"] = benchmark::Counter(double(camera.bufferPoolMisses()) / state.iterations(),
+                                                            benchmark::Counter::kAvgThreads);
+    state.counters["allocs_per_sec"] = benchmark::Counter(double(camera.bufferPoolMisses()),
+                                                          benchmark::Counter::kIsRate);
+    state.counters["p99_us"] = benchmark::Counter(sink.p99LatencyMicros(), benchmark::Counter::kAvgThreads);
+    state.counters["jitter_us"] = benchmark::Counter(double(camera.captureStats().jitterUSecs),
+                                                     benchmark::Counter::kAvgThreads);
+}
+} // namespace
+
+BENCHMARK(captureFrames)->ArgName("pooled")->Arg(0)->Arg(1)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,207 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/detail/camera_reactor_v4l2_p.hpp>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <set>
+
+#include <gtest/gtest.h>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+/**
+ * Stands in for a capture device, readable while the counter is not zero.
+ */
+struct FakeDevice
+{
+    FakeDevice()
+        : fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+    {
+    }
+    ~FakeDevice() { close(fd); }
+
+    void signal()
+    {
+        const uint64_t value = 1;
+        EXPECT_EQ(write(fd, &value, sizeof(value)), ssize_t(sizeof(value)));
+    }
+    void drain()
+    {
+        uint64_t value = 0;
+        if (read(fd, &value, sizeof(value)) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            events += static_cast<int>(value);
+            condition.notify_all();
+        }
+    }
+    bool waitFor(int expected)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return condition.wait_for(lock, std::chrono::seconds(5), [&]() { return events >= expected; });
+    }
+    int count()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events;
+    }
+
+    const int fd;
+    std::mutex mutex;
+    std::condition_variable condition;
+    int events{0};
+};
+} // namespace
+
+TEST(CameraReactorV4L2Test, DispatchesManyDevicesOnOneThread)
+{
+    CameraReactorV4L2 reactor;
+    ASSERT_TRUE(reactor.isValid());
+    EXPECT_EQ(reactor.threadCount(), 1);
+
+    FakeDevice devices[8];
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    for (auto &device : devices)
+    {
+        ASSERT_TRUE(reactor.add(device.fd,
+                                [&](uint32_t)
+                                {
+                                    {
+                                        std::lock_guard<std::mutex> lock(mutex);
+                                        threads.insert(std::this_thread::get_id());
+                                    }
+                                    device.drain();
+                                    return true;
+                                }));
+    }
+    EXPECT_EQ(reactor.size(), 8u);
+
+    for (int round = 1; round <= 3; ++round)
+    {
+        for (auto &device : devices)
+        {
+            device.signal();
+        }
+        for (auto &device : devices)
+        {
+            ASSERT_TRUE(device.waitFor(round));
+        }
+    }
+    EXPECT_EQ(threads.size(), 1u);
+
+    for (auto &device : devices)
+    {
+        reactor.remove(device.fd);
+    }
+    EXPECT_EQ(reactor.size(), 0u);
+}
+
+TEST(CameraReactorV4L2Test, ParkedDeviceWaitsForResume)
+{
+    CameraReactorV4L2 reactor;
+    FakeDevice device;
+    std::atomic<int> calls{0};
+    ASSERT_TRUE(reactor.add(device.fd,
+                            [&](uint32_t)
+                            {
+                                ++calls;
+                                // stays readable, like a device reporting EPOLLERR without queued buffers
+                                return false;
+                            }));
+    device.signal();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(calls.load(), 1);
+
+    reactor.resume(device.fd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(calls.load(), 2);
+    reactor.remove(device.fd);
+}
+
+TEST(CameraReactorV4L2Test, RemoveWaitsForRunningHandler)
+{
+    CameraReactorV4L2 reactor;
+    FakeDevice device;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    ASSERT_TRUE(reactor.add(device.fd,
+                            [&](uint32_t)
+                            {
+                                entered = true;
+                                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                                finished = true;
+                                return true;
+                            }));
+    device.signal();
+    while (!entered)
+    {
+        std::this_thread::yield();
+    }
+    reactor.remove(device.fd);
+    EXPECT_TRUE(finished.load());
+    EXPECT_EQ(reactor.size(), 0u);
+}
+
+TEST(CameraReactorV4L2Test, HandlerMayRemoveItself)
+{
+    CameraReactorV4L2 reactor;
+    FakeDevice device;
+    ASSERT_TRUE(reactor.add(device.fd,
+                            [&](uint32_t)
+                            {
+                                reactor.remove(device.fd);
+                                device.drain();
+                                return true;
+                            }));
+    device.signal();
+    ASSERT_TRUE(device.waitFor(1));
+    device.signal();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(device.count(), 1);
+    EXPECT_EQ(reactor.size(), 0u);
+}
+
+TEST(CameraReactorV4L2Test, SharedReactorFollowsItsUsers)
+{
+    auto first = CameraReactorV4L2::shared();
+    auto second = CameraReactorV4L2::shared();
+    EXPECT_EQ(first, second);
+    std::weak_ptr<CameraReactorV4L2> weak = first;
+    first.reset();
+    second.reset();
+    EXPECT_TRUE(weak.expired());
+}
+
+OCTK_END_NAMESPACE
@@ -297,6 +297,92 @@ TEST_F(FrameGeneratorTest, MultipleFrameNV12FilesWithRepeat)
     CheckFrameAndMutate(generator->nextFrame(), 0, 0, 0);
 }
 
+TEST_F(FrameGeneratorTest, MultipleFrameMappedYuvFilesWithRepeat)
+{
+    const int kRepeatCount = 2;
+    std::vector<std::string> files;
+    files.push_back(two_frame_yuv_filename_);
+    files.push_back(one_frame_yuv_filename_);
+    std::unique_ptr<FrameGeneratorInterface> generator(
+        utils::CreateFromMappedYuvFileFrameGenerator(files,
+                                                     FrameGeneratorInterface::OutputType::kI420,
+                                                     kFrameWidth,
+                                                     kFrameHeight,
+                                                     kRepeatCount));
+    ASSERT_TRUE(generator);
+    const uint8_t colors[][3] = {{0, 0, 0}, {127, 128, 129}, {255, 255, 255}};
+    for (const auto &color : colors)
+    {
+        for (int i = 0; i < kRepeatCount; ++i)
+        {
+            const auto frame = generator->nextFrame();
+            ASSERT_TRUE(frame.updateRect);
+            EXPECT_EQ(i > 0, frame.updateRect->isEmpty());
+            CheckFrameAndMutate(frame, color[0], color[1], color[2]);
+        }
+    }
+    CheckFrameAndMutate(generator->nextFrame(), 0, 0, 0);
+}
+
+TEST_F(FrameGeneratorTest, MultipleFrameMappedNV12Files)
+{
+    std::vector<std::string> files;
+    files.push_back(two_frame_nv12_filename_);
+    files.push_back(one_frame_nv12_filename_);
+    std::unique_ptr<FrameGeneratorInterface> generator(
+        utils::CreateFromMappedYuvFileFrameGenerator(files,
+                                                     FrameGeneratorInterface::OutputType::kNV12,
+                                                     kFrameWidth,
+                                                     kFrameHeight));
+    ASSERT_TRUE(generator);
+    CheckFrameAndMutate(generator->nextFrame(), 0, 0, 0);
+    CheckFrameAndMutate(generator->nextFrame(), 127, 128, 129);
+    CheckFrameAndMutate(generator->nextFrame(), 255, 255, 255);
+    CheckFrameAndMutate(generator->nextFrame(), 0, 0, 0);
+}
+
+TEST_F(FrameGeneratorTest, MappedYuvFileRandomAccessAndSharing)
+{
+    std::vector<std::string> files;
+    files.push_back(two_frame_yuv_filename_);
+    files.push_back(one_frame_yuv_filename_);
+    files.push_back(two_frame_yuv_filename_ + ".missing");
+    auto first = utils::CreateFromMappedYuvFileFrameGenerator(files,
+                                                              FrameGeneratorInterface::OutputType::kI420,
+                                                              kFrameWidth,
+                                                              kFrameHeight);
+    auto second = utils::CreateFromMappedYuvFileFrameGenerator(files,
+                                                               FrameGeneratorInterface::OutputType::kI420,
+                                                               kFrameWidth,
+                                                               kFrameHeight);
+    ASSERT_TRUE(first && second);
+    EXPECT_EQ(3u, first->frameCount());
+    EXPECT_EQ(nullptr, first->frameAt(3));
+    EXPECT_FALSE(first->seek(3));
+
+    // Frames point into one mapping shared by both generators.
+    const auto frame = first->frameAt(2);
+    EXPECT_EQ(frame->getI420()->dataY(), second->frameAt(2)->getI420()->dataY());
+    CheckFrameAndMutate(FrameGeneratorInterface::VideoFrameData(frame, utils::nullopt), 255, 255, 255);
+
+    ASSERT_TRUE(first->seek(1));
+    CheckFrameAndMutate(first->nextFrame(), 127, 128, 129);
+    CheckFrameAndMutate(first->nextFrame(), 255, 255, 255);
+
+    // Buffers keep the mapping alive after the generators are gone.
+    first.reset();
+    second.reset();
+    CheckFrameAndMutate(FrameGeneratorInterface::VideoFrameData(frame, utils::nullopt), 255, 255, 255);
+}
+
+TEST_F(FrameGeneratorTest, MappedYuvFileWithoutFrames)
+{
+    EXPECT_FALSE(utils::CreateFromMappedYuvFileFrameGenerator(std::vector<std::string>(1, one_frame_yuv_filename_),
+                                                              FrameGeneratorInterface::OutputType::kI420,
+                                                              kFrameWidth * 2,
+                                                              kFrameHeight * 2));
+}
+
 TEST_F(FrameGeneratorTest, SlideGenerator)
 {
     const int kGenCount = 9;
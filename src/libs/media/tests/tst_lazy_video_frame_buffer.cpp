@@ -0,0 +1,146 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/lazy_video_frame_buffer.hpp>
+#include <openctk/media/i420_buffer.hpp>
+#include <openctk/media/nv12_buffer.hpp>
+
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+// Counts how often the wrapped buffer really converts.
+class CountingBuffer : public VideoFrameBuffer
+{
+public:
+    CountingBuffer()
+        : mNV12(NV12Buffer::create(64, 32))
+    {
+    }
+
+    Type type() const override { return Type::kNative; }
+    int width() const override { return mNV12->width(); }
+    int height() const override { return mNV12->height(); }
+    std::shared_ptr<I420BufferInterface> toI420() override
+    {
+        ++mConversions;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return mNV12->toI420();
+    }
+    std::shared_ptr<VideoFrameBuffer> getMappedFrameBuffer(ArrayView<Type> types) override
+    {
+        for (const auto type : types)
+        {
+            if (Type::kNV12 == type)
+            {
+                return mNV12;
+            }
+        }
+        return nullptr;
+    }
+
+    const std::shared_ptr<NV12Buffer> mNV12;
+    std::atomic<int> mConversions{0};
+};
+} // namespace
+
+TEST(LazyVideoFrameBufferTest, ConvertsOnceAcrossThreads)
+{
+    auto counting = std::make_shared<CountingBuffer>();
+    const auto lazy = LazyVideoFrameBuffer::create(counting);
+    EXPECT_EQ(VideoFrameBuffer::Type::kNative, lazy->type());
+    EXPECT_EQ(64, lazy->width());
+    EXPECT_EQ(32, lazy->height());
+    EXPECT_EQ(nullptr, lazy->getI420());
+
+    std::vector<std::shared_ptr<I420BufferInterface>> results(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        threads.emplace_back([&, i]() { results[i] = lazy->toI420(); });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(1, counting->mConversions.load());
+    for (const auto &result : results)
+    {
+        ASSERT_TRUE(result);
+        EXPECT_EQ(results.front(), result);
+    }
+    EXPECT_EQ(results.front().get(), lazy->getI420());
+    EXPECT_EQ(1u, lazy->stats().conversions);
+    EXPECT_EQ(7u, lazy->stats().conversionsAvoided);
+
+    // RGBA is derived from the memoized I420 buffer.
+    const auto rgba = lazy->toRGBA();
+    ASSERT_TRUE(rgba);
+    EXPECT_EQ(rgba, lazy->toRGBA());
+    EXPECT_EQ(1, counting->mConversions.load());
+}
+
+TEST(LazyVideoFrameBufferTest, MappedFrameBuffer)
+{
+    auto nv12 = NV12Buffer::create(32, 16);
+    const auto lazy = LazyVideoFrameBuffer::create(nv12);
+    EXPECT_EQ(lazy, LazyVideoFrameBuffer::create(lazy));
+
+    VideoFrameBuffer::Type nv12Types[] = {VideoFrameBuffer::Type::kNV12};
+    EXPECT_EQ(nv12, lazy->getMappedFrameBuffer(nv12Types));
+
+    VideoFrameBuffer::Type i420Types[] = {VideoFrameBuffer::Type::kI420};
+    const auto i420 = lazy->getMappedFrameBuffer(i420Types);
+    ASSERT_TRUE(i420);
+    EXPECT_EQ(VideoFrameBuffer::Type::kI420, i420->type());
+    EXPECT_EQ(i420, lazy->toI420());
+
+    VideoFrameBuffer::Type i444Types[] = {VideoFrameBuffer::Type::kI444};
+    EXPECT_EQ(nullptr, lazy->getMappedFrameBuffer(i444Types));
+
+    // Native buffers are asked for a mapping before anything gets converted.
+    auto counting = std::make_shared<CountingBuffer>();
+    const auto lazyNative = LazyVideoFrameBuffer::create(counting);
+    VideoFrameBuffer::Type planarTypes[] = {VideoFrameBuffer::Type::kI420, VideoFrameBuffer::Type::kNV12};
+    EXPECT_EQ(counting->mNV12, lazyNative->getMappedFrameBuffer(planarTypes));
+    EXPECT_EQ(0, counting->mConversions.load());
+    EXPECT_EQ(1u, lazyNative->stats().conversionsAvoided);
+}
+
+TEST(LazyVideoFrameBufferTest, I420BufferIsReadInPlace)
+{
+    auto i420 = I420Buffer::create(32, 16);
+    const auto lazy = LazyVideoFrameBuffer::create(i420);
+    EXPECT_EQ(i420.get(), lazy->getI420());
+    EXPECT_EQ(0u, lazy->stats().conversions);
+}
+
+OCTK_END_NAMESPACE
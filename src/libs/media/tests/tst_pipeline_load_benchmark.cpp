@@ -0,0 +1,95 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/pipeline_load_generator.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace octk;
+
+namespace
+{
+/**
+ * Runs the pipeline once per iteration and reports its throughput, drops and end to end latency as counters, so
+ * --benchmark_out=<file> --benchmark_out_format=json gives a record for regression tracking.
+ */
+void runPipeline(benchmark::State &state, const PipelineLoadGenerator::Config &config)
+{
+    PipelineLoadGenerator::Report total;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        const auto report = PipelineLoadGenerator(config).run();
+        state.SetIterationTime(report.elapsedUSecs / 1e6);
+        total.elapsedUSecs += report.elapsedUSecs;
+        total.framesGenerated += report.framesGenerated;
+        total.framesMissed += report.framesMissed;
+        total.framesDroppedByAdapter += report.framesDroppedByAdapter;
+        total.framesDroppedBySinkQueues += report.framesDroppedBySinkQueues;
+        total.framesDelivered += report.framesDelivered;
+        total.endToEndLatency.merge(report.endToEndLatency);
+    }
+    const double seconds = total.elapsedUSecs / 1e6;
+    state.counters["sourceFps"] = (total.framesGenerated - total.framesDroppedByAdapter) / seconds;
+    state.counters["sinkFps"] = total.framesDelivered / seconds;
+    state.counters["missed"] = static_cast<double>(total.framesMissed);
+    state.counters["droppedByAdapter"] = static_cast<double>(total.framesDroppedByAdapter);
+    state.counters["droppedBySinkQueues"] = static_cast<double>(total.framesDroppedBySinkQueues);
+    state.counters["p50Us"] = static_cast<double>(total.endToEndLatency.percentile(50));
+    state.counters["p99Us"] = static_cast<double>(total.endToEndLatency.percentile(99));
+    state.counters["maxUs"] = static_cast<double>(total.endToEndLatency.max());
+}
+} // namespace
+
+// range(0): sources, range(1): sinks per source.
+void BM_PipelineClosedLoop(benchmark::State &state)
+{
+    PipelineLoadGenerator::Config config;
+    config.mode = PipelineLoadGenerator::Mode::kClosedLoop;
+    config.sources = static_cast<int>(state.range(0));
+    config.sinksPerSource = static_cast<int>(state.range(1));
+    config.durationMSecs = 500;
+    runPipeline(state, config);
+}
+
+// range(0): sources, 30 fps 640x360 each, async sinks wanting 320x180.
+void BM_PipelineOpenLoop(benchmark::State &state)
+{
+    PipelineLoadGenerator::Config config;
+    config.mode = PipelineLoadGenerator::Mode::kOpenLoop;
+    config.sources = static_cast<int>(state.range(0));
+    config.sinksPerSource = 2;
+    config.fps = 30;
+    config.durationMSecs = 1000;
+    config.sinkMaxPixelCount = 320 * 180;
+    config.asyncSinks = true;
+    runPipeline(state, config);
+}
+
+BENCHMARK(BM_PipelineClosedLoop)
+    ->ArgsProduct({{1, 4, 16}, {1, 4}})
+    ->UseManualTime()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PipelineOpenLoop)->Arg(1)->Arg(16)->Arg(50)->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
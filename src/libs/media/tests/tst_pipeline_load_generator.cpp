@@ -0,0 +1,158 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/pipeline_load_generator.hpp>
+#include <openctk/media/frame_generator.hpp>
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+// Frames whose conversion takes longer than generating them, so async sink queues are never empty.
+class SlowBuffer : public VideoFrameBuffer
+{
+public:
+    explicit SlowBuffer(std::shared_ptr<VideoFrameBuffer> buffer)
+        : mBuffer(std::move(buffer))
+    {
+    }
+
+    Type type() const override { return Type::kNative; }
+    int width() const override { return mBuffer->width(); }
+    int height() const override { return mBuffer->height(); }
+    std::shared_ptr<I420BufferInterface> toI420() override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return mBuffer->toI420();
+    }
+
+private:
+    const std::shared_ptr<VideoFrameBuffer> mBuffer;
+};
+
+class SlowGenerator : public SquareGenerator
+{
+public:
+    SlowGenerator()
+        : SquareGenerator(320, 180, OutputType::kI420, 1)
+    {
+    }
+
+    VideoFrameData nextFrame() override
+    {
+        auto data = SquareGenerator::nextFrame();
+        data.buffer = std::make_shared<SlowBuffer>(data.buffer);
+        return data;
+    }
+};
+} // namespace
+
+TEST(PipelineLoadGeneratorTest, LatencyHistogramPercentiles)
+{
+    PipelineLoadGenerator::LatencyHistogram histogram;
+    EXPECT_EQ(0, histogram.percentile(50));
+    for (int64_t value = 1; value <= 1000; ++value)
+    {
+        histogram.add(value);
+    }
+    EXPECT_EQ(1000u, histogram.count());
+    EXPECT_EQ(1, histogram.min());
+    EXPECT_EQ(1000, histogram.max());
+    EXPECT_DOUBLE_EQ(500.5, histogram.mean());
+    EXPECT_EQ(1, histogram.percentile(0));
+    EXPECT_EQ(1000, histogram.percentile(100));
+    // Buckets are 1/16 of their magnitude wide above 16.
+    EXPECT_NEAR(500, histogram.percentile(50), 500 / 16);
+    EXPECT_NEAR(990, histogram.percentile(99), 990 / 16);
+
+    PipelineLoadGenerator::LatencyHistogram other;
+    other.add(1 << 20);
+    histogram.merge(other);
+    EXPECT_EQ(1001u, histogram.count());
+    EXPECT_EQ(1 << 20, histogram.percentile(100));
+}
+
+TEST(PipelineLoadGeneratorTest, ClosedLoop)
+{
+    PipelineLoadGenerator::Config config;
+    config.sources = 2;
+    config.sinksPerSource = 2;
+    config.width = 320;
+    config.height = 180;
+    config.durationMSecs = 200;
+    const auto report = PipelineLoadGenerator(config).run();
+    EXPECT_GT(report.framesGenerated, 0u);
+    EXPECT_EQ(0u, report.framesMissed);
+    EXPECT_EQ(0u, report.framesDroppedByAdapter);
+    EXPECT_EQ(2 * report.framesGenerated, report.framesDelivered);
+    EXPECT_EQ(report.framesGenerated, report.generateLatency.count());
+    EXPECT_EQ(report.framesDelivered, report.endToEndLatency.count());
+    EXPECT_GT(report.sinkFps, report.sourceFps);
+
+    const auto json = report.toJson();
+    EXPECT_EQ("closedLoop", json["mode"].get<std::string>());
+    EXPECT_EQ(report.framesDelivered, json["frames"]["delivered"].get<uint64_t>());
+    EXPECT_TRUE(json["latencyUSecs"]["endToEnd"].contains("p99"));
+}
+
+TEST(PipelineLoadGeneratorTest, ClosedLoopAsyncSinks)
+{
+    PipelineLoadGenerator::Config config;
+    config.sources = 2;
+    config.sinksPerSource = 2;
+    config.durationMSecs = 200;
+    config.asyncSinks = true;
+    config.sinkQueueSize = 1;
+    config.generatorFactory = [](int) { return utils::make_unique<SlowGenerator>(); };
+    const auto report = PipelineLoadGenerator(config).run();
+    EXPECT_GT(report.framesDroppedBySinkQueues, 0u);
+    // frames still queued when the run ends count as delivered or dropped, never as neither
+    EXPECT_EQ(2 * (report.framesGenerated - report.framesDroppedByAdapter),
+              report.framesDelivered + report.framesDroppedBySinkQueues);
+    EXPECT_EQ(report.framesDelivered, report.endToEndLatency.count());
+}
+
+TEST(PipelineLoadGeneratorTest, OpenLoop)
+{
+    PipelineLoadGenerator::Config config;
+    config.mode = PipelineLoadGenerator::Mode::kOpenLoop;
+    config.sources = 3;
+    config.fps = 50;
+    config.durationMSecs = 400;
+    config.sinkMaxPixelCount = 320 * 180;
+    config.asyncSinks = true;
+    const auto report = PipelineLoadGenerator(config).run();
+    // 20 frames per source, give or take one at the end of the run.
+    EXPECT_NEAR(3 * 20, static_cast<double>(report.framesGenerated + report.framesMissed), 3);
+    EXPECT_EQ(report.framesGenerated - report.framesDroppedByAdapter,
+              report.framesDelivered + report.framesDroppedBySinkQueues);
+    EXPECT_EQ(report.framesGenerated, report.adaptLatency.count());
+}
+
+OCTK_END_NAMESPACE
@@ -0,0 +1,126 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/rtc_video_frame.hpp>
+#include <openctk/media/i420_buffer.hpp>
+#include <openctk/media/nv12_buffer.hpp>
+#include <openctk/media/video_frame.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace octk;
+
+namespace
+{
+constexpr int kWidth = 1920;
+constexpr int kHeight = 1080;
+constexpr double kFps = 60;
+constexpr VideoRotation kRotation = VideoRotation::kAngle0;
+
+enum Bridge
+{
+    kPooled,
+    kShared,
+    kLegacyI420 // what the bridge did before frames kept their format: convert every frame, then wrap it
+};
+
+std::shared_ptr<VideoFrameBuffer> createBuffer(RtcVideoFrame::Format format)
+{
+    if (RtcVideoFrame::Format::kNV12 == format)
+    {
+        auto buffer = NV12Buffer::create(kWidth, kHeight);
+        buffer->InitializeData();
+        return buffer;
+    }
+    auto buffer = I420Buffer::create(kWidth, kHeight);
+    buffer->InitializeData();
+    return buffer;
+}
+
+// Stands in for a renderer or an encoder picking up the frame, reads one byte per plane it would consume.
+int consume(const RtcVideoFrame &frame)
+{
+    if (RtcVideoFrame::Format::kNV12 == frame.format())
+    {
+        return frame.dataY()[frame.strideY()] + frame.dataUV()[frame.strideUV()];
+    }
+    return frame.dataY()[frame.strideY()] + frame.dataU()[frame.strideU()] + frame.dataV()[frame.strideV()];
+}
+
+/**
+ * Receive path of one 1080p60 stream: decoded VideoFrame -> RtcVideoFrame bridge -> two sinks. The frameBudget
+ * counter is the share of the 16.7ms frame interval the bridge costs, fps is the bridge throughput.
+ */
+void runBridge(benchmark::State &state, RtcVideoFrame::Format format, Bridge bridge)
+{
+    const auto buffer = createBuffer(format);
+    RtcVideoFramePool pool;
+    int64_t timestamp = 0;
+    int sum = 0;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        timestamp += static_cast<int64_t>(1000000 / kFps);
+        RtcVideoFrame::SharedPtr rtcFrame;
+        switch (bridge)
+        {
+        case kPooled: rtcFrame = RtcVideoFrame::create(VideoFrame(buffer, kRotation, timestamp), pool); break;
+        case kShared: rtcFrame = RtcVideoFrame::create(VideoFrame(buffer, kRotation, timestamp)); break;
+        case kLegacyI420: rtcFrame = RtcVideoFrame::create(VideoFrame(buffer->toI420(), kRotation, timestamp)); break;
+        }
+        sum += consume(*rtcFrame);
+        sum += consume(*rtcFrame);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    state.counters["frameBudget"] = benchmark::Counter(state.iterations() / kFps,
+                                                       benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    if (kPooled == bridge)
+    {
+        const auto stats = pool.stats();
+        state.counters["poolHits"] = static_cast<double>(stats.hits);
+        state.counters["poolMisses"] = static_cast<double>(stats.misses);
+    }
+}
+} // namespace
+
+// range(0): 0 for I420 frames, 1 for NV12 frames.
+void BM_RtcVideoFrameBridgePooled(benchmark::State &state)
+{
+    runBridge(state, state.range(0) ? RtcVideoFrame::Format::kNV12 : RtcVideoFrame::Format::kI420, kPooled);
+}
+
+void BM_RtcVideoFrameBridgeShared(benchmark::State &state)
+{
+    runBridge(state, state.range(0) ? RtcVideoFrame::Format::kNV12 : RtcVideoFrame::Format::kI420, kShared);
+}
+
+void BM_RtcVideoFrameBridgeLegacyI420(benchmark::State &state)
+{
+    runBridge(state, state.range(0) ? RtcVideoFrame::Format::kNV12 : RtcVideoFrame::Format::kI420, kLegacyI420);
+}
+
+BENCHMARK(BM_RtcVideoFrameBridgePooled)->Arg(0)->Arg(1);
+BENCHMARK(BM_RtcVideoFrameBridgeShared)->Arg(0)->Arg(1);
+BENCHMARK(BM_RtcVideoFrameBridgeLegacyI420)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
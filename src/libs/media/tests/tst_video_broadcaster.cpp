@@ -0,0 +1,256 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/lazy_video_frame_buffer.hpp>
+#include <openctk/media/video_broadcaster.hpp>
+#include <openctk/media/nv12_buffer.hpp>
+#include <openctk/media/i420_buffer.hpp>
+#include <openctk/media/video_frame.hpp>
+
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+#include <gtest/gtest.h>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+VideoFrame makeFrame(uint16_t id, bool withUpdateRect = false)
+{
+    auto builder = VideoFrame::Builder().setVideoFrameBuffer(I420Buffer::create(16, 16)).setId(id);
+    if (withUpdateRect)
+    {
+        builder.setUpdateRect(VideoFrame::UpdateRect{0, 0, 8, 8});
+    }
+    return builder.build();
+}
+
+// Statistics of async sinks are updated after their onFrame() returned.
+bool waitForDelivered(const VideoBroadcaster &broadcaster, const VideoSinkInterface<VideoFrame> *sink, uint64_t count)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (broadcaster.sinkStats(sink)->framesDelivered < count)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+class RecordingSink : public VideoSinkInterface<VideoFrame>
+{
+public:
+    explicit RecordingSink(std::chrono::milliseconds delay = std::chrono::milliseconds(0))
+        : mDelay(delay)
+    {
+    }
+
+    void onFrame(const VideoFrame &frame) override
+    {
+        ++mEntered;
+        if (mDelay.count() > 0)
+        {
+            std::this_thread::sleep_for(mDelay);
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIds.push_back(frame.id());
+        mUpdateRects.push_back(frame.hasUpdateRect());
+    }
+    void onDiscardedFrame() override { ++mDiscarded; }
+
+    std::vector<uint16_t> ids()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mIds;
+    }
+    std::vector<bool> updateRects()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mUpdateRects;
+    }
+
+    std::atomic<int> mEntered{0};
+    std::atomic<int> mDiscarded{0};
+
+private:
+    const std::chrono::milliseconds mDelay;
+    std::mutex mMutex;
+    std::vector<uint16_t> mIds;
+    std::vector<bool> mUpdateRects;
+};
+} // namespace
+
+TEST(VideoBroadcasterTest, DeliversToEverySink)
+{
+    VideoBroadcaster broadcaster;
+    EXPECT_FALSE(broadcaster.frameWanted());
+
+    RecordingSink first;
+    RecordingSink second;
+    broadcaster.addOrUpdateSink(&first, VideoSinkWants());
+    broadcaster.addOrUpdateSink(&second, VideoSinkWants());
+    EXPECT_TRUE(broadcaster.frameWanted());
+
+    broadcaster.onFrame(makeFrame(1));
+    EXPECT_EQ(first.ids(), std::vector<uint16_t>{1});
+    EXPECT_EQ(second.ids(), std::vector<uint16_t>{1});
+
+    broadcaster.removeSink(&first);
+    broadcaster.onFrame(makeFrame(2));
+    EXPECT_EQ(first.ids().size(), 1u);
+    EXPECT_EQ(second.ids().size(), 2u);
+    EXPECT_FALSE(broadcaster.sinkStats(&first).has_value());
+    ASSERT_TRUE(broadcaster.sinkStats(&second).has_value());
+    EXPECT_EQ(broadcaster.sinkStats(&second)->framesDelivered, 2u);
+    EXPECT_EQ(broadcaster.sinkStats(&second)->framesDropped, 0u);
+}
+
+TEST(VideoBroadcasterTest, DiscardsFramesWithPendingRotation)
+{
+    VideoBroadcaster broadcaster;
+    RecordingSink sink;
+    VideoSinkWants wants;
+    wants.rotationApplied = true;
+    broadcaster.addOrUpdateSink(&sink, wants);
+    EXPECT_TRUE(broadcaster.wants().rotationApplied);
+
+    VideoFrame frame = makeFrame(1);
+    frame.setRotation(VideoRotation::kAngle90);
+    broadcaster.onFrame(frame);
+    EXPECT_TRUE(sink.ids().empty());
+    EXPECT_EQ(sink.mDiscarded.load(), 1);
+}
+
+TEST(VideoBroadcasterTest, ClearsUpdateRectForNewSinks)
+{
+    VideoBroadcaster broadcaster;
+    RecordingSink first;
+    broadcaster.addOrUpdateSink(&first, VideoSinkWants());
+    broadcaster.onFrame(makeFrame(1, true));
+    broadcaster.onFrame(makeFrame(2, true));
+
+    RecordingSink second;
+    broadcaster.addOrUpdateSink(&second, VideoSinkWants());
+    broadcaster.onFrame(makeFrame(3, true));
+    broadcaster.onFrame(makeFrame(4, true));
+
+    EXPECT_EQ(first.updateRects(), (std::vector<bool>{false, true, false, true}));
+    EXPECT_EQ(second.updateRects(), (std::vector<bool>{false, true}));
+}
+
+TEST(VideoBroadcasterTest, RemoveSinkWaitsForDeliveryInProgress)
+{
+    VideoBroadcaster broadcaster;
+    RecordingSink slow(std::chrono::milliseconds(100));
+    broadcaster.addOrUpdateSink(&slow, VideoSinkWants());
+
+    std::thread producer([&]() { broadcaster.onFrame(makeFrame(1)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    broadcaster.removeSink(&slow);
+    // the frame in progress finished before removeSink returned
+    EXPECT_EQ(slow.ids().size(), 1u);
+    producer.join();
+}
+
+TEST(VideoBroadcasterTest, AsyncSinkDoesNotStallOthers)
+{
+    VideoBroadcaster broadcaster;
+    RecordingSink slow(std::chrono::milliseconds(50));
+    RecordingSink fast;
+    VideoBroadcaster::SinkOptions options;
+    options.async = true;
+    options.queueSize = 1;
+    broadcaster.addOrUpdateSink(&slow, VideoSinkWants(), options);
+    broadcaster.addOrUpdateSink(&fast, VideoSinkWants());
+
+    const auto start = std::chrono::steady_clock::now();
+    broadcaster.onFrame(makeFrame(1));
+    while (0 == slow.mEntered.load())
+    {
+        std::this_thread::yield();
+    }
+    for (uint16_t id = 2; id <= 5; ++id)
+    {
+        broadcaster.onFrame(makeFrame(id));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+    EXPECT_EQ(fast.ids().size(), 5u);
+
+    // the first frame is being delivered, of the rest only the newest is kept
+    ASSERT_TRUE(waitForDelivered(broadcaster, &slow, 2));
+    EXPECT_EQ(slow.ids(), (std::vector<uint16_t>{1, 5}));
+    const auto stats = broadcaster.sinkStats(&slow);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->framesDelivered, 2u);
+    EXPECT_EQ(stats->framesDropped, 3u);
+    EXPECT_GE(stats->maxLatencyUSecs, 50000);
+    EXPECT_GE(stats->maxLatencyUSecs, stats->averageLatencyUSecs);
+
+    // updating the wants keeps the delivery mode
+    broadcaster.addOrUpdateSink(&slow, VideoSinkWants());
+    broadcaster.onFrame(makeFrame(6));
+    EXPECT_TRUE(waitForDelivered(broadcaster, &slow, 3));
+    broadcaster.removeSink(&slow);
+}
+
+TEST(VideoBroadcasterTest, SharesConversionsBetweenSinks)
+{
+    class ConvertingSink : public VideoSinkInterface<VideoFrame>
+    {
+    public:
+        void onFrame(const VideoFrame &frame) override { mI420 = frame.videoFrameBuffer()->toI420(); }
+        std::shared_ptr<I420BufferInterface> mI420;
+    };
+
+    VideoBroadcaster broadcaster;
+    broadcaster.setShareConversions(true);
+    ConvertingSink renderer;
+    ConvertingSink encoder;
+    ConvertingSink recorder;
+    broadcaster.addOrUpdateSink(&renderer, VideoSinkWants());
+    broadcaster.addOrUpdateSink(&encoder, VideoSinkWants());
+    broadcaster.addOrUpdateSink(&recorder, VideoSinkWants());
+
+    const auto before = LazyVideoFrameBuffer::totalStats();
+    broadcaster.onFrame(VideoFrame::Builder().setVideoFrameBuffer(NV12Buffer::create(32, 16)).setId(1).build());
+    const auto after = LazyVideoFrameBuffer::totalStats();
+    ASSERT_TRUE(renderer.mI420);
+    EXPECT_EQ(renderer.mI420, encoder.mI420);
+    EXPECT_EQ(renderer.mI420, recorder.mI420);
+    EXPECT_EQ(after.conversions - before.conversions, 1u);
+    EXPECT_EQ(after.conversionsAvoided - before.conversionsAvoided, 2u);
+
+    broadcaster.setShareConversions(false);
+    broadcaster.onFrame(VideoFrame::Builder().setVideoFrameBuffer(NV12Buffer::create(32, 16)).setId(2).build());
+    EXPECT_NE(renderer.mI420, encoder.mI420);
+}
+
+OCTK_END_NAMESPACE
@@ -23,13 +23,16 @@
 **
 ***********************************************************************************************************************/
 
-#include <openctk/core/video_frame_buffer_pool.hpp>
-#include <openctk/core/video_frame_buffer.hpp>
-#include <openctk/core/i420_buffer.hpp>
+#include <openctk/media/video_frame_buffer_pool.hpp>
+#include <openctk/media/video_frame_buffer.hpp>
+#include <openctk/media/i420_buffer.hpp>
 
 #include <stdint.h>
 #include <string.h>
 
+#include <thread>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -154,4 +157,135 @@ TEST(VideoFrameBufferPoolTests, SwitchingPixelFormat)
     EXPECT_EQ(nullptr, pool.CreateI210Buffer(16, 16).get());
 }
 
+TEST(VideoFrameBufferPoolTests, CountsAllocations)
+{
+    VideoFrameBufferPool pool(false, 2);
+    EXPECT_EQ(0u, pool.AllocationCount());
+    auto first = pool.CreateI420Buffer(16, 16);
+    auto second = pool.CreateI420Buffer(16, 16);
+    EXPECT_EQ(2u, pool.AllocationCount());
+    first = nullptr;
+    first = pool.CreateI420Buffer(16, 16);
+    EXPECT_EQ(2u, pool.AllocationCount());
+}
+
+TEST(VideoFrameBufferPoolTests, GrowingKeepsFreeBuffers)
+{
+    VideoFrameBufferPool pool(false, 1);
+    auto buffer = pool.CreateI420Buffer(16, 16);
+    const uint8_t *y_ptr = buffer->dataY();
+    buffer = nullptr;
+    EXPECT_TRUE(pool.Resize(4));
+    buffer = pool.CreateI420Buffer(16, 16);
+    EXPECT_EQ(y_ptr, buffer->dataY());
+    EXPECT_EQ(1u, pool.AllocationCount());
+}
+
+TEST(VideoFrameBufferPoolTests, KeepsShapesApart)
+{
+    VideoFrameBufferPool pool(false, 1);
+    auto small = pool.CreateI420Buffer(16, 16);
+    auto large = pool.CreateI420Buffer(32, 16);
+    auto nv12 = pool.CreateNV12Buffer(16, 16);
+    const uint8_t *small_ptr = small->dataY();
+    const uint8_t *large_ptr = large->dataY();
+    small = nullptr;
+    large = nullptr;
+    // Switching between resolutions recycles the buffers of both.
+    EXPECT_EQ(large_ptr, pool.CreateI420Buffer(32, 16)->dataY());
+    EXPECT_EQ(small_ptr, pool.CreateI420Buffer(16, 16)->dataY());
+    EXPECT_EQ(3u, pool.AllocationCount());
+}
+
+TEST(VideoFrameBufferPoolTests, Stats)
+{
+    VideoFrameBufferPool pool;
+    auto first = pool.CreateI420Buffer(16, 16);
+    auto second = pool.CreateI420Buffer(16, 16);
+    first = nullptr;
+    first = pool.CreateI420Buffer(16, 16);
+    second = nullptr;
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(2u, stats.misses);
+    EXPECT_EQ(1u, stats.buffersInUse);
+    EXPECT_EQ(1u, stats.buffersFree);
+    EXPECT_EQ(2u * 16 * 24, stats.bytesResident);
+    EXPECT_EQ(16u * 24, stats.bytesFree);
+
+    pool.Release();
+    stats = pool.GetStats();
+    EXPECT_EQ(1u, stats.trimmed);
+    EXPECT_EQ(0u, stats.buffersFree);
+    EXPECT_EQ(16u * 24, stats.bytesResident);
+}
+
+TEST(VideoFrameBufferPoolTests, TrimsAboveHighWaterMark)
+{
+    VideoFrameBufferPool::Options options;
+    // Room for two free 16x16 I420 buffers.
+    options.highWaterBytes = 2 * 16 * 24;
+    VideoFrameBufferPool pool(options);
+    std::vector<std::shared_ptr<I420Buffer>> buffers;
+    for (int i = 0; i < 4; ++i)
+    {
+        buffers.push_back(pool.CreateI420Buffer(16, 16));
+    }
+    const uint8_t *newest_ptr = buffers.back()->dataY();
+    buffers.clear();
+    auto stats = pool.GetStats();
+    EXPECT_EQ(2u, stats.buffersFree);
+    EXPECT_EQ(2u, stats.trimmed);
+    // The most recently returned buffer is handed out first.
+    EXPECT_EQ(newest_ptr, pool.CreateI420Buffer(16, 16)->dataY());
+
+    pool.Trim(0);
+    EXPECT_EQ(0u, pool.GetStats().bytesFree);
+}
+
+TEST(VideoFrameBufferPoolTests, SharedAcrossThreads)
+{
+    VideoFrameBufferPool::Options options;
+    options.maxBuffersPerShape = 16;
+    VideoFrameBufferPool pool(options);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(
+            [&pool]()
+            {
+                for (int j = 0; j < 1000; ++j)
+                {
+                    auto buffer = pool.CreateNV12Buffer(32, 32);
+                    ASSERT_TRUE(buffer);
+                    memset(buffer->MutableDataY(), j & 0xff, buffer->strideY() * buffer->height());
+                    // Hand the buffer to another thread which drops the last reference.
+                    std::thread([buffer]() mutable { buffer = nullptr; }).join();
+                }
+            });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    const auto stats = pool.GetStats();
+    EXPECT_EQ(4000u, stats.hits + stats.misses);
+    EXPECT_LE(stats.misses, 4u);
+    EXPECT_EQ(0u, stats.buffersInUse);
+}
+
+TEST(VideoFrameBufferPoolTests, HugePageOptions)
+{
+    VideoFrameBufferPool::Options options;
+    options.hugePages = true;
+    options.numaNode = 0;
+    options.zeroInitialize = true;
+    VideoFrameBufferPool pool(options);
+    auto buffer = pool.CreateI420Buffer(1920, 1080);
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(0, buffer->dataY()[1920 * 1080 - 1]);
+    memset(buffer->MutableDataY(), 0xA5, 1920 * 1080);
+}
+
 OCTK_END_NAMESPACE
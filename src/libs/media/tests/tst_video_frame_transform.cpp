@@ -0,0 +1,250 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/video_frame_transform.hpp>
+#include <openctk/media/yuv.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+
+#include <gtest/gtest.h>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+void fillRandom(uint8_t *data, int stride, int width, int height, std::mt19937 &generator)
+{
+    std::uniform_int_distribution<int> distribution(0, 255);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            data[stride * y + x] = static_cast<uint8_t>(distribution(generator));
+        }
+    }
+}
+
+std::shared_ptr<I420Buffer> randomI420(int width, int height)
+{
+    std::mt19937 generator(width * height);
+    auto buffer = I420Buffer::create(width, height);
+    fillRandom(buffer->MutableDataY(), buffer->strideY(), width, height, generator);
+    fillRandom(buffer->MutableDataU(), buffer->strideU(), buffer->chromaWidth(), buffer->chromaHeight(), generator);
+    fillRandom(buffer->MutableDataV(), buffer->strideV(), buffer->chromaWidth(), buffer->chromaHeight(), generator);
+    return buffer;
+}
+
+std::shared_ptr<NV12Buffer> randomNV12(int width, int height)
+{
+    std::mt19937 generator(width * height);
+    auto buffer = NV12Buffer::create(width, height);
+    fillRandom(buffer->MutableDataY(), buffer->strideY(), width, height, generator);
+    fillRandom(buffer->MutableDataUV(), buffer->strideUV(), 2 * buffer->chromaWidth(), buffer->chromaHeight(), generator);
+    return buffer;
+}
+
+int planeDifference(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height)
+{
+    int difference = 0;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            difference = std::max(difference, std::abs(a[strideA * y + x] - b[strideB * y + x]));
+        }
+    }
+    return difference;
+}
+
+// Largest per sample difference of two I420 images, -1 if their sizes differ.
+int maxDifference(const I420BufferInterface &a, const I420BufferInterface &b)
+{
+    if (a.width() != b.width() || a.height() != b.height())
+    {
+        return -1;
+    }
+    return std::max({planeDifference(a.dataY(), a.strideY(), b.dataY(), b.strideY(), a.width(), a.height()),
+                     planeDifference(a.dataU(), a.strideU(), b.dataU(), b.strideU(), a.chromaWidth(), a.chromaHeight()),
+                     planeDifference(a.dataV(), a.strideV(), b.dataV(), b.strideV(), a.chromaWidth(), a.chromaHeight())});
+}
+
+// The unfused chain the transform replaces: crop and scale, rotate, each into a new buffer.
+std::shared_ptr<I420Buffer> reference(const I420BufferInterface &src,
+                                      int cropX,
+                                      int cropY,
+                                      int cropWidth,
+                                      int cropHeight,
+                                      int scaleWidth,
+                                      int scaleHeight,
+                                      VideoRotation rotation)
+{
+    auto scaled = I420Buffer::create(scaleWidth, scaleHeight);
+    scaled->cropAndScaleFrom(src, cropX, cropY, cropWidth, cropHeight);
+    return I420Buffer::Rotate(*scaled, rotation);
+}
+
+class VideoFrameTransformTest : public testing::Test
+{
+protected:
+    void SetUp() override { mDefaults = utils::yuv::sliceOptions(); }
+    void TearDown() override { utils::yuv::setSliceOptions(mDefaults); }
+
+    void setSliced(bool sliced)
+    {
+        utils::yuv::SliceOptions options;
+        options.sliceCount = sliced ? 4 : 1;
+        options.sliceCacheBytes = 4096;
+        options.minSlicedPixels = 0;
+        utils::yuv::setSliceOptions(options);
+    }
+
+private:
+    utils::yuv::SliceOptions mDefaults;
+};
+
+const VideoRotation kRotations[] = {VideoRotation::kAngle0,
+                                    VideoRotation::kAngle90,
+                                    VideoRotation::kAngle180,
+                                    VideoRotation::kAngle270};
+} // namespace
+
+TEST_F(VideoFrameTransformTest, OutputSize)
+{
+    VideoFrameTransform transform;
+    EXPECT_EQ(640, transform.outputWidth(640, 480));
+    EXPECT_EQ(480, transform.outputHeight(640, 480));
+    transform.setCrop(10, 20, 320, 200).setRotation(VideoRotation::kAngle90);
+    EXPECT_EQ(200, transform.outputWidth(640, 480));
+    EXPECT_EQ(320, transform.outputHeight(640, 480));
+    transform.setScale(160, 100);
+    EXPECT_EQ(100, transform.outputWidth(640, 480));
+    EXPECT_EQ(160, transform.outputHeight(640, 480));
+}
+
+TEST_F(VideoFrameTransformTest, I420MatchesUnfusedChain)
+{
+    const auto src = randomI420(640, 360);
+    // Exact downscales run in strips, the others as a whole frame.
+    const int scales[][2] = {{320, 180}, {320, 160}, {300, 170}, {640, 360}, {500, 400}};
+    for (bool sliced : {false, true})
+    {
+        setSliced(sliced);
+        for (const auto &scale : scales)
+        {
+            for (const auto rotation : kRotations)
+            {
+                SCOPED_TRACE(testing::Message() << scale[0] << "x" << scale[1] << " rotation "
+                                                << static_cast<int>(rotation) << " sliced " << sliced);
+                VideoFrameTransform transform;
+                transform.setCrop(64, 20, 640 - 128, 320).setScale(scale[0], scale[1]).setRotation(rotation);
+                const auto result = transform.apply(*src);
+                ASSERT_TRUE(result);
+                ASSERT_EQ(VideoFrameBuffer::Type::kI420, result->type());
+                const auto expected = reference(*src, 64, 20, 640 - 128, 320, scale[0], scale[1], rotation);
+                EXPECT_EQ(0, maxDifference(*expected, *result->getI420()));
+            }
+        }
+    }
+}
+
+TEST_F(VideoFrameTransformTest, NV12ToI420)
+{
+    const auto src = randomNV12(640, 480);
+    const auto i420 = src->toI420();
+    for (bool sliced : {false, true})
+    {
+        setSliced(sliced);
+        for (const auto rotation : kRotations)
+        {
+            SCOPED_TRACE(testing::Message() << "rotation " << static_cast<int>(rotation) << " sliced " << sliced);
+            VideoFrameTransform transform;
+            transform.setCrop(32, 48, 576, 384).setRotation(rotation);
+            auto result = transform.apply(*src);
+            ASSERT_TRUE(result);
+            EXPECT_EQ(0, maxDifference(*reference(*i420, 32, 48, 576, 384, 576, 384, rotation), *result->getI420()));
+
+            // Scaling interleaved chroma rounds like scaling split planes up to the box filter's last bit.
+            transform.setScale(288, 192);
+            result = transform.apply(*src);
+            ASSERT_TRUE(result);
+            EXPECT_GE(1, maxDifference(*reference(*i420, 32, 48, 576, 384, 288, 192, rotation), *result->getI420()));
+        }
+    }
+}
+
+TEST_F(VideoFrameTransformTest, OutputNV12)
+{
+    const auto src = randomNV12(640, 480);
+    const auto i420 = randomI420(640, 480);
+    for (const auto rotation : kRotations)
+    {
+        SCOPED_TRACE(testing::Message() << "rotation " << static_cast<int>(rotation));
+        VideoFrameTransform transform;
+        transform.setCrop(16, 16, 480, 320).setScale(240, 160).setRotation(rotation);
+        transform.setOutputType(VideoFrameBuffer::Type::kNV12);
+
+        auto result = transform.apply(*src);
+        ASSERT_TRUE(result);
+        ASSERT_EQ(VideoFrameBuffer::Type::kNV12, result->type());
+        auto expected = NV12Buffer::create(240, 160);
+        expected->cropAndScaleFrom(*src, 16, 16, 480, 320);
+        EXPECT_EQ(0, maxDifference(*I420Buffer::Rotate(*expected->toI420(), rotation), *result->toI420()));
+
+        result = transform.apply(*i420);
+        ASSERT_TRUE(result);
+        ASSERT_EQ(VideoFrameBuffer::Type::kNV12, result->type());
+        EXPECT_EQ(0, maxDifference(*reference(*i420, 16, 16, 480, 320, 240, 160, rotation), *result->toI420()));
+    }
+}
+
+TEST_F(VideoFrameTransformTest, BufferPool)
+{
+    const auto src = randomI420(320, 240);
+    VideoFrameBufferPool pool(false, 2);
+    VideoFrameTransform transform;
+    transform.setScale(160, 120).setRotation(VideoRotation::kAngle90).setBufferPool(&pool);
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto result = transform.apply(*src);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(120, result->width());
+        EXPECT_EQ(160, result->height());
+    }
+    EXPECT_EQ(1u, pool.AllocationCount());
+}
+
+TEST_F(VideoFrameTransformTest, InvalidCrop)
+{
+    const auto src = randomI420(320, 240);
+    VideoFrameTransform transform;
+    transform.setCrop(100, 0, 256, 240);
+    EXPECT_FALSE(transform.apply(*src));
+
+    auto dst = I420Buffer::create(100, 100);
+    EXPECT_FALSE(VideoFrameTransform().applyTo(*src, *dst));
+}
+
+OCTK_END_NAMESPACE
@@ -0,0 +1,305 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/video_quality_analyzer.hpp>
+#include <openctk/media/yuv.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+std::shared_ptr<I420Buffer> randomI420(int width, int height, uint32_t seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    auto buffer = I420Buffer::create(width, height);
+    const int chromaSize = buffer->chromaHeight() * buffer->strideU();
+    for (int i = 0; i < buffer->height() * buffer->strideY(); ++i)
+    {
+        buffer->MutableDataY()[i] = static_cast<uint8_t>(distribution(generator));
+    }
+    for (int i = 0; i < chromaSize; ++i)
+    {
+        buffer->MutableDataU()[i] = static_cast<uint8_t>(distribution(generator));
+        buffer->MutableDataV()[i] = static_cast<uint8_t>(distribution(generator));
+    }
+    return buffer;
+}
+
+// Copy of src with uniform noise of +-amplitude added to every sample.
+std::shared_ptr<I420Buffer> noisyCopy(const I420Buffer &src, int amplitude, uint32_t seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(-amplitude, amplitude);
+    auto buffer = I420Buffer::Copy(src);
+    uint8_t *planes[] = {buffer->MutableDataY(), buffer->MutableDataU(), buffer->MutableDataV()};
+    const int sizes[] = {buffer->height() * buffer->strideY(),
+                         buffer->chromaHeight() * buffer->strideU(),
+                         buffer->chromaHeight() * buffer->strideV()};
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        for (int i = 0; i < sizes[plane]; ++i)
+        {
+            const int value = planes[plane][i] + distribution(generator);
+            planes[plane][i] = static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+        }
+    }
+    return buffer;
+}
+
+// Straightforward SSIM over 8x8 windows on a 4 pixel grid.
+double referenceSSIM(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height)
+{
+    double sum = 0.0;
+    int windows = 0;
+    for (int y = 0; y + 8 <= height; y += 4)
+    {
+        for (int x = 0; x + 8 <= width; x += 4)
+        {
+            double meanA = 0, meanB = 0;
+            for (int j = 0; j < 8; ++j)
+            {
+                for (int i = 0; i < 8; ++i)
+                {
+                    meanA += a[(y + j) * strideA + x + i];
+                    meanB += b[(y + j) * strideB + x + i];
+                }
+            }
+            meanA /= 64;
+            meanB /= 64;
+            double varA = 0, varB = 0, covariance = 0;
+            for (int j = 0; j < 8; ++j)
+            {
+                for (int i = 0; i < 8; ++i)
+                {
+                    const double da = a[(y + j) * strideA + x + i] - meanA;
+                    const double db = b[(y + j) * strideB + x + i] - meanB;
+                    varA += da * da;
+                    varB += db * db;
+                    covariance += da * db;
+                }
+            }
+            varA /= 64;
+            varB /= 64;
+            covariance /= 64;
+            const double c1 = 6.5025, c2 = 58.5225;
+            sum += ((2 * meanA * meanB + c1) * (2 * covariance + c2)) /
+                   ((meanA * meanA + meanB * meanB + c1) * (varA + varB + c2));
+            ++windows;
+        }
+    }
+    return sum / windows;
+}
+
+void expectSameResult(const VideoQualityAnalyzer::FrameResult &expected,
+                      const VideoQualityAnalyzer::FrameResult &actual)
+{
+    for (int plane = 0; plane < VideoQualityAnalyzer::kPlaneCount; ++plane)
+    {
+        EXPECT_EQ(expected.psnr[plane], actual.psnr[plane]);
+        EXPECT_EQ(expected.ssim[plane], actual.ssim[plane]);
+        EXPECT_EQ(expected.msssim[plane], actual.msssim[plane]);
+    }
+}
+} // namespace
+
+TEST(VideoQualityAnalyzerTest, PlaneSSIMMatchesReference)
+{
+    // Odd sizes leave partial blocks and vector tails.
+    const int sizes[][2] = {{640, 360}, {97, 53}, {33, 17}, {16, 8}};
+    for (const auto &size : sizes)
+    {
+        auto ref = randomI420(size[0], size[1], 1);
+        auto test = noisyCopy(*ref, 24, 2);
+        const double expected =
+            referenceSSIM(ref->dataY(), ref->strideY(), test->dataY(), test->strideY(), size[0], size[1]);
+        const double actual =
+            utils::yuv::planeSSIM(ref->dataY(), ref->strideY(), test->dataY(), test->strideY(), size[0], size[1]);
+        EXPECT_NEAR(expected, actual, 1e-9) << size[0] << "x" << size[1];
+    }
+}
+
+TEST(VideoQualityAnalyzerTest, ThinPlaneSSIMDoesNotOverflow)
+{
+    // narrower than two blocks, compared as one window whose squared sums exceed 32 bits
+    const int width = 4;
+    const int height = 40000;
+    std::vector<uint8_t> a(width * height);
+    std::vector<uint8_t> b(width * height);
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        a[i] = static_cast<uint8_t>(200 + i % 56);
+        b[i] = static_cast<uint8_t>(a[i] - i % 7);
+    }
+    double sa = 0, sb = 0, saa = 0, sbb = 0, sab = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        sa += a[i];
+        sb += b[i];
+        saa += a[i] * a[i];
+        sbb += b[i] * b[i];
+        sab += a[i] * b[i];
+    }
+    const double n = static_cast<double>(a.size());
+    const double meanA = sa / n, meanB = sb / n;
+    const double varA = saa / n - meanA * meanA, varB = sbb / n - meanB * meanB;
+    const double covariance = sab / n - meanA * meanB;
+    const double c1 = 6.5025, c2 = 58.5225;
+    const double expected = ((2 * meanA * meanB + c1) * (2 * covariance + c2)) /
+                            ((meanA * meanA + meanB * meanB + c1) * (varA + varB + c2));
+    EXPECT_NEAR(expected, utils::yuv::planeSSIM(a.data(), width, b.data(), width, width, height), 1e-9);
+}
+
+TEST(VideoQualityAnalyzerTest, IdenticalFramesArePerfect)
+{
+    auto ref = randomI420(320, 240, 3);
+    const auto result = VideoQualityAnalyzer::analyze(*ref, *I420Buffer::Copy(*ref), VideoQualityAnalyzer::kAllMetrics);
+    for (int plane = 0; plane < VideoQualityAnalyzer::kPlaneCount; ++plane)
+    {
+        EXPECT_FLOAT_EQ(utils::kPerfectPSNR, result.psnr[plane]);
+        EXPECT_FLOAT_EQ(1.0f, result.ssim[plane]);
+        EXPECT_FLOAT_EQ(1.0f, result.msssim[plane]);
+    }
+}
+
+TEST(VideoQualityAnalyzerTest, ScoresDropWithNoise)
+{
+    auto ref = randomI420(320, 240, 4);
+    const auto light = VideoQualityAnalyzer::analyze(*ref, *noisyCopy(*ref, 4, 5), VideoQualityAnalyzer::kAllMetrics);
+    const auto heavy = VideoQualityAnalyzer::analyze(*ref, *noisyCopy(*ref, 32, 5), VideoQualityAnalyzer::kAllMetrics);
+    for (int plane = 0; plane < VideoQualityAnalyzer::kPlaneCount; ++plane)
+    {
+        EXPECT_GT(light.psnr[plane], heavy.psnr[plane]);
+        EXPECT_GT(light.ssim[plane], heavy.ssim[plane]);
+        EXPECT_GT(light.msssim[plane], heavy.msssim[plane]);
+        EXPECT_LT(heavy.msssim[plane], 1.0f);
+        EXPECT_GT(heavy.msssim[plane], 0.0f);
+    }
+
+    const auto psnrOnly = VideoQualityAnalyzer::analyze(*ref, *noisyCopy(*ref, 4, 5), VideoQualityAnalyzer::kPSNR);
+    EXPECT_EQ(light.psnr[0], psnrOnly.psnr[0]);
+    EXPECT_TRUE(std::isnan(psnrOnly.ssim[0]));
+    EXPECT_TRUE(std::isnan(psnrOnly.msssim[0]));
+}
+
+TEST(VideoQualityAnalyzerTest, KeepsFrameOrderAndWritesLog)
+{
+    const std::string logPath = ::testing::TempDir() + "video_quality_analyzer.log";
+    VideoQualityAnalyzer::Options options;
+    options.workers = 4;
+    options.maxPendingFrames = 3;
+    options.logPath = logPath;
+
+    std::vector<VideoQualityAnalyzer::FrameResult> expected;
+    {
+        VideoQualityAnalyzer analyzer(options);
+        for (uint32_t i = 0; i < 24; ++i)
+        {
+            auto ref = randomI420(176, 144, i);
+            // Every third test frame is smaller and scaled up before the comparison.
+            auto test = noisyCopy(*ref, static_cast<int>(i % 8), i + 100);
+            if (0 == i % 3)
+            {
+                test = I420Buffer::create(88, 72);
+                test->scaleFrom(*ref);
+            }
+            expected.push_back(VideoQualityAnalyzer::analyze(*ref, *test, options.metrics));
+            EXPECT_EQ(i, analyzer.addFrame(ref, test));
+        }
+        ASSERT_TRUE(analyzer.flush());
+
+        const auto results = analyzer.results();
+        ASSERT_EQ(expected.size(), results.size());
+        for (uint32_t i = 0; i < results.size(); ++i)
+        {
+            EXPECT_EQ(i, results[i].frameIndex);
+            expectSameResult(expected[i], results[i]);
+        }
+        const auto summary = analyzer.summary();
+        EXPECT_EQ(24, summary.frames);
+        EXPECT_GT(summary.psnr[0], 30.0);
+    }
+
+    std::vector<VideoQualityAnalyzer::FrameResult> logged;
+    ASSERT_TRUE(VideoQualityAnalyzer::readLog(logPath, logged));
+    ASSERT_EQ(expected.size(), logged.size());
+    for (uint32_t i = 0; i < logged.size(); ++i)
+    {
+        EXPECT_EQ(i, logged[i].frameIndex);
+        expectSameResult(expected[i], logged[i]);
+    }
+    std::remove(logPath.c_str());
+}
+
+TEST(VideoQualityAnalyzerTest, AnalyzesFiles)
+{
+    const int width = 64;
+    const int height = 48;
+    const std::string refPath = ::testing::TempDir() + "video_quality_analyzer_ref.yuv";
+    const std::string testPath = ::testing::TempDir() + "video_quality_analyzer_test.yuv";
+    std::FILE *refFile = std::fopen(refPath.c_str(), "wb");
+    std::FILE *testFile = std::fopen(testPath.c_str(), "wb");
+    ASSERT_TRUE(refFile && testFile);
+    std::vector<VideoQualityAnalyzer::FrameResult> expected;
+    const size_t frameSize = width * height * 3 / 2;
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        auto ref = randomI420(width, height, i);
+        auto test = noisyCopy(*ref, 10, i);
+        expected.push_back(VideoQualityAnalyzer::analyze(*ref, *test, VideoQualityAnalyzer::kAllMetrics));
+        EXPECT_EQ(1u, std::fwrite(ref->dataY(), frameSize, 1, refFile));
+        EXPECT_EQ(1u, std::fwrite(test->dataY(), frameSize, 1, testFile));
+    }
+    // A trailing partial frame is ignored.
+    EXPECT_EQ(1u, std::fwrite(expected.data(), 16, 1, testFile));
+    std::fclose(refFile);
+    std::fclose(testFile);
+
+    VideoQualityAnalyzer::Options options;
+    options.maxPendingFrames = 2;
+    VideoQualityAnalyzer analyzer(options);
+    EXPECT_EQ(5, analyzer.addFiles(refPath, testPath, width, height));
+    EXPECT_EQ(-1, analyzer.addFiles(refPath + ".missing", testPath, width, height));
+    ASSERT_TRUE(analyzer.flush());
+    const auto results = analyzer.results();
+    ASSERT_EQ(expected.size(), results.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        expectSameResult(expected[i], results[i]);
+    }
+    std::remove(refPath.c_str());
+    std::remove(testPath.c_str());
+}
+
+OCTK_END_NAMESPACE
@@ -0,0 +1,184 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/yuv.hpp>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace octk;
+
+namespace
+{
+struct Resolution
+{
+    int width;
+    int height;
+};
+
+const Resolution kResolutions[] = {{640, 360}, {1280, 720}, {1920, 1080}, {3840, 2160}};
+
+// range(0): index into kResolutions, range(1): slice count, 0 uses every pool thread and 1 disables slicing.
+class YuvSlices
+{
+public:
+    explicit YuvSlices(const benchmark::State &state)
+        : mResolution(kResolutions[state.range(0)])
+        , mDefaults(utils::yuv::sliceOptions())
+    {
+        auto options = mDefaults;
+        options.sliceCount = static_cast<int>(state.range(1));
+        utils::yuv::setSliceOptions(options);
+    }
+    ~YuvSlices() { utils::yuv::setSliceOptions(mDefaults); }
+
+    int width() const { return mResolution.width; }
+    int height() const { return mResolution.height; }
+
+private:
+    const Resolution mResolution;
+    const utils::yuv::SliceOptions mDefaults;
+};
+
+void setPixels(benchmark::State &state, const YuvSlices &slices)
+{
+    state.SetItemsProcessed(state.iterations() * slices.width() * slices.height());
+}
+} // namespace
+
+void BM_NV12ToI420(benchmark::State &state)
+{
+    YuvSlices slices(state);
+    std::vector<uint8_t> src(slices.width() * slices.height() * 3 / 2, 128);
+    std::vector<uint8_t> dst(src.size());
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        utils::yuv::convertNV12ToI420(src.data(), dst.data(), slices.width(), slices.height());
+    }
+    setPixels(state, slices);
+}
+
+void BM_I420ToARGB(benchmark::State &state)
+{
+    YuvSlices slices(state);
+    std::vector<uint8_t> src(slices.width() * slices.height() * 3 / 2, 128);
+    std::vector<uint8_t> dst(slices.width() * slices.height() * 4);
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        utils::yuv::convertI420ToARGB(src.data(), dst.data(), slices.width(), slices.height());
+    }
+    setPixels(state, slices);
+}
+
+void BM_ARGBToI420(benchmark::State &state)
+{
+    YuvSlices slices(state);
+    std::vector<uint8_t> src(slices.width() * slices.height() * 4, 128);
+    std::vector<uint8_t> dst(slices.width() * slices.height() * 3 / 2);
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        utils::yuv::convertARGBToI420(src.data(), dst.data(), slices.width(), slices.height());
+    }
+    setPixels(state, slices);
+}
+
+// Halves the resolution, the row sliced path.
+void BM_ScaleI420Half(benchmark::State &state)
+{
+    YuvSlices slices(state);
+    std::vector<uint8_t> src(slices.width() * slices.height() * 3 / 2, 128);
+    std::vector<uint8_t> dst(src.size() / 4);
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        utils::yuv::scaleI420(src.data(),
+                              slices.width(),
+                              slices.height(),
+                              dst.data(),
+                              slices.width() / 2,
+                              slices.height() / 2);
+    }
+    setPixels(state, slices);
+}
+
+// 4:3 downscale, libyuv steps are inexact so the planes run concurrently.
+void BM_ScaleI420ThreeQuarters(benchmark::State &state)
+{
+    YuvSlices slices(state);
+    std::vector<uint8_t> src(slices.width() * slices.height() * 3 / 2, 128);
+    std::vector<uint8_t> dst(src.size());
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        utils::yuv::scaleI420(src.data(),
+                              slices.width(),
+                              slices.height(),
+                              dst.data(),
+                              slices.width() * 3 / 4,
+                              slices.height() * 3 / 4);
+    }
+    setPixels(state, slices);
+}
+
+void BM_NV12ToI420Scale(benchmark::State &state)
+{
+    YuvSlices slices(state);
+    std::vector<uint8_t> src(slices.width() * slices.height() * 3 / 2, 128);
+    const int dstWidth = slices.width() / 2;
+    const int dstHeight = slices.height() / 2;
+    std::vector<uint8_t> dst(dstWidth * dstHeight * 3 / 2);
+    utils::NV12ToI420Scaler scaler;
+    for (auto s : state)
+    {
+        OCTK_UNUSED(s);
+        scaler.NV12ToI420Scale(src.data(),
+                               slices.width(),
+                               src.data() + slices.width() * slices.height(),
+                               slices.width(),
+                               slices.width(),
+                               slices.height(),
+                               dst.data(),
+                               dstWidth,
+                               dst.data() + dstWidth * dstHeight,
+                               dstWidth / 2,
+                               dst.data() + dstWidth * dstHeight * 5 / 4,
+                               dstWidth / 2,
+                               dstWidth,
+                               dstHeight);
+    }
+    setPixels(state, slices);
+}
+
+#define YUV_SLICES_BENCHMARK(name) BENCHMARK(name)->ArgsProduct({{0, 1, 2, 3}, {1, 0}})->UseRealTime()
+
+YUV_SLICES_BENCHMARK(BM_NV12ToI420);
+YUV_SLICES_BENCHMARK(BM_I420ToARGB);
+YUV_SLICES_BENCHMARK(BM_ARGBToI420);
+YUV_SLICES_BENCHMARK(BM_ScaleI420Half);
+YUV_SLICES_BENCHMARK(BM_ScaleI420ThreeQuarters);
+YUV_SLICES_BENCHMARK(BM_NV12ToI420Scale);
@@ -0,0 +1,235 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/media/yuv.hpp>
+
+#include <functional>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+std::vector<uint8_t> randomBytes(size_t size)
+{
+    std::mt19937 generator(size);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    std::vector<uint8_t> bytes(size);
+    for (auto &byte : bytes)
+    {
+        byte = static_cast<uint8_t>(distribution(generator));
+    }
+    return bytes;
+}
+
+class YuvSlicesTest : public testing::Test
+{
+protected:
+    void SetUp() override { mDefaults = utils::yuv::sliceOptions(); }
+    void TearDown() override { utils::yuv::setSliceOptions(mDefaults); }
+
+    // Runs convert once on the calling thread and once split into many small slices, both must write the same bytes.
+    void expectSlicedEqual(size_t dstSize, const std::function<void(uint8_t *)> &convert)
+    {
+        utils::yuv::SliceOptions options;
+        options.sliceCount = 1;
+        utils::yuv::setSliceOptions(options);
+        std::vector<uint8_t> expected(dstSize, 0x5a);
+        convert(expected.data());
+
+        options.sliceCount = 4;
+        options.sliceCacheBytes = 4096;
+        options.minSlicedPixels = 0;
+        utils::yuv::setSliceOptions(options);
+        std::vector<uint8_t> sliced(dstSize, 0x5a);
+        convert(sliced.data());
+        EXPECT_EQ(expected, sliced);
+    }
+
+private:
+    utils::yuv::SliceOptions mDefaults;
+};
+
+size_t i420Size(int width, int height) { return width * height * 3 / 2; }
+} // namespace
+
+TEST_F(YuvSlicesTest, Conversions)
+{
+    const int width = 320;
+    const int height = 180;
+    const auto i420 = randomBytes(i420Size(width, height));
+    const auto argb = randomBytes(width * height * 4);
+    expectSlicedEqual(width * height * 4,
+                      [&](uint8_t *dst) { utils::yuv::convertI420ToARGB(i420.data(), dst, width, height); });
+    expectSlicedEqual(width * height * 3,
+                      [&](uint8_t *dst) { utils::yuv::convertI420ToRGB24(i420.data(), dst, width, height); });
+    expectSlicedEqual(i420Size(width, height),
+                      [&](uint8_t *dst) { utils::yuv::convertI420ToNV21(i420.data(), dst, width, height); });
+    expectSlicedEqual(i420Size(width, height),
+                      [&](uint8_t *dst) { utils::yuv::convertARGBToI420(argb.data(), dst, width, height); });
+    expectSlicedEqual(i420Size(width, height),
+                      [&](uint8_t *dst) { utils::yuv::convertNV12ToI420(i420.data(), dst, width, height); });
+    expectSlicedEqual(width * height * 4,
+                      [&](uint8_t *dst) { utils::yuv::convertBGRAToARGB(argb.data(), dst, width, height); });
+}
+
+TEST_F(YuvSlicesTest, ConvertToI420WithCrop)
+{
+    const int width = 320;
+    const int height = 240;
+    const auto yuy2 = randomBytes(width * height * 2);
+    const int cropWidth = 256;
+    const int cropHeight = 202;
+    const auto convert = [&](VideoType type, const std::vector<uint8_t> &sample)
+    {
+        return [&, type](uint8_t *dst)
+        {
+            EXPECT_TRUE(utils::yuv::convertToI420(sample.data(),
+                                                  sample.size(),
+                                                  dst,
+                                                  cropWidth,
+                                                  dst + cropWidth * cropHeight,
+                                                  cropWidth / 2,
+                                                  dst + cropWidth * cropHeight * 5 / 4,
+                                                  cropWidth / 2,
+                                                  32,
+                                                  18,
+                                                  width,
+                                                  height,
+                                                  cropWidth,
+                                                  cropHeight,
+                                                  VideoRotation::kAngle0,
+                                                  type));
+        };
+    };
+    expectSlicedEqual(i420Size(cropWidth, cropHeight), convert(VideoType::kYUY2, yuy2));
+    expectSlicedEqual(i420Size(cropWidth, cropHeight), convert(VideoType::kNV12, yuy2));
+    expectSlicedEqual(i420Size(cropWidth, cropHeight), convert(VideoType::kARGB, randomBytes(width * height * 4)));
+}
+
+TEST_F(YuvSlicesTest, ScaleI420)
+{
+    const int width = 640;
+    const int height = 360;
+    const auto i420 = randomBytes(i420Size(width, height));
+    // Row sliced downscales and plane split scales for inexact ratios and upscales.
+    const int sizes[][2] = {{320, 180}, {426, 240}, {160, 90}, {480, 270}, {600, 346}, {800, 450}};
+    for (const auto &size : sizes)
+    {
+        for (bool highestQuality : {true, false})
+        {
+            SCOPED_TRACE(testing::Message() << size[0] << "x" << size[1] << " box:" << highestQuality);
+            expectSlicedEqual(i420Size(size[0], size[1]),
+                              [&](uint8_t *dst)
+                              {
+                                  utils::yuv::scaleI420(i420.data(),
+                                                        width,
+                                                        height,
+                                                        dst,
+                                                        size[0],
+                                                        size[1],
+                                                        highestQuality);
+                              });
+            expectSlicedEqual(i420Size(size[0], size[1]),
+                              [&](uint8_t *dst)
+                              {
+                                  utils::yuv::scaleNV12(i420.data(),
+                                                        width,
+                                                        height,
+                                                        dst,
+                                                        size[0],
+                                                        size[1],
+                                                        highestQuality);
+                              });
+        }
+    }
+}
+
+TEST_F(YuvSlicesTest, ScaleARGB)
+{
+    const int width = 320;
+    const int height = 240;
+    const auto argb = randomBytes(width * height * 4);
+    expectSlicedEqual(200 * 150 * 4,
+                      [&](uint8_t *dst) { utils::yuv::scaleARGB(argb.data(), width, height, dst, 200, 150); });
+    expectSlicedEqual(500 * 300 * 4,
+                      [&](uint8_t *dst) { utils::yuv::scaleARGB(argb.data(), width, height, dst, 500, 300, false); });
+}
+
+TEST_F(YuvSlicesTest, NV12ToI420Scaler)
+{
+    const int width = 640;
+    const int height = 480;
+    const auto nv12 = randomBytes(i420Size(width, height));
+    const auto scale = [&](int dstWidth, int dstHeight)
+    {
+        return [&, dstWidth, dstHeight](uint8_t *dst)
+        {
+            utils::NV12ToI420Scaler scaler;
+            scaler.NV12ToI420Scale(nv12.data(),
+                                   width,
+                                   nv12.data() + width * height,
+                                   width,
+                                   width,
+                                   height,
+                                   dst,
+                                   dstWidth,
+                                   dst + dstWidth * dstHeight,
+                                   dstWidth / 2,
+                                   dst + dstWidth * dstHeight * 5 / 4,
+                                   dstWidth / 2,
+                                   dstWidth,
+                                   dstHeight);
+        };
+    };
+    expectSlicedEqual(i420Size(width, height), scale(width, height));
+    expectSlicedEqual(i420Size(320, 240), scale(320, 240));
+    expectSlicedEqual(i420Size(360, 270), scale(360, 270));
+}
+
+TEST_F(YuvSlicesTest, CopyCenterIn)
+{
+    const auto large = randomBytes(i420Size(320, 240) * 2);
+    const auto small = randomBytes(i420Size(160, 98) * 2);
+    expectSlicedEqual(i420Size(200, 150),
+                      [&](uint8_t *dst) { utils::yuv::copyCenterInI420(large.data(), 320, 240, dst, 200, 150); });
+    expectSlicedEqual(i420Size(200, 150),
+                      [&](uint8_t *dst) { utils::yuv::copyCenterInI420(small.data(), 160, 98, dst, 200, 150); });
+    expectSlicedEqual(i420Size(200, 150),
+                      [&](uint8_t *dst) { utils::yuv::copyCenterInNV12(small.data(), 160, 98, dst, 200, 150); });
+    expectSlicedEqual(200 * 150 * 4,
+                      [&](uint8_t *dst) { utils::yuv::copyCenterInARGB(large.data(), 160, 120, dst, 200, 150); });
+    expectSlicedEqual(i420Size(200, 150),
+                      [&](uint8_t *dst)
+                      { utils::yuv::convertCenterInNV12ToI420(small.data(), 160, 98, dst, 200, 150); });
+    expectSlicedEqual(i420Size(120, 90),
+                      [&](uint8_t *dst)
+                      { utils::yuv::convertCenterInARGBToI420(large.data(), 160, 120, dst, 120, 90); });
+}
+
+OCTK_END_NAMESPACE
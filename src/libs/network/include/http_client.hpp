@@ -0,0 +1 @@
+#include "../source/http/http_client.hpp"
@@ -23,11 +23,166 @@
 ***********************************************************************************************************************/
 
 #include <openctk/network/detail/http_p.hpp>
+#include <openctk/core/logging.hpp>
+
+#if defined(OCTK_OS_WIN)
+#    include <windows.h>
+#    include <io.h>
+#else
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    include <fcntl.h>
+#    include <poll.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
 
 OCTK_BEGIN_NAMESPACE
 
 namespace http
 {
+namespace detail
+{
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+// Upload buffer of streamed bodies, fewer and larger reads than curl's 64KiB default.
+static constexpr long kBodyStreamBufferSize = 512 * 1024;
+
+BodyChunkWriter::BodyChunkWriter(ChunkCallback callback, bool pausable)
+    : mCallback(std::move(callback))
+    , mPausable(pausable)
+{
+}
+
+void BodyChunkWriter::install(CURL *handle)
+{
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &BodyChunkWriter::write);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, this);
+}
+
+void BodyChunkWriter::finish()
+{
+    if (!mAborted && !mChunk.empty())
+    {
+        this->deliver();
+    }
+}
+
+size_t BodyChunkWriter::write(char *data, size_t size, size_t count, void *userdata)
+{
+    auto writer = static_cast<BodyChunkWriter *>(userdata);
+    const size_t length = size * count;
+    if (!writer->mChunk.empty() && writer->mChunk.size() + length > writer->mChunk.capacity())
+    {
+        switch (writer->deliver())
+        {
+            case ChunkCallback::Action::kAbort: writer->mAborted = true; return 0;
+            case ChunkCallback::Action::kPause:
+                if (writer->mPausable)
+                {
+                    writer->mPaused = true;
+                    return CURL_WRITEFUNC_PAUSE;
+                }
+                break;
+            default: break;
+        }
+    }
+    if (0 == writer->mChunk.capacity())
+    {
+        const auto capacity = std::max(writer->mCallback.chunkSize, length);
+        writer->mChunk = writer->mCallback.allocator ? writer->mCallback.allocator(capacity)
+                                                     : SharedBuffer(0, capacity);
+        writer->mChunk.SetSize(0);
+        writer->mChunk.EnsureCapacity(length);
+    }
+    writer->mChunk.AppendData(data, length);
+    return length;
+}
+
+ChunkCallback::Action BodyChunkWriter::deliver()
+{
+    SharedBuffer chunk;
+    swap(chunk, mChunk);
+    return mCallback.consumer(std::move(chunk));
+}
+
+std::shared_ptr<MappedBodyFile> MappedBodyFile::open(const BodyFile &file)
+{
+    std::shared_ptr<MappedBodyFile> mapped(new MappedBodyFile);
+#if defined(OCTK_OS_WIN)
+    HANDLE handle = file.fd >= 0 ? reinterpret_cast<HANDLE>(_get_osfhandle(file.fd))
+                                 : CreateFileA(file.path.c_str(),
+                                               GENERIC_READ,
+                                               FILE_SHARE_READ,
+                                               nullptr,
+                                               OPEN_EXISTING,
+                                               FILE_ATTRIBUTE_NORMAL,
+                                               nullptr);
+    if (INVALID_HANDLE_VALUE == handle)
+    {
+        return nullptr;
+    }
+    LARGE_INTEGER size;
+    bool ok = GetFileSizeEx(handle, &size);
+    if (ok && size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            mapped->mData = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            mapped->mSize = static_cast<size_t>(size.QuadPart);
+            CloseHandle(mapping);
+        }
+        ok = nullptr != mapped->mData;
+    }
+    if (file.fd < 0)
+    {
+        CloseHandle(handle);
+    }
+#else
+    const int fd = file.fd >= 0 ? file.fd : ::open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat status;
+    bool ok = 0 == fstat(fd, &status) && S_ISREG(status.st_mode);
+    if (ok && status.st_size > 0)
+    {
+        void *data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (MAP_FAILED != data)
+        {
+            madvise(data, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+            mapped->mData = static_cast<const uint8_t *>(data);
+            mapped->mSize = static_cast<size_t>(status.st_size);
+        }
+        ok = nullptr != mapped->mData;
+    }
+    if (file.fd < 0)
+    {
+        ::close(fd);
+    }
+#endif
+    return ok ? mapped : nullptr;
+}
+
+MappedBodyFile::~MappedBodyFile()
+{
+    if (mData)
+    {
+#if defined(OCTK_OS_WIN)
+        UnmapViewOfFile(mData);
+#else
+        munmap(const_cast<uint8_t *>(mData), mSize);
+#endif
+    }
+}
+#endif
+} // namespace detail
+
 CookiePrivate::CookiePrivate(Cookie *p)
     : mPPtr(p)
 {
@@ -224,6 +379,16 @@ std::string Response::header(StringView key) const
 #endif
 }
 
+std::string Response::errorString() const
+{
+    OCTK_D(const Response);
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    return d->mResponse.error.message;
+#endif
+}
+
 AuthenticationPrivate::AuthenticationPrivate(Authentication *p)
     : mPPtr(p)
 {
@@ -311,6 +476,62 @@ SessionPrivate::~SessionPrivate()
 {
 }
 
+#if !OCTK_FEATURE_USE_BOOST_BACKEND
+void SessionPrivate::resetBody()
+{
+    mBodyRewinder = nullptr;
+    mBodyError.clear();
+    mBodyConsumed = false;
+    mBodyBlocking = false;
+}
+
+CURLcode SessionPrivate::prepareBody(std::string *error)
+{
+    if (!mBodyError.empty())
+    {
+        *error = mBodyError;
+        return CURLE_READ_ERROR;
+    }
+    if (mBodyRewinder)
+    {
+        if (!mBodyRewinder(0))
+        {
+            *error = "request body can't be rewound";
+            return CURLE_SEND_FAIL_REWIND;
+        }
+        mBodyConsumed = false;
+    }
+    else if (mBodyConsumed)
+    {
+        *error = "request body was already sent and can't be rewound";
+        return CURLE_SEND_FAIL_REWIND;
+    }
+    return CURLE_OK;
+}
+
+bool SessionPrivate::failUnpreparedBody(cpr::Response &response)
+{
+    std::string error;
+    const auto code = this->prepareBody(&error);
+    if (CURLE_OK == code)
+    {
+        return false;
+    }
+    response.error = cpr::Error(code, std::move(error));
+    return true;
+}
+
+int SessionPrivate::seekBody(void *userdata, curl_off_t offset, int origin)
+{
+    auto d = static_cast<SessionPrivate *>(userdata);
+    if (SEEK_SET != origin || !d->mBodyRewinder)
+    {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    return d->mBodyRewinder(offset) ? CURL_SEEKFUNC_OK : CURL_SEEKFUNC_FAIL;
+}
+#endif
+
 Session::Session()
     : mDPtr(new SessionPrivate(this))
 {
@@ -401,10 +622,115 @@ void Session::setBody(const Body &body)
 #if OCTK_FEATURE_USE_BOOST_BACKEND
 
 #else
+    d->resetBody();
     d->mSession.SetBody(body.string());
 #endif
 }
 
+constexpr size_t BodyStream::kAbort;
+
+void Session::setBody(const BodyStream &body)
+{
+    OCTK_D(Session);
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    d->resetBody();
+    auto producer = body.producer;
+    d->mSession.SetReadCallback(cpr::ReadCallback(body.size,
+                                                  [producer, d](char *buffer, size_t &size, intptr_t)
+                                                  {
+                                                      d->mBodyConsumed = true;
+                                                      const size_t length = producer(buffer, size);
+                                                      if (BodyStream::kAbort == length)
+                                                      {
+                                                          return false;
+                                                      }
+                                                      size = length;
+                                                      return true;
+                                                  }));
+    d->mBodyRewinder = body.rewinder;
+    CURL *handle = d->mSession.GetCurlHolder()->handle;
+    curl_easy_setopt(handle, CURLOPT_UPLOAD_BUFFERSIZE, detail::kBodyStreamBufferSize);
+    curl_easy_setopt(handle, CURLOPT_SEEKFUNCTION, body.rewinder ? &SessionPrivate::seekBody : nullptr);
+    curl_easy_setopt(handle, CURLOPT_SEEKDATA, d);
+#endif
+}
+
+void Session::setBody(const BodyFile &body)
+{
+    OCTK_D(Session);
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    auto mapped = detail::MappedBodyFile::open(body);
+    if (mapped && 0 == mapped->size())
+    {
+        // nothing mapped, send an empty body
+        this->setBody(Body(std::string()));
+        return;
+    }
+    if (mapped)
+    {
+        auto offset = std::make_shared<size_t>(0);
+        this->setBody(BodyStream(
+            [mapped, offset](char *data, size_t size)
+            {
+                const size_t length = std::min(size, mapped->size() - *offset);
+                std::memcpy(data, mapped->data() + *offset, length);
+                *offset += length;
+                return length;
+            },
+            static_cast<int64_t>(mapped->size()),
+            [mapped, offset](int64_t position)
+            {
+                if (position < 0 || static_cast<uint64_t>(position) > mapped->size())
+                {
+                    return false;
+                }
+                *offset = static_cast<size_t>(position);
+                return true;
+            }));
+        return;
+    }
+#    if !defined(OCTK_OS_WIN)
+    if (body.fd >= 0)
+    {
+        const int fd = body.fd;
+        this->setBody(BodyStream(
+            [fd](char *data, size_t size)
+            {
+                while (true)
+                {
+                    const auto length = ::read(fd, data, size);
+                    if (length >= 0)
+                    {
+                        return static_cast<size_t>(length);
+                    }
+                    if (EAGAIN == errno || EWOULDBLOCK == errno)
+                    {
+                        // non-blocking descriptor, wait for data like a blocking one would
+                        pollfd readable{fd, POLLIN, 0};
+                        ::poll(&readable, 1, -1);
+                    }
+                    else if (EINTR != errno)
+                    {
+                        OCTK_WARNING() << "http::Session: failed to read body fd " << fd << ": " << strerror(errno);
+                        return BodyStream::kAbort;
+                    }
+                }
+            }));
+        d->mBodyBlocking = true;
+        return;
+    }
+#    endif
+    OCTK_WARNING() << "http::Session: failed to open body file '" << body.path << "', fd " << body.fd;
+    // don't let the requests go out with whatever body was set before
+    d->resetBody();
+    d->mBodyError = "failed to open request body file '" + body.path + "', fd " + std::to_string(body.fd);
+#endif
+}
+
 void Session::setBearer(const Bearer &bearer)
 {
     OCTK_D(Session);
@@ -426,6 +752,7 @@ void Session::setPayload(const Payload &payload)
     {
         cprPayload.Add({item.key, item.value});
     }
+    d->resetBody();
     d->mSession.SetPayload(std::move(cprPayload));
 #endif
 }
@@ -470,7 +797,10 @@ Response::SharedPtr Session::put()
 #if OCTK_FEATURE_USE_BOOST_BACKEND
 
 #else
-    response->dFunc()->mResponse = std::move(d->mSession.Put());
+    if (!d->failUnpreparedBody(response->dFunc()->mResponse))
+    {
+        response->dFunc()->mResponse = std::move(d->mSession.Put());
+    }
 #endif
     return response;
 }
@@ -482,7 +812,10 @@ Response::SharedPtr Session::post()
 #if OCTK_FEATURE_USE_BOOST_BACKEND
 
 #else
-    response->dFunc()->mResponse = std::move(d->mSession.Post());
+    if (!d->failUnpreparedBody(response->dFunc()->mResponse))
+    {
+        response->dFunc()->mResponse = std::move(d->mSession.Post());
+    }
 #endif
     return response;
 }
@@ -511,6 +844,24 @@ Response::SharedPtr Session::download(const WriteCallback &write)
     return response;
 }
 
+Response::SharedPtr Session::download(const ChunkCallback &chunks)
+{
+    OCTK_D(Session);
+    auto response = utils::make_shared<Response>();
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    d->mSession.PrepareGet();
+    detail::BodyChunkWriter writer(chunks, false);
+    CURL *handle = d->mSession.GetCurlHolder()->handle;
+    writer.install(handle);
+    const auto code = curl_easy_perform(handle);
+    writer.finish();
+    response->dFunc()->mResponse = d->mSession.Complete(code);
+#endif
+    return response;
+}
+
 } // namespace http
 
 OCTK_END_NAMESPACE
\ No newline at end of file
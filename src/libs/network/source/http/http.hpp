@@ -27,15 +27,18 @@
 #include <openctk/network/network_global.hpp>
 #include <openctk/core/string_view.hpp>
 #include <openctk/core/thread_pool.hpp>
+#include <openctk/core/shared_buffer.hpp>
+#include <openctk/core/concurrent.hpp>
+#include <openctk/core/future.hpp>
 #include <openctk/core/memory.hpp>
 
 #include <map>
 #include <string>
-#include <future>
 #include <chrono>
 #include <fstream>
 #include <numeric>
 #include <algorithm>
+#include <functional>
 #include <initializer_list>
 
 OCTK_BEGIN_NAMESPACE
@@ -188,6 +191,92 @@ public:
     std::function<bool(std::string data, intptr_t userdata)> callback;
 };
 
+/**
+ * Request body produced while it is sent, instead of materialized up front. The producer fills at most `size` bytes
+ * into `data` and returns how many it wrote, 0 once the body is complete, or kAbort when it can't deliver the body,
+ * which fails the transfer. Without a known size the body goes out with chunked transfer encoding.
+ *
+ * The optional rewinder moves the body back to `offset` bytes from its start and returns false if it can't. It is
+ * called with 0 before each request on the session and by curl when redirects or authentication resend the body.
+ * Without one such a resend fails and the session sends the body only once, later put/post requests fail with an
+ * error response until another body is set.
+ */
+class BodyStream
+{
+public:
+    using Producer = std::function<size_t(char *data, size_t size)>;
+    using Rewinder = std::function<bool(int64_t offset)>;
+
+    static constexpr size_t kAbort = static_cast<size_t>(-1);
+
+    BodyStream() = default;
+    BodyStream(Producer p_producer, int64_t p_size = -1, Rewinder p_rewinder = nullptr)
+        : producer(std::move(p_producer))
+        , rewinder(std::move(p_rewinder))
+        , size(p_size)
+    {
+    }
+
+    Producer producer;
+    Rewinder rewinder;
+    int64_t size{-1};
+};
+
+/**
+ * Request body sent from a whole file, given by path or by a descriptor the caller keeps open until the response
+ * arrived. Regular files are memory mapped and streamed from the mapping, which rewinds for every request and
+ * resend. Other descriptors such as pipes are read as they are sent with chunked transfer encoding, only once; a read
+ * error fails the transfer. Those reads block, so only Session sends them, Client fails such requests. A file that
+ * can't be opened fails the requests of the session until another body is set.
+ */
+class BodyFile
+{
+public:
+    explicit BodyFile(std::string p_path)
+        : path(std::move(p_path))
+    {
+    }
+    explicit BodyFile(int p_fd)
+        : fd(p_fd)
+    {
+    }
+
+    std::string path;
+    int fd{-1};
+};
+
+/**
+ * Consumes a response body chunk by chunk instead of buffering it for Response::text(). Chunks are SharedBuffers of
+ * up to chunkSize bytes whose ownership goes to the consumer, created by the optional allocator so that callers can
+ * hand out recycled buffers. The consumer applies backpressure with kPause, the transfer stops reading from the socket
+ * until Client::resume(). Session::download() has no one to resume it, its consumer blocks instead and kPause acts
+ * as kContinue there. kAbort fails the transfer.
+ */
+class ChunkCallback
+{
+public:
+    enum class Action
+    {
+        kContinue,
+        kPause,
+        kAbort
+    };
+    using Consumer = std::function<Action(SharedBuffer chunk)>;
+    using Allocator = std::function<SharedBuffer(size_t capacity)>;
+
+    ChunkCallback() = default;
+    ChunkCallback(Consumer p_consumer, size_t p_chunkSize = 256 * 1024, Allocator p_allocator = nullptr)
+        : consumer(std::move(p_consumer))
+        , allocator(std::move(p_allocator))
+        , chunkSize(p_chunkSize)
+    {
+    }
+
+    Consumer consumer;
+    Allocator allocator;
+    size_t chunkSize{256 * 1024};
+};
+
 using Url = detail::StringHolder<OCTK_FOURCC('u', 'r', 'l', ' ')>;
 using Body = detail::StringHolder<OCTK_FOURCC('b', 'o', 'd', 'y')>;
 using Bearer = detail::StringHolder<OCTK_FOURCC('b', 'a', 'e', 'r')>;
@@ -351,14 +440,22 @@ public:
     std::string text() const;
     std::string reason() const;
     std::string header(StringView key) const;
+    // Transport failure, e.g. refused connection or timeout, empty when the server answered.
+    std::string errorString() const;
 
 protected:
+    friend class ClientPrivate;
     friend class Session;
     OCTK_DEFINE_DPTR(Response)
     OCTK_DECLARE_PRIVATE(Response)
     OCTK_DISABLE_COPY_MOVE(Response)
 };
-using AsyncResponse = std::future<Response::SharedPtr>;
+/**
+ * Formerly a std::future. Future keeps its get(), valid(), wait_for() and wait_until(), so such callers still
+ * compile, but get() no longer moves the result out and a Future is copyable. New code should use result(),
+ * waitFor() and then().
+ */
+using AsyncResponse = Future<Response::SharedPtr>;
 
 class AuthenticationPrivate;
 class OCTK_NETWORK_API Authentication
@@ -401,6 +498,8 @@ public:
     void setConnectTimeout(const ConnectTimeout &timeout);
     void setAuth(const Authentication &auth);
     void setBody(const Body &body);
+    void setBody(const BodyStream &body);
+    void setBody(const BodyFile &body);
     void setBearer(const Bearer &bearer);
     void setPayload(const Payload &payload);
     void setCookies(const Cookies &cookies);
@@ -412,6 +511,8 @@ public:
     void setOption(const ConnectTimeout &timeout) { this->setConnectTimeout(timeout); }
     void setOption(const Authentication &auth) { this->setAuth(auth); }
     void setOption(const Body &body) { this->setBody(body); }
+    void setOption(const BodyStream &body) { this->setBody(body); }
+    void setOption(const BodyFile &body) { this->setBody(body); }
     void setOption(const Bearer &bearer) { this->setBearer(bearer); }
     void setOption(const Payload &payload) { this->setPayload(payload); }
     void setOption(const Cookies &cookies) { this->setCookies(cookies); }
@@ -421,8 +522,10 @@ public:
     Response::SharedPtr post();
     Response::SharedPtr download(std::ofstream &file);
     Response::SharedPtr download(const WriteCallback &write);
+    Response::SharedPtr download(const ChunkCallback &chunks);
 
 protected:
+    friend class ClientPrivate;
     OCTK_DEFINE_DPTR(Session)
     OCTK_DECLARE_PRIVATE(Session)
     OCTK_DISABLE_COPY_MOVE(Session)
@@ -465,9 +568,9 @@ void set_option(Session &session, Ts &&...ts)
 }
 
 template <class Fn, class... Args>
-auto async(Fn &&fn, Args &&...args) -> std::future<decltype(fn(args...))>
+auto async(Fn &&fn, Args &&...args) -> Future<decltype(fn(args...))>
 {
-    return ThreadPool::defaultInstance()->start(std::forward<Fn>(fn), std::forward<Args>(args)...);
+    return concurrent::run(std::bind(std::forward<Fn>(fn), std::forward<Args>(args)...));
 }
 } // namespace detail
 
@@ -564,6 +667,21 @@ Response::SharedPtr download(const WriteCallback &write, Ts &&...ts)
     return session.download(write);
 }
 
+/**
+ * Download in chunks
+ * @tparam Ts
+ * @param chunks
+ * @param ts
+ * @return
+ */
+template <typename... Ts>
+Response::SharedPtr download(const ChunkCallback &chunks, Ts &&...ts)
+{
+    Session session;
+    detail::set_option(session, std::forward<Ts>(ts)...);
+    return session.download(chunks);
+}
+
 /**
  * Download methods
  * @tparam Ts
@@ -589,8 +707,7 @@ Response::SharedPtr download(std::ofstream &file, Ts &&...ts)
 template <typename... Ts>
 AsyncResponse asyncDownload(std::string local_path, Ts... ts)
 {
-    return std::async(
-        std::launch::async,
+    return detail::async(
         [](std::string local_path, Ts... ts)
         {
             std::ofstream f(local_path);
@@ -0,0 +1,466 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/network/detail/http_p.hpp>
+#include <openctk/network/http_client.hpp>
+#include <openctk/core/platform_thread.hpp>
+#include <openctk/core/logging.hpp>
+#include <openctk/core/checks.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace http
+{
+
+namespace detail
+{
+class ClientReactor;
+} // namespace detail
+
+class ClientPrivate
+{
+public:
+    explicit ClientPrivate(Client *p);
+    virtual ~ClientPrivate();
+
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    static cpr::Session &cprSession(Session &session) { return session.dFunc()->mSession; }
+    static cpr::Response &cprResponse(Response &response) { return response.dFunc()->mResponse; }
+    static SessionPrivate *sessionPrivate(Session &session) { return session.dFunc(); }
+#endif
+
+    // Reactor of the session's origin, so that all requests to a host share its connections.
+    detail::ClientReactor *reactorFor(Session &session);
+
+    std::vector<std::unique_ptr<detail::ClientReactor>> mReactors;
+
+protected:
+    OCTK_DEFINE_PPTR(Client)
+    OCTK_DECLARE_PUBLIC(Client)
+    OCTK_DISABLE_COPY_MOVE(ClientPrivate)
+};
+
+namespace detail
+{
+// Upper bound of one reactor wait, curl shortens it on its own when a transfer timeout is due sooner.
+static constexpr int kReactorPollMSecs = 1000;
+
+// Scheme and authority of an url, e.g. "https://host:443" out of "https://host:443/path?query".
+static std::string urlOrigin(const std::string &url)
+{
+    const auto schemeEnd = url.find("://");
+    const auto authorityBegin = std::string::npos == schemeEnd ? 0 : schemeEnd + 3;
+    const auto authorityEnd = url.find_first_of("/?#", authorityBegin);
+    return url.substr(0, authorityEnd);
+}
+
+struct ClientTransfer
+{
+    SharedPointer<Session> session;
+    Client::Method method;
+    Client::Callback callback;
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    std::unique_ptr<BodyChunkWriter> chunkWriter;
+#endif
+};
+
+class ClientReactor
+{
+public:
+    ClientReactor(const Client::Options &options, int index);
+    ~ClientReactor();
+
+    void post(std::unique_ptr<ClientTransfer> transfer);
+    void resume(const SharedPointer<Session> &session);
+    size_t pendingCount() const { return mPendingCount.load(std::memory_order_relaxed); }
+    bool isCurrent() const { return mThread->threadId() == PlatformThread::currentThreadId(); }
+
+private:
+    void run();
+    void start(std::unique_ptr<ClientTransfer> transfer);
+    void finish(std::unique_ptr<ClientTransfer> transfer, Response::SharedPtr response);
+    void abortAll();
+
+    const bool mHttp2;
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    CURLM *mMulti{nullptr};
+    // owned by the reactor thread, keyed by the easy handle of the transfer's session
+    std::unordered_map<CURL *, std::unique_ptr<ClientTransfer>> mRunning;
+#endif
+    mutable std::mutex mMutex;
+    std::vector<std::unique_ptr<ClientTransfer>> mIncoming;
+    std::vector<SharedPointer<Session>> mResumes;
+    std::atomic<size_t> mPendingCount{0};
+    std::atomic<bool> mQuit{false};
+    PlatformThread::UniquePtr mThread;
+};
+
+ClientReactor::ClientReactor(const Client::Options &options, int index)
+    : mHttp2(options.http2)
+{
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    mMulti = curl_multi_init();
+    curl_multi_setopt(mMulti, CURLMOPT_MAX_HOST_CONNECTIONS, options.maxHostConnections);
+    curl_multi_setopt(mMulti, CURLMOPT_MAX_TOTAL_CONNECTIONS, options.maxTotalConnections);
+    curl_multi_setopt(mMulti, CURLMOPT_MAXCONNECTS, options.maxIdleConnections);
+    curl_multi_setopt(mMulti, CURLMOPT_PIPELINING, options.http2 ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+#endif
+    mThread = PlatformThread::create([this]() { this->run(); });
+    mThread->setName("HttpClient" + std::to_string(index));
+    mThread->start();
+}
+
+ClientReactor::~ClientReactor()
+{
+    // run() is still on the reactor thread's stack, which can't join itself, see ClientPrivate::~ClientPrivate().
+    OCTK_DCHECK(!this->isCurrent());
+    mQuit.store(true);
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    curl_multi_wakeup(mMulti);
+#endif
+    mThread->wait();
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    curl_multi_cleanup(mMulti);
+#endif
+}
+
+void ClientReactor::post(std::unique_ptr<ClientTransfer> transfer)
+{
+    mPendingCount.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIncoming.push_back(std::move(transfer));
+    }
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+    this->abortAll();
+#else
+    curl_multi_wakeup(mMulti);
+#endif
+}
+
+void ClientReactor::resume(const SharedPointer<Session> &session)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mResumes.push_back(session);
+    }
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    curl_multi_wakeup(mMulti);
+#endif
+}
+
+void ClientReactor::run()
+{
+    std::vector<std::unique_ptr<ClientTransfer>> incoming;
+    std::vector<SharedPointer<Session>> resumes;
+    while (!mQuit.load())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            incoming.swap(mIncoming);
+            resumes.swap(mResumes);
+        }
+        for (auto &transfer : incoming)
+        {
+            this->start(std::move(transfer));
+        }
+        incoming.clear();
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+        break;
+#else
+        for (const auto &session : resumes)
+        {
+            // the transfer may have completed or been resumed already
+            CURL *handle = ClientPrivate::cprSession(*session).GetCurlHolder()->handle;
+            const auto iter = mRunning.find(handle);
+            if (mRunning.end() != iter && iter->second->chunkWriter && iter->second->chunkWriter->isPaused())
+            {
+                iter->second->chunkWriter->setResumed();
+                curl_easy_pause(handle, CURLPAUSE_CONT);
+            }
+        }
+        resumes.clear();
+        int running = 0;
+        curl_multi_perform(mMulti, &running);
+        int queued = 0;
+        while (CURLMsg *message = curl_multi_info_read(mMulti, &queued))
+        {
+            if (CURLMSG_DONE != message->msg)
+            {
+                continue;
+            }
+            const auto iter = mRunning.find(message->easy_handle);
+            OCTK_DCHECK(mRunning.end() != iter);
+            auto transfer = std::move(iter->second);
+            mRunning.erase(iter);
+            curl_multi_remove_handle(mMulti, message->easy_handle);
+
+            if (transfer->chunkWriter)
+            {
+                transfer->chunkWriter->finish();
+            }
+            auto response = utils::make_shared<Response>();
+            auto &session = ClientPrivate::cprSession(*transfer->session);
+            ClientPrivate::cprResponse(*response) = session.Complete(message->data.result);
+            this->finish(std::move(transfer), std::move(response));
+        }
+        curl_multi_poll(mMulti, nullptr, 0, kReactorPollMSecs, nullptr);
+#endif
+    }
+    this->abortAll();
+}
+
+void ClientReactor::start(std::unique_ptr<ClientTransfer> transfer)
+{
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+    this->finish(std::move(transfer), utils::make_shared<Response>());
+#else
+    if (Client::Method::kGet != transfer->method)
+    {
+        auto response = utils::make_shared<Response>();
+        auto sessionPrivate = ClientPrivate::sessionPrivate(*transfer->session);
+        auto &cprResponse = ClientPrivate::cprResponse(*response);
+        if (sessionPrivate->mBodyBlocking)
+        {
+            // a blocking read() in the producer would stall every transfer of this reactor
+            cprResponse.error = cpr::Error(CURLE_READ_ERROR, "descriptor request bodies can't be sent by http::Client");
+            this->finish(std::move(transfer), std::move(response));
+            return;
+        }
+        if (sessionPrivate->failUnpreparedBody(cprResponse))
+        {
+            this->finish(std::move(transfer), std::move(response));
+            return;
+        }
+    }
+    auto &session = ClientPrivate::cprSession(*transfer->session);
+    switch (transfer->method)
+    {
+        case Client::Method::kGet: session.PrepareGet(); break;
+        case Client::Method::kPut: session.PreparePut(); break;
+        case Client::Method::kPost: session.PreparePost(); break;
+    }
+    CURL *handle = session.GetCurlHolder()->handle;
+    if (transfer->chunkWriter)
+    {
+        transfer->chunkWriter->install(handle);
+    }
+    if (mHttp2)
+    {
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    }
+    const auto code = curl_multi_add_handle(mMulti, handle);
+    if (CURLM_OK != code)
+    {
+        auto response = utils::make_shared<Response>();
+        ClientPrivate::cprResponse(*response).error = cpr::Error(CURLE_FAILED_INIT, curl_multi_strerror(code));
+        this->finish(std::move(transfer), std::move(response));
+        return;
+    }
+    mRunning.emplace(handle, std::move(transfer));
+#endif
+}
+
+void ClientReactor::finish(std::unique_ptr<ClientTransfer> transfer, Response::SharedPtr response)
+{
+    mPendingCount.fetch_sub(1, std::memory_order_relaxed);
+    try
+    {
+        transfer->callback(response);
+    }
+    catch (const std::exception &e)
+    {
+        OCTK_WARNING() << "http client callback threw:" << e.what();
+    }
+}
+
+void ClientReactor::abortAll()
+{
+    std::vector<std::unique_ptr<ClientTransfer>> aborted;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        aborted.swap(mIncoming);
+    }
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    for (auto &item : mRunning)
+    {
+        curl_multi_remove_handle(mMulti, item.first);
+        aborted.push_back(std::move(item.second));
+    }
+    mRunning.clear();
+#endif
+    for (auto &transfer : aborted)
+    {
+        auto response = utils::make_shared<Response>();
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+        ClientPrivate::cprResponse(*response).error = cpr::Error(CURLE_ABORTED_BY_CALLBACK, "http client destroyed");
+#endif
+        this->finish(std::move(transfer), std::move(response));
+    }
+}
+} // namespace detail
+
+ClientPrivate::ClientPrivate(Client *p)
+    : mPPtr(p)
+{
+}
+
+ClientPrivate::~ClientPrivate()
+{
+    // A callback dropped the last reference to the client: the reactor thread returns to run() once the callback is
+    // done, so tear the reactors down from another thread, which waits for that and then quits them as usual.
+    for (const auto &reactor : mReactors)
+    {
+        if (reactor->isCurrent())
+        {
+            std::thread([reactors = std::move(mReactors)]() mutable { reactors.clear(); }).detach();
+            return;
+        }
+    }
+}
+
+detail::ClientReactor *ClientPrivate::reactorFor(Session &session)
+{
+    size_t index = 0;
+    if (mReactors.size() > 1)
+    {
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+        const auto origin = detail::urlOrigin(cprSession(session).GetFullRequestUrl());
+        index = std::hash<std::string>()(origin) % mReactors.size();
+#endif
+    }
+    return mReactors[index].get();
+}
+
+Client::Client()
+    : Client(Options())
+{
+}
+
+Client::Client(const Options &options)
+    : mDPtr(new ClientPrivate(this))
+{
+    OCTK_D(Client);
+    for (int i = 0; i < std::max(options.reactorThreads, 1); ++i)
+    {
+        d->mReactors.push_back(utils::make_unique<detail::ClientReactor>(options, i));
+    }
+}
+
+Client::~Client()
+{
+}
+
+void Client::send(Method method, const SharedPointer<Session> &session, Callback callback)
+{
+    OCTK_D(Client);
+    OCTK_DCHECK(session);
+    OCTK_DCHECK(callback);
+    auto transfer = utils::make_unique<detail::ClientTransfer>();
+    transfer->session = session;
+    transfer->method = method;
+    transfer->callback = std::move(callback);
+    d->reactorFor(*session)->post(std::move(transfer));
+}
+
+void Client::download(const SharedPointer<Session> &session, const ChunkCallback &chunks, Callback callback)
+{
+    OCTK_D(Client);
+    OCTK_DCHECK(session);
+    OCTK_DCHECK(callback);
+    auto transfer = utils::make_unique<detail::ClientTransfer>();
+    transfer->session = session;
+    transfer->method = Method::kGet;
+    transfer->callback = std::move(callback);
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+    transfer->chunkWriter = utils::make_unique<detail::BodyChunkWriter>(chunks, true);
+#endif
+    d->reactorFor(*session)->post(std::move(transfer));
+}
+
+AsyncResponse Client::download(const SharedPointer<Session> &session, const ChunkCallback &chunks)
+{
+    auto promise = std::make_shared<Promise<Response::SharedPtr>>();
+    auto future = promise->future();
+    this->download(session, chunks, [promise](const Response::SharedPtr &response) { promise->setValue(response); });
+    return future;
+}
+
+void Client::resume(const SharedPointer<Session> &session)
+{
+    OCTK_D(Client);
+    d->reactorFor(*session)->resume(session);
+}
+
+AsyncResponse Client::send(Method method, const SharedPointer<Session> &session)
+{
+    auto promise = std::make_shared<Promise<Response::SharedPtr>>();
+    auto future = promise->future();
+    this->send(method, session, [promise](const Response::SharedPtr &response) { promise->setValue(response); });
+    return future;
+}
+
+size_t Client::pendingCount() const
+{
+    OCTK_D(const Client);
+    size_t count = 0;
+    for (const auto &reactor : d->mReactors)
+    {
+        count += reactor->pendingCount();
+    }
+    return count;
+}
+
+} // namespace http
+
+OCTK_END_NAMESPACE
@@ -0,0 +1,126 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#pragma once
+
+#include <openctk/network/http.hpp>
+
+#include <functional>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace http
+{
+
+class ClientPrivate;
+/**
+ * Event driven counterpart of Session::get/put/post. Transfers run on curl multi handles driven by a few reactor
+ * threads, not on one blocked thread each, so thousands of requests can be in flight at once. Requests to the same
+ * host always land on the same reactor, which keeps their connections alive for reuse and, over TLS, multiplexes
+ * them as streams of one HTTP/2 connection when the server supports it.
+ *
+ * Callbacks run on a reactor thread and must not block it, hand heavy work to another queue. A Session passed to the
+ * client belongs to it until its response is delivered and must not be touched in between. Destroying the client
+ * aborts the transfers still in flight, their responses carry statusCode() 0 and an errorString(). A callback may drop
+ * the last reference to its client, the reactors are then shut down from a helper thread after the callback returned.
+ */
+class OCTK_NETWORK_API Client
+{
+public:
+    using SharedPtr = SharedPointer<Client>;
+    using Callback = std::function<void(const Response::SharedPtr &response)>;
+
+    enum class Method
+    {
+        kGet,
+        kPut,
+        kPost
+    };
+
+    struct Options
+    {
+        int reactorThreads{1};
+        // Parallel connections to one host, 0 for no limit. Requests above it queue for a free connection.
+        long maxHostConnections{6};
+        // Parallel connections of one reactor, 0 for no limit.
+        long maxTotalConnections{0};
+        // Idle connections a reactor keeps open for reuse.
+        long maxIdleConnections{64};
+        // Negotiate HTTP/2 over TLS and wait for a multiplexed stream instead of opening another connection.
+        bool http2{true};
+    };
+
+    Client();
+    explicit Client(const Options &options);
+    virtual ~Client();
+
+    void send(Method method, const SharedPointer<Session> &session, Callback callback);
+    AsyncResponse send(Method method, const SharedPointer<Session> &session);
+
+    /**
+     * GET whose body goes to `chunks` as it arrives instead of into Response::text(). A consumer that returned
+     * ChunkCallback::Action::kPause gets further chunks only after resume() was called for the session.
+     */
+    void download(const SharedPointer<Session> &session, const ChunkCallback &chunks, Callback callback);
+    AsyncResponse download(const SharedPointer<Session> &session, const ChunkCallback &chunks);
+    void resume(const SharedPointer<Session> &session);
+
+    template <typename... Ts>
+    AsyncResponse get(Ts &&...ts)
+    {
+        return this->send(Method::kGet, makeSession(std::forward<Ts>(ts)...));
+    }
+    template <typename... Ts>
+    AsyncResponse put(Ts &&...ts)
+    {
+        return this->send(Method::kPut, makeSession(std::forward<Ts>(ts)...));
+    }
+    template <typename... Ts>
+    AsyncResponse post(Ts &&...ts)
+    {
+        return this->send(Method::kPost, makeSession(std::forward<Ts>(ts)...));
+    }
+
+    /**
+     * Requests sent but not yet answered, over all reactors.
+     */
+    size_t pendingCount() const;
+
+protected:
+    template <typename... Ts>
+    static SharedPointer<Session> makeSession(Ts &&...ts)
+    {
+        auto session = utils::make_shared<Session>();
+        detail::set_option(*session, std::forward<Ts>(ts)...);
+        return session;
+    }
+
+    OCTK_DEFINE_DPTR(Client)
+    OCTK_DECLARE_PRIVATE(Client)
+    OCTK_DISABLE_COPY_MOVE(Client)
+};
+
+} // namespace http
+
+OCTK_END_NAMESPACE
@@ -39,6 +39,57 @@ OCTK_BEGIN_NAMESPACE
 namespace http
 {
 
+namespace detail
+{
+#if OCTK_FEATURE_USE_BOOST_BACKEND
+
+#else
+/**
+ * Curl write function feeding a ChunkCallback. A chunk is handed over before curl data that does not fit into it is
+ * taken, so a pause never leaves data half consumed, curl delivers the same data again after the resume.
+ */
+class BodyChunkWriter
+{
+public:
+    BodyChunkWriter(ChunkCallback callback, bool pausable);
+
+    void install(CURL *handle);
+    // Hands over the last partial chunk once the transfer completed.
+    void finish();
+
+    bool isPaused() const { return mPaused; }
+    void setResumed() { mPaused = false; }
+
+private:
+    static size_t write(char *data, size_t size, size_t count, void *userdata);
+    ChunkCallback::Action deliver();
+
+    const ChunkCallback mCallback;
+    const bool mPausable;
+    SharedBuffer mChunk;
+    bool mPaused{false};
+    bool mAborted{false};
+};
+
+// Read only mapping of a request body file, unmapped once the last request using it is done.
+class MappedBodyFile
+{
+public:
+    static std::shared_ptr<MappedBodyFile> open(const BodyFile &file);
+    ~MappedBodyFile();
+
+    const uint8_t *data() const { return mData; }
+    size_t size() const { return mSize; }
+
+private:
+    MappedBodyFile() = default;
+
+    const uint8_t *mData{nullptr};
+    size_t mSize{0};
+};
+#endif
+} // namespace detail
+
 class ResponsePrivate
 {
 public:
@@ -104,7 +155,22 @@ public:
 #if OCTK_FEATURE_USE_BOOST_BACKEND
 
 #else
+    // Forgets the state of a previous BodyStream or BodyFile body.
+    void resetBody();
+    // Starts the body over before an upload. Returns CURLE_OK, or why the body can't be sent with `error` set.
+    CURLcode prepareBody(std::string *error);
+    // Fails `response` with the error of prepareBody(), false if there was none.
+    bool failUnpreparedBody(cpr::Response &response);
+    static int seekBody(void *userdata, curl_off_t offset, int origin);
+
     cpr::Session mSession;
+    BodyStream::Rewinder mBodyRewinder;
+    // Why the last body can't be sent, e.g. a BodyFile that didn't open.
+    std::string mBodyError;
+    // A producer without rewinder was read from, its body is gone.
+    bool mBodyConsumed{false};
+    // The producer blocks in read() on a pipe or socket, which would stall the client's reactor threads.
+    bool mBodyBlocking{false};
 #endif
 
 protected:
@@ -0,0 +1,681 @@
+/***********************************************************************************************************************
+**
+** Library: OpenCTK
+**
+** Copyright (C) 2026~Present ChengXueWen.
+**
+** License: MIT License
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+** documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+** and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in all copies or substantial portions
+** of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+** TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+** THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+** CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+** IN THE SOFTWARE.
+**
+***********************************************************************************************************************/
+
+#include <openctk/network/http_client.hpp>
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <thread>
+
+OCTK_BEGIN_NAMESPACE
+
+namespace
+{
+// Deterministic body content for the streaming tests.
+std::string pattern(size_t size)
+{
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+    {
+        data[i] = static_cast<char>(i % 251);
+    }
+    return data;
+}
+
+uint64_t digest(const std::string &data)
+{
+    uint64_t hash = 1469598103934665603ull;
+    for (const auto c : data)
+    {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Keep-alive HTTP/1.1 stand-in on 127.0.0.1, one poll() thread for all connections. It answers
+ * "<METHOD> <PATH>[:<BODY>]", paths starting with /slow/<ms> are answered after that delay. /bytes/<n> answers n
+ * bytes of pattern(), /digest answers "<length>:<digest>" of the request body, which may be chunked.
+ */
+class LoopbackServer
+{
+public:
+    LoopbackServer()
+    {
+        mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+        const int yes = 1;
+        setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(mListenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        socklen_t length = sizeof(addr);
+        getsockname(mListenFd, reinterpret_cast<sockaddr *>(&addr), &length);
+        mPort = ntohs(addr.sin_port);
+        listen(mListenFd, 1024);
+        fcntl(mListenFd, F_SETFL, O_NONBLOCK);
+        mThread = std::thread([this]() { this->run(); });
+    }
+    ~LoopbackServer()
+    {
+        mQuit.store(true);
+        mThread.join();
+        for (const auto &item : mConnections)
+        {
+            close(item.first);
+        }
+        close(mListenFd);
+    }
+
+    std::string url(const std::string &path) const { return "http://127.0.0.1:" + std::to_string(mPort) + path; }
+    int acceptedConnections() const { return mAccepted.load(); }
+
+private:
+    struct Connection
+    {
+        std::string input;
+        std::string output;
+        std::chrono::steady_clock::time_point sendAt;
+        bool continued{false};
+        // answered early, the rest of the request is dropped and the connection closed once the answer is out
+        bool closing{false};
+    };
+
+    void run()
+    {
+        while (!mQuit.load())
+        {
+            std::vector<pollfd> fds;
+            fds.push_back({mListenFd, POLLIN, 0});
+            for (const auto &item : mConnections)
+            {
+                fds.push_back({item.first, static_cast<short>(POLLIN | (item.second.output.empty() ? 0 : POLLOUT)), 0});
+            }
+            poll(fds.data(), fds.size(), 10);
+            if (fds[0].revents & POLLIN)
+            {
+                int fd;
+                while ((fd = accept(mListenFd, nullptr, nullptr)) >= 0)
+                {
+                    fcntl(fd, F_SETFL, O_NONBLOCK);
+                    mConnections[fd];
+                    ++mAccepted;
+                }
+            }
+            const auto now = std::chrono::steady_clock::now();
+            for (size_t i = 1; i < fds.size(); ++i)
+            {
+                auto &connection = mConnections[fds[i].fd];
+                if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+                {
+                    char buffer[64 * 1024];
+                    const auto size = read(fds[i].fd, buffer, sizeof(buffer));
+                    if (size <= 0)
+                    {
+                        close(fds[i].fd);
+                        mConnections.erase(fds[i].fd);
+                        continue;
+                    }
+                    if (!connection.closing)
+                    {
+                        connection.input.append(buffer, size);
+                    }
+                    while (this->parse(connection))
+                    {
+                    }
+                }
+                if (!connection.output.empty() && now >= connection.sendAt)
+                {
+                    const auto size = write(fds[i].fd, connection.output.data(), connection.output.size());
+                    if (size > 0)
+                    {
+                        connection.output.erase(0, size);
+                    }
+                }
+                if (connection.closing && connection.output.empty())
+                {
+                    close(fds[i].fd);
+                    mConnections.erase(fds[i].fd);
+                }
+            }
+        }
+    }
+
+    // Takes one complete request off the input, false while it is still incomplete.
+    bool parse(Connection &connection)
+    {
+        const auto headerEnd = connection.input.find("\r\n\r\n");
+        if (std::string::npos == headerEnd)
+        {
+            return false;
+        }
+        const auto head = connection.input.substr(0, headerEnd);
+        if (0 == head.find("PUT /reject") || 0 == head.find("POST /reject"))
+        {
+            connection.output += "HTTP/1.1 413 Payload Too Large\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+            connection.sendAt = std::chrono::steady_clock::now();
+            connection.closing = true;
+            connection.input.clear();
+            return false;
+        }
+        if (!connection.continued && std::string::npos != head.find("Expect: 100-continue"))
+        {
+            connection.output += "HTTP/1.1 100 Continue\r\n\r\n";
+            connection.continued = true;
+        }
+        std::string content;
+        size_t consumed = headerEnd + 4;
+        if (std::string::npos != head.find("chunked"))
+        {
+            while (true)
+            {
+                const auto lineEnd = connection.input.find("\r\n", consumed);
+                if (std::string::npos == lineEnd)
+                {
+                    return false;
+                }
+                const auto size = std::stoul(connection.input.substr(consumed, lineEnd - consumed), nullptr, 16);
+                if (connection.input.size() < lineEnd + 2 + size + 2)
+                {
+                    return false;
+                }
+                content.append(connection.input, lineEnd + 2, size);
+                consumed = lineEnd + 2 + size + 2;
+                if (0 == size)
+                {
+                    break;
+                }
+            }
+        }
+        else
+        {
+            const auto lengthPos = head.find("Content-Length: ");
+            const size_t length = std::string::npos == lengthPos ? 0 : std::stoul(head.substr(lengthPos + 16));
+            if (connection.input.size() < consumed + length)
+            {
+                return false;
+            }
+            content = connection.input.substr(consumed, length);
+            consumed += length;
+        }
+        connection.input.erase(0, consumed);
+        connection.continued = false;
+
+        const auto methodEnd = head.find(' ');
+        const auto pathEnd = head.find(' ', methodEnd + 1);
+        const auto path = head.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+        std::string body;
+        if (0 == path.find("/bytes/"))
+        {
+            body = pattern(std::stoul(path.substr(7)));
+        }
+        else if (0 == path.find("/digest"))
+        {
+            body = std::to_string(content.size()) + ":" + std::to_string(digest(content));
+        }
+        else
+        {
+            body = head.substr(0, pathEnd) + (content.empty() ? "" : ":" + content);
+        }
+        connection.sendAt = std::chrono::steady_clock::now();
+        if (0 == path.find("/redirect/"))
+        {
+            // 307 keeps method and body, curl has to rewind the body for the second request
+            connection.output += "HTTP/1.1 307 Temporary Redirect\r\nLocation: " + path.substr(9) +
+                                 "\r\nContent-Length: 0\r\n\r\n";
+            return true;
+        }
+        if (0 == path.find("/slow/"))
+        {
+            connection.sendAt += std::chrono::milliseconds(std::stoi(path.substr(6)));
+        }
+        connection.output += "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        return true;
+    }
+
+    int mListenFd{-1};
+    uint16_t mPort{0};
+    std::atomic<int> mAccepted{0};
+    std::atomic<bool> mQuit{false};
+    std::map<int, Connection> mConnections;
+    std::thread mThread;
+};
+} // namespace
+
+TEST(HttpClientTest, GetDeliversResponseThroughFuture)
+{
+    LoopbackServer server;
+    http::Client client;
+    const auto response = client.get(http::Url{server.url("/hello")}).result();
+    ASSERT_TRUE(response);
+    EXPECT_EQ(200, response->statusCode());
+    EXPECT_EQ("GET /hello", response->text());
+    EXPECT_TRUE(response->errorString().empty());
+    EXPECT_EQ(0u, client.pendingCount());
+}
+
+TEST(HttpClientTest, PostSendsBody)
+{
+    LoopbackServer server;
+    http::Client client;
+    const auto response = client.post(http::Url{server.url("/echo")}, http::Body{"payload"}).result();
+    EXPECT_EQ(200, response->statusCode());
+    EXPECT_EQ("POST /echo:payload", response->text());
+}
+
+TEST(HttpClientTest, CallbacksRunForEveryRequest)
+{
+    LoopbackServer server;
+    http::Client::Options options;
+    options.reactorThreads = 2;
+    http::Client client(options);
+    std::atomic<int> ok{0};
+    std::atomic<int> done{0};
+    const int count = 64;
+    for (int i = 0; i < count; ++i)
+    {
+        auto session = utils::make_shared<http::Session>();
+        session->setUrl(http::Url{server.url("/item/" + std::to_string(i))});
+        const auto expected = "GET /item/" + std::to_string(i);
+        client.send(http::Client::Method::kGet,
+                    session,
+                    [&, expected](const http::Response::SharedPtr &response)
+                    {
+                        ok += response->text() == expected ? 1 : 0;
+                        ++done;
+                    });
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (done.load() < count && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(count, ok.load());
+}
+
+TEST(HttpClientTest, ReusesConnectionsPerHost)
+{
+    LoopbackServer server;
+    http::Client::Options options;
+    options.maxHostConnections = 2;
+    http::Client client(options);
+    std::vector<http::AsyncResponse> responses;
+    for (int i = 0; i < 40; ++i)
+    {
+        responses.push_back(client.get(http::Url{server.url("/reuse")}));
+    }
+    for (auto &response : responses)
+    {
+        EXPECT_EQ(200, response.result()->statusCode());
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(200, client.get(http::Url{server.url("/again")}).result()->statusCode());
+    }
+    EXPECT_LE(server.acceptedConnections(), 2);
+}
+
+TEST(HttpClientTest, RunsManySlowRequestsOnOneReactor)
+{
+    LoopbackServer server;
+    http::Client::Options options;
+    options.maxHostConnections = 0;
+    http::Client client(options);
+    const int count = 200;
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<http::AsyncResponse> responses;
+    for (int i = 0; i < count; ++i)
+    {
+        responses.push_back(client.get(http::Url{server.url("/slow/200")}));
+    }
+    for (auto &response : responses)
+    {
+        EXPECT_EQ(200, response.result()->statusCode());
+    }
+    // one at a time this takes 40s, concurrently about one delay
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_GT(server.acceptedConnections(), count / 2);
+}
+
+TEST(HttpClientTest, RefusedConnectionReportsError)
+{
+    std::string url;
+    {
+        LoopbackServer server;
+        url = server.url("/gone");
+    }
+    http::Client client;
+    const auto response = client.get(http::Url{url}, http::ConnectTimeout{2000}).result();
+    EXPECT_EQ(0, response->statusCode());
+    EXPECT_FALSE(response->errorString().empty());
+}
+
+TEST(HttpClientTest, DestroyAbortsPendingTransfers)
+{
+    LoopbackServer server;
+    http::AsyncResponse response;
+    {
+        http::Client client;
+        response = client.get(http::Url{server.url("/slow/10000")});
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_EQ(1u, client.pendingCount());
+    }
+    EXPECT_TRUE(response.isFinished());
+    EXPECT_EQ(0, response.result()->statusCode());
+    EXPECT_FALSE(response.result()->errorString().empty());
+}
+
+TEST(HttpClientTest, CallbackMayDestroyClient)
+{
+    LoopbackServer server;
+    http::Client::Options options;
+    // don't let the second request wait for the slow one to tell whether its connection multiplexes
+    options.http2 = false;
+    auto client = utils::make_shared<http::Client>(options);
+    // still in flight when the client goes away, aborted by the teardown
+    const auto pending = client->get(http::Url{server.url("/slow/10000")});
+    std::weak_ptr<http::Client> weak = client;
+    std::atomic<bool> released{false};
+    auto session = utils::make_shared<http::Session>();
+    session->setUrl(http::Url{server.url("/hello")});
+    auto holder = std::make_shared<http::Client::SharedPtr>(std::move(client));
+    (*holder)->send(http::Client::Method::kGet,
+                    session,
+                    [holder, &released](const http::Response::SharedPtr &)
+                    {
+                        holder->reset();
+                        released.store(true);
+                    });
+    holder.reset();
+    EXPECT_EQ(0, pending.result()->statusCode());
+    EXPECT_FALSE(pending.result()->errorString().empty());
+    EXPECT_TRUE(released.load());
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(HttpStreamingTest, UploadsFileFromMapping)
+{
+    LoopbackServer server;
+    const auto content = pattern(3 * 1024 * 1024 + 17);
+    char path[] = "/tmp/octk_http_body_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(static_cast<ssize_t>(content.size()), write(fd, content.data(), content.size()));
+    close(fd);
+
+    http::Session session;
+    session.setUrl(http::Url{server.url("/digest")});
+    session.setBody(http::BodyFile(std::string(path)));
+    const auto expected = std::to_string(content.size()) + ":" + std::to_string(digest(content));
+    EXPECT_EQ(expected, session.post()->text());
+    // the mapping rewinds, the same body can go out again
+    EXPECT_EQ(expected, session.put()->text());
+    unlink(path);
+}
+
+TEST(HttpStreamingTest, MappedBodyRestartsAfterFailedUpload)
+{
+    LoopbackServer server;
+    // larger than the socket buffers, so the rejected upload stops somewhere inside the file
+    const auto content = pattern(32 * 1024 * 1024 + 3);
+    char path[] = "/tmp/octk_http_body_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(static_cast<ssize_t>(content.size()), write(fd, content.data(), content.size()));
+    close(fd);
+
+    http::Session session;
+    session.setHeader(http::Header{{"Expect", ""}});
+    session.setBody(http::BodyFile(std::string(path)));
+    session.setUrl(http::Url{server.url("/reject")});
+    EXPECT_NE(200, session.put()->statusCode());
+    session.setUrl(http::Url{server.url("/digest")});
+    const auto expected = std::to_string(content.size()) + ":" + std::to_string(digest(content));
+    EXPECT_EQ(expected, session.put()->text());
+    // redirects resend the body through the seek callback
+    session.setUrl(http::Url{server.url("/redirect/digest")});
+    const auto redirected = session.post();
+    EXPECT_EQ(200, redirected->statusCode());
+    EXPECT_EQ(expected, redirected->text());
+    unlink(path);
+}
+
+TEST(HttpStreamingTest, PipeReadErrorFailsUpload)
+{
+    LoopbackServer server;
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    http::Session session;
+    session.setUrl(http::Url{server.url("/digest")});
+    // reading the write end fails with EBADF
+    session.setBody(http::BodyFile(fds[1]));
+    const auto response = session.post();
+    // the server may already have sent "100 Continue"
+    EXPECT_NE(200, response->statusCode());
+    EXPECT_FALSE(response->errorString().empty());
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(HttpStreamingTest, NonRewindableBodyIsSentOnce)
+{
+    LoopbackServer server;
+    const auto content = pattern(64 * 1024 + 1);
+    auto offset = std::make_shared<size_t>(0);
+    http::Session session;
+    session.setUrl(http::Url{server.url("/digest")});
+    session.setBody(http::BodyStream(
+        [&content, offset](char *data, size_t size)
+        {
+            const auto length = std::min(size, content.size() - *offset);
+            std::memcpy(data, content.data() + *offset, length);
+            *offset += length;
+            return length;
+        }));
+    EXPECT_EQ(std::to_string(content.size()) + ":" + std::to_string(digest(content)), session.post()->text());
+    // the producer is drained, sending it again must not upload an empty body
+    const auto again = session.post();
+    EXPECT_EQ(0, again->statusCode());
+    EXPECT_FALSE(again->errorString().empty());
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(3, write(fds[1], "abc", 3));
+    close(fds[1]);
+    session.setBody(http::BodyFile(fds[0]));
+    EXPECT_EQ("3:" + std::to_string(digest("abc")), session.put()->text());
+    const auto pipeAgain = session.put();
+    EXPECT_EQ(0, pipeAgain->statusCode());
+    EXPECT_FALSE(pipeAgain->errorString().empty());
+    close(fds[0]);
+}
+
+TEST(HttpStreamingTest, UnopenableBodyFileFailsRequest)
+{
+    LoopbackServer server;
+    http::Session session;
+    session.setUrl(http::Url{server.url("/digest")});
+    session.setBody(http::Body{"previous"});
+    session.setBody(http::BodyFile(std::string("/nonexistent/octk_http_body")));
+    const auto response = session.post();
+    EXPECT_EQ(0, response->statusCode());
+    EXPECT_FALSE(response->errorString().empty());
+    // a new body clears the error
+    session.setBody(http::Body{"abc"});
+    EXPECT_EQ("3:" + std::to_string(digest("abc")), session.post()->text());
+}
+
+TEST(HttpStreamingTest, UploadsEmptyFile)
+{
+    LoopbackServer server;
+    char path[] = "/tmp/octk_http_body_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    http::Session session;
+    session.setUrl(http::Url{server.url("/digest")});
+    session.setBody(http::BodyFile(std::string(path)));
+    EXPECT_EQ("0:" + std::to_string(digest("")), session.post()->text());
+    unlink(path);
+}
+
+TEST(HttpStreamingTest, ClientRejectsDescriptorBody)
+{
+    LoopbackServer server;
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    http::Client client;
+    // nothing is ever written, reading the pipe would block the reactor forever
+    const auto response = client.post(http::Url{server.url("/digest")}, http::BodyFile(fds[0])).result();
+    EXPECT_EQ(0, response->statusCode());
+    EXPECT_FALSE(response->errorString().empty());
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(HttpStreamingTest, UploadsPipeDescriptorChunked)
+{
+    LoopbackServer server;
+    const auto content = pattern(1024 * 1024);
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    std::thread writer(
+        [&]()
+        {
+            size_t offset = 0;
+            while (offset < content.size())
+            {
+                const auto length = std::min<size_t>(4096, content.size() - offset);
+                const auto size = write(fds[1], content.data() + offset, length);
+                offset += size > 0 ? size : 0;
+            }
+            close(fds[1]);
+        });
+    http::Session session;
+    session.setUrl(http::Url{server.url("/digest")});
+    session.setBody(http::BodyFile(fds[0]));
+    EXPECT_EQ(std::to_string(content.size()) + ":" + std::to_string(digest(content)), session.post()->text());
+    writer.join();
+    close(fds[0]);
+}
+
+TEST(HttpStreamingTest, ClientUploadsFromProducer)
+{
+    LoopbackServer server;
+    http::Client client;
+    const auto content = pattern(2 * 1024 * 1024 + 5);
+    auto offset = std::make_shared<size_t>(0);
+    http::BodyStream body(
+        [&content, offset](char *data, size_t size)
+        {
+            const auto length = std::min(size, content.size() - *offset);
+            std::memcpy(data, content.data() + *offset, length);
+            *offset += length;
+            return length;
+        });
+    const auto response = client.post(http::Url{server.url("/digest")}, body).result();
+    EXPECT_EQ(std::to_string(content.size()) + ":" + std::to_string(digest(content)), response->text());
+}
+
+TEST(HttpStreamingTest, DownloadsInChunks)
+{
+    LoopbackServer server;
+    const size_t size = 5 * 1024 * 1024 + 3;
+    const size_t chunkSize = 64 * 1024;
+    std::string received;
+    size_t chunks = 0;
+    size_t largest = 0;
+    http::Session session;
+    session.setUrl(http::Url{server.url("/bytes/" + std::to_string(size))});
+    const auto response = session.download(http::ChunkCallback(
+        [&](SharedBuffer chunk)
+        {
+            ++chunks;
+            largest = std::max(largest, chunk.size());
+            received.append(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+            return http::ChunkCallback::Action::kContinue;
+        },
+        chunkSize));
+    EXPECT_EQ(200, response->statusCode());
+    EXPECT_TRUE(response->text().empty());
+    EXPECT_EQ(pattern(size), received);
+    EXPECT_LE(largest, chunkSize);
+    EXPECT_GE(chunks, size / chunkSize);
+}
+
+TEST(HttpStreamingTest, ClientDownloadPausesUntilResumed)
+{
+    LoopbackServer server;
+    http::Client client;
+    const size_t size = 4 * 1024 * 1024;
+    std::atomic<size_t> chunks{0};
+    std::atomic<size_t> received{0};
+    auto session = utils::make_shared<http::Session>();
+    session->setUrl(http::Url{server.url("/bytes/" + std::to_string(size))});
+    auto response = client.download(session,
+                                    http::ChunkCallback(
+                                        [&](SharedBuffer chunk)
+                                        {
+                                            received += chunk.size();
+                                            return 1 == ++chunks ? http::ChunkCallback::Action::kPause
+                                                                 : http::ChunkCallback::Action::kContinue;
+                                        },
+                                        64 * 1024));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (0 == chunks.load() && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(1u, chunks.load());
+    EXPECT_FALSE(response.isFinished());
+
+    client.resume(session);
+    EXPECT_EQ(200, response.result()->statusCode());
+    EXPECT_EQ(size, received.load());
+}
+
+TEST(HttpStreamingTest, AbortingConsumerFailsTransfer)
+{
+    LoopbackServer server;
+    http::Session session;
+    session.setUrl(http::Url{server.url("/bytes/1048576")});
+    const auto response = session.download(http::ChunkCallback(
+        [](SharedBuffer) { return http::ChunkCallback::Action::kAbort; }, 16 * 1024));
+    EXPECT_FALSE(response->errorString().empty());
+}
+
+OCTK_END_NAMESPACE